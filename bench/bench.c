@@ -0,0 +1,297 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/bench/bench.c
+  * @version    R100
+  * @brief      OTEAX benchmark: EAX throughput across frame sizes and alignments
+  *
+  * Times key setup, and encrypt, decrypt and verify of single frames of
+  * DASH7 sizes (1 to 256 bytes) and of 4KB, 64KB and 1MB buffers, with the
+  * buffer at several offsets from a 64 byte boundary.  Verify runs only the
+  * OMAC of the ciphertext and the tag check, as a receiver filtering frames
+  * would.  Decrypt is timed in place on the same buffer, which is fine,
+  * because it does the same work whether or not the tag matches.
+  *
+  * Each point is the best of several runs of about OTEAX_BENCH_MS (default
+  * 20) milliseconds.  Cycles come from the TSC on x86.  Set OTEAX_BENCH_GHZ
+  * to the core clock to convert from time instead, on other CPUs, or where
+  * the TSC rate is not the core clock.
+  *
+  * Usage: bench build_name [json_file]
+  * It prints a table, and writes one JSON object per point to json_file.  A
+  * kernel named in OTEAX_KERNEL is forced, and the run is skipped if the CPU
+  * lacks it.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#   define BENCH_TSC
+#endif
+
+#include <oteax.h>
+
+#define UNIT        sizeof(io_t)
+#define MAX_BYTES   (1024 * 1024)
+#define NUM_RUNS    5
+
+enum {
+    OP_KEY = 0,
+    OP_ENCRYPT,
+    OP_DECRYPT,
+    OP_VERIFY,
+    NUM_OPS
+};
+
+static const char* op_names[NUM_OPS] = { "key", "encrypt", "decrypt", "verify" };
+
+static const unsigned long sizes[] = {
+    1, 7, 13, 16, 21, 32, 33, 47, 64, 97, 128, 173, 249, 256,
+    4096, 65536, MAX_BYTES
+};
+
+/* Byte offsets from a 64 byte boundary.  __ALIGN32__ builds need words. */
+#if defined(__ALIGN32__)
+static const unsigned int offsets[] = { 0, 4, 8 };
+#else
+static const unsigned int offsets[] = { 0, 1, 4, 8 };
+#endif
+
+#define NUM_SIZES   (sizeof(sizes) / sizeof(sizes[0]))
+#define NUM_OFFSETS (sizeof(offsets) / sizeof(offsets[0]))
+
+typedef struct {
+    double  ns;         // per frame
+    double  cycles;     // per frame, 0 if unknown
+} point_t;
+
+static uint64_t     buffer[(MAX_BYTES + 16 + 64) / 8] __attribute__((aligned(64)));
+static uint32_t     key[4]      = { 0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c };
+static uint32_t     nonce[2]    = { 0x13121110, 0x00161514 };
+static eax_ctx      ctx[1];
+static double       bench_ms    = 20.0;
+static double       ghz         = 0.0;
+static volatile int sink;
+
+
+
+static double sub_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((double)t.tv_sec * 1e9) + (double)t.tv_nsec;
+}
+
+
+
+static uint64_t sub_ticks(void) {
+#   if defined(BENCH_TSC)
+    return __rdtsc();
+#   else
+    return 0;
+#   endif
+}
+
+
+
+static void sub_run(int op, io_t* msg, unsigned long len, unsigned long iters) {
+    unsigned long   units = (len + UNIT - 1) / UNIT;
+    uint32_t        tag[4];
+    int             acc = 0;
+
+    while (iters-- != 0) {
+        switch (op) {
+        case OP_KEY:
+            acc += eax_init_and_key(key, ctx);
+            break;
+        case OP_ENCRYPT:
+            acc += eax_encrypt_message(nonce, msg, len, ctx);
+            break;
+        case OP_DECRYPT:
+            acc += eax_decrypt_message(nonce, msg, len, ctx);
+            break;
+        default:
+            eax_init_message((const io_t*)nonce, ctx);
+            eax_auth_data(msg, units, ctx);
+            eax_compute_tag((io_t*)tag, ctx);
+            acc += memcmp(tag, &msg[units], 4);
+            break;
+        }
+    }
+    sink += acc;
+}
+
+
+
+static point_t sub_measure(int op, io_t* msg, unsigned long len) {
+    unsigned long   iters = 1;
+    double          t0, t1, best_ns;
+    uint64_t        c0, c1, best_c;
+    point_t         p;
+    int             i;
+
+    // Grow the count until one run takes a quarter of the target time
+    for (;;) {
+        t0 = sub_now();
+        sub_run(op, msg, len, iters);
+        t1 = sub_now();
+        if ((t1 - t0) >= (bench_ms * 1e6 / 4)) {
+            break;
+        }
+        iters *= 2;
+    }
+    iters = (unsigned long)((double)iters * (bench_ms * 1e6) / (t1 - t0)) + 1;
+
+    best_ns = 0;
+    best_c  = 0;
+    for (i=0; i<NUM_RUNS; i++) {
+        t0 = sub_now();
+        c0 = sub_ticks();
+        sub_run(op, msg, len, iters);
+        c1 = sub_ticks();
+        t1 = sub_now();
+        if ((i == 0) || ((t1 - t0) < best_ns)) {
+            best_ns = t1 - t0;
+            best_c  = c1 - c0;
+        }
+    }
+
+    p.ns = best_ns / (double)iters;
+    if (ghz > 0) {
+        p.cycles = p.ns * ghz;
+    }
+    else {
+        p.cycles = (double)best_c / (double)iters;
+    }
+    return p;
+}
+
+
+
+static void sub_json(FILE* json, const char* build, int op, unsigned long len, unsigned int off, point_t p) {
+    if (json == NULL) {
+        return;
+    }
+    fprintf(json, "{\"build\": \"%s\", \"kernel\": \"%s\", \"op\": \"%s\", \"bytes\": %lu, \"offset\": %u, "
+                  "\"ns_per_frame\": %.2f, \"frames_per_s\": %.0f, \"cycles_per_frame\": ",
+            build, aes_kernel_name(), op_names[op], len, off, p.ns, 1e9 / p.ns);
+    if (p.cycles > 0) {
+        fprintf(json, "%.1f, \"cycles_per_byte\": ", p.cycles);
+        if (len != 0) {
+            fprintf(json, "%.3f}\n", p.cycles / (double)len);
+        }
+        else {
+            fprintf(json, "null}\n");
+        }
+    }
+    else {
+        fprintf(json, "null, \"cycles_per_byte\": null}\n");
+    }
+}
+
+
+
+int main(int argc, char** argv) {
+    const char*     build;
+    FILE*           json = NULL;
+    char*           env;
+    point_t         p[NUM_OFFSETS];
+    unsigned long   s;
+    unsigned int    o;
+    int             op;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s build_name [json_file]\n", argv[0]);
+        return 1;
+    }
+    build = argv[1];
+    if (argc > 2) {
+        json = fopen(argv[2], "w");
+        if (json == NULL) {
+            perror(argv[2]);
+            return 1;
+        }
+    }
+    // A kernel forced in OTEAX_KERNEL that this CPU can't run skips the
+    // variant, rather than timing the automatic choice under its name
+    if (((env = getenv("OTEAX_KERNEL")) != NULL) && (aes_kernel_select(env) != EXIT_SUCCESS)) {
+        printf("build %s: kernel %s not available, skipped\n", build, env);
+        if (json != NULL) {
+            fclose(json);
+        }
+        return 0;
+    }
+    if ((env = getenv("OTEAX_BENCH_MS")) != NULL) {
+        bench_ms = atof(env);
+    }
+    if ((env = getenv("OTEAX_BENCH_GHZ")) != NULL) {
+        ghz = atof(env);
+    }
+#   if !defined(BENCH_TSC)
+    if (ghz <= 0) {
+        printf("No cycle counter: set OTEAX_BENCH_GHZ to get cycles/byte\n");
+    }
+#   endif
+
+    memset(buffer, 0x5A, sizeof(buffer));
+    eax_init_and_key(key, ctx);
+
+    printf("build %s, kernel %s, cycles from %s\n", build, aes_kernel_name(),
+            (ghz > 0) ? "OTEAX_BENCH_GHZ" : "TSC");
+    printf("%-8s %8s %11s %11s", "op", "bytes", "ns/frame", "frames/s");
+    for (o=0; o<NUM_OFFSETS; o++) {
+        printf("   c/B +%-2u", offsets[o]);
+    }
+    putchar('\n');
+
+    p[0] = sub_measure(OP_KEY, NULL, 0);
+    printf("%-8s %8s %11.1f %11.0f   %6.0f cycles/key\n", "key", "-", p[0].ns, 1e9 / p[0].ns, p[0].cycles);
+    sub_json(json, build, OP_KEY, 0, 0, p[0]);
+
+    for (op=OP_ENCRYPT; op<NUM_OPS; op++) {
+        for (s=0; s<NUM_SIZES; s++) {
+            for (o=0; o<NUM_OFFSETS; o++) {
+                io_t* msg = (io_t*)&((uint8_t*)buffer)[offsets[o]];
+
+                // Verify needs a good tag to check against
+                if (op == OP_VERIFY) {
+                    eax_encrypt_message(nonce, msg, sizes[s], ctx);
+                }
+                p[o] = sub_measure(op, msg, sizes[s]);
+                sub_json(json, build, op, sizes[s], offsets[o], p[o]);
+            }
+            printf("%-8s %8lu %11.1f %11.0f", op_names[op], sizes[s], p[0].ns, 1e9 / p[0].ns);
+            for (o=0; o<NUM_OFFSETS; o++) {
+                printf("   %8.2f", p[o].cycles / (double)sizes[s]);
+            }
+            putchar('\n');
+        }
+    }
+    putchar('\n');
+
+    eax_end(ctx);
+    if (json != NULL) {
+        fclose(json);
+    }
+    return 0;
+}
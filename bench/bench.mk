@@ -0,0 +1,189 @@
+CC := gcc
+LD := ld
+CFLAGS ?= -std=gnu99 -O3 -pthread
+
+GROUP       := bench
+
+X_CC	    ?= $(CC)
+X_CFLAGS    ?= $(CFLAGS)
+X_INC       ?=
+X_LIB       ?= -lpthread
+X_TARG      ?= .
+X_DEF       ?=
+EXT_DEF     ?=
+SCALE_ARGS  ?=
+REPLAY_ARGS ?=
+GEN_ARGS    ?=
+SINK_ARGS   ?=
+RING        ?= /oteax_loop
+VALGRIND    ?= valgrind
+CG_ANNOTATE ?= cg_annotate
+COST_BYTES  ?= 7 16 21 64 128 256
+COST_FRAMES ?= 200 1200
+COST_THRESHOLD ?= 1
+COST_BASELINE ?= ./cost.baseline
+
+BUILDDIR    := ../build/$(X_TARG)/$(GROUP)
+PRODUCTDIR  := ../bin/$(X_TARG)_bench
+INC         := -I../main $(patsubst -I./%,-I./../%,$(X_INC))
+LIB         := $(patsubst -L./%,-L./../%,$(X_LIB))
+LIBSOURCES  := $(wildcard ../main/*.c)
+
+# Each variant is the library sources built into the benchmark with these
+# definitions, so that all of them can be compared in one run.  EXT_DEF is
+# added to every variant.
+VARIANTS    := size normal speed normal-align32 aesni vaes
+DEF_size            := -DOTEAX_OPTIMIZATION=-1
+DEF_normal          := -DOTEAX_OPTIMIZATION=0
+DEF_speed           := -DOTEAX_OPTIMIZATION=2
+DEF_normal-align32  := -DOTEAX_OPTIMIZATION=0 -D__ALIGN32__
+DEF_aesni           := -DOTEAX_OPTIMIZATION=2
+DEF_vaes            := -DOTEAX_OPTIMIZATION=2
+
+# AES kernel forced in each variant, so that a variant measures its own
+# kernel and not the fastest one the CPU has.  bench and setup get it in
+# OTEAX_KERNEL, and skip the variant if the CPU can't run it; cost.c gets it
+# on the command line.
+KERNEL_size             := size
+KERNEL_normal           := normal
+KERNEL_speed            := speed
+KERNEL_normal-align32   := normal
+KERNEL_aesni            := aesni
+KERNEL_vaes             := vaes
+
+# Variants counted by cost: cachegrind counts each AES-NI round as one
+# instruction and does not run AVX-512, so only the table kernels are.
+COST_VARIANTS := size normal speed normal-align32
+
+# Programs: bench (throughput) and setup (fixed costs per frame)
+PROGRAMS    := bench setup
+PRODUCTS    := $(foreach p,$(PROGRAMS),$(addprefix $(PRODUCTDIR)/$(p)_,$(VARIANTS)))
+COST_POINTS := $(foreach v,$(COST_VARIANTS),$(addprefix $(v)_,$(COST_BYTES)))
+
+
+all: directories $(PROGRAMS)
+obj: directories $(PRODUCTS)
+bench: directories $(PRODUCTDIR)/bench.json
+setup: directories $(PRODUCTDIR)/setup.json
+
+# Thread and key population scaling, with the library configuration given
+# to the top Makefile (X_DEF), and options from SCALE_ARGS.  It is not part
+# of all, because a sweep is long and the options depend on the machine.
+scale: directories $(PRODUCTDIR)/scale
+	$(PRODUCTDIR)/scale $(SCALE_ARGS) -o $(BUILDDIR)/scale.json
+	@{ echo "["; sed -e '$$!s/$$/,/' $(BUILDDIR)/scale.json; echo "]"; } > $(PRODUCTDIR)/scale.json
+	@echo "Results written to $(abspath $(PRODUCTDIR)/scale.json)"
+
+# Replay of a recorded frame log, built like scale.  REPLAY_ARGS must give
+# at least the key file and the log (see replay.c).
+replay: directories $(PRODUCTDIR)/replay
+	$(PRODUCTDIR)/replay -o $(PRODUCTDIR)/replay.json $(REPLAY_ARGS)
+
+# Generator to receiver over the shared memory ring, built like scale.  The
+# generator writes the key file first, then both run at once.  GEN_ARGS go
+# to both runs of gen.c, so that the keys match, and SINK_ARGS to sink.c.
+# Both get a new run number, so the generator can't attach to a ring left
+# by an earlier run.
+loop: directories $(PRODUCTDIR)/gen $(PRODUCTDIR)/sink
+	$(PRODUCTDIR)/gen $(GEN_ARGS) -K $(BUILDDIR)/keys.csv
+	run=$$(date +%s%N); \
+	$(PRODUCTDIR)/sink -k $(BUILDDIR)/keys.csv -o $(PRODUCTDIR)/loop.json $(SINK_ARGS) -m $(RING) -g $$run & \
+	$(PRODUCTDIR)/gen $(GEN_ARGS) -m $(RING) -g $$run || kill $$!; \
+	wait $$!
+
+# Instruction counts under cachegrind, which are the same from run to run,
+# for each variant and frame length in COST_BYTES.  cost.txt has the cost
+# per frame, and cost_<variant>_<bytes>.annotate the counts per function.
+# The run fails if instructions per frame grow by more than COST_THRESHOLD
+# percent over COST_BASELINE, or if there is no baseline, unless the check
+# is waived with COST_BASELINE=none; cost_baseline stores the current
+# results as the baseline.
+cost: directories $(PRODUCTDIR)/cost.txt
+	@if [ "$(COST_BASELINE)" = "none" ]; then \
+		echo "Baseline check waived (COST_BASELINE=none)"; \
+	elif [ -f $(COST_BASELINE) ]; then \
+		awk -v mode=check -v threshold=$(COST_THRESHOLD) -f ./cost.awk $(COST_BASELINE) $(PRODUCTDIR)/cost.txt; \
+	else \
+		echo "No baseline at $(COST_BASELINE): make cost_baseline to store one, or set COST_BASELINE=none"; \
+		exit 1; \
+	fi
+
+cost_baseline: directories $(PRODUCTDIR)/cost.txt
+	@[ "$(COST_BASELINE)" != "none" ] || { echo "COST_BASELINE=none: nowhere to store the baseline"; exit 1; }
+	@cp $(PRODUCTDIR)/cost.txt $(COST_BASELINE)
+	@echo "Baseline written to $(abspath $(COST_BASELINE))"
+remake: clean all
+
+
+#Make the Directories
+directories:
+	@mkdir -p $(PRODUCTDIR)
+	@mkdir -p $(BUILDDIR)
+
+#Clean only Objects
+clean:
+	@$(RM) -rf $(BUILDDIR)
+
+#Build each program once per variant
+$(PRODUCTDIR)/bench_%: ./bench.c $(LIBSOURCES)
+	$(X_CC) $(X_CFLAGS) $(DEF_$*) $(EXT_DEF) $(INC) -o $@ ./bench.c $(LIBSOURCES) $(LIB)
+
+$(PRODUCTDIR)/setup_%: ./setup.c $(LIBSOURCES)
+	$(X_CC) $(X_CFLAGS) $(DEF_$*) $(EXT_DEF) $(INC) -o $@ ./setup.c $(LIBSOURCES) $(LIB)
+
+# -g gives cachegrind the source file of each instruction, for the fl=
+# lines that cost.awk groups table reads by; it doesn't change the code
+$(PRODUCTDIR)/cost_%: ./cost.c $(LIBSOURCES)
+	$(X_CC) $(X_CFLAGS) -g $(DEF_$*) $(EXT_DEF) $(INC) -o $@ ./cost.c $(LIBSOURCES) $(LIB)
+
+$(PRODUCTDIR)/scale: ./scale.c ./hist.h $(LIBSOURCES)
+	$(X_CC) $(X_CFLAGS) $(X_DEF) $(INC) -o $@ ./scale.c $(LIBSOURCES) $(LIB) -lm
+
+$(PRODUCTDIR)/replay: ./replay.c ./framelog.h ./hist.h $(LIBSOURCES)
+	$(X_CC) $(X_CFLAGS) $(X_DEF) $(INC) -o $@ ./replay.c $(LIBSOURCES) $(LIB)
+
+$(PRODUCTDIR)/gen: ./gen.c ./framelog.h ./ring.h $(LIBSOURCES)
+	$(X_CC) $(X_CFLAGS) $(X_DEF) $(INC) -o $@ ./gen.c $(LIBSOURCES) $(LIB) -lm -lrt
+
+$(PRODUCTDIR)/sink: ./sink.c ./framelog.h ./ring.h ./hist.h $(LIBSOURCES)
+	$(X_CC) $(X_CFLAGS) $(X_DEF) $(INC) -o $@ ./sink.c $(LIBSOURCES) $(LIB) -lrt
+
+#Run each variant, every time
+$(BUILDDIR)/bench_%.json: $(PRODUCTDIR)/bench_% FORCE
+	@OTEAX_KERNEL=$(KERNEL_$*) $< $* $@
+
+$(BUILDDIR)/setup_%.json: $(PRODUCTDIR)/setup_% FORCE
+	@OTEAX_KERNEL=$(KERNEL_$*) $< $* $@
+
+#Run cost.c twice per point under cachegrind, and take the difference
+$(BUILDDIR)/cost_%.txt: $(addprefix $(PRODUCTDIR)/cost_,$(COST_VARIANTS)) ./cost.awk FORCE
+	@command -v $(VALGRIND) > /dev/null || { echo "cost needs valgrind ($(VALGRIND) not found)"; exit 1; }
+	@set -e; v=$(firstword $(subst _, ,$*)); \
+	for n in $(COST_FRAMES); do \
+		$(VALGRIND) --tool=cachegrind --cache-sim=yes --cachegrind-out-file=$(BUILDDIR)/cg_$*_$$n.out \
+			$(PRODUCTDIR)/cost_$$v $(KERNEL_$(firstword $(subst _, ,$*))) $(lastword $(subst _, ,$*)) $$n > /dev/null; \
+	done; \
+	$(CG_ANNOTATE) $(BUILDDIR)/cg_$*_$(lastword $(COST_FRAMES)).out > $(PRODUCTDIR)/cost_$*.annotate; \
+	awk -v mode=point -v variant=$$v -v bytes=$(lastword $(subst _, ,$*)) \
+		-v n1=$(firstword $(COST_FRAMES)) -v n2=$(lastword $(COST_FRAMES)) -v tables='aescrypt|aeskern_|aeskey' \
+		-f ./cost.awk $(addprefix $(BUILDDIR)/cg_$*_,$(addsuffix .out,$(COST_FRAMES))) > $@
+
+$(PRODUCTDIR)/cost.txt: $(addprefix $(BUILDDIR)/cost_,$(addsuffix .txt,$(COST_POINTS)))
+	@{ echo "# variant bytes ir d1mr dlmr table_d1mr table_dlmr"; cat $^; } > $@
+	@echo "Results written to $(abspath $@)"
+
+#Collect the points of all variants into one JSON array per program
+$(PRODUCTDIR)/%.json: $(addprefix $(BUILDDIR)/%_,$(addsuffix .json,$(VARIANTS)))
+	@{ echo "["; cat $^ | sed -e '$$!s/$$/,/'; echo "]"; } > $@
+	@echo "Results written to $(abspath $@)"
+
+FORCE:
+
+#Non-File Targets
+.PHONY: all obj remake clean directories $(PROGRAMS) scale replay loop cost cost_baseline FORCE
+
+#Keep the results of each variant
+.SECONDARY:
+
+#Variants are timed one after another, so that they don't disturb each other
+.NOTPARALLEL:
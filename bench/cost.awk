@@ -0,0 +1,98 @@
+# OTEAX cost report helper for bench.mk, in POSIX awk.
+#
+# mode=point: reads two cachegrind output files of cost.c, the first run
+# with n1 frames and the second with n2, and prints one summary line:
+#   variant bytes ir d1mr dlmr table_d1mr table_dlmr
+# ir, d1mr and dlmr are per frame, from the difference between the runs.
+# table_d1mr and table_dlmr are the data read misses of the second run in
+# the files matching tables (the code that reads the tables in aestab.h),
+# which are mostly the first touch of each table line.  The table code is
+# found by the source file names cachegrind writes in fl= lines, so cost.c
+# must be built with -g; without it every line is fl=??? and a warning is
+# printed.
+#
+# mode=check: reads a baseline and a new summary, prints the change in
+# instructions per frame for each point, and exits with 1 if any grew by
+# more than threshold percent.
+
+function count(name) {
+    return (name in col) ? $(col[name] + 1) + 0 : 0
+}
+
+mode == "point" && FNR == 1 {
+    run++
+    infile = 0
+}
+
+mode == "point" && /^events:/ {
+    for (i = 2; i <= NF; i++) {
+        col[$i] = i - 1
+    }
+    next
+}
+
+mode == "point" && /^fl=/ {
+    infile = ($0 ~ tables)
+    tables_seen += infile
+    next
+}
+
+mode == "point" && /^summary:/ {
+    ir[run]   = count("Ir")
+    d1mr[run] = count("D1mr")
+    dlmr[run] = count("DLmr")
+    next
+}
+
+mode == "point" && run == 2 && infile && /^[0-9]/ {
+    tab_d1mr += count("D1mr")
+    tab_dlmr += count("DLmr")
+    next
+}
+
+mode == "check" && FNR == 1 {
+    run++
+}
+
+mode == "check" && !/^#/ && NF >= 3 {
+    key = $1 " " $2
+    if (run == 1) {
+        base[key] = $3
+    }
+    else {
+        keys[++num] = key
+        now[key] = $3
+    }
+}
+
+END {
+    if (mode == "point") {
+        if (!tables_seen) {
+            print "cost.awk: no fl= lines match " tables " (no debug info?)" > "/dev/stderr"
+        }
+        frames = n2 - n1
+        printf "%s %s %.1f %.3f %.3f %d %d\n", variant, bytes,
+               (ir[2] - ir[1]) / frames, (d1mr[2] - d1mr[1]) / frames, (dlmr[2] - dlmr[1]) / frames,
+               tab_d1mr, tab_dlmr
+    }
+    else if (mode == "check") {
+        bad = 0
+        printf "%-16s %6s %12s %12s %8s\n", "variant", "bytes", "baseline", "now", "change"
+        for (i = 1; i <= num; i++) {
+            key = keys[i]
+            split(key, k, " ")
+            if (!(key in base) || (base[key] <= 0)) {
+                printf "%-16s %6s %12s %12.1f %8s\n", k[1], k[2], "-", now[key], "new"
+                continue
+            }
+            change = 100 * (now[key] - base[key]) / base[key]
+            flag = ""
+            if (change > threshold) {
+                flag = "  REGRESSION"
+                bad = 1
+            }
+            printf "%-16s %6s %12.1f %12.1f %+7.2f%%%s\n", k[1], k[2], base[key], now[key], change, flag
+        }
+        exit bad
+    }
+}
@@ -0,0 +1,84 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/bench/cost.c
+  * @version    R100
+  * @brief      OTEAX fixed workload for instruction counts under cachegrind
+  *
+  * Encrypts and then decrypts a number of frames of one length, with a
+  * fixed key, nonces and payload, so that every run of the same build
+  * executes the same instructions.  It does no timing: bench.mk runs it
+  * under cachegrind twice with different frame counts, and the difference
+  * between the two runs, over the difference in frames, is the cost of one
+  * frame without the setup.
+  *
+  * The AES kernel is named on the command line and forced, so the table
+  * kernels can be measured on hosts with AES-NI, which cachegrind counts
+  * as single instructions (and does not run at all with AVX-512).
+  *
+  * Usage: cost kernel frame_bytes frames
+  ******************************************************************************
+  */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+#define UNIT        sizeof(io_t)
+#define MAX_BYTES   256
+
+
+
+int main(int argc, char** argv) {
+    static const uint8_t key[16] = {
+        0x23, 0x39, 0x52, 0xDE, 0xE4, 0xD5, 0xED, 0x5F,
+        0x9B, 0x9C, 0x6D, 0x6F, 0xF8, 0x0F, 0xF4, 0x78
+    };
+    eax_ctx         ctx;
+    uint32_t        buf[(MAX_BYTES + 16) / 4];
+    uint32_t        nonce[2] = { 0x62EC67F9u, 0x00C3A2E9u };
+    unsigned long   len, frames, i, fails = 0;
+
+    if (argc != 4) {
+        fprintf(stderr, "Usage: %s kernel frame_bytes frames\n", argv[0]);
+        return 1;
+    }
+    len     = strtoul(argv[2], NULL, 10);
+    frames  = strtoul(argv[3], NULL, 10);
+    if ((len == 0) || (len > MAX_BYTES)) {
+        fprintf(stderr, "frame_bytes must be 1 to %d\n", MAX_BYTES);
+        return 1;
+    }
+    if (aes_kernel_select(argv[1]) != EXIT_SUCCESS) {
+        fprintf(stderr, "%s: kernel not available\n", argv[1]);
+        return 1;
+    }
+
+    eax_init_and_key((io_t*)key, &ctx);
+    memset(buf, 0xA5, sizeof(buf));
+
+    for (i=0; i<frames; i++) {
+        nonce[0]++;
+        eax_encrypt_message(nonce, buf, len, &ctx);
+        fails += (eax_decrypt_message(nonce, buf, len, &ctx) != 0);
+    }
+
+    printf("%s %lu bytes, %lu frames, %lu failed\n", aes_kernel_name(), len, frames, fails);
+    return (fails != 0);
+}
@@ -0,0 +1,344 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/bench/framelog.h
+  * @brief      Recorded frame logs, and the key files that go with them
+  *
+  * A frame log holds received frames: the time, the key ID of the device,
+  * the 7 byte nonce, and the ciphertext followed by the 4 byte tag.  It is
+  * either CSV, one frame per line:
+  *
+  *     time_s,key_id,nonce_hex,frame_hex
+  *
+  * with the time in seconds (up to 9 decimals), and lines starting with #
+  * ignored, or binary (all little-endian): the 8 bytes "OTEAXLOG", a u32
+  * version (1) and a u32 of zero, then per frame a u64 time in ns, a u32
+  * key ID, a u16 ciphertext length, the 7 nonce bytes, a flags byte, and
+  * the ciphertext and tag.  Readers tell the two apart from the first
+  * bytes.  Frames may be up to FRAMELOG_MAX_BYTES long, without the tag.
+  * Binary logs may be read from a pipe (path "-").
+  *
+  * The flags are zero in recorded logs.  The traffic generator sets them to
+  * say what it injected, so that a receiver's counts can be checked.
+  *
+  * Keys are kept apart from the log, in a CSV of key_id,key_hex lines.
+  ******************************************************************************
+  */
+
+#ifndef _BENCH_FRAMELOG_H
+#define _BENCH_FRAMELOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAMELOG_MAGIC      "OTEAXLOG"
+#define FRAMELOG_VERSION    1
+#define FRAMELOG_MAX_BYTES  65535
+#define FRAMELOG_TAG_BYTES  4
+#define FRAMELOG_LINE       (64 + (2 * (FRAMELOG_MAX_BYTES + FRAMELOG_TAG_BYTES)))
+
+#define FRAMELOG_DUPLICATE  0x01        // sent again at once
+#define FRAMELOG_REPLAY     0x02        // an older frame sent again
+#define FRAMELOG_CORRUPT    0x04        // tag damaged
+
+typedef struct {
+    uint64_t    time_ns;
+    uint32_t    key_id;
+    uint16_t    len;                        // ciphertext bytes, without tag
+    uint8_t     nonce[7];
+    uint8_t     flags;
+    uint8_t     data[FRAMELOG_MAX_BYTES + FRAMELOG_TAG_BYTES];
+} framelog_rec;
+
+typedef struct {
+    FILE*       f;
+    int         csv;
+    char*       line;
+} framelog_t;
+
+
+
+static inline int framelog_nibble(char c) {
+    if ((c >= '0') && (c <= '9'))   return c - '0';
+    if ((c >= 'a') && (c <= 'f'))   return c - 'a' + 10;
+    if ((c >= 'A') && (c <= 'F'))   return c - 'A' + 10;
+    return -1;
+}
+
+/* Hex up to a comma or the end of the line.  Returns the bytes, or -1. */
+static inline int framelog_hex(const char* s, uint8_t* out, size_t max) {
+    size_t n = 0;
+
+    while ((s[0] != 0) && (s[0] != '\n') && (s[0] != '\r') && (s[0] != ',')) {
+        int hi = framelog_nibble(s[0]);
+        int lo = framelog_nibble(s[1]);
+        if ((n == max) || (hi < 0) || (lo < 0)) {
+            return -1;
+        }
+        out[n++] = (uint8_t)((hi << 4) | lo);
+        s += 2;
+    }
+    return (int)n;
+}
+
+static inline void framelog_puthex(FILE* f, const uint8_t* p, size_t n) {
+    while (n-- != 0) {
+        fprintf(f, "%02x", *p++);
+    }
+}
+
+static inline void framelog_put32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t framelog_get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+
+/* Writing: csv selects the form.  Returns 0 on success. */
+static inline int framelog_create(framelog_t* log, const char* path, int csv) {
+    uint8_t hdr[16];
+
+    log->csv    = csv;
+    log->line   = NULL;
+    log->f      = (strcmp(path, "-") == 0) ? stdout : fopen(path, csv ? "w" : "wb");
+    if (log->f == NULL) {
+        return -1;
+    }
+    if (csv) {
+        fprintf(log->f, "# time_s,key_id,nonce,frame\n");
+    }
+    else {
+        memcpy(hdr, FRAMELOG_MAGIC, 8);
+        framelog_put32(&hdr[8], FRAMELOG_VERSION);
+        framelog_put32(&hdr[12], 0);
+        fwrite(hdr, 1, 16, log->f);
+    }
+    return 0;
+}
+
+static inline int framelog_write(framelog_t* log, const framelog_rec* r) {
+    uint8_t hdr[22];
+
+    if (log->csv) {
+        fprintf(log->f, "%llu.%09llu,%lu,", (unsigned long long)(r->time_ns / 1000000000u),
+                (unsigned long long)(r->time_ns % 1000000000u), (unsigned long)r->key_id);
+        framelog_puthex(log->f, r->nonce, 7);
+        fputc(',', log->f);
+        framelog_puthex(log->f, r->data, (size_t)r->len + FRAMELOG_TAG_BYTES);
+        fputc('\n', log->f);
+    }
+    else {
+        framelog_put32(&hdr[0], (uint32_t)r->time_ns);
+        framelog_put32(&hdr[4], (uint32_t)(r->time_ns >> 32));
+        framelog_put32(&hdr[8], r->key_id);
+        hdr[12] = (uint8_t)r->len;
+        hdr[13] = (uint8_t)(r->len >> 8);
+        memcpy(&hdr[14], r->nonce, 7);
+        hdr[21] = r->flags;
+        fwrite(hdr, 1, 22, log->f);
+        fwrite(r->data, 1, (size_t)r->len + FRAMELOG_TAG_BYTES, log->f);
+    }
+    return ferror(log->f) ? -1 : 0;
+}
+
+
+
+/* Reading: the form is found from the first bytes.  Returns 0 on success. */
+static inline int framelog_open(framelog_t* log, const char* path) {
+    uint8_t hdr[16];
+
+    log->line   = NULL;
+    log->f      = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    if (log->f == NULL) {
+        return -1;
+    }
+    if ((fread(hdr, 1, 16, log->f) == 16) && (memcmp(hdr, FRAMELOG_MAGIC, 8) == 0)) {
+        log->csv = 0;
+        return (framelog_get32(&hdr[8]) == FRAMELOG_VERSION) ? 0 : -1;
+    }
+    if (log->f == stdin) {
+        return -1;
+    }
+    log->csv    = 1;
+    log->line   = malloc(FRAMELOG_LINE);
+    rewind(log->f);
+    return (log->line != NULL) ? 0 : -1;
+}
+
+/* Returns 1 with a frame in r, 0 at the end, or -1 for a bad frame */
+static inline int framelog_read(framelog_t* log, framelog_rec* r) {
+    uint8_t hdr[22];
+    char*   s;
+    char*   end;
+    int     n;
+
+    if (!log->csv) {
+        if (fread(hdr, 1, 22, log->f) != 22) {
+            return 0;
+        }
+        r->time_ns  = framelog_get32(&hdr[0]) | ((uint64_t)framelog_get32(&hdr[4]) << 32);
+        r->key_id   = framelog_get32(&hdr[8]);
+        r->len      = (uint16_t)(hdr[12] | (hdr[13] << 8));
+        memcpy(r->nonce, &hdr[14], 7);
+        r->flags    = hdr[21];
+        n = (int)r->len + FRAMELOG_TAG_BYTES;
+        return (fread(r->data, 1, (size_t)n, log->f) == (size_t)n) ? 1 : -1;
+    }
+
+    do {
+        if (fgets(log->line, FRAMELOG_LINE, log->f) == NULL) {
+            return 0;
+        }
+    } while ((log->line[0] == '#') || (log->line[0] == '\n') || (log->line[0] == '\r'));
+
+    s = log->line;
+    r->flags   = 0;
+    r->time_ns = (uint64_t)strtoull(s, &end, 10) * 1000000000u;
+    if (*end == '.') {
+        uint64_t scale = 100000000u;
+        for (end++; (*end >= '0') && (*end <= '9'); end++) {
+            r->time_ns += (uint64_t)(*end - '0') * scale;
+            scale /= 10;
+        }
+    }
+    if (*end != ',') {
+        return -1;
+    }
+    r->key_id = (uint32_t)strtoul(end + 1, &end, 10);
+    if ((*end != ',') || (framelog_hex(end + 1, r->nonce, 7) != 7)) {
+        return -1;
+    }
+    s = strchr(end + 1, ',');
+    if (s == NULL) {
+        return -1;
+    }
+    n = framelog_hex(s + 1, r->data, sizeof(r->data));
+    if (n < FRAMELOG_TAG_BYTES) {
+        return -1;
+    }
+    r->len = (uint16_t)(n - FRAMELOG_TAG_BYTES);
+    return 1;
+}
+
+static inline void framelog_close(framelog_t* log) {
+    if ((log->f == stdin) || (log->f == stdout)) {
+        fflush(log->f);
+    }
+    else if (log->f != NULL) {
+        fclose(log->f);
+    }
+    free(log->line);
+    log->f      = NULL;
+    log->line   = NULL;
+}
+
+
+
+/* Key files: reads all key_id,key_hex lines.  Returns the number of keys,
+   or -1, and gives ids and 16 byte keys in malloc'd arrays. */
+static inline long framelog_read_keys(const char* path, uint32_t** ids, uint8_t** keys) {
+    char    line[128];
+    char*   end;
+    long    n = 0, max = 1024;
+    FILE*   f = fopen(path, "r");
+
+    if (f == NULL) {
+        return -1;
+    }
+    *ids    = malloc(max * sizeof(uint32_t));
+    *keys   = malloc(max * 16);
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if ((line[0] == '#') || (line[0] == '\n') || (line[0] == '\r')) {
+            continue;
+        }
+        if (n == max) {
+            max    *= 2;
+            *ids    = realloc(*ids, max * sizeof(uint32_t));
+            *keys   = realloc(*keys, max * 16);
+        }
+        (*ids)[n] = (uint32_t)strtoul(line, &end, 10);
+        if ((*end != ',') || (framelog_hex(end + 1, &(*keys)[n * 16], 16) != 16)) {
+            fclose(f);
+            return -1;
+        }
+        n++;
+    }
+    fclose(f);
+    return n;
+}
+
+static inline void framelog_write_key(FILE* f, uint32_t id, const uint8_t* key) {
+    fprintf(f, "%lu,", (unsigned long)id);
+    framelog_puthex(f, key, 16);
+    fputc('\n', f);
+}
+
+
+
+/* Key index: finds the position of a key ID in the key file */
+typedef struct {
+    uint32_t    id;
+    uint32_t    index;
+} framelog_keyent;
+
+static inline int framelog_keyent_cmp(const void* a, const void* b) {
+    uint32_t x = ((const framelog_keyent*)a)->id;
+    uint32_t y = ((const framelog_keyent*)b)->id;
+    return (x > y) - (x < y);
+}
+
+static inline framelog_keyent* framelog_index_keys(const uint32_t* ids, long n) {
+    framelog_keyent*    idx = malloc((size_t)n * sizeof(framelog_keyent));
+    long                i;
+
+    if (idx != NULL) {
+        for (i=0; i<n; i++) {
+            idx[i].id       = ids[i];
+            idx[i].index    = (uint32_t)i;
+        }
+        qsort(idx, (size_t)n, sizeof(framelog_keyent), &framelog_keyent_cmp);
+    }
+    return idx;
+}
+
+/* Returns the position of id, or -1 */
+static inline long framelog_find_key(const framelog_keyent* idx, long n, uint32_t id) {
+    long lo = 0, hi = n - 1;
+
+    while (lo <= hi) {
+        long mid = (lo + hi) / 2;
+        if (idx[mid].id == id) {
+            return (long)idx[mid].index;
+        }
+        if (idx[mid].id < id) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid - 1;
+        }
+    }
+    return -1;
+}
+
+#endif
@@ -0,0 +1,439 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/bench/gen.c
+  * @version    R100
+  * @brief      OTEAX synthetic DASH7 traffic generator, a stand-in for a radio
+  *
+  * Makes uplink frames from a population of devices and encrypts them with
+  * eax_encrypt_message(), under a per-device key made from the seed.
+  * Devices are picked uniformly or by Zipf popularity, lengths come from a
+  * weighted list or a range, and nonces are a per-device sequence or
+  * random.  A share of frames can be sent twice in a row (duplicates),
+  * replaced by an older frame sent again (replays), or sent with a damaged
+  * tag.  Each injected frame is marked in its flags (framelog.h).  In
+  * __ALIGN32__ builds, lengths are rounded up to whole words.
+  *
+  * Frames go to a receiver through the shared memory ring (ring.h, -m, with
+  * -g for the receiver's run number), to
+  * a pipe as a binary frame log (-o -), or to a frame log file (-o, with -c
+  * for CSV).  The ring and pipe are paced in real time at -r frames/s, or
+  * as fast as the receiver takes them, and each frame is stamped with the
+  * time it is sent.  Log files are written at once, stamped with the times
+  * the frames would be sent.  The key file for the receiver is written
+  * with -K, and on its own if there is no other output.
+  *
+  * Usage: gen [-d devices] [-z zipf_s] [-S seed] [-s len:weight,...|min-max]
+  *            [-N seq|random] [-D dup_pct] [-R replay_pct] [-C corrupt_pct]
+  *            [-r frames_per_s] [-P] [-n frames] [-K keys.csv]
+  *            [-m ring_name [-g run] | -o log [-c]]
+  ******************************************************************************
+  */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <getopt.h>
+
+#include <oteax.h>
+#include "framelog.h"
+#include "ring.h"
+
+#define UNIT        sizeof(io_t)
+#define MAX_SIZES   64
+#define HISTORY     256
+#define SPIN_NS     50000
+
+/* Default lengths: a DASH7 gateway's uplink mix, in bytes and percent */
+static const char def_sizes[] = "7:12,13:16,21:20,33:18,47:12,64:8,97:6,128:4,173:2,249:2";
+
+static unsigned int     sizes[MAX_SIZES];
+static double           size_cdf[MAX_SIZES];
+static int              num_sizes;
+static unsigned int     size_min, size_max;     // range form, if num_sizes is 0
+
+static unsigned long    num_devs    = 1000;
+static double           zipf_s      = 0;
+static double*          dev_cdf;
+static uint32_t         seed        = 0x6F746561;
+static int              seq_nonce   = 1;
+static double           dup_pct, replay_pct, corrupt_pct;
+static double           rate        = 0;
+static int              poisson     = 0;
+static unsigned long    num_frames  = 100000;
+
+static eax_ctx*         ctx;
+static uint64_t*        counter;
+static ring_slot        history[HISTORY];
+static unsigned long    num_history;
+
+
+
+static uint32_t sub_rand(void) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static double sub_uniform(void) {
+    return ((double)sub_rand() + 0.5) / 4294967296.0;
+}
+
+static uint64_t sub_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t)t.tv_sec * 1000000000u) + (uint64_t)t.tv_nsec;
+}
+
+static void sub_wait_until(uint64_t t) {
+    uint64_t now = sub_now();
+
+    if ((now + SPIN_NS) < t) {
+        struct timespec ts;
+        uint64_t sleep = t - now - SPIN_NS;
+        ts.tv_sec  = (time_t)(sleep / 1000000000u);
+        ts.tv_nsec = (long)(sleep % 1000000000u);
+        nanosleep(&ts, NULL);
+    }
+    while (sub_now() < t) {
+    }
+}
+
+
+
+/* "len:weight,..." or "min-max".  Returns 0 on success. */
+static int sub_parse_sizes(const char* spec) {
+    char    buf[512];
+    char*   tok;
+    double  sum = 0;
+    int     i;
+
+    if (sscanf(spec, "%u-%u", &size_min, &size_max) == 2) {
+        num_sizes = 0;
+        return ((size_min >= 1) && (size_min <= size_max) && (size_max <= RING_MAX_BYTES)) ? 0 : -1;
+    }
+    strncpy(buf, spec, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = 0;
+    num_sizes = 0;
+    for (tok=strtok(buf, ","); tok != NULL; tok=strtok(NULL, ",")) {
+        unsigned int    len;
+        double          w;
+        if ((num_sizes == MAX_SIZES) || (sscanf(tok, "%u:%lf", &len, &w) != 2)
+        ||  (len < 1) || (len > RING_MAX_BYTES) || (w < 0)) {
+            return -1;
+        }
+        sizes[num_sizes]    = len;
+        sum                += w;
+        size_cdf[num_sizes] = sum;
+        num_sizes++;
+    }
+    if ((num_sizes == 0) || (sum <= 0)) {
+        return -1;
+    }
+    for (i=0; i<num_sizes; i++) {
+        size_cdf[i] /= sum;
+    }
+    return 0;
+}
+
+static unsigned int sub_pick_size(void) {
+    double  u;
+    int     i;
+
+    if (num_sizes == 0) {
+        return size_min + (sub_rand() % (size_max - size_min + 1));
+    }
+    u = sub_uniform();
+    for (i=0; i<(num_sizes - 1); i++) {
+        if (u < size_cdf[i]) {
+            break;
+        }
+    }
+    return sizes[i];
+}
+
+static uint32_t sub_pick_device(void) {
+    unsigned long lo = 0, hi = num_devs - 1;
+    double u;
+
+    if (dev_cdf == NULL) {
+        return sub_rand() % (uint32_t)num_devs;
+    }
+    u = sub_uniform();
+    while (lo < hi) {
+        unsigned long mid = (lo + hi) / 2;
+        if (dev_cdf[mid] < u) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return (uint32_t)lo;
+}
+
+
+
+/* Keys from the seed, so that the key file can be written on its own */
+static void sub_keys(const char* key_path) {
+    uint8_t*        keys = malloc(num_devs * 16);
+    FILE*           kf = NULL;
+    unsigned long   i;
+
+    for (i=0; i<(num_devs * 16); i+=4) {
+        framelog_put32(&keys[i], sub_rand());
+    }
+    if (key_path != NULL) {
+        kf = fopen(key_path, "w");
+        if (kf == NULL) {
+            perror(key_path);
+            exit(1);
+        }
+        fprintf(kf, "# key_id,key\n");
+        for (i=0; i<num_devs; i++) {
+            framelog_write_key(kf, (uint32_t)i, &keys[i * 16]);
+        }
+        fclose(kf);
+    }
+    if (posix_memalign((void**)&ctx, 64, num_devs * sizeof(eax_ctx)) != 0) {
+        perror("posix_memalign");
+        exit(1);
+    }
+    eax_init_and_keys(keys, num_devs, ctx);
+    free(keys);
+
+    counter = malloc(num_devs * sizeof(uint64_t));
+    for (i=0; i<num_devs; i++) {
+        counter[i] = sub_rand();
+    }
+}
+
+
+
+/* A new frame from a device, encrypted, into f */
+static void sub_make(ring_slot* f) {
+    uint32_t        buf[(RING_MAX_BYTES + 8) / 4];
+    uint32_t        nonce[2] = { 0, 0 };
+    uint32_t        dev = sub_pick_device();
+    unsigned int    len = sub_pick_size();
+    size_t          units = ((size_t)len + UNIT - 1) / UNIT;
+    unsigned int    i;
+
+    // Word builds pad frames to whole words, so their frames are whole words
+    if (UNIT > 1) {
+        len = (unsigned int)(units * UNIT);
+    }
+
+    if (seq_nonce) {
+        uint64_t n = ++counter[dev];
+        for (i=0; i<7; i++) {
+            f->nonce[i] = (uint8_t)(n >> (8 * (6 - i)));
+        }
+    }
+    else {
+        for (i=0; i<7; i++) {
+            f->nonce[i] = (uint8_t)sub_rand();
+        }
+    }
+    memcpy(nonce, f->nonce, 7);
+    for (i=0; i<((len + 3) / 4); i++) {
+        buf[i] = sub_rand();
+    }
+
+    eax_encrypt_message(nonce, buf, len, &ctx[dev]);
+
+    f->key_id   = dev;
+    f->len      = (uint16_t)len;
+    f->flags    = 0;
+    memcpy(f->data, buf, len);
+    memcpy(&f->data[len], &((uint8_t*)buf)[units * UNIT], FRAMELOG_TAG_BYTES);
+}
+
+
+
+static void sub_usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-d devices] [-z zipf_s] [-S seed] [-s len:weight,...|min-max]\n"
+                    "       [-N seq|random] [-D dup_pct] [-R replay_pct] [-C corrupt_pct]\n"
+                    "       [-r frames_per_s] [-P] [-n frames] [-K keys.csv] [-m ring_name [-g run] | -o log [-c]]\n", name);
+    exit(1);
+}
+
+
+
+int main(int argc, char** argv) {
+    static framelog_rec rec;
+    const char*     key_path = NULL;
+    const char*     log_path = NULL;
+    const char*     ring_name = NULL;
+    int             csv = 0;
+    int             live;
+    framelog_t      out = { NULL, 0, NULL };
+    ring_t*         ring = NULL;
+    uint64_t        run = 0;
+    ring_slot       f, dup;
+    unsigned long   sent = 0, n_dup = 0, n_replay = 0, n_corrupt = 0, stalls = 0;
+    uint64_t        t_start, t_next, t_end;
+    double          secs;
+    int             opt, pending_dup = 0;
+
+    while ((opt = getopt(argc, argv, "d:z:S:s:N:D:R:C:r:Pn:K:m:g:o:c")) != -1) {
+        switch (opt) {
+        case 'd':   num_devs    = strtoul(optarg, NULL, 10);            break;
+        case 'z':   zipf_s      = atof(optarg);                         break;
+        case 'S':   seed        = (uint32_t)strtoul(optarg, NULL, 0);   break;
+        case 's':   if (sub_parse_sizes(optarg) != 0) sub_usage(argv[0]); break;
+        case 'N':   seq_nonce   = (strcmp(optarg, "random") != 0);      break;
+        case 'D':   dup_pct     = atof(optarg);                         break;
+        case 'R':   replay_pct  = atof(optarg);                         break;
+        case 'C':   corrupt_pct = atof(optarg);                         break;
+        case 'r':   rate        = atof(optarg);                         break;
+        case 'P':   poisson     = 1;                                    break;
+        case 'n':   num_frames  = strtoul(optarg, NULL, 10);            break;
+        case 'K':   key_path    = optarg;                               break;
+        case 'm':   ring_name   = optarg;                               break;
+        case 'g':   run         = strtoull(optarg, NULL, 0);            break;
+        case 'o':   log_path    = optarg;                               break;
+        case 'c':   csv         = 1;                                    break;
+        default:    sub_usage(argv[0]);
+        }
+    }
+    if ((num_devs == 0) || (seed == 0) || (rate < 0) || ((ring_name != NULL) && (log_path != NULL))
+    ||  ((ring_name == NULL) && (log_path == NULL) && (key_path == NULL))) {
+        sub_usage(argv[0]);
+    }
+    if ((num_sizes == 0) && (size_max == 0)) {
+        sub_parse_sizes(def_sizes);
+    }
+
+    if (zipf_s > 0) {
+        double          sum = 0;
+        unsigned long   i;
+        dev_cdf = malloc(num_devs * sizeof(double));
+        for (i=0; i<num_devs; i++) {
+            sum        += 1.0 / pow((double)(i + 1), zipf_s);
+            dev_cdf[i]  = sum;
+        }
+        for (i=0; i<num_devs; i++) {
+            dev_cdf[i] /= sum;
+        }
+    }
+    sub_keys(key_path);
+    if ((ring_name == NULL) && (log_path == NULL)) {
+        return 0;
+    }
+
+    if (ring_name != NULL) {
+        ring = ring_attach(ring_name, run, 5000);
+        if (ring == NULL) {
+            fprintf(stderr, "%s: no receiver ring\n", ring_name);
+            return 1;
+        }
+    }
+    else if (framelog_create(&out, log_path, csv) != 0) {
+        perror(log_path);
+        return 1;
+    }
+    live = (ring != NULL) || (strcmp(log_path, "-") == 0);
+
+    t_start = sub_now();
+    t_next  = t_start;
+    while (sent < num_frames) {
+        if (pending_dup) {
+            f = dup;
+            pending_dup = 0;
+            n_dup++;
+        }
+        else {
+            // The next arrival
+            if (rate > 0) {
+                t_next += (uint64_t)(1e9 * (poisson ? -log(sub_uniform()) : 1.0) / rate);
+            }
+            if ((num_history != 0) && ((sub_uniform() * 100) < replay_pct)) {
+                f = history[sub_rand() % ((num_history < HISTORY) ? num_history : HISTORY)];
+                f.flags = FRAMELOG_REPLAY;
+                n_replay++;
+            }
+            else {
+                sub_make(&f);
+                history[num_history++ % HISTORY] = f;
+                if ((sub_uniform() * 100) < corrupt_pct) {
+                    f.data[f.len + (sub_rand() % FRAMELOG_TAG_BYTES)] ^= (uint8_t)(1 << (sub_rand() % 8));
+                    f.flags = FRAMELOG_CORRUPT;
+                    n_corrupt++;
+                }
+                if ((sub_uniform() * 100) < dup_pct) {
+                    dup         = f;
+                    dup.flags  |= FRAMELOG_DUPLICATE;
+                    pending_dup = 1;
+                }
+            }
+            if (live && (rate > 0)) {
+                sub_wait_until(t_next);
+            }
+        }
+        f.time_ns = live ? sub_now() : t_next;
+
+        if (ring != NULL) {
+            ring_slot* s;
+            while ((s = ring_claim(ring)) == NULL) {
+                stalls++;
+                sched_yield();
+            }
+            memcpy(s, &f, sizeof(ring_slot));
+            s->time_ns = sub_now();
+            ring_publish(ring);
+        }
+        else {
+            rec.time_ns = f.time_ns;
+            rec.key_id  = f.key_id;
+            rec.len     = f.len;
+            rec.flags   = f.flags;
+            memcpy(rec.nonce, f.nonce, 7);
+            memcpy(rec.data, f.data, (size_t)f.len + FRAMELOG_TAG_BYTES);
+            if (framelog_write(&out, &rec) != 0) {
+                perror(log_path);
+                return 1;
+            }
+            if (live) {
+                fflush(stdout);
+            }
+        }
+        sent++;
+    }
+    t_end = sub_now();
+
+    if (ring != NULL) {
+        ring_finish(ring);
+        ring_detach(ring);
+    }
+    else {
+        framelog_close(&out);
+    }
+
+    secs = (double)(t_end - t_start) / 1e9;
+    fprintf(stderr, "gen: %lu frames from %lu devices (%lu duplicates, %lu replays, %lu corrupt tags), "
+                    "%.3f s, %.0f frames/s, %lu ring full waits, kernel %s\n",
+            sent, num_devs, n_dup, n_replay, n_corrupt, secs, (double)sent / secs, stalls, aes_kernel_name());
+    return 0;
+}
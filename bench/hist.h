@@ -0,0 +1,80 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/bench/hist.h
+  * @brief      Latency histogram for the benchmarks
+  *
+  * Nanosecond values go into buckets that are exact below 16 ns, then split
+  * each power of two into 8, so any value is within 12.5% of its bucket.
+  * A histogram is an array of HIST_BUCKETS counters.
+  ******************************************************************************
+  */
+
+#ifndef _BENCH_HIST_H
+#define _BENCH_HIST_H
+
+#include <stdint.h>
+
+#define HIST_BUCKETS    (16 + (48 * 8))
+
+static inline unsigned int hist_bucket(uint64_t ns) {
+    unsigned int e;
+
+    if (ns < 16) {
+        return (unsigned int)ns;
+    }
+    e = 63 - (unsigned int)__builtin_clzll(ns);
+    e = 16 + ((e - 4) * 8) + (unsigned int)((ns >> (e - 3)) & 7);
+    return (e < HIST_BUCKETS) ? e : (HIST_BUCKETS - 1);
+}
+
+/* Lowest value in bucket b */
+static inline uint64_t hist_bucket_ns(unsigned int b) {
+    unsigned int e;
+
+    if (b < 16) {
+        return b;
+    }
+    e = ((b - 16) / 8) + 4;
+    return ((uint64_t)(8 + ((b - 16) % 8))) << (e - 3);
+}
+
+static inline uint64_t hist_total(const uint64_t* hist) {
+    uint64_t        sum = 0;
+    unsigned int    b;
+
+    for (b=0; b<HIST_BUCKETS; b++) {
+        sum += hist[b];
+    }
+    return sum;
+}
+
+/* Value below which a fraction pct of the total falls */
+static inline uint64_t hist_percentile(const uint64_t* hist, uint64_t total, double pct) {
+    uint64_t        want = (uint64_t)((double)total * pct);
+    uint64_t        sum = 0;
+    unsigned int    b;
+
+    for (b=0; b<HIST_BUCKETS; b++) {
+        sum += hist[b];
+        if (sum > want) {
+            break;
+        }
+    }
+    return hist_bucket_ns((b < HIST_BUCKETS) ? b : (HIST_BUCKETS - 1));
+}
+
+#endif
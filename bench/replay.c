@@ -0,0 +1,357 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/bench/replay.c
+  * @version    R100
+  * @brief      OTEAX benchmark: replay of a recorded frame log
+  *
+  * Loads a frame log and its key file (see framelog.h), keys a context per
+  * device with eax_init_and_keys(), and puts every frame through
+  * eax_decrypt_message().  By default frames go as fast as possible; with
+  * -r they are released at their recorded times (-x scales the pace).
+  *
+  * Reported: throughput, the decrypt latency histogram, and the number of
+  * frames that failed to verify, in total and by frame length.  When paced,
+  * the time from each frame's release to the end of its decryption is also
+  * reported, which shows queueing behind bursts.
+  *
+  * Frames are copied into a receive buffer before each decrypt, outside the
+  * timed part, as a radio driver would leave them.  Logs recorded from byte
+  * builds only verify in __ALIGN32__ builds if every frame is a whole
+  * number of words, as that build pads frames to words.
+  *
+  * Usage: replay -k keys.csv [-r] [-x speed] [-n passes] [-o json_file] log
+  ******************************************************************************
+  */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#include <oteax.h>
+#include "hist.h"
+#include "framelog.h"
+
+#define UNIT        sizeof(io_t)
+#define NUM_CLASSES 6
+#define SPIN_NS     50000
+
+typedef struct {
+    uint64_t        time_ns;        // from the first frame
+    uint32_t        ctx;
+    uint32_t        nonce[2];
+    uint32_t        len;
+    size_t          offset;         // into blob, at a 16 byte boundary
+} frame_t;
+
+static const unsigned long class_max[NUM_CLASSES] = { 16, 32, 64, 128, 256, (unsigned long)-1 };
+static const char* class_names[NUM_CLASSES] = { "1-16", "17-32", "33-64", "65-128", "129-256", ">256" };
+
+static frame_t*     frames;
+static uint8_t*     blob;
+static eax_ctx*     ctx;
+static framelog_keyent* key_idx;
+static long         num_keys;
+
+
+
+static uint64_t sub_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t)t.tv_sec * 1000000000u) + (uint64_t)t.tv_nsec;
+}
+
+
+
+static void sub_wait_until(uint64_t t) {
+    uint64_t now = sub_now();
+
+    if ((now + SPIN_NS) < t) {
+        struct timespec ts;
+        uint64_t sleep = t - now - SPIN_NS;
+        ts.tv_sec  = (time_t)(sleep / 1000000000u);
+        ts.tv_nsec = (long)(sleep % 1000000000u);
+        nanosleep(&ts, NULL);
+    }
+    while (sub_now() < t) {
+    }
+}
+
+
+
+static int sub_class(unsigned long len) {
+    int c = 0;
+    while (len > class_max[c]) {
+        c++;
+    }
+    return c;
+}
+
+
+
+/* Keys, then the log into memory.  Returns the number of frames. */
+static long sub_load(const char* key_path, const char* log_path, unsigned long* unknown) {
+    static framelog_rec r;
+    framelog_t      log;
+    uint32_t*       ids;
+    uint8_t*        keys;
+    long            n = 0, max = 4096;
+    size_t          used = 0, size = 1 << 20;
+    uint64_t        t0 = 0;
+    int             rc;
+
+    num_keys = framelog_read_keys(key_path, &ids, &keys);
+    if (num_keys <= 0) {
+        fprintf(stderr, "%s: no keys read\n", key_path);
+        return -1;
+    }
+    if (posix_memalign((void**)&ctx, 64, (size_t)num_keys * sizeof(eax_ctx)) != 0) {
+        return -1;
+    }
+    eax_init_and_keys(keys, (unsigned long)num_keys, ctx);
+    free(keys);
+    key_idx = framelog_index_keys(ids, num_keys);
+    free(ids);
+
+    if (framelog_open(&log, log_path) != 0) {
+        fprintf(stderr, "%s: cannot read frame log\n", log_path);
+        return -1;
+    }
+    frames  = malloc((size_t)max * sizeof(frame_t));
+    blob    = malloc(size);
+    *unknown = 0;
+    while ((rc = framelog_read(&log, &r)) != 0) {
+        long    k;
+        size_t  units, need;
+
+        if (rc < 0) {
+            fprintf(stderr, "%s: bad frame after %ld frames\n", log_path, n);
+            framelog_close(&log);
+            return -1;
+        }
+        k = framelog_find_key(key_idx, num_keys, r.key_id);
+        if (k < 0) {
+            (*unknown)++;
+            continue;
+        }
+        if (n == max) {
+            max    *= 2;
+            frames  = realloc(frames, (size_t)max * sizeof(frame_t));
+        }
+        units   = ((size_t)r.len + UNIT - 1) / UNIT;
+        need    = ((units * UNIT) + FRAMELOG_TAG_BYTES + 15) & ~(size_t)15;
+        while ((used + need) > size) {
+            size   *= 2;
+            blob    = realloc(blob, size);
+        }
+        if ((frames == NULL) || (blob == NULL)) {
+            fprintf(stderr, "out of memory\n");
+            return -1;
+        }
+        if (n == 0) {
+            t0 = r.time_ns;
+        }
+
+        // Ciphertext, then the tag at the next io_t
+        memset(&blob[used], 0, need);
+        memcpy(&blob[used], r.data, r.len);
+        memcpy(&blob[used + (units * UNIT)], &r.data[r.len], FRAMELOG_TAG_BYTES);
+        frames[n].time_ns   = (r.time_ns > t0) ? (r.time_ns - t0) : 0;
+        frames[n].ctx       = (uint32_t)k;
+        frames[n].nonce[0]  = 0;
+        frames[n].nonce[1]  = 0;
+        memcpy(frames[n].nonce, r.nonce, 7);
+        frames[n].len       = r.len;
+        frames[n].offset    = used;
+        used += need;
+        n++;
+    }
+    framelog_close(&log);
+    return n;
+}
+
+
+
+static void sub_usage(const char* name) {
+    fprintf(stderr, "Usage: %s -k keys.csv [-r] [-x speed] [-n passes] [-o json_file] log\n", name);
+    exit(1);
+}
+
+
+
+int main(int argc, char** argv) {
+    static uint64_t hist[HIST_BUCKETS];
+    static uint64_t queue[HIST_BUCKETS];
+    static uint64_t class_hist[NUM_CLASSES][HIST_BUCKETS];
+    uint64_t        class_fails[NUM_CLASSES];
+    const char*     key_path = NULL;
+    const char*     json_path = NULL;
+    FILE*           json;
+    int             paced = 0;
+    double          speed = 1.0;
+    long            passes = 1;
+    long            num_frames, i, p;
+    unsigned long   unknown;
+    uint64_t        fails = 0, bytes = 0, total, late = 0;
+    uint64_t        t_start, t_end, span, max_ns = 0;
+    uint32_t*       rx;
+    double          secs;
+    int             opt, c;
+
+    while ((opt = getopt(argc, argv, "k:rx:n:o:")) != -1) {
+        switch (opt) {
+        case 'k':   key_path    = optarg;           break;
+        case 'r':   paced       = 1;                break;
+        case 'x':   speed       = atof(optarg);     break;
+        case 'n':   passes      = atol(optarg);     break;
+        case 'o':   json_path   = optarg;           break;
+        default:    sub_usage(argv[0]);
+        }
+    }
+    if ((key_path == NULL) || (optind != (argc - 1)) || (speed <= 0) || (passes < 1)) {
+        sub_usage(argv[0]);
+    }
+
+    num_frames = sub_load(key_path, argv[optind], &unknown);
+    if (num_frames < 0) {
+        return 1;
+    }
+    if (num_frames == 0) {
+        fprintf(stderr, "%s: no frames with known keys\n", argv[optind]);
+        return 1;
+    }
+    rx = malloc(FRAMELOG_MAX_BYTES + 64);
+    memset(class_fails, 0, sizeof(class_fails));
+
+    // Pace each pass one log length (plus a mean frame gap) after the last
+    span = frames[num_frames - 1].time_ns;
+    span += (num_frames > 1) ? (span / (uint64_t)(num_frames - 1)) : 0;
+
+    t_start = sub_now();
+    for (p=0; p<passes; p++) {
+        for (i=0; i<num_frames; i++) {
+            const frame_t*  f = &frames[i];
+            size_t          n = ((((size_t)f->len + UNIT - 1) / UNIT) * UNIT) + FRAMELOG_TAG_BYTES;
+            uint64_t        release = 0, t0, t1;
+
+            memcpy(rx, &blob[f->offset], n);
+            if (paced) {
+                release = t_start + (uint64_t)((double)(((uint64_t)p * span) + f->time_ns) / speed);
+                sub_wait_until(release);
+            }
+            t0 = sub_now();
+            c  = (eax_decrypt_message(f->nonce, rx, f->len, &ctx[f->ctx]) != 0);
+            t1 = sub_now();
+
+            fails   += (uint64_t)c;
+            bytes   += f->len;
+            hist[hist_bucket(t1 - t0)]++;
+            max_ns   = ((t1 - t0) > max_ns) ? (t1 - t0) : max_ns;
+            class_hist[sub_class(f->len)][hist_bucket(t1 - t0)]++;
+            class_fails[sub_class(f->len)] += (uint64_t)c;
+            if (paced) {
+                queue[hist_bucket(t1 - release)]++;
+                late += (t0 > (release + SPIN_NS));
+            }
+        }
+    }
+    t_end = sub_now();
+
+    total   = hist_total(hist);
+    secs    = (double)(t_end - t_start) / 1e9;
+    printf("%ld frames from %s, %ld keys, %lu frames with unknown keys skipped, kernel %s\n",
+            num_frames, argv[optind], num_keys, unknown, aes_kernel_name());
+    printf("%llu frames in %.3f s (%s): %.0f frames/s, %.1f MB/s\n", (unsigned long long)total, secs,
+            paced ? "paced" : "as fast as possible", (double)total / secs, (double)bytes / secs / 1e6);
+    printf("verify failures: %llu (%.3f%%)\n", (unsigned long long)fails, 100.0 * (double)fails / (double)total);
+    printf("decrypt ns: p50 %llu, p90 %llu, p99 %llu, p99.9 %llu, max %llu\n",
+            (unsigned long long)hist_percentile(hist, total, 0.50),
+            (unsigned long long)hist_percentile(hist, total, 0.90),
+            (unsigned long long)hist_percentile(hist, total, 0.99),
+            (unsigned long long)hist_percentile(hist, total, 0.999), (unsigned long long)max_ns);
+    if (paced) {
+        printf("release to done ns: p50 %llu, p99 %llu, p99.9 %llu; %llu frames started late\n",
+                (unsigned long long)hist_percentile(queue, total, 0.50),
+                (unsigned long long)hist_percentile(queue, total, 0.99),
+                (unsigned long long)hist_percentile(queue, total, 0.999), (unsigned long long)late);
+    }
+
+    printf("\n%-8s %10s %10s %8s %8s\n", "bytes", "frames", "failures", "p50 ns", "p99 ns");
+    for (c=0; c<NUM_CLASSES; c++) {
+        uint64_t n = hist_total(class_hist[c]);
+        if (n != 0) {
+            printf("%-8s %10llu %10llu %8llu %8llu\n", class_names[c], (unsigned long long)n,
+                    (unsigned long long)class_fails[c],
+                    (unsigned long long)hist_percentile(class_hist[c], n, 0.50),
+                    (unsigned long long)hist_percentile(class_hist[c], n, 0.99));
+        }
+    }
+
+    // Histogram, in powers of two
+    printf("\n%-16s %10s\n", "decrypt ns", "frames");
+    for (c=0; c<HIST_BUCKETS; ) {
+        uint64_t n = 0;
+        int      end = (c < 16) ? 16 : (c + 8);
+        int      b;
+        for (b=c; b<end; b++) {
+            n += hist[b];
+        }
+        if (n != 0) {
+            char range[32];
+            snprintf(range, sizeof(range), "%llu-%llu", (unsigned long long)hist_bucket_ns((unsigned int)c),
+                     (unsigned long long)((end < HIST_BUCKETS) ? hist_bucket_ns((unsigned int)end) - 1 : max_ns));
+            printf("%-16s %10llu\n", range, (unsigned long long)n);
+        }
+        c = end;
+    }
+    putchar('\n');
+
+    if (json_path != NULL) {
+        json = fopen(json_path, "w");
+        if (json == NULL) {
+            perror(json_path);
+            return 1;
+        }
+        fprintf(json, "{\"log\": \"%s\", \"frames\": %llu, \"keys\": %ld, \"unknown\": %lu, \"kernel\": \"%s\", "
+                      "\"paced\": %s, \"speed\": %.3f, \"seconds\": %.6f, \"frames_per_s\": %.0f, "
+                      "\"bytes_per_s\": %.0f, \"fails\": %llu, \"late\": %llu, \"decrypt_ns\": {",
+                argv[optind], (unsigned long long)total, num_keys, unknown, aes_kernel_name(),
+                paced ? "true" : "false", speed, secs, (double)total / secs, (double)bytes / secs,
+                (unsigned long long)fails, (unsigned long long)late);
+        fprintf(json, "\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu}, \"histogram\": [",
+                (unsigned long long)hist_percentile(hist, total, 0.50),
+                (unsigned long long)hist_percentile(hist, total, 0.90),
+                (unsigned long long)hist_percentile(hist, total, 0.99),
+                (unsigned long long)hist_percentile(hist, total, 0.999), (unsigned long long)max_ns);
+        for (opt=0, c=0; c<HIST_BUCKETS; c++) {
+            if (hist[c] != 0) {
+                fprintf(json, "%s[%llu, %llu]", opt++ ? ", " : "",
+                        (unsigned long long)hist_bucket_ns((unsigned int)c), (unsigned long long)hist[c]);
+            }
+        }
+        fprintf(json, "]}\n");
+        fclose(json);
+    }
+
+    free(rx);
+    return 0;
+}
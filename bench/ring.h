@@ -0,0 +1,184 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/bench/ring.h
+  * @brief      Shared memory frame ring, from the traffic generator to a receiver
+  *
+  * A single producer, single consumer ring of DASH7 sized frames in POSIX
+  * shared memory.  The receiver creates it with ring_create(), and the
+  * generator attaches with ring_attach(), so either may start first.  The
+  * receiver stamps the ring with a run number, and the generator attaches
+  * only to a ring with the number it was given, so it can't write into a
+  * ring left by an earlier run before the receiver replaces it.  The head
+  * (written by the producer) and tail (written by the consumer) are in
+  * their own cache lines.  The producer sets done after its last frame.
+  *
+  * A slot holds the same fields as a frame log record (framelog.h), with
+  * the time being when the frame was sent, on CLOCK_MONOTONIC.
+  ******************************************************************************
+  */
+
+#ifndef _BENCH_RING_H
+#define _BENCH_RING_H
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define RING_MAGIC      0x4F54524Eu     // "OTRN"
+#define RING_MAX_BYTES  256
+#define RING_SLOTS      4096            // power of two
+
+typedef struct {
+    uint64_t    time_ns;
+    uint32_t    key_id;
+    uint16_t    len;                    // ciphertext bytes, without tag
+    uint8_t     nonce[7];
+    uint8_t     flags;                  // FRAMELOG_DUPLICATE etc.
+    uint8_t     data[RING_MAX_BYTES + 8];
+} __attribute__((aligned(64))) ring_slot;
+
+typedef struct {
+    uint32_t    magic;
+    uint32_t    slots;
+    uint32_t    done;
+    uint64_t    run;                    // from ring_create(), 0 for none
+    uint64_t    head __attribute__((aligned(64)));
+    uint64_t    tail __attribute__((aligned(64)));
+    ring_slot   slot[RING_SLOTS];
+} ring_t;
+
+
+
+static inline ring_t* ring_map(int fd) {
+    void* p = mmap(NULL, sizeof(ring_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return (p == MAP_FAILED) ? NULL : (ring_t*)p;
+}
+
+/* Receiver: name is a shm name, like "/oteax", and run a number that is
+   new for each run, which the generator must be given too
+*/
+static inline ring_t* ring_create(const char* name, uint64_t run) {
+    ring_t* r;
+    int     fd;
+
+    shm_unlink(name);
+    fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if ((fd < 0) || (ftruncate(fd, sizeof(ring_t)) != 0)) {
+        return NULL;
+    }
+    r = ring_map(fd);
+    if (r != NULL) {
+        r->slots = RING_SLOTS;
+        r->done  = 0;
+        r->run   = run;
+        r->head  = 0;
+        r->tail  = 0;
+        __atomic_store_n(&r->magic, RING_MAGIC, __ATOMIC_RELEASE);
+    }
+    return r;
+}
+
+/* Generator: waits up to wait_ms for the receiver to create the ring for
+   this run.  A run of 0 takes any ring.  The object is not mapped until it
+   has its full size, as touching it between the receiver's shm_open() and
+   ftruncate() would raise SIGBUS.
+*/
+static inline ring_t* ring_attach(const char* name, uint64_t run, unsigned int wait_ms) {
+    struct timespec ms = { 0, 1000000 };
+    struct stat     st;
+    ring_t* r;
+    int     fd;
+
+    for (;;) {
+        fd = shm_open(name, O_RDWR, 0600);
+        if ((fd >= 0) && ((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(ring_t)))) {
+            close(fd);
+            fd = -1;
+        }
+        if (fd >= 0) {
+            r = ring_map(fd);
+            if ((r == NULL) || ((__atomic_load_n(&r->magic, __ATOMIC_ACQUIRE) == RING_MAGIC)
+                             && ((run == 0) || (r->run == run)))) {
+                return r;
+            }
+            munmap(r, sizeof(ring_t));
+        }
+        if (wait_ms-- == 0) {
+            return NULL;
+        }
+        nanosleep(&ms, NULL);
+    }
+}
+
+static inline void ring_detach(ring_t* r) {
+    munmap(r, sizeof(ring_t));
+}
+
+/* Receiver, when finished */
+static inline void ring_destroy(ring_t* r, const char* name) {
+    munmap(r, sizeof(ring_t));
+    shm_unlink(name);
+}
+
+
+
+/* Producer: a free slot, or NULL if the ring is full */
+static inline ring_slot* ring_claim(ring_t* r) {
+    uint64_t head = r->head;
+
+    if ((head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE)) >= RING_SLOTS) {
+        return NULL;
+    }
+    return &r->slot[head & (RING_SLOTS - 1)];
+}
+
+static inline void ring_publish(ring_t* r) {
+    __atomic_store_n(&r->head, r->head + 1, __ATOMIC_RELEASE);
+}
+
+static inline void ring_finish(ring_t* r) {
+    __atomic_store_n(&r->done, 1, __ATOMIC_RELEASE);
+}
+
+
+
+/* Consumer: the next frame, or NULL if there is none yet */
+static inline ring_slot* ring_peek(ring_t* r) {
+    uint64_t tail = r->tail;
+
+    if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) == tail) {
+        return NULL;
+    }
+    return &r->slot[tail & (RING_SLOTS - 1)];
+}
+
+static inline void ring_release(ring_t* r) {
+    __atomic_store_n(&r->tail, r->tail + 1, __ATOMIC_RELEASE);
+}
+
+/* True once the producer is done and every frame has been taken */
+static inline int ring_drained(ring_t* r) {
+    return __atomic_load_n(&r->done, __ATOMIC_ACQUIRE)
+        && (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) == r->tail);
+}
+
+#endif
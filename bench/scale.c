@@ -0,0 +1,496 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/bench/scale.c
+  * @version    R100
+  * @brief      OTEAX benchmark: gateway receive throughput across threads and keys
+  *
+  * Models a gateway receiving uplinks from a population of devices, each
+  * with its own key.  Device popularity follows a Zipf distribution, and a
+  * shared pool of frames is encrypted up front under each frame's device
+  * key.  For each thread count, that many workers take frames from the
+  * pool, as if from a radio buffer, and decrypt them with
+  * eax_decrypt_message(), or eax_decrypt_messages() in batches.
+  *
+  * Keyed state lives in a key store, either as keyed contexts made with
+  * eax_init_and_keys() (-m ctx), which a miss copies, or as raw keys
+  * (-m key), which a miss has to key again.  Each worker keeps a direct
+  * mapped cache of contexts, which also holds its message state.  With a
+  * large population the store does not fit in cache, and misses become
+  * memory bound.  With -p the frame counters of all workers are packed
+  * into one cache line, to show false sharing.
+  *
+  * Reported per thread count: frames/s, scaling against one thread, p50
+  * and p99 latency per decrypt call (key lookup included), and the key
+  * cache hit rate.
+  *
+  * Usage: scale [-t threads,...] [-k keys] [-z zipf_s] [-c cache_entries]
+  *              [-m ctx|key] [-b batch] [-l frame_bytes] [-d seconds] [-p]
+  *              [-o json_file]
+  ******************************************************************************
+  */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <oteax.h>
+#include "hist.h"
+
+#define UNIT        sizeof(io_t)
+#define MAX_THREADS 64
+#define MAX_BYTES   256
+#define POOL_FRAMES (1 << 18)
+#define LINE        64
+
+typedef struct {
+    uint32_t        dev;
+    uint32_t        nonce[2];
+} frame_t;
+
+typedef struct {
+    pthread_t       thread;
+    int             id;
+    uint32_t        seed;
+    eax_ctx*        cache;
+    int32_t*        tags;
+    volatile uint64_t* count;   // frames, in its own line unless -p
+    uint64_t        hits;
+    uint64_t        misses;
+    uint64_t        fails;
+    uint64_t        hist[HIST_BUCKETS];
+} __attribute__((aligned(LINE))) worker_t;
+
+/* Settings */
+static int              threads[MAX_THREADS];
+static int              num_points  = 0;
+static unsigned long    num_keys    = 1000;
+static double           zipf_s      = 1.0;
+static unsigned long    cache_size  = 256;
+static int              store_ctx   = 1;
+static unsigned int     batch       = 1;
+static unsigned long    bytes       = 20;
+static double           seconds     = 1.0;
+static int              packed      = 0;
+static const char*      json_file   = NULL;
+
+/* Shared, read-only while workers run */
+static eax_ctx*         store;
+static uint32_t*        keys;
+static frame_t*         frames;
+static uint32_t*        pool;
+static unsigned long    stride;     // words per frame in pool
+static double*          cdf;
+static uint32_t         perm_mul;
+
+static worker_t*        workers;
+static uint64_t         slots[MAX_THREADS * (LINE / 8)] __attribute__((aligned(LINE)));
+static pthread_barrier_t start_line;
+static volatile int     stop;
+
+
+
+static uint32_t sub_rand(uint32_t* x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+
+
+static uint64_t sub_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t)t.tv_sec * 1000000000u) + (uint64_t)t.tv_nsec;
+}
+
+
+
+static void* sub_alloc(size_t size) {
+    void* p;
+
+    if (posix_memalign(&p, LINE, size) != 0) {
+        perror("posix_memalign");
+        exit(1);
+    }
+    return p;
+}
+
+
+
+/* Zipf: rank from a uniform draw, then a fixed shuffle so that the popular
+   devices are spread over the key store */
+static uint32_t sub_device(uint32_t* seed) {
+    double          u = (double)sub_rand(seed) / 4294967296.0;
+    unsigned long   lo = 0;
+    unsigned long   hi = num_keys - 1;
+
+    while (lo < hi) {
+        unsigned long mid = (lo + hi) / 2;
+        if (cdf[mid] < u) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return (uint32_t)(((uint64_t)lo * perm_mul) % num_keys);
+}
+
+static uint32_t sub_gcd(uint32_t a, uint32_t b) {
+    while (b != 0) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+
+
+/* Key cache: a context for dev, with its key loaded.  A miss fills the
+   cache slot, or scratch if that is given. */
+static eax_ctx* sub_lookup(worker_t* w, uint32_t dev, eax_ctx* scratch) {
+    eax_ctx* c;
+    unsigned long slot;
+
+    if (cache_size != 0) {
+        slot = ((uint64_t)dev * 0x9E3779B1u) % cache_size;
+        if (w->tags[slot] == (int32_t)dev) {
+            w->hits++;
+            return &w->cache[slot];
+        }
+        if (scratch == NULL) {
+            w->tags[slot] = (int32_t)dev;
+            scratch = &w->cache[slot];
+        }
+    }
+    w->misses++;
+    c = scratch;
+    if (store_ctx) {
+        memcpy(c, &store[dev], sizeof(eax_ctx));
+    }
+    else {
+        eax_init_and_key(&keys[dev * 4], c);
+    }
+    return c;
+}
+
+
+
+static void* sub_worker(void* arg) {
+    worker_t*       w = arg;
+    eax_ctx*        scratch;
+    uint32_t*       rx;
+    unsigned long   next;
+    unsigned long   step;
+    unsigned int    i;
+
+    const void*     iv[EAX_BATCH_MAX];
+    void*           msg[EAX_BATCH_MAX];
+    unsigned long   len[EAX_BATCH_MAX];
+    eax_ctx*        ctx[EAX_BATCH_MAX];
+    uint32_t        dev[EAX_BATCH_MAX];
+    int             fill[EAX_BATCH_MAX];
+
+    scratch = sub_alloc(EAX_BATCH_MAX * sizeof(eax_ctx));
+    rx      = sub_alloc(EAX_BATCH_MAX * stride * 4);
+    next    = ((unsigned long)sub_rand(&w->seed)) % POOL_FRAMES;
+    step    = (2 * (unsigned long)w->id) + 1;
+    for (i=0; i<EAX_BATCH_MAX; i++) {
+        len[i] = bytes;
+        msg[i] = &rx[i * stride];
+    }
+
+    pthread_barrier_wait(&start_line);
+
+    while (!__atomic_load_n(&stop, __ATOMIC_RELAXED)) {
+        uint64_t t0;
+
+        // Frames arrive in the radio buffer
+        for (i=0; i<batch; i++) {
+            memcpy(msg[i], &pool[next * stride], stride * 4);
+            iv[i]   = frames[next].nonce;
+            dev[i]  = frames[next].dev;
+            next    = (next + step) % POOL_FRAMES;
+        }
+
+        t0 = sub_now();
+        if (batch == 1) {
+            ctx[0] = sub_lookup(w, dev[0], (cache_size != 0) ? NULL : &scratch[0]);
+        }
+        else {
+            /* Misses go to scratch contexts, and enter the cache after the
+               batch, so that no context is replaced while the batch uses it */
+            for (i=0; i<batch; i++) {
+                ctx[i]  = sub_lookup(w, dev[i], &scratch[i]);
+                fill[i] = (ctx[i] == &scratch[i]);
+            }
+        }
+        if (batch == 1) {
+            w->fails += (eax_decrypt_message(iv[0], msg[0], bytes, ctx[0]) != 0);
+        }
+        else {
+            uint_32t pass;
+            eax_decrypt_messages(iv, msg, len, batch, ctx, &pass);
+            w->fails += (unsigned int)(batch - (unsigned int)__builtin_popcount(pass));
+        }
+        w->hist[hist_bucket(sub_now() - t0)]++;
+        *w->count += batch;
+
+        if ((batch != 1) && (cache_size != 0)) {
+            for (i=0; i<batch; i++) {
+                if (fill[i]) {
+                    unsigned long slot = ((uint64_t)dev[i] * 0x9E3779B1u) % cache_size;
+                    memcpy(&w->cache[slot], &scratch[i], sizeof(eax_ctx));
+                    w->tags[slot] = (int32_t)dev[i];
+                }
+            }
+        }
+    }
+
+    free(rx);
+    free(scratch);
+    return NULL;
+}
+
+
+
+/* Key store, Zipf table and the frame pool, shared by every run */
+static void sub_setup(void) {
+    uint32_t        seed = 0x2545F491;
+    double          sum = 0;
+    unsigned long   i, k;
+    eax_ctx         tx[1];
+
+    keys = sub_alloc(num_keys * 16);
+    for (k=0; k<(num_keys * 4); k++) {
+        keys[k] = sub_rand(&seed);
+    }
+    if (store_ctx) {
+        store = sub_alloc(num_keys * sizeof(eax_ctx));
+        for (k=0; k<num_keys; k+=1024) {
+            unsigned long n = ((num_keys - k) < 1024) ? (num_keys - k) : 1024;
+            eax_init_and_keys(&keys[k * 4], n, &store[k]);
+        }
+    }
+
+    cdf = sub_alloc(num_keys * sizeof(double));
+    for (k=0; k<num_keys; k++) {
+        sum    += 1.0 / pow((double)(k + 1), zipf_s);
+        cdf[k]  = sum;
+    }
+    for (k=0; k<num_keys; k++) {
+        cdf[k] /= sum;
+    }
+    perm_mul = 2654435761u;
+    while (sub_gcd(perm_mul, (uint32_t)num_keys) != 1) {
+        perm_mul -= 2;
+    }
+
+    stride  = ((((bytes + UNIT - 1) / UNIT) * UNIT) + 4 + 3) / 4;
+    frames  = sub_alloc(POOL_FRAMES * sizeof(frame_t));
+    pool    = sub_alloc(POOL_FRAMES * stride * 4);
+    for (i=0; i<POOL_FRAMES; i++) {
+        uint32_t* f = &pool[i * stride];
+
+        frames[i].dev       = sub_device(&seed);
+        frames[i].nonce[0]  = (uint32_t)i;
+        frames[i].nonce[1]  = sub_rand(&seed) & 0x00FFFFFF;
+        for (k=0; k<stride; k++) {
+            f[k] = sub_rand(&seed);
+        }
+        eax_init_and_key(&keys[frames[i].dev * 4], tx);
+        eax_encrypt_message(frames[i].nonce, f, bytes, tx);
+    }
+    eax_end(tx);
+}
+
+
+
+/* One thread count: returns frames/s */
+static double sub_point(int n, FILE* json, double base) {
+    uint64_t        hist[HIST_BUCKETS];
+    uint64_t        total = 0, hits = 0, misses = 0, fails = 0, calls = 0;
+    uint64_t        t0, t1;
+    double          fps, hit_rate;
+    unsigned int    b;
+    int             i;
+    long            ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+    memset(slots, 0, sizeof(slots));
+    memset(workers, 0, MAX_THREADS * sizeof(worker_t));
+    pthread_barrier_init(&start_line, NULL, (unsigned int)n + 1);
+    stop = 0;
+
+    for (i=0; i<n; i++) {
+        worker_t* w = &workers[i];
+
+        w->id       = i;
+        w->seed     = 0x9E3779B9u * (uint32_t)(i + 1);
+        w->count    = packed ? &slots[i] : &slots[i * (LINE / 8)];
+        if (cache_size != 0) {
+            w->cache    = sub_alloc(cache_size * sizeof(eax_ctx));
+            w->tags     = sub_alloc(cache_size * sizeof(int32_t));
+            memset(w->tags, 0xFF, cache_size * sizeof(int32_t));
+        }
+        pthread_create(&w->thread, NULL, &sub_worker, w);
+#       if defined(__linux__)
+        {   cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET((int)(i % ncpu), &cpus);
+            pthread_setaffinity_np(w->thread, sizeof(cpus), &cpus);
+        }
+#       endif
+    }
+
+    pthread_barrier_wait(&start_line);
+    t0 = sub_now();
+    usleep((useconds_t)(seconds * 1e6));
+    __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+    for (i=0; i<n; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    t1 = sub_now();
+    pthread_barrier_destroy(&start_line);
+
+    memset(hist, 0, sizeof(hist));
+    for (i=0; i<n; i++) {
+        worker_t* w = &workers[i];
+
+        total  += *w->count;
+        hits   += w->hits;
+        misses += w->misses;
+        fails  += w->fails;
+        for (b=0; b<HIST_BUCKETS; b++) {
+            hist[b] += w->hist[b];
+            calls   += w->hist[b];
+        }
+        free(w->cache);
+        free(w->tags);
+    }
+
+    fps      = (double)total * 1e9 / (double)(t1 - t0);
+    hit_rate = ((hits + misses) != 0) ? ((double)hits / (double)(hits + misses)) : 0;
+    if (base == 0) {
+        base = fps;
+    }
+    printf("%7d %12.0f %8.2f %9llu %9llu %8.1f%%\n", n, fps, fps / base,
+            (unsigned long long)hist_percentile(hist, calls, 0.50),
+            (unsigned long long)hist_percentile(hist, calls, 0.99), hit_rate * 100);
+    if (fails != 0) {
+        printf("        %llu frames failed to authenticate\n", (unsigned long long)fails);
+    }
+    if (json != NULL) {
+        fprintf(json, "{\"threads\": %d, \"keys\": %lu, \"zipf_s\": %.2f, \"cache\": %lu, \"store\": \"%s\", "
+                      "\"batch\": %u, \"bytes\": %lu, \"packed\": %s, \"kernel\": \"%s\", "
+                      "\"frames_per_s\": %.0f, \"scaling\": %.3f, \"p50_ns\": %llu, \"p99_ns\": %llu, "
+                      "\"hit_rate\": %.4f, \"fails\": %llu}\n",
+                n, num_keys, zipf_s, cache_size, store_ctx ? "ctx" : "key", batch, bytes,
+                packed ? "true" : "false", aes_kernel_name(), fps, fps / base,
+                (unsigned long long)hist_percentile(hist, calls, 0.50),
+                (unsigned long long)hist_percentile(hist, calls, 0.99), hit_rate, (unsigned long long)fails);
+    }
+    return fps;
+}
+
+
+
+static void sub_usage(const char* name) {
+    fprintf(stderr, "Usage: %s [-t threads,...] [-k keys] [-z zipf_s] [-c cache_entries]\n"
+                    "       [-m ctx|key] [-b batch] [-l frame_bytes] [-d seconds] [-p] [-o json_file]\n", name);
+    exit(1);
+}
+
+
+
+int main(int argc, char** argv) {
+    static const int def_threads[] = { 1, 2, 4, 8, 16, 32, 64 };
+    FILE*   json = NULL;
+    double  base = 0;
+    char*   arg;
+    int     opt, i;
+
+    while ((opt = getopt(argc, argv, "t:k:z:c:m:b:l:d:po:")) != -1) {
+        switch (opt) {
+        case 't':
+            for (arg=strtok(optarg, ","); (arg != NULL) && (num_points < MAX_THREADS); arg=strtok(NULL, ",")) {
+                threads[num_points] = atoi(arg);
+                if ((threads[num_points] < 1) || (threads[num_points] > MAX_THREADS)) {
+                    sub_usage(argv[0]);
+                }
+                num_points++;
+            }
+            break;
+        case 'k':   num_keys    = strtoul(optarg, NULL, 10);    break;
+        case 'z':   zipf_s      = atof(optarg);                 break;
+        case 'c':   cache_size  = strtoul(optarg, NULL, 10);    break;
+        case 'm':   store_ctx   = (strcmp(optarg, "key") != 0); break;
+        case 'b':   batch       = (unsigned int)atoi(optarg);   break;
+        case 'l':   bytes       = strtoul(optarg, NULL, 10);    break;
+        case 'd':   seconds     = atof(optarg);                 break;
+        case 'p':   packed      = 1;                            break;
+        case 'o':   json_file   = optarg;                       break;
+        default:    sub_usage(argv[0]);
+        }
+    }
+    if ((num_keys == 0) || (num_keys > 0x7FFFFFFF) || (batch == 0) || (batch > EAX_BATCH_MAX)
+    ||  (bytes == 0) || (bytes > MAX_BYTES) || (seconds <= 0)) {
+        sub_usage(argv[0]);
+    }
+    if (num_points == 0) {
+        for (i=0; i<(int)(sizeof(def_threads) / sizeof(int)); i++) {
+            threads[num_points++] = def_threads[i];
+        }
+    }
+    if (json_file != NULL) {
+        json = fopen(json_file, "w");
+        if (json == NULL) {
+            perror(json_file);
+            return 1;
+        }
+    }
+
+    sub_setup();
+    workers = sub_alloc(MAX_THREADS * sizeof(worker_t));
+
+    printf("%lu keys (zipf s=%.2f, %s store), %lu byte frames, batch %u, %lu cached keys per thread%s, kernel %s\n",
+            num_keys, zipf_s, store_ctx ? "ctx" : "key", bytes, batch, cache_size,
+            packed ? ", packed counters" : "", aes_kernel_name());
+    printf("%7s %12s %8s %9s %9s %9s\n", "threads", "frames/s", "scaling", "p50 ns", "p99 ns", "key hits");
+    for (i=0; i<num_points; i++) {
+        double fps = sub_point(threads[i], json, base);
+        if (i == 0) {
+            base = fps;
+        }
+    }
+    putchar('\n');
+
+    if (json != NULL) {
+        fclose(json);
+    }
+    return 0;
+}
@@ -0,0 +1,349 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/bench/setup.c
+  * @version    R100
+  * @brief      OTEAX benchmark: fixed costs of one EAX frame, phase by phase
+  *
+  * Times each phase of a frame on its own: key setup (eax_init_and_key()),
+  * message setup (eax_init_message(), the nonce OMAC), the payload
+  * (eax_encrypt()) and the tag (eax_compute_tag()), and the whole frame
+  * through eax_encrypt_message() for comparison.  Each phase is timed
+  * singly, many times, warm (just after running it) and cold, and the
+  * median and minimum are reported.  Cold runs follow a read through twice
+  * the last level cache, but no more than OTEAX_BENCH_EVICT_MB (default 64)
+  * megabytes, and on x86 the context is also flushed from every level.
+  *
+  * The AES calls per phase are counted in a separate, untimed pass, with a
+  * backend attached to the context that counts blocks and hands them to
+  * eax_backend_sw.  Key setup runs before a backend can be attached, so its
+  * single call, E(0), is counted from omac_init_and_key().
+  *
+  * Usage: setup build_name [json_file] [frame_bytes]
+  * The frame is 20 bytes by default, a typical DASH7 uplink.  A kernel named
+  * in OTEAX_KERNEL is forced, and the run is skipped if the CPU lacks it.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#   define BENCH_TSC
+#endif
+
+#include <oteax.h>
+
+#define UNIT        sizeof(io_t)
+#define MAX_BYTES   256
+#define DEF_BYTES   20
+#define WARM_RUNS   2001
+#define COLD_RUNS   201
+#define EVICT_MB    64
+#define KEY_CALLS   1       // E(0), in omac_init_and_key()
+
+enum {
+    PH_KEY = 0,
+    PH_INIT,
+    PH_DATA,
+    PH_TAG,
+    PH_MESSAGE,
+    NUM_PHASES
+};
+
+static const char* ph_names[NUM_PHASES] = { "key", "init", "data", "tag", "message" };
+
+static uint32_t         msg[(MAX_BYTES + 16) / 4];
+static uint32_t         tag[4];
+static uint32_t         key[4]      = { 0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c };
+static uint32_t         nonce[2]    = { 0x13121110, 0x00161514 };
+static eax_ctx          ctx[1];
+static unsigned long    bytes       = DEF_BYTES;
+static unsigned long    units;
+static uint8_t*         evict;
+static size_t           evict_size;
+static uint64_t         overhead;
+static volatile uint8_t sink;
+
+
+
+/* Counting backend: every AES block goes through one of these */
+static unsigned long aes_calls;
+
+static ret_type cnt_block(const io_t* in, io_t* out, const aes_encrypt_ctx cx[1], void* hdl) {
+    aes_calls++;
+    return eax_backend_sw.block(in, out, cx, hdl);
+}
+
+static ret_type cnt_ecb(const io_t* in, io_t* out, unsigned long blocks, const aes_encrypt_ctx cx[1], void* hdl) {
+    aes_calls += blocks;
+    return eax_backend_sw.ecb(in, out, blocks, cx, hdl);
+}
+
+static ret_type cnt_ctr(io_t* data, unsigned long blocks, io_t* ctr, const aes_encrypt_ctx cx[1], void* hdl) {
+    aes_calls += blocks;
+    return eax_backend_sw.ctr(data, blocks, ctr, cx, hdl);
+}
+
+static ret_type cnt_cbcmac(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx cx[1], void* hdl) {
+    aes_calls += blocks;
+    return eax_backend_sw.cbcmac(data, blocks, cbc, cx, hdl);
+}
+
+static const eax_backend backend_count = {
+    "count", &cnt_block, &cnt_ecb, &cnt_ctr, &cnt_cbcmac, NULL
+};
+
+
+
+static uint64_t sub_ticks(void) {
+#   if defined(BENCH_TSC)
+    uint64_t t;
+    _mm_lfence();
+    t = __rdtsc();
+    _mm_lfence();
+    return t;
+#   else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t)t.tv_sec * 1000000000u) + (uint64_t)t.tv_nsec;
+#   endif
+}
+
+
+
+/* Put the state a phase starts from in place */
+static void sub_prepare(int phase) {
+    switch (phase) {
+    case PH_DATA:
+        eax_init_message((const io_t*)nonce, ctx);
+        break;
+    case PH_TAG:
+        eax_init_message((const io_t*)nonce, ctx);
+        eax_encrypt((io_t*)msg, units, ctx);
+        break;
+    default:
+        break;
+    }
+}
+
+
+
+static void sub_phase(int phase) {
+    switch (phase) {
+    case PH_KEY:
+        eax_init_and_key(key, ctx);
+        break;
+    case PH_INIT:
+        eax_init_message((const io_t*)nonce, ctx);
+        break;
+    case PH_DATA:
+        eax_encrypt((io_t*)msg, units, ctx);
+        break;
+    case PH_TAG:
+        eax_compute_tag((io_t*)tag, ctx);
+        break;
+    default:
+        eax_encrypt_message(nonce, msg, bytes, ctx);
+        break;
+    }
+}
+
+
+
+static void sub_evict(void) {
+    size_t  i;
+    uint8_t acc = 0;
+
+    for (i=0; i<evict_size; i+=64) {
+        acc += evict[i];
+    }
+    sink = acc;
+#   if defined(BENCH_TSC)
+    for (i=0; i<sizeof(ctx); i+=64) {
+        _mm_clflush(&((uint8_t*)ctx)[i]);
+    }
+    _mm_mfence();
+#   endif
+}
+
+
+
+static int sub_cmp(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+
+
+/* Times one phase runs times, and sorts the samples */
+static void sub_sample(int phase, int cold, uint64_t* t, int runs) {
+    uint64_t t0;
+    int i;
+
+    for (i=0; i<runs; i++) {
+        sub_prepare(phase);
+        if (cold) {
+            sub_evict();
+        }
+        else {
+            sub_phase(phase);
+            sub_prepare(phase);
+        }
+        t0 = sub_ticks();
+        sub_phase(phase);
+        t[i] = sub_ticks() - t0;
+        t[i] = (t[i] > overhead) ? (t[i] - overhead) : 0;
+    }
+    qsort(t, (size_t)runs, sizeof(uint64_t), &sub_cmp);
+}
+
+
+
+static unsigned long sub_count(int phase) {
+    if (phase == PH_KEY) {
+        return KEY_CALLS;
+    }
+    eax_init_and_key(key, ctx);
+    eax_set_backend(&backend_count, NULL, ctx);
+    sub_prepare(phase);
+    aes_calls = 0;
+    sub_phase(phase);
+    eax_set_backend(NULL, NULL, ctx);
+    return aes_calls;
+}
+
+
+
+int main(int argc, char** argv) {
+    static uint64_t t[WARM_RUNS];
+    const char*     build;
+    const char*     unit;
+    FILE*           json = NULL;
+    unsigned long   calls[NUM_PHASES];
+    long            llc;
+    size_t          evict_max = EVICT_MB;
+    char*           env;
+    int             phase, cold, i;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s build_name [json_file] [frame_bytes]\n", argv[0]);
+        return 1;
+    }
+    build = argv[1];
+    if ((argc > 2) && (argv[2][0] != 0)) {
+        json = fopen(argv[2], "w");
+        if (json == NULL) {
+            perror(argv[2]);
+            return 1;
+        }
+    }
+    if (argc > 3) {
+        bytes = strtoul(argv[3], NULL, 10);
+        if ((bytes == 0) || (bytes > MAX_BYTES)) {
+            fprintf(stderr, "frame_bytes must be 1 to %d\n", MAX_BYTES);
+            return 1;
+        }
+    }
+    units = (bytes + UNIT - 1) / UNIT;
+    // A kernel forced in OTEAX_KERNEL that this CPU can't run skips the
+    // variant, rather than timing the automatic choice under its name
+    if (((env = getenv("OTEAX_KERNEL")) != NULL) && (aes_kernel_select(env) != EXIT_SUCCESS)) {
+        printf("build %s: kernel %s not available, skipped\n", build, env);
+        if (json != NULL) {
+            fclose(json);
+        }
+        return 0;
+    }
+
+#   if defined(_SC_LEVEL3_CACHE_SIZE)
+    llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#   else
+    llc = 0;
+#   endif
+    if ((env = getenv("OTEAX_BENCH_EVICT_MB")) != NULL) {
+        evict_max = strtoul(env, NULL, 10);
+    }
+    evict_max  *= 1024 * 1024;
+    evict_size  = ((llc > 0) && ((2 * (size_t)llc) < evict_max)) ? (2 * (size_t)llc) : evict_max;
+    evict       = malloc(evict_size);
+    if (evict == NULL) {
+        perror("malloc");
+        return 1;
+    }
+    memset(evict, 1, evict_size);
+    memset(msg, 0x5A, sizeof(msg));
+
+#   if defined(BENCH_TSC)
+    unit = "cycles";
+#   else
+    unit = "ns";
+#   endif
+
+    for (phase=0; phase<NUM_PHASES; phase++) {
+        calls[phase] = sub_count(phase);
+    }
+
+    // Timer overhead, taken off every sample
+    for (i=0; i<WARM_RUNS; i++) {
+        uint64_t t0 = sub_ticks();
+        t[i] = sub_ticks() - t0;
+    }
+    qsort(t, WARM_RUNS, sizeof(uint64_t), &sub_cmp);
+    overhead = t[WARM_RUNS/2];
+
+    eax_init_and_key(key, ctx);
+    printf("build %s, kernel %s, %lu byte frame, %s (timer overhead %llu removed)\n",
+            build, aes_kernel_name(), bytes, unit, (unsigned long long)overhead);
+    printf("%-8s %6s %10s %10s %10s %10s\n", "phase", "AES", "warm med", "warm min", "cold med", "cold min");
+
+    for (phase=0; phase<NUM_PHASES; phase++) {
+        uint64_t med[2], min[2];
+
+        for (cold=0; cold<2; cold++) {
+            int runs = cold ? COLD_RUNS : WARM_RUNS;
+
+            sub_sample(phase, cold, t, runs);
+            med[cold] = t[runs/2];
+            min[cold] = t[0];
+            if (json != NULL) {
+                fprintf(json, "{\"build\": \"%s\", \"kernel\": \"%s\", \"phase\": \"%s\", \"bytes\": %lu, "
+                              "\"cache\": \"%s\", \"aes_calls\": %lu, \"%s_median\": %llu, \"%s_min\": %llu}\n",
+                        build, aes_kernel_name(), ph_names[phase], bytes, cold ? "cold" : "warm",
+                        calls[phase], unit, (unsigned long long)med[cold], unit, (unsigned long long)min[cold]);
+            }
+        }
+        printf("%-8s %6lu %10llu %10llu %10llu %10llu\n", ph_names[phase], calls[phase],
+                (unsigned long long)med[0], (unsigned long long)min[0],
+                (unsigned long long)med[1], (unsigned long long)min[1]);
+    }
+    putchar('\n');
+
+    eax_end(ctx);
+    free(evict);
+    if (json != NULL) {
+        fclose(json);
+    }
+    return 0;
+}
@@ -0,0 +1,314 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/bench/sink.c
+  * @version    R100
+  * @brief      OTEAX receiver for the traffic generator (gen.c)
+  *
+  * Takes frames from the shared memory ring (-m, which it creates and stamps
+  * with the run number given with -g, for the generator to check) or from
+  * a binary frame log on a pipe or file, and puts each one through
+  * eax_decrypt_message() under its device's key.  With -w, frames that
+  * verify are also checked against the last nonce accepted from their
+  * device, so that duplicates and replays are rejected; this needs the
+  * generator's sequence nonces.
+  *
+  * Reported: throughput, the decrypt latency and the end to end latency
+  * (from the generator's send time to the end of the decrypt) at p50, p99
+  * and p99.9, tag failures, and frames rejected by the nonce check.  These
+  * are set against the frames the generator marked as damaged, duplicated
+  * or replayed, so anything let through or wrongly rejected is shown (a
+  * replay of a frame that was first sent with a damaged tag is let through
+  * correctly, as the device's nonce was never accepted).  End
+  * to end latency is only meaningful for live input, as log files carry
+  * the times frames would have been sent.
+  *
+  * Usage: sink -k keys.csv [-w] [-o json_file] (-m ring_name [-g run] | log | -)
+  ******************************************************************************
+  */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include <getopt.h>
+
+#include <oteax.h>
+#include "hist.h"
+#include "framelog.h"
+#include "ring.h"
+
+#define UNIT        sizeof(io_t)
+
+static eax_ctx*         ctx;
+static uint64_t*        last_nonce;
+static framelog_keyent* key_idx;
+static long             num_keys;
+
+
+
+static uint64_t sub_now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t)t.tv_sec * 1000000000u) + (uint64_t)t.tv_nsec;
+}
+
+
+
+static int sub_keys(const char* key_path) {
+    uint32_t*   ids;
+    uint8_t*    keys;
+
+    num_keys = framelog_read_keys(key_path, &ids, &keys);
+    if (num_keys <= 0) {
+        fprintf(stderr, "%s: no keys read\n", key_path);
+        return -1;
+    }
+    if (posix_memalign((void**)&ctx, 64, (size_t)num_keys * sizeof(eax_ctx)) != 0) {
+        return -1;
+    }
+    eax_init_and_keys(keys, (unsigned long)num_keys, ctx);
+    free(keys);
+    key_idx = framelog_index_keys(ids, num_keys);
+    free(ids);
+    last_nonce = calloc((size_t)num_keys, sizeof(uint64_t));
+    return (last_nonce != NULL) ? 0 : -1;
+}
+
+
+
+static void sub_usage(const char* name) {
+    fprintf(stderr, "Usage: %s -k keys.csv [-w] [-o json_file] (-m ring_name [-g run] | log | -)\n", name);
+    exit(1);
+}
+
+
+
+int main(int argc, char** argv) {
+    static framelog_rec rec;
+    static uint64_t dec_hist[HIST_BUCKETS];
+    static uint64_t e2e_hist[HIST_BUCKETS];
+    const char*     key_path = NULL;
+    const char*     json_path = NULL;
+    const char*     ring_name = NULL;
+    const char*     source;
+    FILE*           json;
+    ring_t*         ring = NULL;
+    uint64_t        run = 0;
+    framelog_t      log = { NULL, 0, NULL };
+    int             window = 0;
+    uint64_t        frames = 0, passed = 0, fails = 0, rejected = 0, unknown = 0, bytes = 0;
+    uint64_t        inj_dup = 0, inj_replay = 0, inj_corrupt = 0;
+    uint64_t        let_through = 0, false_rejects = 0;
+    uint64_t        t_start = 0, t_end;
+    uint32_t*       rx;
+    double          secs;
+    int             opt;
+
+    while ((opt = getopt(argc, argv, "k:wo:m:g:")) != -1) {
+        switch (opt) {
+        case 'k':   key_path    = optarg;   break;
+        case 'w':   window      = 1;        break;
+        case 'o':   json_path   = optarg;   break;
+        case 'm':   ring_name   = optarg;   break;
+        case 'g':   run         = strtoull(optarg, NULL, 0);    break;
+        default:    sub_usage(argv[0]);
+        }
+    }
+    if ((key_path == NULL) || (optind != (argc - ((ring_name == NULL) ? 1 : 0)))) {
+        sub_usage(argv[0]);
+    }
+    source = (ring_name != NULL) ? ring_name : argv[optind];
+    if (sub_keys(key_path) != 0) {
+        return 1;
+    }
+
+    if (ring_name != NULL) {
+        ring = ring_create(ring_name, run);
+        if (ring == NULL) {
+            perror(ring_name);
+            return 1;
+        }
+    }
+    else if (framelog_open(&log, source) != 0) {
+        fprintf(stderr, "%s: cannot read frame log\n", source);
+        return 1;
+    }
+    rx = malloc(FRAMELOG_MAX_BYTES + 64);
+
+    for (;;) {
+        const uint8_t*  nonce;
+        const uint8_t*  data;
+        uint32_t        key_id, nonce32[2] = { 0, 0 };
+        uint64_t        sent_ns, t0, t1, n;
+        size_t          len, units;
+        uint8_t         flags;
+        long            k;
+        int             ok, i;
+
+        // The next frame, copied into the receive buffer with the tag at the next io_t
+        if (ring != NULL) {
+            ring_slot* s;
+            while ((s = ring_peek(ring)) == NULL) {
+                if (ring_drained(ring)) {
+                    break;
+                }
+                sched_yield();
+            }
+            if (s == NULL) {
+                break;
+            }
+            sent_ns = s->time_ns;
+            key_id  = s->key_id;
+            len     = s->len;
+            flags   = s->flags;
+            nonce   = s->nonce;
+            data    = s->data;
+        }
+        else {
+            int rc = framelog_read(&log, &rec);
+            if (rc == 0) {
+                break;
+            }
+            if (rc < 0) {
+                fprintf(stderr, "%s: bad frame after %llu frames\n", source, (unsigned long long)frames);
+                return 1;
+            }
+            sent_ns = rec.time_ns;
+            key_id  = rec.key_id;
+            len     = rec.len;
+            flags   = rec.flags;
+            nonce   = rec.nonce;
+            data    = rec.data;
+        }
+        if (frames == 0) {
+            t_start = sub_now();
+        }
+        frames++;
+        inj_dup     += ((flags & FRAMELOG_DUPLICATE) != 0);
+        inj_replay  += ((flags & FRAMELOG_REPLAY) != 0);
+        inj_corrupt += ((flags & FRAMELOG_CORRUPT) != 0);
+
+        k = framelog_find_key(key_idx, num_keys, key_id);
+        if (k < 0) {
+            unknown++;
+            if (ring != NULL) {
+                ring_release(ring);
+            }
+            continue;
+        }
+        units = (len + UNIT - 1) / UNIT;
+        if (units != 0) {
+            memset(&((uint8_t*)rx)[(units - 1) * UNIT], 0, UNIT);
+        }
+        memcpy(rx, data, len);
+        memcpy(&((uint8_t*)rx)[units * UNIT], &data[len], FRAMELOG_TAG_BYTES);
+        memcpy(nonce32, nonce, 7);
+        for (n=0, i=0; i<7; i++) {
+            n = (n << 8) | nonce[i];
+        }
+        if (ring != NULL) {
+            ring_release(ring);
+        }
+
+        t0  = sub_now();
+        ok  = (eax_decrypt_message(nonce32, rx, len, &ctx[k]) == 0);
+        t1  = sub_now();
+        dec_hist[hist_bucket(t1 - t0)]++;
+        e2e_hist[hist_bucket((t1 > sent_ns) ? (t1 - sent_ns) : 0)]++;
+        bytes += len;
+
+        if (!ok) {
+            fails++;
+            continue;
+        }
+        if (window) {
+            if (n <= last_nonce[k]) {
+                rejected++;
+                false_rejects += ((flags & (FRAMELOG_DUPLICATE | FRAMELOG_REPLAY)) == 0);
+                continue;
+            }
+            last_nonce[k] = n;
+        }
+        passed++;
+        let_through += ((flags & (FRAMELOG_DUPLICATE | FRAMELOG_REPLAY | FRAMELOG_CORRUPT)) != 0);
+    }
+    t_end = sub_now();
+
+    if (ring != NULL) {
+        ring_destroy(ring, ring_name);
+    }
+    else {
+        framelog_close(&log);
+    }
+    free(rx);
+
+    if (frames == 0) {
+        fprintf(stderr, "%s: no frames\n", source);
+        return 1;
+    }
+    secs = (double)(t_end - t_start) / 1e9;
+
+    printf("sink: %llu frames from %s, %.3f s, %.0f frames/s, kernel %s\n",
+            (unsigned long long)frames, source, secs, (double)frames / secs, aes_kernel_name());
+    printf("  decrypt ns:    p50 %llu, p99 %llu, p99.9 %llu\n",
+            (unsigned long long)hist_percentile(dec_hist, frames - unknown, 0.50),
+            (unsigned long long)hist_percentile(dec_hist, frames - unknown, 0.99),
+            (unsigned long long)hist_percentile(dec_hist, frames - unknown, 0.999));
+    printf("  end to end ns: p50 %llu, p99 %llu, p99.9 %llu\n",
+            (unsigned long long)hist_percentile(e2e_hist, frames - unknown, 0.50),
+            (unsigned long long)hist_percentile(e2e_hist, frames - unknown, 0.99),
+            (unsigned long long)hist_percentile(e2e_hist, frames - unknown, 0.999));
+    printf("  passed %llu, tag failures %llu (%llu damaged), nonce rejects %llu (%s), unknown keys %llu\n",
+            (unsigned long long)passed, (unsigned long long)fails, (unsigned long long)inj_corrupt,
+            (unsigned long long)rejected, window ? "on" : "off", (unsigned long long)unknown);
+    printf("  injected: %llu duplicates, %llu replays; let through %llu, wrongly rejected %llu\n",
+            (unsigned long long)inj_dup, (unsigned long long)inj_replay,
+            (unsigned long long)let_through, (unsigned long long)false_rejects);
+
+    if (json_path != NULL) {
+        json = fopen(json_path, "w");
+        if (json == NULL) {
+            perror(json_path);
+            return 1;
+        }
+        fprintf(json, "{\"source\": \"%s\", \"frames\": %llu, \"keys\": %ld, \"unknown\": %llu, \"kernel\": \"%s\", "
+                      "\"seconds\": %.6f, \"frames_per_s\": %.0f, \"bytes_per_s\": %.0f, ",
+                source, (unsigned long long)frames, num_keys, (unsigned long long)unknown, aes_kernel_name(),
+                secs, (double)frames / secs, (double)bytes / secs);
+        fprintf(json, "\"passed\": %llu, \"fails\": %llu, \"nonce_check\": %s, \"rejected\": %llu, "
+                      "\"injected\": {\"duplicate\": %llu, \"replay\": %llu, \"corrupt\": %llu}, "
+                      "\"let_through\": %llu, \"false_rejects\": %llu, ",
+                (unsigned long long)passed, (unsigned long long)fails, window ? "true" : "false",
+                (unsigned long long)rejected, (unsigned long long)inj_dup, (unsigned long long)inj_replay,
+                (unsigned long long)inj_corrupt, (unsigned long long)let_through, (unsigned long long)false_rejects);
+        fprintf(json, "\"decrypt_ns\": {\"p50\": %llu, \"p99\": %llu, \"p999\": %llu}, "
+                      "\"end_to_end_ns\": {\"p50\": %llu, \"p99\": %llu, \"p999\": %llu}}\n",
+                (unsigned long long)hist_percentile(dec_hist, frames - unknown, 0.50),
+                (unsigned long long)hist_percentile(dec_hist, frames - unknown, 0.99),
+                (unsigned long long)hist_percentile(dec_hist, frames - unknown, 0.999),
+                (unsigned long long)hist_percentile(e2e_hist, frames - unknown, 0.50),
+                (unsigned long long)hist_percentile(e2e_hist, frames - unknown, 0.99),
+                (unsigned long long)hist_percentile(e2e_hist, frames - unknown, 0.999));
+        fclose(json);
+    }
+    return 0;
+}
@@ -0,0 +1,733 @@
+/*
+---------------------------------------------------------------------------
+Copyright (c) 1998-2010, Brian Gladman, Worcester, UK. All rights reserved.
+
+The redistribution and use of this software (with or without changes)
+is allowed without the payment of fees or royalties provided that:
+
+  source code distributions include the above copyright notice, this
+  list of conditions and the following disclaimer;
+
+  binary distributions include the above copyright notice, this list
+  of conditions and the following disclaimer in their documentation.
+
+This software is provided 'as is' with no explicit or implied warranties
+in respect of its operation, including, but not limited to, correctness
+and fitness for purpose.
+---------------------------------------------------------------------------
+*/
+/** @brief EAX for OpenTag
+  * Adapted for OpenTag by JP Norair, written by Brian Gladman
+  * 
+  * To include the EAX encryption system into your OpenTag project, make sure
+  * to compile all the C files in this directory, and make sure to include this
+  * file.  You don't need to include any other files.
+  *
+  * Here is a list of the functions you need to call in the OT driver (which
+  * acts as little more than a wrapper).  The return value is 0 when everything
+  * works, else -1.
+  * <LI> eax_init_and_key() : Initialize EAX engine </LI>
+  * <LI> eax_init_and_keys() : Initialize many EAX engines at once </LI>
+  * <LI> eax_end() : De-initialize ("free") EAX engine </LI>
+  * <LI> eax_set_backend() : Optional, offload AES to another engine </LI>
+  * <LI> eax_encrypt_message() : Encrypts a message in place </LI>
+  * <LI> eax_decrypt_message() : Decrypts a message in place </LI>
+  * <LI> eax_decrypt_messages() : Decrypts a batch, returns a pass mask </LI>
+  * <LI> eax_prime_encrypt_message() : EAX' (ANSI C12.22) variant </LI>
+  * <LI> eax_prime_decrypt_message() : EAX' (ANSI C12.22) variant </LI>
+  * <LI> cmac_message() : AES-CMAC of a message, no EAX required </LI>
+  * <LI> gcm_encrypt_message() : AES-GCM, for links that want it </LI>
+  * <LI> gcm_decrypt_message() : AES-GCM, for links that want it </LI>
+  * 
+  * Each of these functions include an argument "ctx" of type "eax_ctx" which
+  * must be supplied and retained by the driver through the cryptography 
+  * process.  The AES-EAX driver in OpenTag will alias this as EAX_t.
+  * 
+  * @note [JP Norair, 25 Aug 2014]
+  * This version of eax.h is streamlined for OpenTag/Mode2.  It uses settings
+  * and configurations that are in some places hard-coded for optimization, to
+  * do only the features required (and no more)
+  */
+
+#ifndef _EAX_H
+#define _EAX_H
+
+/*  This define sets the memory alignment that will be used for fast move
+    and xor operations on buffers when the alignment matches this value. 
+*/
+///@note [JPN] I changed the default here from 64 bits to 32 bits.  64 bit
+///      hosts with byte I/O go back to 64 bits.
+#if !defined( UINT_BITS )
+#   if (defined(__x86_64__) || defined(__aarch64__) || defined(_WIN64) || defined(__LP64__)) \
+    && !defined(__ALIGN32__) && !defined(__C2000__)
+#       define UINT_BITS 64
+#   elif 1
+#       define UINT_BITS 32
+#   else
+#       define UINT_BITS  8
+#   endif
+#endif
+
+#if UINT_BITS == 64 && !defined( NEED_UINT_64T )
+#   define NEED_UINT_64T
+#endif
+
+#include "oteax/aes.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/*  After encryption or decryption operations the return value of
+    'compute tag' will be one of the values RETURN_GOOD, RETURN_WARN
+    or RETURN_ERROR, the latter indicating an error. A return value
+    RETURN_GOOD indicates that both encryption and authentication
+    have taken place and resulted in the returned tag value. If
+    the returned value is RETURN_WARN, the tag value is the result
+    of authentication alone without encryption (CCM) or decryption
+    (GCM and EAX).
+*/
+#ifndef RETURN_GOOD
+#   define RETURN_WARN      1
+#   define RETURN_GOOD      0
+#   define RETURN_ERROR    -1
+#endif
+
+#ifndef RET_TYPE_DEFINED
+  typedef int  ret_type;
+#endif
+
+#include "oteax/backend.h"
+
+UINT_TYPEDEF(eax_unit_t, UINT_BITS);
+BUFR_TYPEDEF(eax_buf_t, UINT_BITS, AES_BLOCK_SIZE);
+BUFR_TYPEDEF(eax_dbuf_t, UINT_BITS, 2 * AES_BLOCK_SIZE);
+
+#define EAX_BLOCK_SIZE  AES_BLOCK_SIZE
+
+/*  Build with __AFALG__ on Linux to allow large messages to be offloaded to
+    the kernel crypto API (see eax_afalg_attach() below).
+*/
+#if defined(__AFALG__) && defined(__linux__) && !defined(__ALIGN32__) && !defined(__C2000__)
+#   define AFALG_POSSIBLE
+#endif
+
+/* The EAX-AES  context  */
+
+typedef struct {
+    eax_buf_t       ctr_val;               /* CTR counter value            */
+    eax_buf_t       enc_ctr;               /* encrypted CTR block          */
+    eax_buf_t       hdr_cbc;               /* encrypt(1), for header CBC   */
+    eax_buf_t       txt_cbc;               /* encrypt(2), for ctext CBC    */
+    eax_buf_t       nce_cbc;               /* encrypt (0|nonce), for iv CBC*/
+    eax_dbuf_t      pad_xvv;               /* {02} encrypt(0), pad values  */
+    aes_encrypt_ctx aes[1];                 /* AES encryption context       */
+    uint_32t        hdr_cnt;                /* header io_t units so far     */
+    uint_32t        txt_ccnt;               /* text bytes so far (encrypt)  */
+    uint_32t        txt_acnt;               /* text bytes so far (auth)     */
+    const eax_backend* be;                  /* cipher backend, or NULL      */
+    void*           be_hdl;                 /* backend instance handle      */
+#   if defined(AFALG_POSSIBLE)
+    void*           afalg;                  /* AF_ALG handle, or NULL       */
+#   endif
+} eax_ctx;
+
+
+/* A header OMAC value, {1}OMAC(header), computed once with
+   eax_cache_header() and reused for every frame that has the same header
+   and key.
+*/
+typedef struct {
+    eax_buf_t       omac;
+} eax_hdr_t;
+
+
+
+/* The following calls handle mode initialisation, keying and completion    */
+
+/** @brief First step for EAX encryption or decryption: initialize context and key
+  * @param key  (const void*) AES key.  Typically 128 bits.
+  * @param ctx  (eax_ctx) Mode context, which acts as the control input.
+  * @retval     (ret_type) returns 0 on success.
+  *
+  * The Key input is of type (const void*).  This is usually uint8_t*, but it
+  * can be set to larger increments in order to improve performance or for
+  * compatibility on machines without byte addressing (some DSPs).
+  */
+ret_type eax_init_and_key(const void* key, eax_ctx ctx[1]);
+
+
+/** AES kernels, chosen per context when it is keyed.  EAX_KERNEL_FAST is the
+  * table-driven code selected by OTEAX_OPTIMIZATION.  EAX_KERNEL_CT has no
+  * memory accesses or branches that depend on the key or the data, for hosts
+  * shared with untrusted code, at several times the cost per block.  AES-NI
+  * is constant-time, so where it is available both kernels use it.
+  */
+#define EAX_KERNEL_FAST     AES_KERNEL_FAST
+#define EAX_KERNEL_CT       AES_KERNEL_CT
+
+/** @brief eax_init_and_key(), but with the constant-time AES kernel
+  * @param key  (const void*) AES-128 key
+  * @param ctx  (eax_ctx) Mode context
+  * @retval     (ret_type) returns 0 on success.
+  *
+  * The key schedule and the OMAC pads are computed in constant time as well.
+  * Frames are interchangeable with those of a context keyed the normal way.
+  */
+ret_type eax_init_and_key_ct(const void* key, eax_ctx ctx[1]);
+
+
+/** @brief Report the AES kernel a context was keyed with
+  * @param ctx  (eax_ctx) Keyed mode context
+  * @retval     (int) EAX_KERNEL_FAST or EAX_KERNEL_CT
+  */
+int eax_kernel(const eax_ctx ctx[1]);
+
+
+/** @brief Initialize and key an array of contexts, one per key
+  * @param keys     (const void*) Array of num_keys consecutive AES-128 keys
+  * @param num_keys (unsigned long) Number of keys (and contexts)
+  * @param ctx      (eax_ctx*) Array of num_keys mode contexts, output
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * The result is the same as calling eax_init_and_key() on each key, but it
+  * is faster when loading or refreshing large key tables.  On x86 hosts with
+  * AES-NI, keys are processed four at a time with the key expansion, the E(0)
+  * encryption and the pad doubling all run in SIMD registers.
+  */
+ret_type eax_init_and_keys(const void* keys, unsigned long num_keys, eax_ctx ctx[]);
+
+
+/** @brief Wrap-up cryptography process, do context clean-up.
+  * @param ctx  (eax_ctx) Mode context, which acts as the control input.
+  * @retval     (ret_type) returns 0 on success.
+  */
+ret_type eax_end(eax_ctx ctx[1]);
+
+
+/** @brief Select the cipher backend for a keyed context
+  * @param be       (const eax_backend*) Backend, or NULL for the built-in code
+  * @param hdl      (void*) Backend instance handle, passed to its operations
+  * @param ctx      (eax_ctx) Mode context, already keyed.
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * eax_init_and_key() clears the backend, so call this after keying.  With an
+  * asynchronous backend, the data given to eax_encrypt(), eax_decrypt(),
+  * eax_crypt_data() or eax_auth_data() must be left alone until eax_sync()
+  * or eax_compute_tag() returns.  The message calls are always synchronous.
+  */
+ret_type eax_set_backend(const eax_backend* be, void* hdl, eax_ctx ctx[1]);
+
+
+/** @brief Wait for a context's backend to finish all outstanding work
+  * @param ctx      (eax_ctx) Mode context
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type eax_sync(eax_ctx ctx[1]);
+
+
+#if defined(AFALG_POSSIBLE)
+/** @brief Attach a keyed context to the Linux kernel crypto API (AF_ALG)
+  * @param key      (const void*) Same AES key given to eax_init_and_key()
+  * @param threshold (unsigned long) Minimum message length to offload, or 0
+  * @param ctx      (eax_ctx) Mode context, already keyed.
+  * @retval         (ret_type) returns 0 on success, -1 if AF_ALG, ctr(aes)
+  *                 or cmac(aes) is not available, or if key is not the key
+  *                 of the context.
+  *
+  * Once attached, eax_encrypt_message() and eax_decrypt_message() send the
+  * CTR and ciphertext OMAC stages of messages at least threshold bytes long
+  * to the kernel, which may use a hardware AES engine.  If threshold is 0, it
+  * is calibrated at attach time against the software path.  If attaching
+  * fails the context continues to work in software.  Attaching again
+  * replaces the earlier handle.  eax_end() and re-keying the context with
+  * eax_init_and_key() detach automatically.
+  */
+ret_type eax_afalg_attach(const void* key, unsigned long threshold, eax_ctx ctx[1]);
+
+
+/** @brief Detach a context from AF_ALG and close its sockets
+  * @param ctx      (eax_ctx) Mode context
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type eax_afalg_detach(eax_ctx ctx[1]);
+#endif
+
+
+
+
+/* The following calls handle complete messages in memory as one operation  */
+
+/** @brief Single-call function to encrypt a plain-text data input.
+  * @param iv       (const void*) Initialization vector.
+  * @param msg      (void*) Plain Text message data
+  * @param msg_len  (unsigned long) Number of bytes in length, for msg
+  * @param ctx      (eax_ctx) Mode context, which acts as the control input.
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type eax_encrypt_message(const void* iv, void* msg, unsigned long msg_len, eax_ctx ctx[1]);
+
+
+/** @brief Single-call function to decrypt an EAX data input into plain-text.
+  * @param iv       (const void*) Initialization vector.
+  * @param msg      (void*) Plain Text message data
+  * @param msg_len  (unsigned long) Number of bytes in length, for msg
+  * @param ctx      (eax_ctx) Mode context, which acts as the control input.
+  * @retval         (ret_type) returns 0 (success) when authentication tag 
+  *                 of msg matches the computed tag.
+  */
+ret_type eax_decrypt_message(const void* iv, void* msg, unsigned long msg_len, eax_ctx ctx[1]);
+
+
+/** @brief Decrypt a batch of frames, releasing only those that authenticate
+  * @param iv       (const void* const[]) Initialization vector per frame
+  * @param msg      (void* const[]) Frames, ciphertext followed by the tag
+  * @param msg_len  (const unsigned long[]) Bytes per frame, without the tag
+  * @param num_msgs (unsigned int) Number of frames, 1 to EAX_BATCH_MAX
+  * @param ctx      (eax_ctx* const[]) Keyed context per frame.  The same
+  *                 context may appear more than once.
+  * @param pass     (uint_32t*) Output, bit i is set if frame i passed
+  * @retval         (ret_type) returns 0 when every frame passed.
+  *
+  * All tags are computed over the ciphertext first and compared in constant
+  * time, then only the frames that passed are decrypted.  The others are
+  * left unchanged.
+  */
+#define EAX_BATCH_MAX   32
+ret_type eax_decrypt_messages(const void* const iv[], void* const msg[], const unsigned long msg_len[],
+                              unsigned int num_msgs, eax_ctx* const ctx[], uint_32t* pass);
+
+
+/** @brief Precompute the OMAC of a header (associated data) for a key
+  * @param hdr      (const void*) Header, authenticated but not encrypted
+  * @param hdr_len  (unsigned long) Number of bytes in hdr, may be 0
+  * @param cache    (eax_hdr_t*) Output
+  * @param ctx      (eax_ctx) Mode context, keyed.  Its message state is
+  *                 not changed.
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * The result depends only on the key and the header, so headers built
+  * from a few static templates can be authenticated at no cost per frame.
+  */
+ret_type eax_cache_header(const void* hdr, unsigned long hdr_len, eax_hdr_t* cache, eax_ctx ctx[1]);
+
+
+/** @brief Single-call encryption with an authenticated header
+  * @param iv       (const void*) Initialization vector.
+  * @param hdr      (const eax_hdr_t*) Header OMAC from eax_cache_header()
+  * @param msg      (void*) Plain Text message data
+  * @param msg_len  (unsigned long) Number of bytes in length, for msg
+  * @param ctx      (eax_ctx) Mode context, which acts as the control input.
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * Without a header, OTEAX computes the tag as OMAC(nonce) ^ OMAC(text),
+  * the DASH7 form.  With a header, the tag also covers OMAC(header), which
+  * is standard EAX.  Caching an empty header gives standard EAX for frames
+  * that have none.
+  */
+ret_type eax_encrypt_message_hdr(const void* iv, const eax_hdr_t* hdr, void* msg, unsigned long msg_len, eax_ctx ctx[1]);
+
+
+/** @brief Single-call decryption with an authenticated header
+  * @param iv       (const void*) Initialization vector.
+  * @param hdr      (const eax_hdr_t*) Header OMAC from eax_cache_header()
+  * @param msg      (void*) Cipher Text message data, followed by the tag
+  * @param msg_len  (unsigned long) Number of bytes in length, for msg
+  * @param ctx      (eax_ctx) Mode context, which acts as the control input.
+  * @retval         (ret_type) returns 0 (success) when authentication tag
+  *                 of msg matches the computed tag.
+  */
+ret_type eax_decrypt_message_hdr(const void* iv, const eax_hdr_t* hdr, void* msg, unsigned long msg_len, eax_ctx ctx[1]);
+
+
+/** @brief Single-call EAX' encryption (ANSI C12.22), tag appended to msg
+  * @param clr      (const void*) Cleartext: nonce and header, authenticated
+  *                 but not encrypted.  Must not be empty.
+  * @param clr_len  (unsigned long) Number of bytes in clr
+  * @param msg      (void*) Plain Text message data, encrypted in place
+  * @param msg_len  (unsigned long) Number of bytes in length, for msg
+  * @param ctx      (eax_ctx) Mode context, keyed by eax_init_and_key().
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * EAX' replaces the three tweaked OMACs of EAX with a CMAC over the
+  * cleartext and a CMAC over the ciphertext with the final block masks
+  * swapped.  That saves the two or three AES calls per message that the EAX
+  * tweak blocks cost, which is a large part of the work for small frames.
+  * The 4 byte tag is written after the message, as with eax_encrypt_message().
+  */
+ret_type eax_prime_encrypt_message(const void* clr, unsigned long clr_len,
+                                    void* msg, unsigned long msg_len, eax_ctx ctx[1]);
+
+
+/** @brief Single-call EAX' decryption (ANSI C12.22)
+  * @param clr      (const void*) Cleartext: nonce and header
+  * @param clr_len  (unsigned long) Number of bytes in clr
+  * @param msg      (void*) Cipher Text message data, followed by the tag
+  * @param msg_len  (unsigned long) Number of bytes in length, for msg
+  * @param ctx      (eax_ctx) Mode context, keyed by eax_init_and_key().
+  * @retval         (ret_type) returns 0 (success) when authentication tag
+  *                 of msg matches the computed tag.
+  *
+  * The tag is checked before decrypting, and on a mismatch msg is left as
+  * it was.
+  */
+ret_type eax_prime_decrypt_message(const void* clr, unsigned long clr_len,
+                                    void* msg, unsigned long msg_len, eax_ctx ctx[1]);
+
+
+
+
+
+/* The following calls handle messages in a sequence of operations followed */
+/* by tag computation after the sequence has been completed. In these calls */
+/* the user is responsible for verfiying the computed tag on decryption     */
+
+/** @brief Initialize EAX message with IV.
+  * @param iv       (const io_t*) Initialization vector.
+  * @param ctx      (eax_ctx) Mode context, which acts as the control input.
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type eax_init_message(const io_t* iv, eax_ctx ctx[1]);
+
+
+/** @brief Authenticate header data (associated data) for the message
+  * @param hdr      (const io_t*) Header input
+  * @param hdr_len  (unsigned long) Length of hdr in io_t units.
+  * @param ctx      (eax_ctx) Mode context, after eax_init_message().
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * May be called any number of times before eax_compute_tag(), in any order
+  * with the text calls.  The header is not encrypted.
+  */
+ret_type eax_auth_header(const io_t* hdr, unsigned long hdr_len, eax_ctx ctx[1]);
+
+
+/** @brief Use a cached header OMAC for the message, in place of
+  *        eax_auth_header()
+  * @param hdr      (const eax_hdr_t*) Header OMAC from eax_cache_header()
+  * @param ctx      (eax_ctx) Mode context, after eax_init_message().
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type eax_set_header(const eax_hdr_t* hdr, eax_ctx ctx[1]);
+
+
+/** @brief Encrypt data using already initialized context, IV, Header
+  * @param data     (io_t*) In-place data input/output
+  * @param data_len (unsigned long) Length of data in io_t units.
+  * @param ctx      (eax_ctx) Mode context, which acts as the control input.
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type eax_encrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]);
+
+
+/** @brief Decrypt data using already initialized context, IV, Header
+  * @param data     (void*) In-place data input/output
+  * @param data_len (unsigned long) Length of data in io_t units.
+  * @param ctx      (eax_ctx) Mode context, which acts as the control input.
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type eax_decrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]);
+
+
+/** @brief Compute tag using already initialized context, IV, Header, Data
+  * @param tag      (io_t*) In-place tag input/output
+  * @param ctx      (eax_ctx) Mode context, which acts as the control input.
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type eax_compute_tag(io_t* tag, eax_ctx ctx[1]);
+
+
+
+
+/*  The use of the following calls should be avoided if possible because 
+    their use requires a very good understanding of the way this encryption 
+    mode works and the way in which this code implements it in order to use 
+    them correctly.
+
+    The eax_auth_data routine is used to authenticate encrypted message data.
+    In message encryption eax_crypt_data must be called before eax_auth_data
+    is called since it is encrypted data that is authenticated.  In message
+    decryption authentication must occur before decryption and data can be
+    authenticated without being decrypted if necessary.
+
+    If these calls are used it is up to the user to ensure that these routines
+    are called in the correct order and that the correct data is passed to 
+    them.
+
+    When eax_compute_tag is called it is assumed that an error in use has
+    occurred if both encryption (or decryption) and authentication have taken
+    place but the total lengths of the message data respectively authenticated
+    and encrypted are not the same. If authentication has taken place but 
+    there has been no corresponding encryption or decryption operations (none
+    at all) only a warning is issued. This should be treated as an error if it 
+    occurs during encryption but it is only signalled as a warning as it might 
+    be intentional when decryption operations are involved (this avoids having
+    different compute tag functions for encryption and decryption). Decryption
+    operations can be undertaken freely after authetication but if the tag is
+    computed after such operations an error will be signalled if the lengths
+    of the data authenticated and decrypted don't match.
+*/
+
+
+
+/** @brief Run EAX Authenticator over initialized context, with input data.
+  * @param data     (const io_t*) Data input
+  * @param data_len (unsigned long) Length of data in io_t units.
+  * @param ctx      (eax_ctx) Mode context, which acts as the control input.
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type eax_auth_data(const io_t* data, unsigned long data_len, eax_ctx ctx[1]);
+
+
+/** @brief Run EAX Cryptographer over initialized context, with input data.
+  * @param data     (void*) In place Data input/output
+  * @param data_len (unsigned long) Length of data in io_t units.
+  * @param ctx      (eax_ctx) Mode context, which acts as the control input.
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * @note EAX is a symmetric encryption, so encrypt and decrypt is the same
+  * actual process.
+  */
+ret_type eax_crypt_data(io_t* data, unsigned long data_len, eax_ctx ctx[1]);
+
+
+
+
+/* AES-CMAC (OMAC1, RFC 4493).  EAX is built from three OMACs, so CMAC falls
+   out of the same key setup and CBC code.  The tag is always 16 bytes; it may
+   be truncated by the caller.
+*/
+
+typedef struct {
+    eax_buf_t       cbc;                    /* lazy CBC-MAC state           */
+    eax_dbuf_t      pad_xvv;                /* K1 || K2, as in eax_ctx      */
+    aes_encrypt_ctx aes[1];                 /* AES encryption context       */
+    uint_32t        cnt;                    /* message io_t units so far    */
+} cmac_ctx;
+
+
+/** @brief Initialize a CMAC context and key it
+  * @param key      (const void*) AES-128 key
+  * @param ctx      (cmac_ctx) CMAC context
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type cmac_init_and_key(const void* key, cmac_ctx ctx[1]);
+
+
+/** @brief cmac_init_and_key(), but with the constant-time AES kernel
+  * @param key      (const void*) AES-128 key
+  * @param ctx      (cmac_ctx) CMAC context
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type cmac_init_and_key_ct(const void* key, cmac_ctx ctx[1]);
+
+
+/** @brief Add message data to a CMAC in progress
+  * @param data     (const void*) Data input
+  * @param data_len (unsigned long) Length of data in io_t units.
+  * @param ctx      (cmac_ctx) CMAC context
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * May be called any number of times, with any lengths, between keying (or
+  * the last cmac_compute_tag()) and cmac_compute_tag().
+  */
+ret_type cmac_update(const void* data, unsigned long data_len, cmac_ctx ctx[1]);
+
+
+/** @brief Finish a CMAC and reset the context for the next message
+  * @param tag      (void*) 16 byte tag output
+  * @param ctx      (cmac_ctx) CMAC context
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type cmac_compute_tag(void* tag, cmac_ctx ctx[1]);
+
+
+/** @brief Single-call CMAC of a message
+  * @param msg      (const void*) Message
+  * @param msg_len  (unsigned long) Length of msg in io_t units.
+  * @param tag      (void*) 16 byte tag output
+  * @param ctx      (cmac_ctx) CMAC context, keyed.  Any message in progress
+  *                 is discarded.
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type cmac_message(const void* msg, unsigned long msg_len, void* tag, cmac_ctx ctx[1]);
+
+
+/** @brief CMAC of many independent messages under one key
+  * @param msg      (const void* const[]) Messages
+  * @param msg_len  (const unsigned long[]) Length of each message, io_t units
+  * @param tag      (void* const[]) 16 byte tag output for each message
+  * @param num_msgs (unsigned long) Number of messages
+  * @param ctx      (cmac_ctx) CMAC context, keyed.  Its message state is
+  *                 not used or changed.
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * Tags are the same as from cmac_message().  CBC-MAC cannot be pipelined
+  * within one message, so up to 32 messages are run side by side, which
+  * on AES-NI hosts is several times faster than one at a time for short
+  * messages.  VAES hosts put four messages in each register.
+  */
+ret_type cmac_messages(const void* const msg[], const unsigned long msg_len[], void* const tag[],
+                        unsigned long num_msgs, cmac_ctx ctx[1]);
+
+
+
+
+/* AES-GCM (NIST SP 800-38D).  GCM shares the AES key schedule, the CTR
+   engine and the cipher backends with EAX, so a build that needs both
+   carries only one AES.  The calls mirror the EAX ones.  Tags are 16 bytes.
+*/
+
+typedef struct {
+    eax_buf_t       ctr_val;                /* CTR counter value            */
+    eax_buf_t       enc_ctr;                /* encrypted CTR block          */
+    eax_buf_t       ghash;                  /* GHASH accumulator            */
+    eax_buf_t       tag_pad;                /* E(J0), masks the tag         */
+    eax_buf_t       hkey;                   /* H = E(0)                     */
+    uint_32t        htab[16][4];            /* GHASH table, or powers of H  */
+    aes_encrypt_ctx aes[1];                 /* AES encryption context       */
+    uint_32t        hdr_cnt;                /* header io_t units so far     */
+    uint_32t        txt_ccnt;               /* text units so far (encrypt)  */
+    uint_32t        txt_acnt;               /* text units so far (auth)     */
+    uint_32t        ctr_lo;                 /* low 32 bits of ctr_val       */
+    const eax_backend* be;                  /* cipher backend, or NULL      */
+    void*           be_hdl;                 /* backend instance handle      */
+} gcm_ctx;
+
+
+/** @brief Initialize a GCM context and key it
+  * @param key      (const void*) AES-128 key
+  * @param ctx      (gcm_ctx) GCM context
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type gcm_init_and_key(const void* key, gcm_ctx ctx[1]);
+
+
+/** @brief Initialize and key an array of GCM contexts, one per key
+  * @param keys     (const void*) Array of num_keys consecutive AES-128 keys
+  * @param num_keys (unsigned long) Number of keys (and contexts)
+  * @param ctx      (gcm_ctx*) Array of num_keys contexts, output
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type gcm_init_and_keys(const void* keys, unsigned long num_keys, gcm_ctx ctx[]);
+
+
+/** @brief Wrap-up a GCM context, do context clean-up.
+  * @param ctx      (gcm_ctx) GCM context
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type gcm_end(gcm_ctx ctx[1]);
+
+
+/** @brief Select the cipher backend for a keyed GCM context
+  * @param be       (const eax_backend*) Backend, or NULL for the built-in code
+  * @param hdl      (void*) Backend instance handle, passed to its operations
+  * @param ctx      (gcm_ctx) GCM context, already keyed.
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * The backend does the CTR work.  GHASH always runs on the CPU.  The same
+  * rules apply as for eax_set_backend().
+  */
+ret_type gcm_set_backend(const eax_backend* be, void* hdl, gcm_ctx ctx[1]);
+
+
+/** @brief Wait for a GCM context's backend to finish all outstanding work
+  * @param ctx      (gcm_ctx) GCM context
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type gcm_sync(gcm_ctx ctx[1]);
+
+
+/** @brief Single-call GCM encryption, in place, tag appended to msg
+  * @param iv       (const void*) 12 byte IV
+  * @param hdr      (const void*) Additional authenticated data, or NULL
+  * @param hdr_len  (unsigned long) Number of bytes in hdr
+  * @param msg      (void*) Plain Text message data
+  * @param msg_len  (unsigned long) Number of bytes in length, for msg
+  * @param ctx      (gcm_ctx) GCM context, keyed.
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * The 16 byte tag is written right after the message.
+  */
+ret_type gcm_encrypt_message(const void* iv, const void* hdr, unsigned long hdr_len,
+                             void* msg, unsigned long msg_len, gcm_ctx ctx[1]);
+
+
+/** @brief Single-call GCM decryption, in place, tag read from after msg
+  * @param iv       (const void*) 12 byte IV
+  * @param hdr      (const void*) Additional authenticated data, or NULL
+  * @param hdr_len  (unsigned long) Number of bytes in hdr
+  * @param msg      (void*) Cipher Text message data, followed by the tag
+  * @param msg_len  (unsigned long) Number of bytes in length, for msg
+  * @param ctx      (gcm_ctx) GCM context, keyed.
+  * @retval         (ret_type) returns 0 (success) when the tag matches.
+  *
+  * The tag is checked first, in constant time, and on a mismatch msg is
+  * left as it was.
+  */
+ret_type gcm_decrypt_message(const void* iv, const void* hdr, unsigned long hdr_len,
+                             void* msg, unsigned long msg_len, gcm_ctx ctx[1]);
+
+
+/** @brief Start a GCM message
+  * @param iv       (const io_t*) IV.  12 bytes is recommended, other
+  *                 lengths are hashed as SP 800-38D describes.
+  * @param iv_len   (unsigned long) Length of iv in io_t units.
+  * @param ctx      (gcm_ctx) GCM context, keyed.
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type gcm_init_message(const io_t* iv, unsigned long iv_len, gcm_ctx ctx[1]);
+
+
+/** @brief Add additional authenticated data, before any message data
+  * @param hdr      (const io_t*) Header input
+  * @param hdr_len  (unsigned long) Length of hdr in io_t units.
+  * @param ctx      (gcm_ctx) GCM context
+  * @retval         (ret_type) returns 0 on success, -1 if message data has
+  *                 already been given.
+  */
+ret_type gcm_auth_header(const io_t* hdr, unsigned long hdr_len, gcm_ctx ctx[1]);
+
+
+/** @brief Encrypt data in place, within a started message
+  * @param data     (io_t*) In-place data input/output
+  * @param data_len (unsigned long) Length of data in io_t units.
+  * @param ctx      (gcm_ctx) GCM context
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type gcm_encrypt(io_t* data, unsigned long data_len, gcm_ctx ctx[1]);
+
+
+/** @brief Decrypt data in place, within a started message
+  * @param data     (io_t*) In-place data input/output
+  * @param data_len (unsigned long) Length of data in io_t units.
+  * @param ctx      (gcm_ctx) GCM context
+  * @retval         (ret_type) returns 0 on success.
+  */
+ret_type gcm_decrypt(io_t* data, unsigned long data_len, gcm_ctx ctx[1]);
+
+
+/** @brief Finish a message and compute its tag
+  * @param tag      (io_t*) 16 byte tag output
+  * @param ctx      (gcm_ctx) GCM context
+  * @retval         (ret_type) returns 0 on success.  The rules are the same
+  *                 as for eax_compute_tag().
+  */
+ret_type gcm_compute_tag(io_t* tag, gcm_ctx ctx[1]);
+
+
+/** @brief GHASH ciphertext only.  See the notes on eax_auth_data().
+  */
+ret_type gcm_auth_data(const io_t* data, unsigned long data_len, gcm_ctx ctx[1]);
+
+
+/** @brief CTR encrypt or decrypt only.  See the notes on eax_crypt_data().
+  */
+ret_type gcm_crypt_data(io_t* data, unsigned long data_len, gcm_ctx ctx[1]);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
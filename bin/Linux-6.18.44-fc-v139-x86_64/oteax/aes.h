@@ -0,0 +1,303 @@
+/*
+---------------------------------------------------------------------------
+Copyright (c) 1998-2010, Brian Gladman, Worcester, UK. All rights reserved.
+
+The redistribution and use of this software (with or without changes)
+is allowed without the payment of fees or royalties provided that:
+
+  source code distributions include the above copyright notice, this
+  list of conditions and the following disclaimer;
+
+  binary distributions include the above copyright notice, this list
+  of conditions and the following disclaimer in their documentation.
+
+This software is provided 'as is' with no explicit or implied warranties
+in respect of its operation, including, but not limited to, correctness
+and fitness for purpose.
+---------------------------------------------------------------------------
+Issue Date: 20/12/2007
+
+ This file contains the definitions required to use AES in C. See aesopt.h
+ for optimisation details.
+*/
+
+#ifndef _AES_H
+#define _AES_H
+
+#include <stdlib.h>
+
+
+/*  This include is used to find 8 & 32 bit unsigned integer types  */
+#include "brg_types.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+///@note [JPN] I commented-out these key schedulers as they are not needed
+#define AES_128     /* if a fast 128 bit key scheduler is needed    */
+//#define AES_192     /* if a fast 192 bit key scheduler is needed    */
+//#define AES_256     /* if a fast 256 bit key scheduler is needed    */
+//#define AES_VAR     /* if variable key size scheduler is needed     */
+#define AES_MODES   /* if support is needed for modes               */
+
+/* The following must also be set in assembler files if being used  */
+
+#define AES_ENCRYPT /* if support for encryption is needed          */
+#define AES_DECRYPT /* if support for decryption is needed          */
+#define AES_REV_DKS /* define to reverse decryption key schedule    */
+
+#define AES_BLOCK_SIZE  16  /* the AES block size in bytes          */
+#define N_COLS           4  /* the number of columns in the state   */
+
+/* The key schedule length is 11, 13 or 15 16-byte blocks for 128,  */
+/* 192 or 256-bit keys respectively. That is 176, 208 or 240 bytes  */
+/* or 44, 52 or 60 32-bit words.                                    */
+
+#if defined( AES_VAR ) || defined( AES_256 )
+#   define KS_LENGTH    60
+#elif defined( AES_192 )
+#   define KS_LENGTH    52
+#else
+#   define KS_LENGTH    44
+#endif
+
+/* When __OTF_KEYSCHED__ is defined, the encryption context holds   */
+/* only the 128 bit cipher key (4 32-bit words) and aes_encrypt()   */
+/* computes each round key on-the-fly as it runs the rounds.  This  */
+/* trades a little compute per block for a context that is about    */
+/* 1/9 the size, which is useful when many keys must stay resident. */
+/* Only AES-128 is supported in this mode.                          */
+
+#if defined( __OTF_KEYSCHED__ )
+#   if defined( AES_VAR ) || defined( AES_192 ) || defined( AES_256 )
+#       error "__OTF_KEYSCHED__ supports only AES-128 keys"
+#   endif
+#   define EKS_LENGTH   4
+#else
+#   define EKS_LENGTH   KS_LENGTH
+#endif
+
+/* The amalgamated build (OTEAX_AMALGAMATION, see the Makefile) has */
+/* the whole library in one translation unit, and the AES functions  */
+/* are given internal linkage there, as are the internal functions   */
+/* shared between source files, whose prototypes are marked          */
+/* OTEAX_INTERNAL.  The block loops of the modes are marked          */
+/* AES_FLATTEN, so that the compiler inlines the cipher into them;   */
+/* elsewhere a call costs less than the code it saves.               */
+
+#if defined( OTEAX_AMALGAMATION ) && defined( __GNUC__ )
+#   define OTEAX_INTERNAL   static __attribute__((unused))
+#   define AES_FLATTEN      __attribute__((flatten))
+#elif defined( OTEAX_AMALGAMATION )
+#   define OTEAX_INTERNAL   static
+#   define AES_FLATTEN
+#else
+#   define OTEAX_INTERNAL
+#   define AES_FLATTEN
+#endif
+
+#if defined( OTEAX_AMALGAMATION )
+#   define AES_RETURN   OTEAX_INTERNAL int
+#else
+#   define AES_RETURN   INT_RETURN
+#endif
+
+
+
+/* the character array 'inf' in the following structures is used    */
+/* to hold AES context information. This AES code uses cx->inf.b[0] */
+/* to hold the number of rounds multiplied by 16, and cx->inf.b[1]  */
+/* to select the kernel (see AES_KERNEL_CT below). The other two    */
+/* elements can be used by code that implements additional modes    */
+#if defined(__C2000__)
+    typedef union {   
+        uint_32t l;
+    } aes_inf;
+#   define INF_L(i)     ((i).l)
+#   define INF_B(i,n)   (__byte((int*)&((i).l), n))
+
+#else
+    typedef union {   
+        uint_32t l;
+        uint_8t b[4];
+    } aes_inf;
+#   define INF_L(i)     ((i).l)
+#   define INF_B(i,n)   ((i).b[n])
+#endif
+
+
+typedef struct {   
+    uint_32t ks[EKS_LENGTH];
+    aes_inf inf;
+} aes_encrypt_ctx;
+
+typedef struct {   
+    uint_32t ks[KS_LENGTH];
+    aes_inf inf;
+} aes_decrypt_ctx;
+
+/* This routine must be called before first use if non-static       */
+/* tables are being used                                            */
+
+AES_RETURN aes_init(void);
+
+/* Key lengths in the range 16 <= key_len <= 32 are given in bytes, */
+/* those in the range 128 <= key_len <= 256 are given in bits       */
+
+#if defined( AES_ENCRYPT )
+    AES_RETURN aes_encrypt(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]);
+
+#   if defined(AES_VAR)
+        AES_RETURN aes_encrypt_key128(const io_t *key, aes_encrypt_ctx cx[1]);
+        AES_RETURN aes_encrypt_key192(const io_t *key, aes_encrypt_ctx cx[1]);
+        AES_RETURN aes_encrypt_key256(const io_t *key, aes_encrypt_ctx cx[1]);
+        AES_RETURN aes_encrypt_key(const io_t *key, int key_len, aes_encrypt_ctx cx[1]);
+    
+#   elif defined(AES_128)
+        AES_RETURN aes_encrypt_key128(const io_t *key, aes_encrypt_ctx cx[1]);
+#       define aes_encrypt_key(key, len, ctx)   aes_encrypt_key128(key, ctx)
+
+#   elif defined(AES_192)
+        AES_RETURN aes_encrypt_key192(const io_t *key, aes_encrypt_ctx cx[1]);
+#       define aes_encrypt_key(key, len, ctx)   aes_encrypt_key128(key, ctx)
+
+#   elif defined(AES_256)
+        AES_RETURN aes_encrypt_key256(const io_t *key, aes_encrypt_ctx cx[1]);
+#       define aes_encrypt_key(key, len, ctx)   aes_encrypt_key128(key, ctx)
+#   endif
+#endif
+
+/* Constant-time kernel, chosen per key.  A context keyed with      */
+/* aes_encrypt_key128_ct() is marked in INF_B(inf,1), and from then */
+/* on aes_encrypt() runs it through aes_encrypt_ct(), which has no  */
+/* table lookups or branches that depend on the key or the data.    */
+/* It costs several times more per block than the table kernels.    */
+
+#define AES_KERNEL_FAST     0
+#define AES_KERNEL_CT       1
+
+#if defined( AES_ENCRYPT )
+    AES_RETURN aes_encrypt_key128_ct(const io_t *key, aes_encrypt_ctx cx[1]);
+    AES_RETURN aes_encrypt_ct(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]);
+#endif
+
+/* Kernel selection.  Hosted builds (AES_DISPATCH in aesdisp.h) have */
+/* several kernels behind aes_encrypt(), and use the fastest one the */
+/* CPU can run, unless the environment variable OTEAX_KERNEL names   */
+/* another.  aes_kernel_select() does the same at runtime: "vaes",   */
+/* "aesni", "speed", "normal" or "size", or NULL for the automatic   */
+/* choice.  The choice also decides whether the multi-block CTR and  */
+/* CBC-MAC paths use VAES and AES-NI.  Builds without dispatch have  */
+/* only the kernel set by OTEAX_OPTIMIZATION, and accept only its    */
+/* name.                                                             */
+
+OTEAX_INTERNAL const char* aes_kernel_name(void);
+AES_RETURN  aes_kernel_select(const char* name);
+
+
+
+#if defined( AES_DECRYPT )
+    AES_RETURN aes_decrypt(const io_t *in, io_t *out, const aes_decrypt_ctx cx[1]);
+
+#   if defined(AES_VAR)
+        AES_RETURN aes_decrypt_key128(const io_t *key, aes_decrypt_ctx cx[1]);
+        AES_RETURN aes_decrypt_key192(const io_t *key, aes_decrypt_ctx cx[1]);
+        AES_RETURN aes_decrypt_key256(const io_t *key, aes_decrypt_ctx cx[1]);
+        AES_RETURN aes_decrypt_key(const io_t *key, int key_len, aes_decrypt_ctx cx[1])
+        
+#   elif defined( AES_128 )
+        AES_RETURN aes_decrypt_key128(const io_t *key, aes_decrypt_ctx cx[1]);
+#       define aes_decrypt_key(key, len, ctx)   aes_decrypt_key128(key, ctx)
+
+#   elif defined( AES_192 )
+        AES_RETURN aes_decrypt_key192(const io_t *key, aes_decrypt_ctx cx[1]);
+#       define aes_decrypt_key(key, len, ctx)   aes_decrypt_key192(key, ctx)
+
+#   elif defined( AES_256 )
+        AES_RETURN aes_decrypt_key256(const io_t *key, aes_decrypt_ctx cx[1]);
+#       define aes_decrypt_key(key, len, ctx)   aes_decrypt_key256(key, ctx)
+#   endif
+#endif
+
+
+
+#if defined( AES_MODES )
+
+/* Multiple calls to the following subroutines for multiple block   */
+/* ECB, CBC, CFB, OFB and CTR mode encryption can be used to handle */
+/* long messages incremantally provided that the context AND the iv */
+/* are preserved between all such calls.  For the ECB and CBC modes */
+/* each individual call within a series of incremental calls must   */
+/* process only full blocks (i.e. len must be a multiple of 16) but */
+/* the CFB, OFB and CTR mode calls can handle multiple incremental  */
+/* calls of any length. Each mode is reset when a new AES key is    */
+/* set but ECB and CBC operations can be reset without setting a    */
+/* new key by setting a new IV value.  To reset CFB, OFB and CTR    */
+/* without setting the key, aes_mode_reset() must be called and the */
+/* IV must be set.  NOTE: All these calls update the IV on exit so  */
+/* this has to be reset if a new operation with the same IV as the  */
+/* previous one is required (or decryption follows encryption with  */
+/* the same IV array).                                              */
+
+AES_RETURN aes_test_alignment_detection(unsigned int n);
+
+AES_RETURN aes_ecb_encrypt(const io_t *ibuf, io_t *obuf, int len, const aes_encrypt_ctx cx[1]);
+
+AES_RETURN aes_ecb_decrypt(const io_t *ibuf, io_t *obuf, int len, const aes_decrypt_ctx cx[1]);
+/*
+AES_RETURN aes_cbc_encrypt(cubyte *ibuf, unsigned char *obuf,
+                    int len, unsigned char *iv, const aes_encrypt_ctx cx[1]);
+
+AES_RETURN aes_cbc_decrypt(cubyte *ibuf, unsigned char *obuf,
+                    int len, unsigned char *iv, const aes_decrypt_ctx cx[1]);
+*/
+
+AES_RETURN aes_mode_reset(aes_encrypt_ctx cx[1]);
+
+/*
+AES_RETURN aes_cfb_encrypt(cubyte *ibuf, unsigned char *obuf,
+                    int len, unsigned char *iv, aes_encrypt_ctx cx[1]);
+
+AES_RETURN aes_cfb_decrypt(cubyte *ibuf, unsigned char *obuf,
+                    int len, unsigned char *iv, aes_encrypt_ctx cx[1]);
+*/
+/*
+#define aes_ofb_encrypt aes_ofb_crypt
+#define aes_ofb_decrypt aes_ofb_crypt
+
+AES_RETURN aes_ofb_crypt(cubyte *ibuf, unsigned char *obuf,
+                    int len, unsigned char *iv, aes_encrypt_ctx cx[1]);
+*/
+
+/* CTR mode keeps its own state, so one AES key may drive any number of  */
+/* CTR streams at once.  The counter is the low 32, 64 or 128 bits of   */
+/* the big-endian counter block, and it wraps within that field.  Whole */
+/* blocks are encrypted in batches, with AES-NI where it is available. */
+/* Lengths are in io_t units, like the other calls here.               */
+
+typedef struct {
+    uint_32t    ctr[4];             /* next counter block (as io_t)     */
+    uint_32t    ks[4];              /* current key stream block         */
+    uint_8t     b_pos;              /* key stream units already used    */
+    uint_8t     ctr_bits;           /* counter width: 32, 64 or 128     */
+} aes_ctr_ctx;
+
+#define aes_ctr_encrypt aes_ctr_crypt
+#define aes_ctr_decrypt aes_ctr_crypt
+
+AES_RETURN aes_ctr_init(const io_t *iv, int ctr_bits, aes_ctr_ctx cc[1]);
+
+AES_RETURN aes_ctr_crypt(const io_t *ibuf, io_t *obuf, int len, aes_ctr_ctx cc[1], const aes_encrypt_ctx cx[1]);
+
+/* Stateless bulk form: whole blocks only, ctr is advanced by blocks    */
+AES_RETURN aes_ctr_blocks(const io_t *ibuf, io_t *obuf, unsigned long blocks, io_t *ctr, int ctr_bits, const aes_encrypt_ctx cx[1]);
+
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -0,0 +1,65 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/afalg.h
+  * @brief      Linux AF_ALG kernel crypto offload (INTERNAL)
+  *
+  * The public calls, eax_afalg_attach() and eax_afalg_detach(), are in
+  * oteax.h.  The calls here are used by oteax.c to route large messages
+  * through the kernel's ctr(aes) and cmac(aes) transforms.
+  ******************************************************************************
+  */
+
+#ifndef _AFALG_H
+#define _AFALG_H
+
+#include "../oteax.h"
+
+#if defined(AFALG_POSSIBLE)
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/** @brief Message length (bytes) at and above which AF_ALG is used
+  * @param hdl      (void*) AF_ALG handle from eax_ctx.afalg
+  * @retval         (unsigned long) Threshold length
+  */
+unsigned long afalg_threshold(void* hdl);
+
+
+/** @brief eax_encrypt_message() and eax_decrypt_message() via AF_ALG
+  * @param iv       (const io_t*) Initialization vector.
+  * @param msg      (io_t*) Message data, in place, followed by tag
+  * @param msg_len  (unsigned long) Number of bytes in length, for msg
+  * @param ctx      (eax_ctx) Mode context, with AF_ALG attached.
+  * @retval         (ret_type) Same as eax_encrypt_message() and
+  *                 eax_decrypt_message(), respectively.
+  *
+  * The nonce OMAC is computed in software by eax_init_message(), the CTR
+  * stage goes to ctr(aes) and the ciphertext OMAC goes to cmac(aes).
+  */
+ret_type afalg_eax_encrypt(const io_t* iv, io_t* msg, unsigned long msg_len, eax_ctx ctx[1]);
+ret_type afalg_eax_decrypt(const io_t* iv, io_t* msg, unsigned long msg_len, eax_ctx ctx[1]);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
+
+#endif
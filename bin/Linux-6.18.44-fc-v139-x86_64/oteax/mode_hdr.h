@@ -0,0 +1,606 @@
+/*
+---------------------------------------------------------------------------
+Copyright (c) 1998-2010, Brian Gladman, Worcester, UK. All rights reserved.
+
+The redistribution and use of this software (with or without changes)
+is allowed without the payment of fees or royalties provided that:
+
+  source code distributions include the above copyright notice, this
+  list of conditions and the following disclaimer;
+
+  binary distributions include the above copyright notice, this list
+  of conditions and the following disclaimer in their documentation.
+
+This software is provided 'as is' with no explicit or implied warranties
+in respect of its operation, including, but not limited to, correctness
+and fitness for purpose.
+---------------------------------------------------------------------------
+Issue Date: 07/10/2010
+
+This header file is an INTERNAL file which supports mode implementation
+*/
+
+#ifndef _MODE_HDR_H
+#define _MODE_HDR_H
+
+#include <limits.h>
+#include "brg_endian.h"
+
+
+#define oteax_memcpy    memcpy
+#define oteax_memset    memset
+
+#if (defined(__OPENTAG__) || defined(__opentag__) || defined(__LIBOTFS__))
+#   include <platform/config.h>
+#   include <otlib/memcpy.h>
+
+#   if (defined(__STM32__) || defined(_STM32x_))
+//#       include <cm3_endian.h>
+//#       include <cm3_byteswap.h>
+//#       include <cm3_bitrotate.h>
+#       define rotl32           __rotl32
+#       define rotr32           __rotr32
+#       define rotl16           __rotr
+#       define bswap_16(x)      __bswap16(x)
+#       define bswap_32(x)      __bswap32(x)
+#       define bswap_64(x)      __bswap64(x)
+#       define NET_ENDIAN32(W)  bswap_32(W)
+#   endif
+
+#   if defined(__C2000__)
+#       undef  oteax_memcpy
+#       undef  oteax_memset
+#       define oteax_memcpy(DST, SRC, SIZE) memcpy(DST, SRC, ((SIZE)+1)>>1 )
+#       define oteax_memset(DST, VAL, SIZE) memset(DST, VAL, ((SIZE)+1)>>1 )
+#   endif
+
+#else
+#   include <string.h>
+#   if defined(__C2000__)
+#       undef  oteax_memcpy
+#       undef  oteax_memset
+#       define oteax_memcpy(DST, SRC, SIZE) memcpy(DST, SRC, ((SIZE)+1)>>1 )
+#       define oteax_memset(DST, VAL, SIZE) memset(DST, VAL, ((SIZE)+1)>>1 )
+#   endif
+
+#endif
+
+
+
+#if defined(__C2000__)
+    ///@note there is no C2000 instruction for swapping bytes.
+    ///@todo make sure endianness isn't totally fucked by 16bit bytes.
+#   define NET_ENDIAN32(W)  ((((uint32_t)(W)>>24)&0xFF)|(((uint32_t)(W)>>8)&0xFF00)|(((uint32_t)(W)<<8)&0xFF0000)|(((uint32_t)(W)<<24)&0xFF000000))
+
+#elif (PLATFORM_BYTE_ORDER == IS_LITTLE_ENDIAN)
+    ///@todo potentially include byteswap.h or similar
+//#   include <byteswap.h>
+#   define NET_ENDIAN32(W)  ((((uint32_t)(W)>>24)&0xFF)|(((uint32_t)(W)>>8)&0xFF00)|(((uint32_t)(W)<<8)&0xFF0000)|(((uint32_t)(W)<<24)&0xFF000000))
+
+#else 
+#   define NET_ENDIAN32(W)  (W)
+#endif
+
+
+
+/*  This define sets the units in which buffers are processed.  This code
+    can provide significant speed gains if buffers can be processed in
+    32 or 64 bit chunks rather than in bytes.  This define sets the units
+    in which buffers will be accessed if possible
+*/
+
+///@note hack to force C2000 to use 32 bit data elements
+#if defined(__C2000__)
+#   undef UINT_BITS
+#   define UINT_BITS    32
+#endif
+
+#if !defined( UINT_BITS )
+#   if (PLATFORM_BYTE_ORDER == IS_BIG_ENDIAN)
+#       if 0
+#           define UINT_BITS  32
+#       elif 1
+#           define UINT_BITS  64
+#       endif
+#   elif defined( _WIN64 )
+#       define UINT_BITS 64
+#   else
+#       define UINT_BITS 32
+#   endif
+#endif
+
+#if UINT_BITS == 64 && !defined( NEED_UINT_64T )
+#  define NEED_UINT_64T
+#endif
+
+#include "brg_types.h"
+
+/*  Use of inlines is preferred but code blocks can also be expanded inline
+    using 'defines'.  But the latter approach will typically generate a LOT
+    of code and is not recommended. 
+*/
+#if 1 && !defined( USE_INLINING )
+#   define USE_INLINING
+#endif
+
+#if defined( _MSC_VER )
+#   if _MSC_VER >= 1400
+#       include <stdlib.h>
+#       include <intrin.h>
+#       pragma intrinsic(memset)
+#       pragma intrinsic(memcpy)
+#       define rotl32        _rotl
+#       define rotr32        _rotr
+#       define rotl64        _rotl64
+#       define rotr64        _rotl64
+#       define bswap_16(x)   _byteswap_ushort(x)
+#       define bswap_32(x)   _byteswap_ulong(x)
+#       define bswap_64(x)   _byteswap_uint64(x)
+#   else
+#       define rotl32 _lrotl
+#       define rotr32 _lrotr
+#   endif
+#endif
+
+#if defined( USE_INLINING )
+#   if defined( _MSC_VER )
+#       define mh_decl __inline
+#   elif defined( __GNUC__ ) || defined( __GNU_LIBRARY__ )
+#       define mh_decl static inline
+#   else
+#       define mh_decl static
+#   endif
+#endif
+
+#if defined(__cplusplus)
+    extern "C" {
+#endif
+
+
+#define  UI8_PTR(x)     UPTR_CAST(x,  8)
+#define UI16_PTR(x)     UPTR_CAST(x, 16)
+#define UI32_PTR(x)     UPTR_CAST(x, 32)
+#define UI64_PTR(x)     UPTR_CAST(x, 64)
+#define UINT_PTR(x)     UPTR_CAST(x, UINT_BITS)
+#if defined(__ALIGN32__)
+#   define IO_PTR(x)    UPTR_CAST(x, 32)
+#else
+#   define IO_PTR(x)    UPTR_CAST(x, 8)
+#endif
+
+#define  UI8_VAL(x)     UINT_CAST(x,  8)
+#define UI16_VAL(x)     UINT_CAST(x, 16)
+#define UI32_VAL(x)     UINT_CAST(x, 32)
+#define UI64_VAL(x)     UINT_CAST(x, 64)
+#define UINT_VAL(x)     UINT_CAST(x, UINT_BITS)
+
+#define BUF_INC          (UINT_BITS >> 3)
+#define BUF_ADRMASK     ((UINT_BITS >> 3) - 1)
+
+#define rep2_u2(f,r,x)    f( 0,r,x); f( 1,r,x) 
+#define rep2_u4(f,r,x)    f( 0,r,x); f( 1,r,x); f( 2,r,x); f( 3,r,x) 
+#define rep2_u16(f,r,x)   f( 0,r,x); f( 1,r,x); f( 2,r,x); f( 3,r,x); \
+                          f( 4,r,x); f( 5,r,x); f( 6,r,x); f( 7,r,x); \
+                          f( 8,r,x); f( 9,r,x); f(10,r,x); f(11,r,x); \
+                          f(12,r,x); f(13,r,x); f(14,r,x); f(15,r,x)
+
+#define rep2_d2(f,r,x)    f( 1,r,x); f( 0,r,x) 
+#define rep2_d4(f,r,x)    f( 3,r,x); f( 2,r,x); f( 1,r,x); f( 0,r,x) 
+#define rep2_d16(f,r,x)   f(15,r,x); f(14,r,x); f(13,r,x); f(12,r,x); \
+                          f(11,r,x); f(10,r,x); f( 9,r,x); f( 8,r,x); \
+                          f( 7,r,x); f( 6,r,x); f( 5,r,x); f( 4,r,x); \
+                          f( 3,r,x); f( 2,r,x); f( 1,r,x); f( 0,r,x)
+
+#define rep3_u2(f,r,x,y,c)  f( 0,r,x,y,c); f( 1,r,x,y,c) 
+#define rep3_u4(f,r,x,y,c)  f( 0,r,x,y,c); f( 1,r,x,y,c); f( 2,r,x,y,c); f( 3,r,x,y,c) 
+#define rep3_u16(f,r,x,y,c) f( 0,r,x,y,c); f( 1,r,x,y,c); f( 2,r,x,y,c); f( 3,r,x,y,c); \
+                            f( 4,r,x,y,c); f( 5,r,x,y,c); f( 6,r,x,y,c); f( 7,r,x,y,c); \
+                            f( 8,r,x,y,c); f( 9,r,x,y,c); f(10,r,x,y,c); f(11,r,x,y,c); \
+                            f(12,r,x,y,c); f(13,r,x,y,c); f(14,r,x,y,c); f(15,r,x,y,c)
+
+#define rep3_d2(f,r,x,y,c)  f( 1,r,x,y,c); f( 0,r,x,y,c) 
+#define rep3_d4(f,r,x,y,c)  f( 3,r,x,y,c); f( 2,r,x,y,c); f( 1,r,x,y,c); f( 0,r,x,y,c) 
+#define rep3_d16(f,r,x,y,c) f(15,r,x,y,c); f(14,r,x,y,c); f(13,r,x,y,c); f(12,r,x,y,c); \
+                            f(11,r,x,y,c); f(10,r,x,y,c); f( 9,r,x,y,c); f( 8,r,x,y,c); \
+                            f( 7,r,x,y,c); f( 6,r,x,y,c); f( 5,r,x,y,c); f( 4,r,x,y,c); \
+                            f( 3,r,x,y,c); f( 2,r,x,y,c); f( 1,r,x,y,c); f( 0,r,x,y,c)
+
+/* function pointers might be used for fast XOR operations */
+
+typedef void (*xor_function)(void* r, const void* p, const void* q);
+
+
+
+
+/* left and right rotates on 32 and 64 bit variables */
+///@todo put these in ARM inline assembly
+
+#if !defined( rotl32 )  /* NOTE: 0 <= n <= 32 ASSUMED */
+mh_decl uint_32t rotl32(uint_32t x, int n) {
+    return (((x) << n) | ((x) >> (32 - n)));
+}
+#endif
+
+
+#if !defined( rotr32 )  /* NOTE: 0 <= n <= 32 ASSUMED */
+mh_decl uint_32t rotr32(uint_32t x, int n) {
+    return (((x) >> n) | ((x) << (32 - n)));
+}
+#endif
+
+
+#if UINT_BITS == 64 && !defined( rotl64 )  /* NOTE: 0 <= n <= 64 ASSUMED */
+mh_decl uint_64t rotl64(uint_64t x, int n) {
+    return (((x) << n) | ((x) >> (64 - n)));
+}
+#endif
+
+
+#if UINT_BITS == 64 && !defined( rotr64 )  /* NOTE: 0 <= n <= 64 ASSUMED */
+mh_decl uint_64t rotr64(uint_64t x, int n) {
+    return (((x) >> n) | ((x) << (64 - n)));
+}
+#endif
+
+
+
+
+/* byte order inversions for 16, 32 and 64 bit variables */
+///@todo put these in ARM inline assembly
+
+#if !defined(bswap_16)
+mh_decl uint_16t bswap_16(uint_16t x) {
+    return (uint_16t)((x >> 8) | (x << 8));
+}
+#endif
+
+
+#if !defined(bswap_32)
+//#error "This should not be compiled with OpenTag"
+mh_decl uint_32t bswap_32(uint_32t x) {
+    return ((rotr32((x), 24) & 0x00ff00ff) | (rotr32((x), 8) & 0xff00ff00));
+}
+#endif
+
+
+#if UINT_BITS == 64 && !defined(bswap_64)
+mh_decl uint_64t bswap_64(uint_64t x) {   
+    return bswap_32((uint_32t)(x >> 32)) | ((uint_64t)bswap_32((uint_32t)x) << 32);
+}
+#endif
+
+
+
+/* support for fast aligned buffer move, xor and byte swap operations - 
+   source and destination buffers for move and xor operations must not 
+   overlap, those for byte order revesal must either not overlap or
+   must be identical
+*/
+
+#define f_copy(n,p,q)     p[n] = q[n]
+#define f_xor(n,r,p,q,c)  r[n] = c(p[n] ^ q[n])
+
+/*  Where the target has 128 bit vectors (SSE2 on x86, NEON on ARM) the
+    block operations use them, with unaligned loads and stores, so the
+    "aligned" versions are the same as the others.  Byte builds with 64 bit
+    words, or with __UNALIGNED_ACCESS__ (see brg_endian.h), otherwise go
+    through memcpy(), which compilers turn into plain unaligned loads.
+*/
+#if defined(__SSE2__) && !defined(__C2000__)
+#   include <emmintrin.h>
+#   define MH_SSE2
+#   define mh_load128(p)        _mm_loadu_si128((const __m128i*)(p))
+#   define mh_store128(p, v)    _mm_storeu_si128((__m128i*)(p), v)
+#   define mh_xor128(a, b)      _mm_xor_si128(a, b)
+#elif defined(__ARM_NEON) && !defined(__C2000__)
+#   include <arm_neon.h>
+#   define MH_NEON
+#   define mh_load128(p)        vld1q_u8((const uint8_t*)(p))
+#   define mh_store128(p, v)    vst1q_u8((uint8_t*)(p), v)
+#   define mh_xor128(a, b)      veorq_u8(a, b)
+#endif
+
+#if defined(mh_load128)
+#   define MH_SIMD128
+#endif
+
+#if defined(__UNALIGNED_ACCESS__)
+mh_decl uint_32t mh_load32(const void* p) {
+    uint_32t v;
+    oteax_memcpy(&v, p, 4);
+    return v;
+}
+
+mh_decl void mh_store32(void* p, uint_32t v) {
+    oteax_memcpy(p, &v, 4);
+}
+#endif
+
+#if UINT_BITS == 64
+mh_decl uint_64t mh_load64(const void* p) {
+    uint_64t v;
+    oteax_memcpy(&v, p, 8);
+    return v;
+}
+
+mh_decl void mh_store64(void* p, uint_64t v) {
+    oteax_memcpy(p, &v, 8);
+}
+#endif
+
+
+
+mh_decl void copy_block(void* p, const void* q) {
+#if defined(MH_SIMD128)
+    mh_store128(p, mh_load128(q));
+#else
+    oteax_memcpy(p, q, 16);
+#endif
+}
+
+
+
+mh_decl void copy_block_aligned(void *p, const void *q) {
+#if defined(MH_SIMD128)
+    mh_store128(p, mh_load128(q));
+#elif UINT_BITS == 8
+    oteax_memcpy(p, q, 16);
+#elif UINT_BITS == 32
+    rep2_u4(f_copy,UINT_PTR(p),UINT_PTR(q));
+#else
+    rep2_u2(f_copy,UINT_PTR(p),UINT_PTR(q));
+#endif
+}
+
+
+
+
+mh_decl void xor_block(void *r, const void* p, const void* q) {
+#if defined(MH_SIMD128)
+    mh_store128(r, mh_xor128(mh_load128(p), mh_load128(q)));
+#elif UINT_BITS == 64
+    mh_store64(UI8_PTR(r),   mh_load64(UI8_PTR(p))   ^ mh_load64(UI8_PTR(q)));
+    mh_store64(UI8_PTR(r)+8, mh_load64(UI8_PTR(p)+8) ^ mh_load64(UI8_PTR(q)+8));
+#else
+    rep3_u16(f_xor, UI8_PTR(r), UI8_PTR(p), UI8_PTR(q), UI8_VAL);
+#endif
+}
+
+
+
+
+mh_decl void xor_block_aligned(void *r, const void *p, const void *q) {
+#if defined(MH_SIMD128)
+    mh_store128(r, mh_xor128(mh_load128(p), mh_load128(q)));
+#elif UINT_BITS == 8
+    rep3_u16(f_xor, UINT_PTR(r), UINT_PTR(p), UINT_PTR(q), UINT_VAL);
+#elif UINT_BITS == 32
+    rep3_u4(f_xor, UINT_PTR(r), UINT_PTR(p), UINT_PTR(q), UINT_VAL);
+#else
+    rep3_u2(f_xor, UINT_PTR(r), UINT_PTR(p), UINT_PTR(q), UINT_VAL);
+#endif
+}
+
+
+
+
+/* Tag comparison, in constant time: bit i of the result is set when
+   a[i] == b[i], for i < n <= 32.  Four tags at a time where there is SIMD.
+*/
+mh_decl uint_32t tag_mask(const uint_32t* a, const uint_32t* b, unsigned int n) {
+    uint_32t        mask    = 0;
+    unsigned int    i       = 0;
+
+#if defined(MH_SSE2)
+    for (; (i+4) <= n; i+=4) {
+        __m128i eq = _mm_cmpeq_epi32(mh_load128(&a[i]), mh_load128(&b[i]));
+        mask |= (uint_32t)_mm_movemask_ps(_mm_castsi128_ps(eq)) << i;
+    }
+#elif defined(MH_NEON) && defined(__aarch64__)
+    static const uint32_t lane_bit[4] = { 1, 2, 4, 8 };
+    for (; (i+4) <= n; i+=4) {
+        uint32x4_t eq = vceqq_u32(vld1q_u32(&a[i]), vld1q_u32(&b[i]));
+        mask |= vaddvq_u32(vandq_u32(eq, vld1q_u32(lane_bit))) << i;
+    }
+#endif
+    for (; i<n; i++) {
+        uint_32t d = a[i] ^ b[i];
+        mask |= (((d | (0u - d)) >> 31) ^ 1) << i;
+    }
+    return mask;
+}
+
+
+
+
+/* r = p ^ q over n bytes, with no alignment required of any of them */
+mh_decl void xor_bytes(void* r, const void* p, const void* q, unsigned long n) {
+    uint_8t* rr = (uint_8t*)r;
+    const uint_8t* pp = (const uint_8t*)p;
+    const uint_8t* qq = (const uint_8t*)q;
+
+#if defined(MH_SIMD128)
+    for (; n >= 16; n -= 16, rr += 16, pp += 16, qq += 16) {
+        mh_store128(rr, mh_xor128(mh_load128(pp), mh_load128(qq)));
+    }
+#endif
+#if UINT_BITS == 64
+    for (; n >= 8; n -= 8, rr += 8, pp += 8, qq += 8) {
+        mh_store64(rr, mh_load64(pp) ^ mh_load64(qq));
+    }
+#elif defined(__UNALIGNED_ACCESS__)
+    for (; n >= 4; n -= 4, rr += 4, pp += 4, qq += 4) {
+        mh_store32(rr, mh_load32(pp) ^ mh_load32(qq));
+    }
+#endif
+    while (n-- != 0) {
+        *rr++ = *pp++ ^ *qq++;
+    }
+}
+
+
+
+
+/* byte swap within 32-bit words in a 16 byte block; don't move 32-bit words */
+mh_decl void bswap32_block(void *d, const void* s) {
+#if UINT_BITS == 8
+    uint_8t t;
+    t = UINT_PTR(s)[ 0]; UINT_PTR(d)[ 0] = UINT_PTR(s)[ 3]; UINT_PTR(d)[ 3] = t;
+    t = UINT_PTR(s)[ 1]; UINT_PTR(d)[ 1] = UINT_PTR(s)[ 2]; UINT_PTR(d)[ 2] = t;
+    t = UINT_PTR(s)[ 4]; UINT_PTR(d)[ 4] = UINT_PTR(s)[ 7]; UINT_PTR(d)[ 7] = t;
+    t = UINT_PTR(s)[ 5]; UINT_PTR(d)[ 5] = UINT_PTR(s)[ 6]; UINT_PTR(d) [6] = t;
+    t = UINT_PTR(s)[ 8]; UINT_PTR(d)[ 8] = UINT_PTR(s)[11]; UINT_PTR(d)[12] = t;
+    t = UINT_PTR(s)[ 9]; UINT_PTR(d)[ 9] = UINT_PTR(s)[10]; UINT_PTR(d)[10] = t;
+    t = UINT_PTR(s)[12]; UINT_PTR(d)[12] = UINT_PTR(s)[15]; UINT_PTR(d)[15] = t;
+    t = UINT_PTR(s)[13]; UINT_PTR(d)[ 3] = UINT_PTR(s)[14]; UINT_PTR(d)[14] = t;
+#elif UINT_BITS == 32
+    UINT_PTR(d)[0] = bswap_32(UINT_PTR(s)[0]); UINT_PTR(d)[1] = bswap_32(UINT_PTR(s)[1]);
+    UINT_PTR(d)[2] = bswap_32(UINT_PTR(s)[2]); UINT_PTR(d)[3] = bswap_32(UINT_PTR(s)[3]);
+#else
+    UI32_PTR(d)[0] = bswap_32(UI32_PTR(s)[0]); UI32_PTR(d)[1] = bswap_32(UI32_PTR(s)[1]);
+    UI32_PTR(d)[2] = bswap_32(UI32_PTR(s)[2]); UI32_PTR(d)[3] = bswap_32(UI32_PTR(s)[3]);
+#endif
+}
+
+
+
+
+/* byte swap within 64-bit words in a 16 byte block; don't move 64-bit words */
+mh_decl void bswap64_block(void *d, const void* s) {
+#if UINT_BITS == 8
+    uint_8t t;
+    t = UINT_PTR(s)[ 0]; UINT_PTR(d)[ 0] = UINT_PTR(s)[ 7]; UINT_PTR(d)[ 7] = t;
+    t = UINT_PTR(s)[ 1]; UINT_PTR(d)[ 1] = UINT_PTR(s)[ 6]; UINT_PTR(d)[ 6] = t;
+    t = UINT_PTR(s)[ 2]; UINT_PTR(d)[ 2] = UINT_PTR(s)[ 5]; UINT_PTR(d)[ 5] = t;
+    t = UINT_PTR(s)[ 3]; UINT_PTR(d)[ 3] = UINT_PTR(s)[ 3]; UINT_PTR(d) [3] = t;
+    t = UINT_PTR(s)[ 8]; UINT_PTR(d)[ 8] = UINT_PTR(s)[15]; UINT_PTR(d)[15] = t;
+    t = UINT_PTR(s)[ 9]; UINT_PTR(d)[ 9] = UINT_PTR(s)[14]; UINT_PTR(d)[14] = t;
+    t = UINT_PTR(s)[10]; UINT_PTR(d)[10] = UINT_PTR(s)[13]; UINT_PTR(d)[13] = t;
+    t = UINT_PTR(s)[11]; UINT_PTR(d)[11] = UINT_PTR(s)[12]; UINT_PTR(d)[12] = t;
+#elif UINT_BITS == 32
+    uint_32t t;
+    t = bswap_32(UINT_PTR(s)[0]); UINT_PTR(d)[0] = bswap_32(UINT_PTR(s)[1]); UINT_PTR(d)[1] = t;
+    t = bswap_32(UINT_PTR(s)[2]); UINT_PTR(d)[2] = bswap_32(UINT_PTR(s)[2]); UINT_PTR(d)[3] = t;
+#else
+    UINT_PTR(d)[0] = bswap_64(UINT_PTR(s)[0]);  UINT_PTR(d)[1] = bswap_64(UINT_PTR(s)[1]); 
+#endif
+}
+
+
+
+
+mh_decl void bswap128_block(void *d, const void* s) {
+#if UINT_BITS == 8
+    uint_8t t;
+    t = UINT_PTR(s)[0]; UINT_PTR(d)[0] = UINT_PTR(s)[15]; UINT_PTR(d)[15] = t;
+    t = UINT_PTR(s)[1]; UINT_PTR(d)[1] = UINT_PTR(s)[14]; UINT_PTR(d)[14] = t;
+    t = UINT_PTR(s)[2]; UINT_PTR(d)[2] = UINT_PTR(s)[13]; UINT_PTR(d)[13] = t;
+    t = UINT_PTR(s)[3]; UINT_PTR(d)[3] = UINT_PTR(s)[12]; UINT_PTR(d)[12] = t;
+    t = UINT_PTR(s)[4]; UINT_PTR(d)[4] = UINT_PTR(s)[11]; UINT_PTR(d)[11] = t;
+    t = UINT_PTR(s)[5]; UINT_PTR(d)[5] = UINT_PTR(s)[10]; UINT_PTR(d)[10] = t;
+    t = UINT_PTR(s)[6]; UINT_PTR(d)[6] = UINT_PTR(s)[ 9]; UINT_PTR(d)[ 9] = t;
+    t = UINT_PTR(s)[7]; UINT_PTR(d)[7] = UINT_PTR(s)[ 8]; UINT_PTR(d)[ 8] = t;
+#elif UINT_BITS == 32
+    uint_32t t;
+    t = bswap_32(UINT_PTR(s)[0]); UINT_PTR(d)[0] = bswap_32(UINT_PTR(s)[3]); UINT_PTR(d)[3] = t;
+    t = bswap_32(UINT_PTR(s)[1]); UINT_PTR(d)[1] = bswap_32(UINT_PTR(s)[2]); UINT_PTR(d)[2] = t;
+#else
+    uint_64t t;
+    t = bswap_64(UINT_PTR(s)[0]); UINT_PTR(d)[0] = bswap_64(UINT_PTR(s)[1]); UINT_PTR(d)[1] = t;
+#endif
+}
+
+
+
+
+/* platform byte order to big or little endian order for 16, 32 and 64 bit variables */
+
+#if PLATFORM_BYTE_ORDER == IS_BIG_ENDIAN
+#   define uint_16t_to_le(x) (x) = bswap_16((x))
+#   define uint_32t_to_le(x) (x) = bswap_32((x))
+#   define uint_64t_to_le(x) (x) = bswap_64((x))
+#   define uint_16t_to_be(x)
+#   define uint_32t_to_be(x)
+#   define uint_64t_to_be(x)
+
+#else
+#   define uint_16t_to_le(x)
+#   define uint_32t_to_le(x)
+#   define uint_64t_to_le(x)
+#   define uint_16t_to_be(x) (x) = bswap_16((x))
+#   define uint_32t_to_be(x) (x) = bswap_32((x))
+#   define uint_64t_to_be(x) (x) = bswap_64((x))
+
+#endif
+
+
+
+
+/* big-endian increment and decrement of a 16 byte counter block */
+
+///@note In __ALIGN32__ builds the counter is four words that hold the
+///      big-endian bytes.  inc_ctr() steps the last byte in place, where
+///      NET_ENDIAN32(1) is 1 in that byte read as a host word, and only a
+///      carry out of it (1 in 256) goes through the byte-swapped add.
+#if defined(__ALIGN32__)
+#   define inc_ctr(x)  \
+    do {    \
+        if ((x[3] & NET_ENDIAN32(0xFF)) != NET_ENDIAN32(0xFF)) {    \
+            x[3] += NET_ENDIAN32(1);    \
+        }   \
+        else {  \
+            int zz; \
+            for (zz=3; zz>=0; zz--) {   \
+                x[zz] = NET_ENDIAN32((NET_ENDIAN32(x[zz]) + 1));    \
+                if (x[zz] != 0) \
+                    break;   \
+            }   \
+        }   \
+    } while (0)
+
+#   define dec_ctr(x)  \
+    do {    \
+        int zz; \
+        for (zz=3; zz>=0; zz--) {   \
+            if (x[zz] != 0) \
+                break;   \
+            x[zz] = NET_ENDIAN32((NET_ENDIAN32(x[zz]) - 1));    \
+        }   \
+    } while (0)
+        
+#elif defined(__C2000__)
+#   define inc_ctr(x)   do {    \
+                            int i; \
+                            for (i=16-1; i>=0; i--) {      \
+                                __byte((int*)x, i) += 1;            \
+                                if ( __byte((int*)x, i) == 0 ) {    \
+                                    break;                          \
+                                }                                   \
+                            }   \
+                        } while (0)
+
+#   define dec_ctr(x)   do {    \
+                            int i;  \
+                            for (i=16-1; i>=0; i--) {      \
+                                if ( __byte((int*)x, i) == 0 ) {    \
+                                    break;                          \
+                                }                                   \
+                                __byte((int*)x, i) -= 1;            \
+                            }   \
+                        } while (0)
+                        
+#else
+#   define inc_ctr(x)  \
+        {   int i = 16; while(i-- > 0 && !++(UI8_PTR(x)[i])) ; }
+#   define dec_ctr(x)  \
+        {   int i = 16; while(i-- > 0 && !(UI8_PTR(x)[i])--) ; }
+#endif
+
+
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
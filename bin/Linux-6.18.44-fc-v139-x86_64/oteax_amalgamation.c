@@ -0,0 +1,5686 @@
+/* oteax_amalgamation.c: OTEAX 1.2.0, generated by make amalgamation */
+#define OTEAX_AMALGAMATION
+#if !defined(OTEAX_NO_DISPATCH)
+#   define OTEAX_NO_DISPATCH
+#endif
+#line 1 "main/aestab.c"
+/*
+---------------------------------------------------------------------------
+Copyright (c) 1998-2010, Brian Gladman, Worcester, UK. All rights reserved.
+
+The redistribution and use of this software (with or without changes)
+is allowed without the payment of fees or royalties provided that:
+
+  source code distributions include the above copyright notice, this
+  list of conditions and the following disclaimer;
+
+  binary distributions include the above copyright notice, this list
+  of conditions and the following disclaimer in their documentation.
+
+This software is provided 'as is' with no explicit or implied warranties
+in respect of its operation, including, but not limited to, correctness
+and fitness for purpose.
+---------------------------------------------------------------------------
+Issue Date: 20/12/2007
+*/
+
+#define DO_TABLES
+
+#include "oteax/aes.h"
+#include "oteax/aesopt.h"
+
+///@note For MCU usage, you want to make sure to use FIXED_TABLES
+#if defined(FIXED_TABLES)
+
+#define sb_data(w) {\
+    w(0x63), w(0x7c), w(0x77), w(0x7b), w(0xf2), w(0x6b), w(0x6f), w(0xc5),\
+    w(0x30), w(0x01), w(0x67), w(0x2b), w(0xfe), w(0xd7), w(0xab), w(0x76),\
+    w(0xca), w(0x82), w(0xc9), w(0x7d), w(0xfa), w(0x59), w(0x47), w(0xf0),\
+    w(0xad), w(0xd4), w(0xa2), w(0xaf), w(0x9c), w(0xa4), w(0x72), w(0xc0),\
+    w(0xb7), w(0xfd), w(0x93), w(0x26), w(0x36), w(0x3f), w(0xf7), w(0xcc),\
+    w(0x34), w(0xa5), w(0xe5), w(0xf1), w(0x71), w(0xd8), w(0x31), w(0x15),\
+    w(0x04), w(0xc7), w(0x23), w(0xc3), w(0x18), w(0x96), w(0x05), w(0x9a),\
+    w(0x07), w(0x12), w(0x80), w(0xe2), w(0xeb), w(0x27), w(0xb2), w(0x75),\
+    w(0x09), w(0x83), w(0x2c), w(0x1a), w(0x1b), w(0x6e), w(0x5a), w(0xa0),\
+    w(0x52), w(0x3b), w(0xd6), w(0xb3), w(0x29), w(0xe3), w(0x2f), w(0x84),\
+    w(0x53), w(0xd1), w(0x00), w(0xed), w(0x20), w(0xfc), w(0xb1), w(0x5b),\
+    w(0x6a), w(0xcb), w(0xbe), w(0x39), w(0x4a), w(0x4c), w(0x58), w(0xcf),\
+    w(0xd0), w(0xef), w(0xaa), w(0xfb), w(0x43), w(0x4d), w(0x33), w(0x85),\
+    w(0x45), w(0xf9), w(0x02), w(0x7f), w(0x50), w(0x3c), w(0x9f), w(0xa8),\
+    w(0x51), w(0xa3), w(0x40), w(0x8f), w(0x92), w(0x9d), w(0x38), w(0xf5),\
+    w(0xbc), w(0xb6), w(0xda), w(0x21), w(0x10), w(0xff), w(0xf3), w(0xd2),\
+    w(0xcd), w(0x0c), w(0x13), w(0xec), w(0x5f), w(0x97), w(0x44), w(0x17),\
+    w(0xc4), w(0xa7), w(0x7e), w(0x3d), w(0x64), w(0x5d), w(0x19), w(0x73),\
+    w(0x60), w(0x81), w(0x4f), w(0xdc), w(0x22), w(0x2a), w(0x90), w(0x88),\
+    w(0x46), w(0xee), w(0xb8), w(0x14), w(0xde), w(0x5e), w(0x0b), w(0xdb),\
+    w(0xe0), w(0x32), w(0x3a), w(0x0a), w(0x49), w(0x06), w(0x24), w(0x5c),\
+    w(0xc2), w(0xd3), w(0xac), w(0x62), w(0x91), w(0x95), w(0xe4), w(0x79),\
+    w(0xe7), w(0xc8), w(0x37), w(0x6d), w(0x8d), w(0xd5), w(0x4e), w(0xa9),\
+    w(0x6c), w(0x56), w(0xf4), w(0xea), w(0x65), w(0x7a), w(0xae), w(0x08),\
+    w(0xba), w(0x78), w(0x25), w(0x2e), w(0x1c), w(0xa6), w(0xb4), w(0xc6),\
+    w(0xe8), w(0xdd), w(0x74), w(0x1f), w(0x4b), w(0xbd), w(0x8b), w(0x8a),\
+    w(0x70), w(0x3e), w(0xb5), w(0x66), w(0x48), w(0x03), w(0xf6), w(0x0e),\
+    w(0x61), w(0x35), w(0x57), w(0xb9), w(0x86), w(0xc1), w(0x1d), w(0x9e),\
+    w(0xe1), w(0xf8), w(0x98), w(0x11), w(0x69), w(0xd9), w(0x8e), w(0x94),\
+    w(0x9b), w(0x1e), w(0x87), w(0xe9), w(0xce), w(0x55), w(0x28), w(0xdf),\
+    w(0x8c), w(0xa1), w(0x89), w(0x0d), w(0xbf), w(0xe6), w(0x42), w(0x68),\
+    w(0x41), w(0x99), w(0x2d), w(0x0f), w(0xb0), w(0x54), w(0xbb), w(0x16) }
+
+#define isb_data(w) {\
+    w(0x52), w(0x09), w(0x6a), w(0xd5), w(0x30), w(0x36), w(0xa5), w(0x38),\
+    w(0xbf), w(0x40), w(0xa3), w(0x9e), w(0x81), w(0xf3), w(0xd7), w(0xfb),\
+    w(0x7c), w(0xe3), w(0x39), w(0x82), w(0x9b), w(0x2f), w(0xff), w(0x87),\
+    w(0x34), w(0x8e), w(0x43), w(0x44), w(0xc4), w(0xde), w(0xe9), w(0xcb),\
+    w(0x54), w(0x7b), w(0x94), w(0x32), w(0xa6), w(0xc2), w(0x23), w(0x3d),\
+    w(0xee), w(0x4c), w(0x95), w(0x0b), w(0x42), w(0xfa), w(0xc3), w(0x4e),\
+    w(0x08), w(0x2e), w(0xa1), w(0x66), w(0x28), w(0xd9), w(0x24), w(0xb2),\
+    w(0x76), w(0x5b), w(0xa2), w(0x49), w(0x6d), w(0x8b), w(0xd1), w(0x25),\
+    w(0x72), w(0xf8), w(0xf6), w(0x64), w(0x86), w(0x68), w(0x98), w(0x16),\
+    w(0xd4), w(0xa4), w(0x5c), w(0xcc), w(0x5d), w(0x65), w(0xb6), w(0x92),\
+    w(0x6c), w(0x70), w(0x48), w(0x50), w(0xfd), w(0xed), w(0xb9), w(0xda),\
+    w(0x5e), w(0x15), w(0x46), w(0x57), w(0xa7), w(0x8d), w(0x9d), w(0x84),\
+    w(0x90), w(0xd8), w(0xab), w(0x00), w(0x8c), w(0xbc), w(0xd3), w(0x0a),\
+    w(0xf7), w(0xe4), w(0x58), w(0x05), w(0xb8), w(0xb3), w(0x45), w(0x06),\
+    w(0xd0), w(0x2c), w(0x1e), w(0x8f), w(0xca), w(0x3f), w(0x0f), w(0x02),\
+    w(0xc1), w(0xaf), w(0xbd), w(0x03), w(0x01), w(0x13), w(0x8a), w(0x6b),\
+    w(0x3a), w(0x91), w(0x11), w(0x41), w(0x4f), w(0x67), w(0xdc), w(0xea),\
+    w(0x97), w(0xf2), w(0xcf), w(0xce), w(0xf0), w(0xb4), w(0xe6), w(0x73),\
+    w(0x96), w(0xac), w(0x74), w(0x22), w(0xe7), w(0xad), w(0x35), w(0x85),\
+    w(0xe2), w(0xf9), w(0x37), w(0xe8), w(0x1c), w(0x75), w(0xdf), w(0x6e),\
+    w(0x47), w(0xf1), w(0x1a), w(0x71), w(0x1d), w(0x29), w(0xc5), w(0x89),\
+    w(0x6f), w(0xb7), w(0x62), w(0x0e), w(0xaa), w(0x18), w(0xbe), w(0x1b),\
+    w(0xfc), w(0x56), w(0x3e), w(0x4b), w(0xc6), w(0xd2), w(0x79), w(0x20),\
+    w(0x9a), w(0xdb), w(0xc0), w(0xfe), w(0x78), w(0xcd), w(0x5a), w(0xf4),\
+    w(0x1f), w(0xdd), w(0xa8), w(0x33), w(0x88), w(0x07), w(0xc7), w(0x31),\
+    w(0xb1), w(0x12), w(0x10), w(0x59), w(0x27), w(0x80), w(0xec), w(0x5f),\
+    w(0x60), w(0x51), w(0x7f), w(0xa9), w(0x19), w(0xb5), w(0x4a), w(0x0d),\
+    w(0x2d), w(0xe5), w(0x7a), w(0x9f), w(0x93), w(0xc9), w(0x9c), w(0xef),\
+    w(0xa0), w(0xe0), w(0x3b), w(0x4d), w(0xae), w(0x2a), w(0xf5), w(0xb0),\
+    w(0xc8), w(0xeb), w(0xbb), w(0x3c), w(0x83), w(0x53), w(0x99), w(0x61),\
+    w(0x17), w(0x2b), w(0x04), w(0x7e), w(0xba), w(0x77), w(0xd6), w(0x26),\
+    w(0xe1), w(0x69), w(0x14), w(0x63), w(0x55), w(0x21), w(0x0c), w(0x7d) }
+
+#define mm_data(w) {\
+    w(0x00), w(0x01), w(0x02), w(0x03), w(0x04), w(0x05), w(0x06), w(0x07),\
+    w(0x08), w(0x09), w(0x0a), w(0x0b), w(0x0c), w(0x0d), w(0x0e), w(0x0f),\
+    w(0x10), w(0x11), w(0x12), w(0x13), w(0x14), w(0x15), w(0x16), w(0x17),\
+    w(0x18), w(0x19), w(0x1a), w(0x1b), w(0x1c), w(0x1d), w(0x1e), w(0x1f),\
+    w(0x20), w(0x21), w(0x22), w(0x23), w(0x24), w(0x25), w(0x26), w(0x27),\
+    w(0x28), w(0x29), w(0x2a), w(0x2b), w(0x2c), w(0x2d), w(0x2e), w(0x2f),\
+    w(0x30), w(0x31), w(0x32), w(0x33), w(0x34), w(0x35), w(0x36), w(0x37),\
+    w(0x38), w(0x39), w(0x3a), w(0x3b), w(0x3c), w(0x3d), w(0x3e), w(0x3f),\
+    w(0x40), w(0x41), w(0x42), w(0x43), w(0x44), w(0x45), w(0x46), w(0x47),\
+    w(0x48), w(0x49), w(0x4a), w(0x4b), w(0x4c), w(0x4d), w(0x4e), w(0x4f),\
+    w(0x50), w(0x51), w(0x52), w(0x53), w(0x54), w(0x55), w(0x56), w(0x57),\
+    w(0x58), w(0x59), w(0x5a), w(0x5b), w(0x5c), w(0x5d), w(0x5e), w(0x5f),\
+    w(0x60), w(0x61), w(0x62), w(0x63), w(0x64), w(0x65), w(0x66), w(0x67),\
+    w(0x68), w(0x69), w(0x6a), w(0x6b), w(0x6c), w(0x6d), w(0x6e), w(0x6f),\
+    w(0x70), w(0x71), w(0x72), w(0x73), w(0x74), w(0x75), w(0x76), w(0x77),\
+    w(0x78), w(0x79), w(0x7a), w(0x7b), w(0x7c), w(0x7d), w(0x7e), w(0x7f),\
+    w(0x80), w(0x81), w(0x82), w(0x83), w(0x84), w(0x85), w(0x86), w(0x87),\
+    w(0x88), w(0x89), w(0x8a), w(0x8b), w(0x8c), w(0x8d), w(0x8e), w(0x8f),\
+    w(0x90), w(0x91), w(0x92), w(0x93), w(0x94), w(0x95), w(0x96), w(0x97),\
+    w(0x98), w(0x99), w(0x9a), w(0x9b), w(0x9c), w(0x9d), w(0x9e), w(0x9f),\
+    w(0xa0), w(0xa1), w(0xa2), w(0xa3), w(0xa4), w(0xa5), w(0xa6), w(0xa7),\
+    w(0xa8), w(0xa9), w(0xaa), w(0xab), w(0xac), w(0xad), w(0xae), w(0xaf),\
+    w(0xb0), w(0xb1), w(0xb2), w(0xb3), w(0xb4), w(0xb5), w(0xb6), w(0xb7),\
+    w(0xb8), w(0xb9), w(0xba), w(0xbb), w(0xbc), w(0xbd), w(0xbe), w(0xbf),\
+    w(0xc0), w(0xc1), w(0xc2), w(0xc3), w(0xc4), w(0xc5), w(0xc6), w(0xc7),\
+    w(0xc8), w(0xc9), w(0xca), w(0xcb), w(0xcc), w(0xcd), w(0xce), w(0xcf),\
+    w(0xd0), w(0xd1), w(0xd2), w(0xd3), w(0xd4), w(0xd5), w(0xd6), w(0xd7),\
+    w(0xd8), w(0xd9), w(0xda), w(0xdb), w(0xdc), w(0xdd), w(0xde), w(0xdf),\
+    w(0xe0), w(0xe1), w(0xe2), w(0xe3), w(0xe4), w(0xe5), w(0xe6), w(0xe7),\
+    w(0xe8), w(0xe9), w(0xea), w(0xeb), w(0xec), w(0xed), w(0xee), w(0xef),\
+    w(0xf0), w(0xf1), w(0xf2), w(0xf3), w(0xf4), w(0xf5), w(0xf6), w(0xf7),\
+    w(0xf8), w(0xf9), w(0xfa), w(0xfb), w(0xfc), w(0xfd), w(0xfe), w(0xff) }
+
+#define rc_data(w) {\
+    w(0x01), w(0x02), w(0x04), w(0x08), w(0x10),w(0x20), w(0x40), w(0x80),\
+    w(0x1b), w(0x36) }
+
+#define h0(x)   (x)
+
+#define w0(p)   bytes2word(p, 0, 0, 0)
+#define w1(p)   bytes2word(0, p, 0, 0)
+#define w2(p)   bytes2word(0, 0, p, 0)
+#define w3(p)   bytes2word(0, 0, 0, p)
+
+#define u0(p)   bytes2word(f2(p), p, p, f3(p))
+#define u1(p)   bytes2word(f3(p), f2(p), p, p)
+#define u2(p)   bytes2word(p, f3(p), f2(p), p)
+#define u3(p)   bytes2word(p, p, f3(p), f2(p))
+
+#define v0(p)   bytes2word(fe(p), f9(p), fd(p), fb(p))
+#define v1(p)   bytes2word(fb(p), fe(p), f9(p), fd(p))
+#define v2(p)   bytes2word(fd(p), fb(p), fe(p), f9(p))
+#define v3(p)   bytes2word(f9(p), fd(p), fb(p), fe(p))
+
+#endif
+
+#if defined(FIXED_TABLES) || !defined(FF_TABLES)
+
+#define f2(x)   ((x<<1) ^ (((x>>7) & 1) * WPOLY))
+#define f4(x)   ((x<<2) ^ (((x>>6) & 1) * WPOLY) ^ (((x>>6) & 2) * WPOLY))
+#define f8(x)   ((x<<3) ^ (((x>>5) & 1) * WPOLY) ^ (((x>>5) & 2) * WPOLY) \
+                        ^ (((x>>5) & 4) * WPOLY))
+#define f3(x)   (f2(x) ^ x)
+#define f9(x)   (f8(x) ^ x)
+#define fb(x)   (f8(x) ^ f2(x) ^ x)
+#define fd(x)   (f8(x) ^ f4(x) ^ x)
+#define fe(x)   (f8(x) ^ f4(x) ^ f2(x))
+
+#else
+
+#define f2(x) ((x) ? pow[log[x] + 0x19] : 0)
+#define f3(x) ((x) ? pow[log[x] + 0x01] : 0)
+#define f9(x) ((x) ? pow[log[x] + 0xc7] : 0)
+#define fb(x) ((x) ? pow[log[x] + 0x68] : 0)
+#define fd(x) ((x) ? pow[log[x] + 0xee] : 0)
+#define fe(x) ((x) ? pow[log[x] + 0xdf] : 0)
+
+#endif
+
+#include "oteax/aestab.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#if defined(FIXED_TABLES)
+
+/* implemented in case of wrong call for fixed tables */
+
+#if !defined(AES_KERNEL_TU)
+AES_RETURN aes_init(void)
+{
+    return EXIT_SUCCESS;
+}
+#endif
+
+#else   /*  Generate the tables for the dynamic table option */
+
+#if defined(FF_TABLES)
+
+#define gf_inv(x)   ((x) ? pow[ 255 - log[x]] : 0)
+
+#else 
+
+/*  It will generally be sensible to use tables to compute finite
+    field multiplies and inverses but where memory is scarse this
+    code might sometimes be better. But it only has effect during
+    initialisation so its pretty unimportant in overall terms.
+*/
+
+/*  return 2 ^ (n - 1) where n is the bit number of the highest bit
+    set in x with x in the range 1 < x < 0x00000200.   This form is
+    used so that locals within fi can be bytes rather than words
+*/
+
+static uint_8t hibit(const uint_32t x)
+{   uint_8t r = (uint_8t)((x >> 1) | (x >> 2));
+
+    r |= (r >> 2);
+    r |= (r >> 4);
+    return (r + 1) >> 1;
+}
+
+/* return the inverse of the finite field element x */
+
+static uint_8t gf_inv(const uint_8t x)
+{   uint_8t p1 = x, p2 = BPOLY, n1 = hibit(x), n2 = 0x80, v1 = 1, v2 = 0;
+
+    if(x < 2) 
+        return x;
+
+    for( ; ; )
+    {
+        if(n1)
+            while(n2 >= n1)             /* divide polynomial p2 by p1    */
+            {
+                n2 /= n1;               /* shift smaller polynomial left */ 
+                p2 ^= (p1 * n2) & 0xff; /* and remove from larger one    */
+                v2 ^= v1 * n2;          /* shift accumulated value and   */ 
+                n2 = hibit(p2);         /* add into result               */
+            }
+        else
+            return v1;
+
+        if(n2)                          /* repeat with values swapped    */ 
+            while(n1 >= n2)
+            {
+                n1 /= n2; 
+                p1 ^= p2 * n1; 
+                v1 ^= v2 * n1; 
+                n1 = hibit(p1);
+            }
+        else
+            return v2;
+    }
+}
+
+#endif
+
+/* The forward and inverse affine transformations used in the S-box */
+uint_8t fwd_affine(const uint_8t x)
+{   uint_32t w = x;
+    w ^= (w << 1) ^ (w << 2) ^ (w << 3) ^ (w << 4);
+    return 0x63 ^ ((w ^ (w >> 8)) & 0xff);
+}
+
+uint_8t inv_affine(const uint_8t x)
+{   uint_32t w = x;
+    w = (w << 1) ^ (w << 3) ^ (w << 6);
+    return 0x05 ^ ((w ^ (w >> 8)) & 0xff);
+}
+
+static int init = 0;
+
+AES_RETURN aes_init(void)
+{   uint_32t  i, w;
+
+#if defined(FF_TABLES)
+
+    uint_8t  pow[512], log[256];
+
+    if(init)
+        return EXIT_SUCCESS;
+    /*  log and power tables for GF(2^8) finite field with
+        WPOLY as modular polynomial - the simplest primitive
+        root is 0x03, used here to generate the tables
+    */
+
+    i = 0; w = 1;
+    do
+    {
+        pow[i] = (uint_8t)w;
+        pow[i + 255] = (uint_8t)w;
+        log[w] = (uint_8t)i++;
+        w ^=  (w << 1) ^ (w & 0x80 ? WPOLY : 0);
+    }
+    while (w != 1);
+
+#else
+    if(init)
+        return EXIT_SUCCESS;
+#endif
+
+    for(i = 0, w = 1; i < RC_LENGTH; ++i)
+    {
+        t_set(r,c)[i] = bytes2word(w, 0, 0, 0);
+        w = f2(w);
+    }
+
+    for(i = 0; i < 256; ++i)
+    {   uint_8t    b;
+
+        b = fwd_affine(gf_inv((uint_8t)i));
+        w = bytes2word(f2(b), b, b, f3(b));
+
+#if defined( SBX_SET )
+        t_set(s,box)[i] = b;
+#endif
+
+#if defined( FT1_SET )                 /* tables for a normal encryption round */
+        t_set(f,n)[i] = w;
+#endif
+#if defined( FT4_SET )
+        t_set(f,n)[0][i] = w;
+        t_set(f,n)[1][i] = upr(w,1);
+        t_set(f,n)[2][i] = upr(w,2);
+        t_set(f,n)[3][i] = upr(w,3);
+#endif
+        w = bytes2word(b, 0, 0, 0);
+
+#if defined( FL1_SET )            /* tables for last encryption round (may also   */
+        t_set(f,l)[i] = w;        /* be used in the key schedule)                 */
+#endif
+#if defined( FL4_SET )
+        t_set(f,l)[0][i] = w;
+        t_set(f,l)[1][i] = upr(w,1);
+        t_set(f,l)[2][i] = upr(w,2);
+        t_set(f,l)[3][i] = upr(w,3);
+#endif
+
+#if defined( LS1_SET )			/* table for key schedule if t_set(f,l) above is*/
+        t_set(l,s)[i] = w;      /* not of the required form                     */
+#endif
+#if defined( LS4_SET )
+        t_set(l,s)[0][i] = w;
+        t_set(l,s)[1][i] = upr(w,1);
+        t_set(l,s)[2][i] = upr(w,2);
+        t_set(l,s)[3][i] = upr(w,3);
+#endif
+
+        b = gf_inv(inv_affine((uint_8t)i));
+        w = bytes2word(fe(b), f9(b), fd(b), fb(b));
+
+#if defined( IM1_SET )			/* tables for the inverse mix column operation  */
+        t_set(i,m)[b] = w;
+#endif
+#if defined( IM4_SET )
+        t_set(i,m)[0][b] = w;
+        t_set(i,m)[1][b] = upr(w,1);
+        t_set(i,m)[2][b] = upr(w,2);
+        t_set(i,m)[3][b] = upr(w,3);
+#endif
+
+#if defined( ISB_SET )
+        t_set(i,box)[i] = b;
+#endif
+#if defined( IT1_SET )			/* tables for a normal decryption round */
+        t_set(i,n)[i] = w;
+#endif
+#if defined( IT4_SET )
+        t_set(i,n)[0][i] = w;
+        t_set(i,n)[1][i] = upr(w,1);
+        t_set(i,n)[2][i] = upr(w,2);
+        t_set(i,n)[3][i] = upr(w,3);
+#endif
+        w = bytes2word(b, 0, 0, 0);
+#if defined( IL1_SET )			/* tables for last decryption round */
+        t_set(i,l)[i] = w;
+#endif
+#if defined( IL4_SET )
+        t_set(i,l)[0][i] = w;
+        t_set(i,l)[1][i] = upr(w,1);
+        t_set(i,l)[2][i] = upr(w,2);
+        t_set(i,l)[3][i] = upr(w,3);
+#endif
+    }
+    init = 1;
+    return EXIT_SUCCESS;
+}
+
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+
+#line 1 "main/aeskey.c"
+/*
+---------------------------------------------------------------------------
+Copyright (c) 1998-2010, Brian Gladman, Worcester, UK. All rights reserved.
+
+The redistribution and use of this software (with or without changes)
+is allowed without the payment of fees or royalties provided that:
+
+  source code distributions include the above copyright notice, this
+  list of conditions and the following disclaimer;
+
+  binary distributions include the above copyright notice, this list
+  of conditions and the following disclaimer in their documentation.
+
+This software is provided 'as is' with no explicit or implied warranties
+in respect of its operation, including, but not limited to, correctness
+and fitness for purpose.
+---------------------------------------------------------------------------
+Issue Date: 20/12/2007
+*/
+
+#include "oteax/aesopt.h"
+#include "oteax/aestab.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/* Initialise the key schedule from the user supplied key. The key
+   length can be specified in bytes, with legal values of 16, 24
+   and 32, or in bits, with legal values of 128, 192 and 256. These
+   values correspond with Nk values of 4, 6 and 8 respectively.
+
+   The following macros implement a single cycle in the key
+   schedule generation process. The number of cycles needed
+   for each cx->n_col and nk value is:
+
+    nk =             4  5  6  7  8
+    ------------------------------
+    cx->n_col = 4   10  9  8  7  7
+    cx->n_col = 5   14 11 10  9  9
+    cx->n_col = 6   19 15 12 11 11
+    cx->n_col = 7   21 19 16 13 14
+    cx->n_col = 8   29 23 19 17 14
+*/
+
+#if defined( REDUCE_CODE_SIZE )
+#   define ls_box ls_sub
+        uint_32t ls_sub(const uint_32t t, const uint_32t n);
+#   define inv_mcol im_sub
+        uint_32t im_sub(const uint_32t x);
+#   ifdef ENC_KS_UNROLL
+#       undef ENC_KS_UNROLL
+#   endif
+#   ifdef DEC_KS_UNROLL
+#       undef DEC_KS_UNROLL
+#   endif
+#endif
+
+#if (FUNCS_IN_C & ENC_KEYING_IN_C)
+
+#if defined(AES_128) || defined( AES_VAR )
+
+#define ke4(k,i) \
+{   k[4*(i)+4] = ss[0] ^= ls_box(ss[3],3) ^ t_use(r,c)[i]; \
+    k[4*(i)+5] = ss[1] ^= ss[0]; \
+    k[4*(i)+6] = ss[2] ^= ss[1]; \
+    k[4*(i)+7] = ss[3] ^= ss[2]; \
+}
+
+#if defined(__OTF_KEYSCHED__)
+///@note With on-the-fly key scheduling, only the cipher key is stored.  The
+///      round keys are derived by aes_encrypt() as it runs each round.
+AES_RETURN aes_encrypt_key128(const io_t *key, aes_encrypt_ctx cx[1]) {
+    cx->ks[0] = word_in(key, 0);
+    cx->ks[1] = word_in(key, 1);
+    cx->ks[2] = word_in(key, 2);
+    cx->ks[3] = word_in(key, 3);
+    cx->inf.l = 0;
+    INF_B(cx->inf,0) = 10 * 16;
+
+    return EXIT_SUCCESS;
+}
+
+#else
+AES_RETURN aes_encrypt_key128(const io_t *key, aes_encrypt_ctx cx[1]) {   
+    uint_32t    ss[4];
+
+    cx->ks[0] = ss[0] = word_in(key, 0);
+    cx->ks[1] = ss[1] = word_in(key, 1);
+    cx->ks[2] = ss[2] = word_in(key, 2);
+    cx->ks[3] = ss[3] = word_in(key, 3);
+
+#ifdef ENC_KS_UNROLL
+    ke4(cx->ks, 0);
+    ke4(cx->ks, 1);
+    ke4(cx->ks, 2);  
+    ke4(cx->ks, 3);
+    ke4(cx->ks, 4);  
+    ke4(cx->ks, 5);
+    ke4(cx->ks, 6);  
+    ke4(cx->ks, 7);
+    ke4(cx->ks, 8);
+#else
+    {   uint_32t i;
+        for(i = 0; i < 9; ++i)
+            ke4(cx->ks, i);
+    }
+#endif
+    ke4(cx->ks, 9);
+    cx->inf.l = 0;
+    ///@note [JPN] changing inf access to support INF macro
+    //cx->inf.b[0] = 10 * 16;
+    INF_B(cx->inf,0) = 10 * 16;
+
+    return EXIT_SUCCESS;
+}
+#endif
+
+#endif
+
+
+
+
+#if defined(AES_192) || defined( AES_VAR )
+
+#define kef6(k,i) \
+{   k[6*(i)+ 6] = ss[0] ^= ls_box(ss[5],3) ^ t_use(r,c)[i]; \
+    k[6*(i)+ 7] = ss[1] ^= ss[0]; \
+    k[6*(i)+ 8] = ss[2] ^= ss[1]; \
+    k[6*(i)+ 9] = ss[3] ^= ss[2]; \
+}
+
+#define ke6(k,i) \
+{   kef6(k,i); \
+    k[6*(i)+10] = ss[4] ^= ss[3]; \
+    k[6*(i)+11] = ss[5] ^= ss[4]; \
+}
+
+AES_RETURN aes_encrypt_key192(const io_t *key, aes_encrypt_ctx cx[1])
+{   uint_32t    ss[6];
+
+    cx->ks[0] = ss[0] = word_in(key, 0);
+    cx->ks[1] = ss[1] = word_in(key, 1);
+    cx->ks[2] = ss[2] = word_in(key, 2);
+    cx->ks[3] = ss[3] = word_in(key, 3);
+    cx->ks[4] = ss[4] = word_in(key, 4);
+    cx->ks[5] = ss[5] = word_in(key, 5);
+
+#ifdef ENC_KS_UNROLL
+    ke6(cx->ks, 0);  ke6(cx->ks, 1);
+    ke6(cx->ks, 2);  ke6(cx->ks, 3);
+    ke6(cx->ks, 4);  ke6(cx->ks, 5);
+    ke6(cx->ks, 6);
+#else
+    {   uint_32t i;
+        for(i = 0; i < 7; ++i)
+            ke6(cx->ks, i);
+    }
+#endif
+    kef6(cx->ks, 7);
+    cx->inf.l = 0;
+    ///@note [JPN] changing inf access to support INF macro
+    //cx->inf.b[0] = 12 * 16;
+    INF_B(cx->inf,0) = 12*16;
+
+    return EXIT_SUCCESS;
+}
+
+#endif
+
+#if defined(AES_256) || defined( AES_VAR )
+
+#define kef8(k,i) \
+{   k[8*(i)+ 8] = ss[0] ^= ls_box(ss[7],3) ^ t_use(r,c)[i]; \
+    k[8*(i)+ 9] = ss[1] ^= ss[0]; \
+    k[8*(i)+10] = ss[2] ^= ss[1]; \
+    k[8*(i)+11] = ss[3] ^= ss[2]; \
+}
+
+#define ke8(k,i) \
+{   kef8(k,i); \
+    k[8*(i)+12] = ss[4] ^= ls_box(ss[3],0); \
+    k[8*(i)+13] = ss[5] ^= ss[4]; \
+    k[8*(i)+14] = ss[6] ^= ss[5]; \
+    k[8*(i)+15] = ss[7] ^= ss[6]; \
+}
+
+AES_RETURN aes_encrypt_key256(const io_t *key, aes_encrypt_ctx cx[1])
+{   uint_32t    ss[8];
+
+    cx->ks[0] = ss[0] = word_in(key, 0);
+    cx->ks[1] = ss[1] = word_in(key, 1);
+    cx->ks[2] = ss[2] = word_in(key, 2);
+    cx->ks[3] = ss[3] = word_in(key, 3);
+    cx->ks[4] = ss[4] = word_in(key, 4);
+    cx->ks[5] = ss[5] = word_in(key, 5);
+    cx->ks[6] = ss[6] = word_in(key, 6);
+    cx->ks[7] = ss[7] = word_in(key, 7);
+
+#ifdef ENC_KS_UNROLL
+    ke8(cx->ks, 0); ke8(cx->ks, 1);
+    ke8(cx->ks, 2); ke8(cx->ks, 3);
+    ke8(cx->ks, 4); ke8(cx->ks, 5);
+#else
+    {   uint_32t i;
+        for(i = 0; i < 6; ++i)
+            ke8(cx->ks,  i);
+    }
+#endif
+    kef8(cx->ks, 6);
+    cx->inf.l = 0;
+    ///@note [JPN] changing inf access to support INF macro
+    //cx->inf.b[0] = 14 * 16;
+    INF_B(cx->inf,0) = 14 * 16;
+
+    return EXIT_SUCCESS;
+}
+
+#endif
+
+#if defined( AES_VAR )
+
+AES_RETURN aes_encrypt_key(const io_t *key, int key_len, aes_encrypt_ctx cx[1])
+{   
+    switch(key_len)
+    {
+    case 16: case 128: return aes_encrypt_key128(key, cx);
+    case 24: case 192: return aes_encrypt_key192(key, cx);
+    case 32: case 256: return aes_encrypt_key256(key, cx);
+    default: return EXIT_FAILURE;
+    }
+}
+
+#endif
+
+#endif
+
+#if (FUNCS_IN_C & DEC_KEYING_IN_C)
+
+/* this is used to store the decryption round keys  */
+/* in forward or reverse order                      */
+
+#ifdef AES_REV_DKS
+#define v(n,i)  ((n) - (i) + 2 * ((i) & 3))
+#else
+#define v(n,i)  (i)
+#endif
+
+#if DEC_ROUND == NO_TABLES
+#define ff(x)   (x)
+#else
+#define ff(x)   inv_mcol(x)
+#if defined( dec_imvars )
+#define d_vars  dec_imvars
+#endif
+#endif
+
+#if defined(AES_128) || defined( AES_VAR )
+
+#define k4e(k,i) \
+{   k[v(40,(4*(i))+4)] = ss[0] ^= ls_box(ss[3],3) ^ t_use(r,c)[i]; \
+    k[v(40,(4*(i))+5)] = ss[1] ^= ss[0]; \
+    k[v(40,(4*(i))+6)] = ss[2] ^= ss[1]; \
+    k[v(40,(4*(i))+7)] = ss[3] ^= ss[2]; \
+}
+
+#if 1
+
+#define kdf4(k,i) \
+{   ss[0] = ss[0] ^ ss[2] ^ ss[1] ^ ss[3]; \
+    ss[1] = ss[1] ^ ss[3]; \
+    ss[2] = ss[2] ^ ss[3]; \
+    ss[4] = ls_box(ss[(i+3) % 4], 3) ^ t_use(r,c)[i]; \
+    ss[i % 4] ^= ss[4]; \
+    ss[4] ^= k[v(40,(4*(i)))];   k[v(40,(4*(i))+4)] = ff(ss[4]); \
+    ss[4] ^= k[v(40,(4*(i))+1)]; k[v(40,(4*(i))+5)] = ff(ss[4]); \
+    ss[4] ^= k[v(40,(4*(i))+2)]; k[v(40,(4*(i))+6)] = ff(ss[4]); \
+    ss[4] ^= k[v(40,(4*(i))+3)]; k[v(40,(4*(i))+7)] = ff(ss[4]); \
+}
+
+#define kd4(k,i) \
+{   ss[4] = ls_box(ss[(i+3) % 4], 3) ^ t_use(r,c)[i]; \
+    ss[i % 4] ^= ss[4]; ss[4] = ff(ss[4]); \
+    k[v(40,(4*(i))+4)] = ss[4] ^= k[v(40,(4*(i)))]; \
+    k[v(40,(4*(i))+5)] = ss[4] ^= k[v(40,(4*(i))+1)]; \
+    k[v(40,(4*(i))+6)] = ss[4] ^= k[v(40,(4*(i))+2)]; \
+    k[v(40,(4*(i))+7)] = ss[4] ^= k[v(40,(4*(i))+3)]; \
+}
+
+#define kdl4(k,i) \
+{   ss[4] = ls_box(ss[(i+3) % 4], 3) ^ t_use(r,c)[i]; ss[i % 4] ^= ss[4]; \
+    k[v(40,(4*(i))+4)] = (ss[0] ^= ss[1]) ^ ss[2] ^ ss[3]; \
+    k[v(40,(4*(i))+5)] = ss[1] ^ ss[3]; \
+    k[v(40,(4*(i))+6)] = ss[0]; \
+    k[v(40,(4*(i))+7)] = ss[1]; \
+}
+
+#else
+
+#define kdf4(k,i) \
+{   ss[0] ^= ls_box(ss[3],3) ^ t_use(r,c)[i]; k[v(40,(4*(i))+ 4)] = ff(ss[0]); \
+    ss[1] ^= ss[0]; k[v(40,(4*(i))+ 5)] = ff(ss[1]); \
+    ss[2] ^= ss[1]; k[v(40,(4*(i))+ 6)] = ff(ss[2]); \
+    ss[3] ^= ss[2]; k[v(40,(4*(i))+ 7)] = ff(ss[3]); \
+}
+
+#define kd4(k,i) \
+{   ss[4] = ls_box(ss[3],3) ^ t_use(r,c)[i]; \
+    ss[0] ^= ss[4]; ss[4] = ff(ss[4]); k[v(40,(4*(i))+ 4)] = ss[4] ^= k[v(40,(4*(i)))]; \
+    ss[1] ^= ss[0]; k[v(40,(4*(i))+ 5)] = ss[4] ^= k[v(40,(4*(i))+ 1)]; \
+    ss[2] ^= ss[1]; k[v(40,(4*(i))+ 6)] = ss[4] ^= k[v(40,(4*(i))+ 2)]; \
+    ss[3] ^= ss[2]; k[v(40,(4*(i))+ 7)] = ss[4] ^= k[v(40,(4*(i))+ 3)]; \
+}
+
+#define kdl4(k,i) \
+{   ss[0] ^= ls_box(ss[3],3) ^ t_use(r,c)[i]; k[v(40,(4*(i))+ 4)] = ss[0]; \
+    ss[1] ^= ss[0]; k[v(40,(4*(i))+ 5)] = ss[1]; \
+    ss[2] ^= ss[1]; k[v(40,(4*(i))+ 6)] = ss[2]; \
+    ss[3] ^= ss[2]; k[v(40,(4*(i))+ 7)] = ss[3]; \
+}
+
+#endif
+
+AES_RETURN aes_decrypt_key128(const io_t *key, aes_decrypt_ctx cx[1])
+{   uint_32t    ss[5];
+#if defined( d_vars )
+        d_vars;
+#endif
+    cx->ks[v(40,(0))] = ss[0] = word_in(key, 0);
+    cx->ks[v(40,(1))] = ss[1] = word_in(key, 1);
+    cx->ks[v(40,(2))] = ss[2] = word_in(key, 2);
+    cx->ks[v(40,(3))] = ss[3] = word_in(key, 3);
+
+#ifdef DEC_KS_UNROLL
+     kdf4(cx->ks, 0); kd4(cx->ks, 1);
+     kd4(cx->ks, 2);  kd4(cx->ks, 3);
+     kd4(cx->ks, 4);  kd4(cx->ks, 5);
+     kd4(cx->ks, 6);  kd4(cx->ks, 7);
+     kd4(cx->ks, 8);  kdl4(cx->ks, 9);
+#else
+    {   uint_32t i;
+        for(i = 0; i < 10; ++i)
+            k4e(cx->ks, i);
+#if !(DEC_ROUND == NO_TABLES)
+        for(i = N_COLS; i < 10 * N_COLS; ++i)
+            cx->ks[i] = inv_mcol(cx->ks[i]);
+#endif
+    }
+#endif
+    cx->inf.l = 0;
+    ///@note [JPN] changing inf access to support INF macro
+    //cx->inf.b[0] = 10 * 16;
+    INF_B(cx->inf,0) = 10 * 16;
+
+    return EXIT_SUCCESS;
+}
+
+#endif
+
+#if defined(AES_192) || defined( AES_VAR )
+
+#define k6ef(k,i) \
+{   k[v(48,(6*(i))+ 6)] = ss[0] ^= ls_box(ss[5],3) ^ t_use(r,c)[i]; \
+    k[v(48,(6*(i))+ 7)] = ss[1] ^= ss[0]; \
+    k[v(48,(6*(i))+ 8)] = ss[2] ^= ss[1]; \
+    k[v(48,(6*(i))+ 9)] = ss[3] ^= ss[2]; \
+}
+
+#define k6e(k,i) \
+{   k6ef(k,i); \
+    k[v(48,(6*(i))+10)] = ss[4] ^= ss[3]; \
+    k[v(48,(6*(i))+11)] = ss[5] ^= ss[4]; \
+}
+
+#define kdf6(k,i) \
+{   ss[0] ^= ls_box(ss[5],3) ^ t_use(r,c)[i]; k[v(48,(6*(i))+ 6)] = ff(ss[0]); \
+    ss[1] ^= ss[0]; k[v(48,(6*(i))+ 7)] = ff(ss[1]); \
+    ss[2] ^= ss[1]; k[v(48,(6*(i))+ 8)] = ff(ss[2]); \
+    ss[3] ^= ss[2]; k[v(48,(6*(i))+ 9)] = ff(ss[3]); \
+    ss[4] ^= ss[3]; k[v(48,(6*(i))+10)] = ff(ss[4]); \
+    ss[5] ^= ss[4]; k[v(48,(6*(i))+11)] = ff(ss[5]); \
+}
+
+#define kd6(k,i) \
+{   ss[6] = ls_box(ss[5],3) ^ t_use(r,c)[i]; \
+    ss[0] ^= ss[6]; ss[6] = ff(ss[6]); k[v(48,(6*(i))+ 6)] = ss[6] ^= k[v(48,(6*(i)))]; \
+    ss[1] ^= ss[0]; k[v(48,(6*(i))+ 7)] = ss[6] ^= k[v(48,(6*(i))+ 1)]; \
+    ss[2] ^= ss[1]; k[v(48,(6*(i))+ 8)] = ss[6] ^= k[v(48,(6*(i))+ 2)]; \
+    ss[3] ^= ss[2]; k[v(48,(6*(i))+ 9)] = ss[6] ^= k[v(48,(6*(i))+ 3)]; \
+    ss[4] ^= ss[3]; k[v(48,(6*(i))+10)] = ss[6] ^= k[v(48,(6*(i))+ 4)]; \
+    ss[5] ^= ss[4]; k[v(48,(6*(i))+11)] = ss[6] ^= k[v(48,(6*(i))+ 5)]; \
+}
+
+#define kdl6(k,i) \
+{   ss[0] ^= ls_box(ss[5],3) ^ t_use(r,c)[i]; k[v(48,(6*(i))+ 6)] = ss[0]; \
+    ss[1] ^= ss[0]; k[v(48,(6*(i))+ 7)] = ss[1]; \
+    ss[2] ^= ss[1]; k[v(48,(6*(i))+ 8)] = ss[2]; \
+    ss[3] ^= ss[2]; k[v(48,(6*(i))+ 9)] = ss[3]; \
+}
+
+AES_RETURN aes_decrypt_key192(const io_t *key, aes_decrypt_ctx cx[1])
+{   uint_32t    ss[7];
+#if defined( d_vars )
+        d_vars;
+#endif
+    cx->ks[v(48,(0))] = ss[0] = word_in(key, 0);
+    cx->ks[v(48,(1))] = ss[1] = word_in(key, 1);
+    cx->ks[v(48,(2))] = ss[2] = word_in(key, 2);
+    cx->ks[v(48,(3))] = ss[3] = word_in(key, 3);
+
+#ifdef DEC_KS_UNROLL
+    cx->ks[v(48,(4))] = ff(ss[4] = word_in(key, 4));
+    cx->ks[v(48,(5))] = ff(ss[5] = word_in(key, 5));
+    kdf6(cx->ks, 0); kd6(cx->ks, 1);
+    kd6(cx->ks, 2);  kd6(cx->ks, 3);
+    kd6(cx->ks, 4);  kd6(cx->ks, 5);
+    kd6(cx->ks, 6);  kdl6(cx->ks, 7);
+#else
+    cx->ks[v(48,(4))] = ss[4] = word_in(key, 4);
+    cx->ks[v(48,(5))] = ss[5] = word_in(key, 5);
+    {   uint_32t i;
+
+        for(i = 0; i < 7; ++i)
+            k6e(cx->ks, i);
+        k6ef(cx->ks, 7);
+#if !(DEC_ROUND == NO_TABLES)
+        for(i = N_COLS; i < 12 * N_COLS; ++i)
+            cx->ks[i] = inv_mcol(cx->ks[i]);
+#endif
+    }
+#endif
+    cx->inf.l = 0;
+    ///@note [JPN] changing inf access to support INF macro
+    //cx->inf.b[0] = 12 * 16;
+    INF_B(cx->inf,0) = 12 * 16;
+
+    return EXIT_SUCCESS;
+}
+
+#endif
+
+#if defined(AES_256) || defined( AES_VAR )
+
+#define k8ef(k,i) \
+{   k[v(56,(8*(i))+ 8)] = ss[0] ^= ls_box(ss[7],3) ^ t_use(r,c)[i]; \
+    k[v(56,(8*(i))+ 9)] = ss[1] ^= ss[0]; \
+    k[v(56,(8*(i))+10)] = ss[2] ^= ss[1]; \
+    k[v(56,(8*(i))+11)] = ss[3] ^= ss[2]; \
+}
+
+#define k8e(k,i) \
+{   k8ef(k,i); \
+    k[v(56,(8*(i))+12)] = ss[4] ^= ls_box(ss[3],0); \
+    k[v(56,(8*(i))+13)] = ss[5] ^= ss[4]; \
+    k[v(56,(8*(i))+14)] = ss[6] ^= ss[5]; \
+    k[v(56,(8*(i))+15)] = ss[7] ^= ss[6]; \
+}
+
+#define kdf8(k,i) \
+{   ss[0] ^= ls_box(ss[7],3) ^ t_use(r,c)[i]; k[v(56,(8*(i))+ 8)] = ff(ss[0]); \
+    ss[1] ^= ss[0]; k[v(56,(8*(i))+ 9)] = ff(ss[1]); \
+    ss[2] ^= ss[1]; k[v(56,(8*(i))+10)] = ff(ss[2]); \
+    ss[3] ^= ss[2]; k[v(56,(8*(i))+11)] = ff(ss[3]); \
+    ss[4] ^= ls_box(ss[3],0); k[v(56,(8*(i))+12)] = ff(ss[4]); \
+    ss[5] ^= ss[4]; k[v(56,(8*(i))+13)] = ff(ss[5]); \
+    ss[6] ^= ss[5]; k[v(56,(8*(i))+14)] = ff(ss[6]); \
+    ss[7] ^= ss[6]; k[v(56,(8*(i))+15)] = ff(ss[7]); \
+}
+
+#define kd8(k,i) \
+{   ss[8] = ls_box(ss[7],3) ^ t_use(r,c)[i]; \
+    ss[0] ^= ss[8]; ss[8] = ff(ss[8]); k[v(56,(8*(i))+ 8)] = ss[8] ^= k[v(56,(8*(i)))]; \
+    ss[1] ^= ss[0]; k[v(56,(8*(i))+ 9)] = ss[8] ^= k[v(56,(8*(i))+ 1)]; \
+    ss[2] ^= ss[1]; k[v(56,(8*(i))+10)] = ss[8] ^= k[v(56,(8*(i))+ 2)]; \
+    ss[3] ^= ss[2]; k[v(56,(8*(i))+11)] = ss[8] ^= k[v(56,(8*(i))+ 3)]; \
+    ss[8] = ls_box(ss[3],0); \
+    ss[4] ^= ss[8]; ss[8] = ff(ss[8]); k[v(56,(8*(i))+12)] = ss[8] ^= k[v(56,(8*(i))+ 4)]; \
+    ss[5] ^= ss[4]; k[v(56,(8*(i))+13)] = ss[8] ^= k[v(56,(8*(i))+ 5)]; \
+    ss[6] ^= ss[5]; k[v(56,(8*(i))+14)] = ss[8] ^= k[v(56,(8*(i))+ 6)]; \
+    ss[7] ^= ss[6]; k[v(56,(8*(i))+15)] = ss[8] ^= k[v(56,(8*(i))+ 7)]; \
+}
+
+#define kdl8(k,i) \
+{   ss[0] ^= ls_box(ss[7],3) ^ t_use(r,c)[i]; k[v(56,(8*(i))+ 8)] = ss[0]; \
+    ss[1] ^= ss[0]; k[v(56,(8*(i))+ 9)] = ss[1]; \
+    ss[2] ^= ss[1]; k[v(56,(8*(i))+10)] = ss[2]; \
+    ss[3] ^= ss[2]; k[v(56,(8*(i))+11)] = ss[3]; \
+}
+
+AES_RETURN aes_decrypt_key256(const io_t *key, aes_decrypt_ctx cx[1])
+{   uint_32t    ss[9];
+#if defined( d_vars )
+        d_vars;
+#endif
+    cx->ks[v(56,(0))] = ss[0] = word_in(key, 0);
+    cx->ks[v(56,(1))] = ss[1] = word_in(key, 1);
+    cx->ks[v(56,(2))] = ss[2] = word_in(key, 2);
+    cx->ks[v(56,(3))] = ss[3] = word_in(key, 3);
+
+#ifdef DEC_KS_UNROLL
+    cx->ks[v(56,(4))] = ff(ss[4] = word_in(key, 4));
+    cx->ks[v(56,(5))] = ff(ss[5] = word_in(key, 5));
+    cx->ks[v(56,(6))] = ff(ss[6] = word_in(key, 6));
+    cx->ks[v(56,(7))] = ff(ss[7] = word_in(key, 7));
+    kdf8(cx->ks, 0); kd8(cx->ks, 1);
+    kd8(cx->ks, 2);  kd8(cx->ks, 3);
+    kd8(cx->ks, 4);  kd8(cx->ks, 5);
+    kdl8(cx->ks, 6);
+#else
+    cx->ks[v(56,(4))] = ss[4] = word_in(key, 4);
+    cx->ks[v(56,(5))] = ss[5] = word_in(key, 5);
+    cx->ks[v(56,(6))] = ss[6] = word_in(key, 6);
+    cx->ks[v(56,(7))] = ss[7] = word_in(key, 7);
+    {   uint_32t i;
+
+        for(i = 0; i < 6; ++i)
+            k8e(cx->ks,  i);
+        k8ef(cx->ks,  6);
+#if !(DEC_ROUND == NO_TABLES)
+        for(i = N_COLS; i < 14 * N_COLS; ++i)
+            cx->ks[i] = inv_mcol(cx->ks[i]);
+#endif
+    }
+#endif
+    cx->inf.l = 0;
+    ///@note [JPN] changing inf access to support INF macro
+    //cx->inf.b[0] = 14 * 16;
+    INF_B(cx->inf,0) = 14 * 16;
+
+    return EXIT_SUCCESS;
+}
+
+#endif
+
+#if defined( AES_VAR )
+
+AES_RETURN aes_decrypt_key(const io_t *key, int key_len, aes_decrypt_ctx cx[1])
+{
+    switch(key_len)
+    {
+    case 16: case 128: return aes_decrypt_key128(key, cx);
+    case 24: case 192: return aes_decrypt_key192(key, cx);
+    case 32: case 256: return aes_decrypt_key256(key, cx);
+    default: return EXIT_FAILURE;
+    }
+}
+
+#endif
+
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#line 1 "main/aescrypt.c"
+/*
+---------------------------------------------------------------------------
+Copyright (c) 1998-2010, Brian Gladman, Worcester, UK. All rights reserved.
+
+The redistribution and use of this software (with or without changes)
+is allowed without the payment of fees or royalties provided that:
+
+  source code distributions include the above copyright notice, this
+  list of conditions and the following disclaimer;
+
+  binary distributions include the above copyright notice, this list
+  of conditions and the following disclaimer in their documentation.
+
+This software is provided 'as is' with no explicit or implied warranties
+in respect of its operation, including, but not limited to, correctness
+and fitness for purpose.
+---------------------------------------------------------------------------
+Issue Date: 20/12/2007
+*/
+
+#include "oteax/brg_types.h"
+#include "oteax/aesopt.h"
+#include "oteax/aestab.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#define si(y,x,k,c) (s(y,c) = word_in(x, c) ^ (k)[c])
+#define so(y,x,c)   word_out(y, c, s(x,c))
+
+#if defined(ARRAYS)
+#   define locals(y,x)  x[4],y[4]
+#else
+#   define locals(y,x)  x##0,x##1,x##2,x##3,y##0,y##1,y##2,y##3
+#endif
+
+#define l_copy(y, x)    s(y,0)=s(x,0); s(y,1)=s(x,1); s(y,2)=s(x,2); s(y,3)=s(x,3);
+#define state_in(y,x,k) si(y,x,k,0); si(y,x,k,1); si(y,x,k,2); si(y,x,k,3)
+#define state_out(y,x)  so(y,x,0); so(y,x,1); so(y,x,2); so(y,x,3)
+#define round(rm,y,x,k) rm(y,x,k,0); rm(y,x,k,1); rm(y,x,k,2); rm(y,x,k,3)
+
+#if ( FUNCS_IN_C & ENCRYPTION_IN_C )
+
+/* Visual C++ .Net v7.1 provides the fastest encryption code when using
+   Pentium optimiation with small code but this is poor for decryption
+   so we need to control this with the following VC++ pragmas
+*/
+
+#if defined( _MSC_VER ) && !defined( _WIN64 )
+#pragma optimize( "s", on )
+#endif
+
+/* Given the column (c) of the output state variable, the following
+   macros give the input state variables which are needed in its
+   computation for each row (r) of the state. All the alternative
+   macros give the same end values but expand into different ways
+   of calculating these values.  In particular the complex macro
+   used for dynamically variable block sizes is designed to expand
+   to a compile time constant whenever possible but will expand to
+   conditional clauses on some branches (I am grateful to Frank
+   Yellin for this construction)
+*/
+
+#define fwd_var(x,r,c)\
+ ( r == 0 ? ( c == 0 ? s(x,0) : c == 1 ? s(x,1) : c == 2 ? s(x,2) : s(x,3))\
+ : r == 1 ? ( c == 0 ? s(x,1) : c == 1 ? s(x,2) : c == 2 ? s(x,3) : s(x,0))\
+ : r == 2 ? ( c == 0 ? s(x,2) : c == 1 ? s(x,3) : c == 2 ? s(x,0) : s(x,1))\
+ :          ( c == 0 ? s(x,3) : c == 1 ? s(x,0) : c == 2 ? s(x,1) : s(x,2)))
+
+#if defined(FT4_SET)
+#   undef  dec_fmvars
+#   define fwd_rnd(y,x,k,c)    (s(y,c) = (k)[c] ^ four_tables(x,t_use(f,n),fwd_var,rf1,c))
+#elif defined(FT1_SET)
+#   undef  dec_fmvars
+#   define fwd_rnd(y,x,k,c)    (s(y,c) = (k)[c] ^ one_table(x,upr,t_use(f,n),fwd_var,rf1,c))
+#else
+#   define fwd_rnd(y,x,k,c)    (s(y,c) = (k)[c] ^ fwd_mcol(no_table(x,t_use(s,box),fwd_var,rf1,c)))
+#endif
+
+#if defined(FL4_SET)
+#   define fwd_lrnd(y,x,k,c)   (s(y,c) = (k)[c] ^ four_tables(x,t_use(f,l),fwd_var,rf1,c))
+#elif defined(FL1_SET)
+#   define fwd_lrnd(y,x,k,c)   (s(y,c) = (k)[c] ^ one_table(x,ups,t_use(f,l),fwd_var,rf1,c))
+#else
+#   define fwd_lrnd(y,x,k,c)   (s(y,c) = (k)[c] ^ no_table(x,t_use(s,box),fwd_var,rf1,c))
+#endif
+
+#if defined(__OTF_KEYSCHED__)
+
+/* On-the-fly key scheduling: the context holds only the cipher key, so each
+   round key is derived from the previous one (same step as ke4() in aeskey.c)
+   immediately before the round that uses it.
+*/
+#define otf_ke4(k,i) \
+{   k[0] ^= ls_box(k[3],3) ^ t_use(r,c)[i]; \
+    k[1] ^= k[0]; \
+    k[2] ^= k[1]; \
+    k[3] ^= k[2]; \
+}
+
+AES_RETURN aes_encrypt(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {
+    uint_32t         locals(bb0, bb1);
+    uint_32t         rk[4];
+#if defined( dec_fmvars )
+    dec_fmvars; /* declare variables for fwd_mcol() if needed */
+#endif
+
+    if( INF_B(cx->inf,0) != 10 * 16 )
+        return EXIT_FAILURE;
+#if !defined( AES_DISPATCH )
+    if( INF_B(cx->inf,1) == AES_KERNEL_CT )
+        return aes_encrypt_ct(in, out, cx);
+#endif
+
+    rk[0] = cx->ks[0];
+    rk[1] = cx->ks[1];
+    rk[2] = cx->ks[2];
+    rk[3] = cx->ks[3];
+    state_in(bb0, in, rk);
+
+#if (ENC_UNROLL == FULL)
+    otf_ke4(rk, 0); round(fwd_rnd,  bb1, bb0, rk);
+    otf_ke4(rk, 1); round(fwd_rnd,  bb0, bb1, rk);
+    otf_ke4(rk, 2); round(fwd_rnd,  bb1, bb0, rk);
+    otf_ke4(rk, 3); round(fwd_rnd,  bb0, bb1, rk);
+    otf_ke4(rk, 4); round(fwd_rnd,  bb1, bb0, rk);
+    otf_ke4(rk, 5); round(fwd_rnd,  bb0, bb1, rk);
+    otf_ke4(rk, 6); round(fwd_rnd,  bb1, bb0, rk);
+    otf_ke4(rk, 7); round(fwd_rnd,  bb0, bb1, rk);
+    otf_ke4(rk, 8); round(fwd_rnd,  bb1, bb0, rk);
+    otf_ke4(rk, 9); round(fwd_lrnd, bb0, bb1, rk);
+
+#else
+    {   uint_32t    rnd;
+        for(rnd = 0; rnd < 9; ++rnd)
+        {
+            otf_ke4(rk, rnd);
+            round(fwd_rnd, bb1, bb0, rk);
+            l_copy(bb0, bb1);
+        }
+        otf_ke4(rk, 9);
+        round(fwd_lrnd, bb0, bb1, rk);
+    }
+#endif
+
+    state_out(out, bb0);
+    return EXIT_SUCCESS;
+}
+
+#else
+AES_RETURN aes_encrypt(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {   
+    uint_32t         locals(bb0, bb1);
+    const uint_32t   *kp;
+#if defined( dec_fmvars )
+    dec_fmvars; /* declare variables for fwd_mcol() if needed */
+#endif
+    
+    ///@note [JPN] changing inf access to support INF macro
+    //if( cx->inf.b[0] != 10 * 16 && cx->inf.b[0] != 12 * 16 && cx->inf.b[0] != 14 * 16 )
+    ///@note [JPN] with AES-128 alone there is one valid round count, and
+    ///      the compiler can fold it into the round code below
+#if defined( AES_VAR ) || defined( AES_192 ) || defined( AES_256 )
+    if( INF_B(cx->inf,0) != 10 * 16 && INF_B(cx->inf,0) != 12 * 16 && INF_B(cx->inf,0) != 14 * 16 )
+        return EXIT_FAILURE;
+#else
+    if( INF_B(cx->inf,0) != 10 * 16 )
+        return EXIT_FAILURE;
+#endif
+#if !defined( AES_DISPATCH )
+    if( INF_B(cx->inf,1) == AES_KERNEL_CT )
+        return aes_encrypt_ct(in, out, cx);
+#endif
+
+    kp = cx->ks;
+    state_in(bb0, in, kp);
+
+#if (ENC_UNROLL == FULL)
+
+    ///@note [JPN] changing inf access to support INF macro
+    //switch(cx->inf.b[0])
+    switch(INF_B(cx->inf,0))
+    {
+    case 14 * 16:
+        round(fwd_rnd,  bb1, bb0, kp + 1 * N_COLS);
+        round(fwd_rnd,  bb0, bb1, kp + 2 * N_COLS);
+        kp += 2 * N_COLS;
+    case 12 * 16:
+        round(fwd_rnd,  bb1, bb0, kp + 1 * N_COLS);
+        round(fwd_rnd,  bb0, bb1, kp + 2 * N_COLS);
+        kp += 2 * N_COLS;
+    case 10 * 16:
+        round(fwd_rnd,  bb1, bb0, kp + 1 * N_COLS);
+        round(fwd_rnd,  bb0, bb1, kp + 2 * N_COLS);
+        round(fwd_rnd,  bb1, bb0, kp + 3 * N_COLS);
+        round(fwd_rnd,  bb0, bb1, kp + 4 * N_COLS);
+        round(fwd_rnd,  bb1, bb0, kp + 5 * N_COLS);
+        round(fwd_rnd,  bb0, bb1, kp + 6 * N_COLS);
+        round(fwd_rnd,  bb1, bb0, kp + 7 * N_COLS);
+        round(fwd_rnd,  bb0, bb1, kp + 8 * N_COLS);
+        round(fwd_rnd,  bb1, bb0, kp + 9 * N_COLS);
+        round(fwd_lrnd, bb0, bb1, kp +10 * N_COLS);
+    }
+
+#else
+
+#if (ENC_UNROLL == PARTIAL)
+    {   uint_32t    rnd;
+        ///@note [JPN] changing inf access to support INF macro
+        //for(rnd = 0; rnd < (cx->inf.b[0] >> 5) - 1; ++rnd)
+        for(rnd = 0; rnd < (INF_B(cx->inf,0) >> 5) - 1; ++rnd)
+        {
+            kp += N_COLS;
+            round(fwd_rnd, bb1, bb0, kp);
+            kp += N_COLS;
+            round(fwd_rnd, bb0, bb1, kp);
+        }
+        kp += N_COLS;
+        round(fwd_rnd,  bb1, bb0, kp);
+#else
+    {   uint_32t    rnd;
+        ///@note [JPN] changing inf access to support INF macro
+        //for(rnd = 0; rnd < (cx->inf.b[0] >> 4) - 1; ++rnd)
+        for(rnd = 0; rnd < (INF_B(cx->inf,0) >> 4) - 1; ++rnd)
+        {
+            kp += N_COLS;
+            round(fwd_rnd, bb1, bb0, kp);
+            l_copy(bb0, bb1);
+        }
+#endif
+        kp += N_COLS;
+        round(fwd_lrnd, bb0, bb1, kp);
+    }
+#endif
+
+    state_out(out, bb0);
+    return EXIT_SUCCESS;
+}
+#endif
+
+#endif
+
+#if ( FUNCS_IN_C & DECRYPTION_IN_C)
+
+/* Visual C++ .Net v7.1 provides the fastest encryption code when using
+   Pentium optimiation with small code but this is poor for decryption
+   so we need to control this with the following VC++ pragmas
+*/
+
+#if defined( _MSC_VER ) && !defined( _WIN64 )
+#pragma optimize( "t", on )
+#endif
+
+/* Given the column (c) of the output state variable, the following
+   macros give the input state variables which are needed in its
+   computation for each row (r) of the state. All the alternative
+   macros give the same end values but expand into different ways
+   of calculating these values.  In particular the complex macro
+   used for dynamically variable block sizes is designed to expand
+   to a compile time constant whenever possible but will expand to
+   conditional clauses on some branches (I am grateful to Frank
+   Yellin for this construction)
+*/
+
+#define inv_var(x,r,c)\
+ ( r == 0 ? ( c == 0 ? s(x,0) : c == 1 ? s(x,1) : c == 2 ? s(x,2) : s(x,3))\
+ : r == 1 ? ( c == 0 ? s(x,3) : c == 1 ? s(x,0) : c == 2 ? s(x,1) : s(x,2))\
+ : r == 2 ? ( c == 0 ? s(x,2) : c == 1 ? s(x,3) : c == 2 ? s(x,0) : s(x,1))\
+ :          ( c == 0 ? s(x,1) : c == 1 ? s(x,2) : c == 2 ? s(x,3) : s(x,0)))
+
+#if defined(IT4_SET)
+#undef  dec_imvars
+#define inv_rnd(y,x,k,c)    (s(y,c) = (k)[c] ^ four_tables(x,t_use(i,n),inv_var,rf1,c))
+#elif defined(IT1_SET)
+#undef  dec_imvars
+#define inv_rnd(y,x,k,c)    (s(y,c) = (k)[c] ^ one_table(x,upr,t_use(i,n),inv_var,rf1,c))
+#else
+#define inv_rnd(y,x,k,c)    (s(y,c) = inv_mcol((k)[c] ^ no_table(x,t_use(i,box),inv_var,rf1,c)))
+#endif
+
+#if defined(IL4_SET)
+#define inv_lrnd(y,x,k,c)   (s(y,c) = (k)[c] ^ four_tables(x,t_use(i,l),inv_var,rf1,c))
+#elif defined(IL1_SET)
+#define inv_lrnd(y,x,k,c)   (s(y,c) = (k)[c] ^ one_table(x,ups,t_use(i,l),inv_var,rf1,c))
+#else
+#define inv_lrnd(y,x,k,c)   (s(y,c) = (k)[c] ^ no_table(x,t_use(i,box),inv_var,rf1,c))
+#endif
+
+/* This code can work with the decryption key schedule in the   */
+/* order that is used for encrytpion (where the 1st decryption  */
+/* round key is at the high end ot the schedule) or with a key  */
+/* schedule that has been reversed to put the 1st decryption    */
+/* round key at the low end of the schedule in memory (when     */
+/* AES_REV_DKS is defined)                                      */
+
+#ifdef AES_REV_DKS
+#define key_ofs     0
+#define rnd_key(n)  (kp + n * N_COLS)
+#else
+#define key_ofs     1
+#define rnd_key(n)  (kp - n * N_COLS)
+#endif
+
+AES_RETURN aes_decrypt(const io_t *in, io_t *out, const aes_decrypt_ctx cx[1])
+{   uint_32t        locals(bb0, bb1);
+#if defined( dec_imvars )
+    dec_imvars; /* declare variables for inv_mcol() if needed */
+#endif
+    const uint_32t *kp;
+
+    ///@note [JPN] changing inf access to support INF macro
+    //if( cx->inf.b[0] != 10 * 16 && cx->inf.b[0] != 12 * 16 && cx->inf.b[0] != 14 * 16 )
+    if( INF_B(cx->inf,0) != 10 * 16 && INF_B(cx->inf,0) != 12 * 16 && INF_B(cx->inf,0) != 14 * 16 )
+        return EXIT_FAILURE;
+
+    ///@note [JPN] changing inf access to support INF macro
+    //kp = cx->ks + (key_ofs ? (cx->inf.b[0] >> 2) : 0);
+    kp = cx->ks + (key_ofs ? (INF_B(cx->inf,0) >> 2) : 0);
+    state_in(bb0, in, kp);
+
+#if (DEC_UNROLL == FULL)
+
+    ///@note [JPN] changing inf access to support INF macro
+    //kp = cx->ks + (key_ofs ? 0 : (cx->inf.b[0] >> 2));
+    kp = cx->ks + (key_ofs ? 0 : (INF_B(cx->inf,0) >> 2));
+    
+    ///@note [JPN] changing inf access to support INF macro
+    //switch(cx->inf.b[0])
+    switch(INF_B(cx->inf,0))
+    {
+    case 14 * 16:
+        round(inv_rnd,  bb1, bb0, rnd_key(-13));
+        round(inv_rnd,  bb0, bb1, rnd_key(-12));
+    case 12 * 16:
+        round(inv_rnd,  bb1, bb0, rnd_key(-11));
+        round(inv_rnd,  bb0, bb1, rnd_key(-10));
+    case 10 * 16:
+        round(inv_rnd,  bb1, bb0, rnd_key(-9));
+        round(inv_rnd,  bb0, bb1, rnd_key(-8));
+        round(inv_rnd,  bb1, bb0, rnd_key(-7));
+        round(inv_rnd,  bb0, bb1, rnd_key(-6));
+        round(inv_rnd,  bb1, bb0, rnd_key(-5));
+        round(inv_rnd,  bb0, bb1, rnd_key(-4));
+        round(inv_rnd,  bb1, bb0, rnd_key(-3));
+        round(inv_rnd,  bb0, bb1, rnd_key(-2));
+        round(inv_rnd,  bb1, bb0, rnd_key(-1));
+        round(inv_lrnd, bb0, bb1, rnd_key( 0));
+    }
+
+#else
+
+#if (DEC_UNROLL == PARTIAL)
+    {   uint_32t    rnd;
+        ///@note [JPN] changing inf access to support INF macro
+        //for(rnd = 0; rnd < (cx->inf.b[0] >> 5) - 1; ++rnd)
+        for(rnd = 0; rnd < (INF_B(cx->inf,0) >> 5) - 1; ++rnd)
+        {
+            kp = rnd_key(1);
+            round(inv_rnd, bb1, bb0, kp);
+            kp = rnd_key(1);
+            round(inv_rnd, bb0, bb1, kp);
+        }
+        kp = rnd_key(1);
+        round(inv_rnd, bb1, bb0, kp);
+#else
+    {   uint_32t    rnd;
+        ///@note [JPN] changing inf access to support INF macro
+        //for(rnd = 0; rnd < (cx->inf.b[0] >> 4) - 1; ++rnd)
+        for(rnd = 0; rnd < (INF_B(cx->inf,0) >> 4) - 1; ++rnd)
+        {
+            kp = rnd_key(1);
+            round(inv_rnd, bb1, bb0, kp);
+            l_copy(bb0, bb1);
+        }
+#endif
+        kp = rnd_key(1);
+        round(inv_lrnd, bb0, bb1, kp);
+        }
+#endif
+
+    state_out(out, bb0);
+    return EXIT_SUCCESS;
+}
+
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#line 1 "main/aesct.c"
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/aesct.c
+  * @brief      Constant-time AES-128 kernel
+  *
+  * The table-driven code in aescrypt.c indexes its tables with state bytes,
+  * so its cache footprint depends on the key and data.  This kernel has no
+  * lookups or branches that depend on secret values: the S-box is a logic
+  * circuit run on all 16 state bytes at once in bit-sliced form, and the
+  * rest of the round works on column words, as the NO_TABLES code does.  It
+  * is several times slower than the tables.
+  *
+  * The key schedule is in the same layout as aes_encrypt_key128(), and
+  * INF_B(cx->inf,1) marks the context, so aes_encrypt() comes here for
+  * every block of a context keyed by aes_encrypt_key128_ct().  The AES-NI
+  * paths are constant-time already, and they are still used where present.
+  ******************************************************************************
+  */
+
+#include "oteax/brg_types.h"
+#include "oteax/aesopt.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/* bytes of one row within a column word */
+#define CT_ROW0     bytes2word(0xFF, 0, 0, 0)
+#define CT_ROW1     bytes2word(0, 0xFF, 0, 0)
+#define CT_ROW2     bytes2word(0, 0, 0xFF, 0)
+#define CT_ROW3     bytes2word(0, 0, 0, 0xFF)
+
+
+
+/* S-box on the bytes of w[0] to w[n-1], n <= 8.  The bytes are sliced into
+   eight bit planes, one bit per byte per plane, and the planes go through
+   the Boyar-Peralta S-box circuit (113 gates), so every byte costs the same.
+*/
+static void sub_sbox(uint_32t* w, unsigned int n) {
+    uint_32t q[8];
+    uint_32t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint_32t y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11;
+    uint_32t y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+    uint_32t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint_32t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint_32t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint_32t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint_32t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint_32t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint_32t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint_32t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint_32t t60, t61, t62, t63, t64, t65, t66, t67;
+    unsigned int i, j;
+
+    for (j=0; j<8; j++) {
+        q[j] = 0;
+        for (i=0; i<n; i++) {
+            q[j] |= ((w[i] >> j) & 0x01010101) << i;
+        }
+    }
+
+    x0 = q[7];  x1 = q[6];  x2 = q[5];  x3 = q[4];
+    x4 = q[3];  x5 = q[2];  x6 = q[1];  x7 = q[0];
+
+    /* top linear transformation */
+    y14 = x3 ^ x5;      y13 = x0 ^ x6;      y9  = x0 ^ x3;
+    y8  = x0 ^ x5;      t0  = x1 ^ x2;      y1  = t0 ^ x7;
+    y4  = y1 ^ x3;      y12 = y13 ^ y14;    y2  = y1 ^ x0;
+    y5  = y1 ^ x6;      y3  = y5 ^ y8;      t1  = x4 ^ y12;
+    y15 = t1 ^ x5;      y20 = t1 ^ x1;      y6  = y15 ^ x7;
+    y10 = y15 ^ t0;     y11 = y20 ^ y9;     y7  = x7 ^ y11;
+    y17 = y10 ^ y11;    y19 = y10 ^ y8;     y16 = t0 ^ y11;
+    y21 = y13 ^ y16;    y18 = x0 ^ y16;
+
+    /* non-linear section */
+    t2  = y12 & y15;    t3  = y3 & y6;      t4  = t3 ^ t2;
+    t5  = y4 & x7;      t6  = t5 ^ t2;      t7  = y13 & y16;
+    t8  = y5 & y1;      t9  = t8 ^ t7;      t10 = y2 & y7;
+    t11 = t10 ^ t7;     t12 = y9 & y11;     t13 = y14 & y17;
+    t14 = t13 ^ t12;    t15 = y8 & y10;     t16 = t15 ^ t12;
+    t17 = t4 ^ t14;     t18 = t6 ^ t16;     t19 = t9 ^ t14;
+    t20 = t11 ^ t16;    t21 = t17 ^ y20;    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;    t26 = t21 & t23;    t27 = t24 ^ t26;
+    t28 = t25 & t27;    t29 = t28 ^ t22;    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;    t32 = t31 & t30;    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;    t35 = t27 ^ t33;    t36 = t24 & t35;
+    t37 = t36 ^ t34;    t38 = t27 ^ t36;    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;    t42 = t29 ^ t33;    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;    t45 = t42 ^ t41;
+    z0  = t44 & y15;    z1  = t37 & y6;     z2  = t33 & x7;
+    z3  = t43 & y16;    z4  = t40 & y1;     z5  = t29 & y7;
+    z6  = t42 & y11;    z7  = t45 & y17;    z8  = t41 & y10;
+    z9  = t44 & y12;    z10 = t37 & y3;     z11 = t33 & y4;
+    z12 = t43 & y13;    z13 = t40 & y5;     z14 = t29 & y2;
+    z15 = t42 & y9;     z16 = t45 & y14;    z17 = t41 & y8;
+
+    /* bottom linear transformation */
+    t46 = z15 ^ z16;    t47 = z10 ^ z11;    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;     t50 = z2 ^ z12;     t51 = z2 ^ z5;
+    t52 = z7 ^ z8;      t53 = z0 ^ z3;      t54 = z6 ^ z7;
+    t55 = z16 ^ z17;    t56 = z12 ^ t48;    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;     t59 = z3 ^ t54;     t60 = t46 ^ t57;
+    t61 = z14 ^ t57;    t62 = t52 ^ t58;    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;     t65 = t61 ^ t62;    t66 = z1 ^ t63;
+    q[7] = t59 ^ t63;
+    q[1] = t56 ^ ~t62;
+    q[0] = t48 ^ ~t60;
+    t67  = t64 ^ t65;
+    q[4] = t53 ^ t66;
+    q[3] = t51 ^ t66;
+    q[2] = t47 ^ t65;
+    q[6] = t64 ^ ~q[4];
+    q[5] = t55 ^ ~t67;
+
+    for (i=0; i<n; i++) {
+        w[i] = 0;
+        for (j=0; j<8; j++) {
+            w[i] |= ((q[j] >> i) & 0x01010101) << j;
+        }
+    }
+}
+
+
+
+static uint_32t sub_mix_col(uint_32t x) {
+    uint_32t g2 = gf_mulx(x);
+    return g2 ^ upr(x ^ g2, 3) ^ upr(x, 2) ^ upr(x, 1);
+}
+
+
+
+/* Next round key from k, in place, with round constant rc */
+static void sub_next_key(uint_32t* k, uint_32t rc) {
+    uint_32t t = upr(k[3], 3);
+
+    sub_sbox(&t, 1);
+    k[0] ^= t ^ bytes2word(rc, 0, 0, 0);
+    k[1] ^= k[0];
+    k[2] ^= k[1];
+    k[3] ^= k[2];
+}
+
+
+
+AES_RETURN aes_encrypt_key128_ct(const io_t *key, aes_encrypt_ctx cx[1]) {
+    cx->ks[0] = word_in(key, 0);
+    cx->ks[1] = word_in(key, 1);
+    cx->ks[2] = word_in(key, 2);
+    cx->ks[3] = word_in(key, 3);
+
+#   if !defined(__OTF_KEYSCHED__)
+    {   uint_32t i, rc;
+        for (i=4, rc=1; i<KS_LENGTH; i+=4) {
+            cx->ks[i+0] = cx->ks[i-4];
+            cx->ks[i+1] = cx->ks[i-3];
+            cx->ks[i+2] = cx->ks[i-2];
+            cx->ks[i+3] = cx->ks[i-1];
+            sub_next_key(&cx->ks[i], rc);
+            rc = ((rc << 1) ^ ((rc >> 7) * BPOLY)) & 0xFF;
+        }
+    }
+#   endif
+
+    cx->inf.l = 0;
+    INF_B(cx->inf,0) = 10 * 16;
+    INF_B(cx->inf,1) = AES_KERNEL_CT;
+    return EXIT_SUCCESS;
+}
+
+
+
+AES_RETURN aes_encrypt_ct(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {
+    uint_32t s[4], t[4];
+    uint_32t rnd, c;
+#   if defined(__OTF_KEYSCHED__)
+    uint_32t k[4];
+    uint_32t rc = 1;
+#   else
+    const uint_32t* k;
+#   endif
+
+    if (INF_B(cx->inf,0) != 10 * 16)
+        return EXIT_FAILURE;
+
+#   if defined(__OTF_KEYSCHED__)
+    k[0] = cx->ks[0];
+    k[1] = cx->ks[1];
+    k[2] = cx->ks[2];
+    k[3] = cx->ks[3];
+#   else
+    k = cx->ks;
+#   endif
+
+    for (c=0; c<4; c++) {
+        s[c] = word_in(in, c) ^ k[c];
+    }
+
+    for (rnd=1; rnd<=10; rnd++) {
+        sub_sbox(s, 4);
+        for (c=0; c<4; c++) {
+            t[c] = (s[c] & CT_ROW0) | (s[(c+1)&3] & CT_ROW1)
+                 | (s[(c+2)&3] & CT_ROW2) | (s[(c+3)&3] & CT_ROW3);
+        }
+        if (rnd != 10) {
+            for (c=0; c<4; c++) {
+                t[c] = sub_mix_col(t[c]);
+            }
+        }
+
+#       if defined(__OTF_KEYSCHED__)
+        sub_next_key(k, rc);
+        rc = ((rc << 1) ^ ((rc >> 7) * BPOLY)) & 0xFF;
+#       else
+        k += N_COLS;
+#       endif
+
+        for (c=0; c<4; c++) {
+            s[c] = t[c] ^ k[c];
+        }
+    }
+
+    word_out(out, 0, s[0]);
+    word_out(out, 1, s[1]);
+    word_out(out, 2, s[2]);
+    word_out(out, 3, s[3]);
+    return EXIT_SUCCESS;
+}
+
+#undef CT_ROW0
+#undef CT_ROW1
+#undef CT_ROW2
+#undef CT_ROW3
+
+#if defined(__cplusplus)
+}
+#endif
+
+#line 1 "main/aesni.c"
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/aesni.c
+  * @brief      x86 AES-NI code paths, selected at runtime
+  *
+  * Everything in this file is compiled only for GCC-compatible x86 builds
+  * (see AESNI_POSSIBLE in aesni.h).  Other targets, including C2000 and
+  * Cortex-M, compile it to nothing.  Buffers are io_t, which is a 32 bit
+  * word in __ALIGN32__ builds, so offsets in here are always taken in bytes.
+  ******************************************************************************
+  */
+
+#include "oteax/aesni.h"
+#include "oteax/aesdisp.h"
+
+#if defined(AESNI_POSSIBLE)
+
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+#if defined(VAES_POSSIBLE)
+#   include <immintrin.h>
+#endif
+
+#define AESNI_TARGET    __attribute__((target("aes,ssse3")))
+#define CLMUL_TARGET    __attribute__((target("pclmul,ssse3")))
+#define VAES_TARGET     __attribute__((target("aes,ssse3,avx512f,avx512bw,vaes")))
+
+/* Set only through aesni_enable(), by aes_kernel_resolve() and
+   aes_kernel_select(); -1 until the kernel is settled.  The CPUID caches
+   below are filled by whichever thread gets there first, with the same
+   value, so they are atomic too.
+*/
+static int aesni_on = -1;
+
+int aesni_supported(void) {
+    static int avail = -1;
+    int a = __atomic_load_n(&avail, __ATOMIC_RELAXED);
+
+    if (a < 0) {
+        __builtin_cpu_init();
+        a = (__builtin_cpu_supports("aes") && __builtin_cpu_supports("ssse3"));
+        __atomic_store_n(&avail, a, __ATOMIC_RELAXED);
+    }
+    return a;
+}
+
+
+
+int aesni_available(void) {
+    int on = __atomic_load_n(&aesni_on, __ATOMIC_ACQUIRE);
+
+    if (on < 0) {
+        aes_kernel_resolve();
+        on = __atomic_load_n(&aesni_on, __ATOMIC_ACQUIRE);
+    }
+    return (on > 0);
+}
+
+
+
+void aesni_enable(int on) {
+    __atomic_store_n(&aesni_on, on, __ATOMIC_RELEASE);
+}
+
+
+
+int aesni_vaes_supported(void) {
+#   if defined(VAES_POSSIBLE)
+    static int avail = -1;
+    int a = __atomic_load_n(&avail, __ATOMIC_RELAXED);
+
+    if (a < 0) {
+        __builtin_cpu_init();
+        a = (__builtin_cpu_supports("vaes") && __builtin_cpu_supports("avx512f")
+          && __builtin_cpu_supports("avx512bw"));
+        __atomic_store_n(&avail, a, __ATOMIC_RELAXED);
+    }
+    return a;
+#   else
+    return 0;
+#   endif
+}
+
+
+
+/* aesni_available() has been checked by the caller */
+static int sub_vaes_on(void) {
+    return (__atomic_load_n(&aesni_on, __ATOMIC_RELAXED) > 1) && aesni_vaes_supported();
+}
+
+
+
+int aesni_clmul_available(void) {
+    static int avail = -1;
+
+    int a = __atomic_load_n(&avail, __ATOMIC_RELAXED);
+
+    if (a < 0) {
+        __builtin_cpu_init();
+        a = (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3"));
+        __atomic_store_n(&avail, a, __ATOMIC_RELAXED);
+    }
+    return a;
+}
+
+
+
+/* One step of the AES-128 key expansion.  RCON must be an immediate value,
+   so the expansion is always fully unrolled.
+*/
+#define KEXP128(K, RCON) do {                                   \
+        __m128i _t = _mm_aeskeygenassist_si128((K), (RCON));    \
+        _t  = _mm_shuffle_epi32(_t, 0xFF);                      \
+        (K) = _mm_xor_si128((K), _mm_slli_si128((K), 4));       \
+        (K) = _mm_xor_si128((K), _mm_slli_si128((K), 4));       \
+        (K) = _mm_xor_si128((K), _mm_slli_si128((K), 4));       \
+        (K) = _mm_xor_si128((K), _t);                           \
+    } while (0)
+
+/* Expand round R for all four lanes, store the round keys and advance the
+   E(0) computation in each lane by one round.
+*/
+#define KEXP128_X4(R, RCON) do {                                \
+        KEXP128(k0, RCON); KEXP128(k1, RCON);                   \
+        KEXP128(k2, RCON); KEXP128(k3, RCON);                   \
+        _mm_storeu_si128((__m128i*)&cx[0]->ks[4*(R)], k0);      \
+        _mm_storeu_si128((__m128i*)&cx[1]->ks[4*(R)], k1);      \
+        _mm_storeu_si128((__m128i*)&cx[2]->ks[4*(R)], k2);      \
+        _mm_storeu_si128((__m128i*)&cx[3]->ks[4*(R)], k3);      \
+        if ((R) < 10) {                                         \
+            s0 = _mm_aesenc_si128(s0, k0);                      \
+            s1 = _mm_aesenc_si128(s1, k1);                      \
+            s2 = _mm_aesenc_si128(s2, k2);                      \
+            s3 = _mm_aesenc_si128(s3, k3);                      \
+        }                                                       \
+        else {                                                  \
+            s0 = _mm_aesenclast_si128(s0, k0);                  \
+            s1 = _mm_aesenclast_si128(s1, k1);                  \
+            s2 = _mm_aesenclast_si128(s2, k2);                  \
+            s3 = _mm_aesenclast_si128(s3, k3);                  \
+        }                                                       \
+    } while (0)
+
+
+
+/* Multiply by {02} in GF(2^128) mod x^128 + x^7 + x^2 + x + 1.  The input
+   and output are the block byte-reversed, so that the 128 bit shift can be
+   done on two little-endian 64 bit lanes.  This is branch-free.
+*/
+AESNI_TARGET static inline __m128i sub_gf128_dbl(__m128i x) {
+    __m128i carry   = _mm_srli_epi64(x, 63);
+    __m128i msb     = _mm_shuffle_epi32(_mm_srai_epi32(x, 31), 0xFF);
+
+    x = _mm_slli_epi64(x, 1);
+    x = _mm_or_si128(x, _mm_slli_si128(carry, 8));
+    return _mm_xor_si128(x, _mm_and_si128(msb, _mm_set_epi32(0, 0, 0, 0x87)));
+}
+
+AESNI_TARGET static inline void sub_store_pads(io_t* pad, __m128i e0) {
+    const __m128i bswap = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    __m128i x;
+
+    x = sub_gf128_dbl(_mm_shuffle_epi8(e0, bswap));
+    _mm_storeu_si128((__m128i*)&pad[0], _mm_shuffle_epi8(x, bswap));
+    x = sub_gf128_dbl(x);
+    _mm_storeu_si128((__m128i*)&((uint_8t*)pad)[16], _mm_shuffle_epi8(x, bswap));
+}
+
+
+
+AESNI_TARGET
+void aesni_omac_key128_x4(const io_t* key, aes_encrypt_ctx* const cx[4], io_t* const pad[4]) {
+    __m128i k0, k1, k2, k3;
+    __m128i s0, s1, s2, s3;
+
+    /* round 0: the plaintext is zero, so the state is just the round key */
+    s0 = k0 = _mm_loadu_si128((const __m128i*)&key[0]);
+    s1 = k1 = _mm_loadu_si128((const __m128i*)&((const uint_8t*)key)[16]);
+    s2 = k2 = _mm_loadu_si128((const __m128i*)&((const uint_8t*)key)[32]);
+    s3 = k3 = _mm_loadu_si128((const __m128i*)&((const uint_8t*)key)[48]);
+    _mm_storeu_si128((__m128i*)&cx[0]->ks[0], k0);
+    _mm_storeu_si128((__m128i*)&cx[1]->ks[0], k1);
+    _mm_storeu_si128((__m128i*)&cx[2]->ks[0], k2);
+    _mm_storeu_si128((__m128i*)&cx[3]->ks[0], k3);
+
+    KEXP128_X4(1, 0x01);
+    KEXP128_X4(2, 0x02);
+    KEXP128_X4(3, 0x04);
+    KEXP128_X4(4, 0x08);
+    KEXP128_X4(5, 0x10);
+    KEXP128_X4(6, 0x20);
+    KEXP128_X4(7, 0x40);
+    KEXP128_X4(8, 0x80);
+    KEXP128_X4(9, 0x1b);
+    KEXP128_X4(10, 0x36);
+
+    cx[0]->inf.l = 0;   INF_B(cx[0]->inf, 0) = 10 * 16;
+    cx[1]->inf.l = 0;   INF_B(cx[1]->inf, 0) = 10 * 16;
+    cx[2]->inf.l = 0;   INF_B(cx[2]->inf, 0) = 10 * 16;
+    cx[3]->inf.l = 0;   INF_B(cx[3]->inf, 0) = 10 * 16;
+
+    sub_store_pads(pad[0], s0);
+    sub_store_pads(pad[1], s1);
+    sub_store_pads(pad[2], s2);
+    sub_store_pads(pad[3], s3);
+}
+
+
+
+/* Counter blocks are kept byte-reversed, so that the low 64 bits of the
+   big-endian counter sit in lane 0 and can be stepped with one SIMD add.  A
+   32 bit counter uses a 32 bit add and a 64 bit counter a 64 bit add, which
+   wrap within the counter field by themselves.  A 128 bit counter also uses
+   the 64 bit add, and the rare carry into the top half is done separately.
+*/
+#define CTR_ADD(C, N)   ((ctr_bits == 32) ? _mm_add_epi32((C), _mm_cvtsi32_si128(N)) \
+                                          : _mm_add_epi64((C), _mm_cvtsi32_si128(N)))
+#define CTR_ADD4(C, V)  ((ctr_bits == 32) ? _mm512_add_epi32((C), (V)) : _mm512_add_epi64((C), (V)))
+
+AESNI_TARGET static inline __m128i sub_ctr_inc128(__m128i c) {
+    uint_64t lo;
+
+    c = _mm_add_epi64(c, _mm_cvtsi32_si128(1));
+    _mm_storel_epi64((__m128i*)&lo, c);
+    if (lo == 0) {
+        c = _mm_add_epi64(c, _mm_set_epi32(0, 1, 0, 0));
+    }
+    return c;
+}
+
+
+
+#if defined(VAES_POSSIBLE)
+/* The VAES engine puts four counter blocks in each 512 bit register and
+   keeps eight registers in flight.  It runs whole groups of four blocks
+   and returns how many it did, leaving the rest to the AES-NI code.  It
+   also stops early when a 128 bit counter is close to carrying into its
+   top half.
+*/
+VAES_TARGET
+static unsigned long sub_vaes_ctr(const uint_8t* in, uint_8t* out, unsigned long blocks, io_t* ctr, int ctr_bits, const aes_encrypt_ctx cx[1]) {
+    const __m512i bswap = _mm512_broadcast_i32x4(_mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15));
+    const __m512i lanes = _mm512_set_epi32(0,0,0,3, 0,0,0,2, 0,0,0,1, 0,0,0,0);
+    const __m512i four  = _mm512_set_epi32(0,0,0,4, 0,0,0,4, 0,0,0,4, 0,0,0,4);
+    __m512i rk[11];
+    __m512i c, b[8];
+    unsigned long done = 0;
+    uint_64t lo;
+    int i, r, n;
+
+    for (r=0; r<11; r++) {
+        rk[r] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&cx->ks[4*r]));
+    }
+    c = _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)ctr)), bswap);
+    c = CTR_ADD4(c, lanes);
+
+    while ((blocks - done) >= 4) {
+        n = ((blocks - done) >= 32) ? 8 : 1;
+        _mm_storel_epi64((__m128i*)&lo, _mm512_castsi512_si128(c));
+        if ((ctr_bits == 128) && (lo > (~(uint_64t)0 - 32))) {
+            break;
+        }
+
+        for (i=0; i<n; i++) {
+            b[i]    = _mm512_xor_si512(_mm512_shuffle_epi8(c, bswap), rk[0]);
+            c       = CTR_ADD4(c, four);
+        }
+        for (r=1; r<10; r++) {
+            for (i=0; i<n; i++) {
+                b[i] = _mm512_aesenc_epi128(b[i], rk[r]);
+            }
+        }
+        for (i=0; i<n; i++) {
+            b[i] = _mm512_aesenclast_epi128(b[i], rk[10]);
+            b[i] = _mm512_xor_si512(b[i], _mm512_loadu_si512((const void*)&in[64*i]));
+            _mm512_storeu_si512((void*)&out[64*i], b[i]);
+        }
+
+        in      = &in[n*64];
+        out     = &out[n*64];
+        done   += 4*n;
+    }
+
+    /* lane 0 holds the next counter */
+    _mm_storeu_si128((__m128i*)ctr, _mm_shuffle_epi8(_mm512_castsi512_si128(c), _mm512_castsi512_si128(bswap)));
+    return done;
+}
+#endif
+
+
+
+AESNI_TARGET
+void aesni_ctr_blocks(const io_t* in_v, io_t* out_v, unsigned long blocks, io_t* ctr, int ctr_bits, const aes_encrypt_ctx cx[1]) {
+    const __m128i bswap = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    const uint_8t* in = (const uint_8t*)in_v;
+    uint_8t* out = (uint_8t*)out_v;
+    __m128i rk[11];
+    __m128i c, b[8];
+    uint_64t lo;
+    int i, r;
+
+#   if defined(VAES_POSSIBLE)
+    if ((blocks >= 16) && sub_vaes_on()) {
+        unsigned long done = sub_vaes_ctr(in, out, blocks, ctr, ctr_bits, cx);
+        in      = &in[16*done];
+        out     = &out[16*done];
+        blocks -= done;
+    }
+#   endif
+
+    for (r=0; r<11; r++) {
+        rk[r] = _mm_loadu_si128((const __m128i*)&cx->ks[4*r]);
+    }
+    c = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)ctr), bswap);
+
+    /* Eight blocks at a time keeps the AES unit pipeline full */
+    while (blocks >= 8) {
+        _mm_storel_epi64((__m128i*)&lo, c);
+        if ((ctr_bits == 128) && (lo > (~(uint_64t)0 - 8))) {
+            for (i=0; i<8; i++) {
+                b[i]    = _mm_shuffle_epi8(c, bswap);
+                c       = sub_ctr_inc128(c);
+            }
+        }
+        else {
+            for (i=0; i<8; i++) {
+                b[i]    = _mm_shuffle_epi8(CTR_ADD(c, i), bswap);
+            }
+            c = CTR_ADD(c, 8);
+        }
+
+        for (i=0; i<8; i++) {
+            b[i] = _mm_xor_si128(b[i], rk[0]);
+        }
+        for (r=1; r<10; r++) {
+            for (i=0; i<8; i++) {
+                b[i] = _mm_aesenc_si128(b[i], rk[r]);
+            }
+        }
+        for (i=0; i<8; i++) {
+            b[i] = _mm_aesenclast_si128(b[i], rk[10]);
+            b[i] = _mm_xor_si128(b[i], _mm_loadu_si128((const __m128i*)&in[16*i]));
+            _mm_storeu_si128((__m128i*)&out[16*i], b[i]);
+        }
+
+        in      = &in[8*16];
+        out     = &out[8*16];
+        blocks -= 8;
+    }
+
+    while (blocks != 0) {
+        b[0] = _mm_xor_si128(_mm_shuffle_epi8(c, bswap), rk[0]);
+        c    = (ctr_bits == 128) ? sub_ctr_inc128(c) : CTR_ADD(c, 1);
+        for (r=1; r<10; r++) {
+            b[0] = _mm_aesenc_si128(b[0], rk[r]);
+        }
+        b[0] = _mm_aesenclast_si128(b[0], rk[10]);
+        b[0] = _mm_xor_si128(b[0], _mm_loadu_si128((const __m128i*)in));
+        _mm_storeu_si128((__m128i*)out, b[0]);
+
+        in      = &in[16];
+        out     = &out[16];
+        blocks -= 1;
+    }
+
+    _mm_storeu_si128((__m128i*)ctr, _mm_shuffle_epi8(c, bswap));
+}
+
+#undef CTR_ADD
+#undef CTR_ADD4
+
+
+
+AESNI_TARGET
+AES_RETURN aesni_encrypt(const io_t* in, io_t* out, const aes_encrypt_ctx cx[1]) {
+    __m128i s;
+    int r;
+
+    if (INF_B(cx->inf,0) != 10 * 16) {
+        return 1;
+    }
+    s = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), _mm_loadu_si128((const __m128i*)&cx->ks[0]));
+    for (r=1; r<10; r++) {
+        s = _mm_aesenc_si128(s, _mm_loadu_si128((const __m128i*)&cx->ks[4*r]));
+    }
+    s = _mm_aesenclast_si128(s, _mm_loadu_si128((const __m128i*)&cx->ks[40]));
+    _mm_storeu_si128((__m128i*)out, s);
+    return 0;
+}
+
+
+
+AESNI_TARGET
+void aesni_encrypt_x2(io_t* a, io_t* b, const aes_encrypt_ctx cx[1]) {
+    __m128i s0, s1, k;
+    int r;
+
+    k   = _mm_loadu_si128((const __m128i*)&cx->ks[0]);
+    s0  = _mm_xor_si128(_mm_loadu_si128((const __m128i*)a), k);
+    s1  = _mm_xor_si128(_mm_loadu_si128((const __m128i*)b), k);
+    for (r=1; r<10; r++) {
+        k   = _mm_loadu_si128((const __m128i*)&cx->ks[4*r]);
+        s0  = _mm_aesenc_si128(s0, k);
+        s1  = _mm_aesenc_si128(s1, k);
+    }
+    k   = _mm_loadu_si128((const __m128i*)&cx->ks[40]);
+    _mm_storeu_si128((__m128i*)a, _mm_aesenclast_si128(s0, k));
+    _mm_storeu_si128((__m128i*)b, _mm_aesenclast_si128(s1, k));
+}
+
+
+
+AESNI_TARGET
+static void sub_cbcmac_x8(const io_t* const data[], io_t* const cbc[], unsigned int n,
+                          unsigned long blocks, const aes_encrypt_ctx cx[1]) {
+    __m128i rk[11];
+    __m128i s[8];
+    unsigned long k;
+    unsigned int i;
+    int r;
+
+    for (r=0; r<11; r++) {
+        rk[r] = _mm_loadu_si128((const __m128i*)&cx->ks[4*r]);
+    }
+    for (i=0; i<n; i++) {
+        s[i] = _mm_loadu_si128((const __m128i*)cbc[i]);
+    }
+
+    for (k=0; k<blocks; k++) {
+        for (i=0; i<n; i++) {
+            s[i] = _mm_xor_si128(s[i], rk[0]);
+        }
+        for (r=1; r<10; r++) {
+            for (i=0; i<n; i++) {
+                s[i] = _mm_aesenc_si128(s[i], rk[r]);
+            }
+        }
+        for (i=0; i<n; i++) {
+            s[i] = _mm_aesenclast_si128(s[i], rk[10]);
+            s[i] = _mm_xor_si128(s[i], _mm_loadu_si128((const __m128i*)&((const uint_8t*)data[i])[16*k]));
+        }
+    }
+
+    for (i=0; i<n; i++) {
+        _mm_storeu_si128((__m128i*)cbc[i], s[i]);
+    }
+}
+
+
+
+#if defined(VAES_POSSIBLE)
+/* Chain j is in lane j%4 of register j/4.  Unused lanes of the last
+   register run on a copy of chain 0, and are not stored.
+*/
+VAES_TARGET
+static void sub_vaes_cbcmac(const io_t* const data[], io_t* const cbc[], unsigned int n,
+                            unsigned long blocks, const aes_encrypt_ctx cx[1]) {
+    const uint_8t* d[32];
+    __m512i rk[11];
+    __m512i s[8];
+    __m128i t[4];
+    unsigned long k;
+    unsigned int i, g;
+    int r;
+
+    g = (n + 3) / 4;
+    for (i=0; i<(4*g); i++) {
+        d[i] = (const uint_8t*)data[(i < n) ? i : 0];
+    }
+    for (r=0; r<11; r++) {
+        rk[r] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&cx->ks[4*r]));
+    }
+    for (i=0; i<g; i++) {
+        s[i] = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i*)cbc[4*i]));
+        s[i] = _mm512_inserti32x4(s[i], _mm_loadu_si128((const __m128i*)cbc[(4*i+1 < n) ? 4*i+1 : 0]), 1);
+        s[i] = _mm512_inserti32x4(s[i], _mm_loadu_si128((const __m128i*)cbc[(4*i+2 < n) ? 4*i+2 : 0]), 2);
+        s[i] = _mm512_inserti32x4(s[i], _mm_loadu_si128((const __m128i*)cbc[(4*i+3 < n) ? 4*i+3 : 0]), 3);
+    }
+
+    for (k=0; k<blocks; k++) {
+        for (i=0; i<g; i++) {
+            s[i] = _mm512_xor_si512(s[i], rk[0]);
+        }
+        for (r=1; r<10; r++) {
+            for (i=0; i<g; i++) {
+                s[i] = _mm512_aesenc_epi128(s[i], rk[r]);
+            }
+        }
+        for (i=0; i<g; i++) {
+            __m512i x;
+            x = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i*)&d[4*i][16*k]));
+            x = _mm512_inserti32x4(x, _mm_loadu_si128((const __m128i*)&d[4*i+1][16*k]), 1);
+            x = _mm512_inserti32x4(x, _mm_loadu_si128((const __m128i*)&d[4*i+2][16*k]), 2);
+            x = _mm512_inserti32x4(x, _mm_loadu_si128((const __m128i*)&d[4*i+3][16*k]), 3);
+            s[i] = _mm512_xor_si512(_mm512_aesenclast_epi128(s[i], rk[10]), x);
+        }
+    }
+
+    for (i=0; i<n; i++) {
+        if ((i & 3) == 0) {
+            _mm512_storeu_si512((void*)t, s[i/4]);
+        }
+        _mm_storeu_si128((__m128i*)cbc[i], t[i & 3]);
+    }
+}
+#endif
+
+
+
+void aesni_cbcmac_xn(const io_t* const data[], io_t* const cbc[], unsigned int n,
+                     unsigned long blocks, const aes_encrypt_ctx cx[1]) {
+    unsigned int i;
+
+#   if defined(VAES_POSSIBLE)
+    if ((n > 4) && sub_vaes_on()) {
+        sub_vaes_cbcmac(data, cbc, n, blocks, cx);
+        return;
+    }
+#   endif
+    for (i=0; i<n; i+=8) {
+        sub_cbcmac_x8(&data[i], &cbc[i], ((n-i) > 8) ? 8 : (n-i), blocks, cx);
+    }
+}
+
+
+
+
+/* GHASH is done on byte-reversed blocks, so that the bit-reflected GCM field
+   maps onto PCLMULQDQ with one left shift before the reduction.  Products
+   are accumulated unreduced, so several blocks share one reduction.
+*/
+CLMUL_TARGET static inline void sub_clmul_acc(__m128i a, __m128i b, __m128i* lo, __m128i* mid, __m128i* hi) {
+    *lo     = _mm_xor_si128(*lo, _mm_clmulepi64_si128(a, b, 0x00));
+    *hi     = _mm_xor_si128(*hi, _mm_clmulepi64_si128(a, b, 0x11));
+    *mid    = _mm_xor_si128(*mid, _mm_clmulepi64_si128(a, b, 0x10));
+    *mid    = _mm_xor_si128(*mid, _mm_clmulepi64_si128(a, b, 0x01));
+}
+
+
+
+CLMUL_TARGET static inline __m128i sub_clmul_reduce(__m128i lo, __m128i mid, __m128i hi) {
+    __m128i t0, t1, t2;
+
+    lo  = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi  = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    /* shift the 256 bit product left by one */
+    t0  = _mm_srli_epi32(lo, 31);
+    t1  = _mm_srli_epi32(hi, 31);
+    lo  = _mm_slli_epi32(lo, 1);
+    hi  = _mm_slli_epi32(hi, 1);
+    t2  = _mm_srli_si128(t0, 12);
+    t1  = _mm_slli_si128(t1, 4);
+    t0  = _mm_slli_si128(t0, 4);
+    lo  = _mm_or_si128(lo, t0);
+    hi  = _mm_or_si128(hi, t1);
+    hi  = _mm_or_si128(hi, t2);
+
+    /* reduce modulo x^128 + x^7 + x^2 + x + 1 */
+    t0  = _mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30));
+    t0  = _mm_xor_si128(t0, _mm_slli_epi32(lo, 25));
+    t1  = _mm_srli_si128(t0, 4);
+    t0  = _mm_slli_si128(t0, 12);
+    lo  = _mm_xor_si128(lo, t0);
+    t2  = _mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2));
+    t2  = _mm_xor_si128(t2, _mm_srli_epi32(lo, 7));
+    t2  = _mm_xor_si128(t2, t1);
+    lo  = _mm_xor_si128(lo, t2);
+    return _mm_xor_si128(hi, lo);
+}
+
+
+
+CLMUL_TARGET static inline __m128i sub_clmul_mul(__m128i a, __m128i b) {
+    __m128i lo  = _mm_setzero_si128();
+    __m128i mid = _mm_setzero_si128();
+    __m128i hi  = _mm_setzero_si128();
+
+    sub_clmul_acc(a, b, &lo, &mid, &hi);
+    return sub_clmul_reduce(lo, mid, hi);
+}
+
+
+
+CLMUL_TARGET
+void aesni_ghash_init(const io_t* h, io_t* hpow) {
+    const __m128i bswap = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    __m128i p[4];
+    int i;
+
+    p[0] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)h), bswap);
+    for (i=1; i<4; i++) {
+        p[i] = sub_clmul_mul(p[i-1], p[0]);
+    }
+    for (i=0; i<4; i++) {
+        _mm_storeu_si128((__m128i*)&((uint_8t*)hpow)[16*i], p[i]);
+    }
+}
+
+
+
+CLMUL_TARGET
+void aesni_ghash_blocks(const io_t* data_v, unsigned long blocks, io_t* y, const io_t* hpow) {
+    const __m128i bswap = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    const uint_8t* data = (const uint_8t*)data_v;
+    __m128i h[4];
+    __m128i x, lo, mid, hi;
+    int i;
+
+    for (i=0; i<4; i++) {
+        h[i] = _mm_loadu_si128((const __m128i*)&((const uint_8t*)hpow)[16*i]);
+    }
+    x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)y), bswap);
+
+    /* Y = (Y ^ X0)H^4 ^ X1 H^3 ^ X2 H^2 ^ X3 H, with one reduction */
+    while (blocks >= 4) {
+        lo = mid = hi = _mm_setzero_si128();
+        for (i=0; i<4; i++) {
+            __m128i d = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&data[16*i]), bswap);
+            if (i == 0) {
+                d = _mm_xor_si128(d, x);
+            }
+            sub_clmul_acc(d, h[3-i], &lo, &mid, &hi);
+        }
+        x       = sub_clmul_reduce(lo, mid, hi);
+        data    = &data[4*16];
+        blocks -= 4;
+    }
+
+    while (blocks != 0) {
+        x       = _mm_xor_si128(x, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)data), bswap));
+        x       = sub_clmul_mul(x, h[0]);
+        data    = &data[16];
+        blocks -= 1;
+    }
+
+    _mm_storeu_si128((__m128i*)y, _mm_shuffle_epi8(x, bswap));
+}
+
+#endif
+
+#line 1 "main/aesdisp.c"
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/aesdisp.c
+  * @brief      aes_encrypt() kernel dispatch
+  *
+  * With AES_DISPATCH, aes_encrypt() is defined here and calls through a
+  * pointer to the selected kernel.  The kernel is resolved when the library
+  * is loaded, by a constructor that reads OTEAX_KERNEL and the CPU features,
+  * so threads never race to make the first choice.  Code that runs before
+  * the constructor (another library's constructor, say) finds a stub that
+  * resolves through the same pthread_once().  The pointers, and the AES-NI
+  * setting in aesni.c, are atomic, so aes_kernel_select() can change them
+  * while other threads encrypt: each block goes through one kernel or the
+  * other, and both give the same result.  Contexts keyed for the
+  * constant-time kernel go to a second pointer, which is AES-NI when that is
+  * selected (it is constant-time too) and aes_encrypt_ct() otherwise.
+  *
+  * There is no separate portable multi-block entry.  Without AES-NI, the
+  * multi-block CTR and CBC-MAC loops (aes_ctr_blocks(), cmac_messages())
+  * are portable C that batch blocks through whichever table kernel is
+  * selected here, so they come with every table kernel in the list.
+  ******************************************************************************
+  */
+
+#include "oteax/aesopt.h"
+#include "oteax/aesni.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#if defined(AES_DISPATCH)
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+typedef AES_RETURN (*aes_kernel_fn)(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]);
+
+typedef struct {
+    const char*     name;
+    aes_kernel_fn   encrypt;
+    int             simd;           /* for aesni_enable(): 1 AES-NI, 2 with VAES */
+} aes_kernel_t;
+
+/* In order of preference */
+static const aes_kernel_t kernels[] = {
+#   if defined(VAES_POSSIBLE)
+    { "vaes",   &aesni_encrypt,         2 },
+#   endif
+#   if defined(AESNI_POSSIBLE)
+    { "aesni",  &aesni_encrypt,         1 },
+#   endif
+    { "speed",  &aes_encrypt_speed,     0 },
+    { "normal", &aes_encrypt_normal,    0 },
+    { "size",   &aes_encrypt_size,      0 }
+};
+
+#define NUM_KERNELS (sizeof(kernels) / sizeof(aes_kernel_t))
+
+static AES_RETURN sub_first(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]);
+
+static pthread_once_t       resolved    = PTHREAD_ONCE_INIT;
+static const aes_kernel_t*  sel         = NULL;
+static aes_kernel_fn        fast_fn     = &sub_first;
+static aes_kernel_fn        safe_fn     = &sub_first;
+
+
+
+static int sub_usable(const aes_kernel_t* k) {
+#   if defined(AESNI_POSSIBLE)
+    if (k->simd > 1) {
+        return aesni_supported() && aesni_vaes_supported();
+    }
+    if (k->simd) {
+        return aesni_supported();
+    }
+#   endif
+    return 1;
+}
+
+
+
+static const aes_kernel_t* sub_find(const char* name) {
+    unsigned int i;
+
+    for (i=0; i<NUM_KERNELS; i++) {
+        if ((strcmp(name, kernels[i].name) == 0) && sub_usable(&kernels[i])) {
+            return &kernels[i];
+        }
+    }
+    return NULL;
+}
+
+
+
+static void sub_set(const aes_kernel_t* k) {
+    __atomic_store_n(&fast_fn, k->encrypt, __ATOMIC_RELAXED);
+    __atomic_store_n(&safe_fn, (k->simd ? k->encrypt : &aes_encrypt_ct), __ATOMIC_RELAXED);
+#   if defined(AESNI_POSSIBLE)
+    aesni_enable(k->simd);
+#   endif
+    __atomic_store_n(&sel, k, __ATOMIC_RELEASE);
+}
+
+
+
+/* The kernel named, or the first usable one if name is NULL or can't be used */
+static AES_RETURN sub_choose(const char* name) {
+    const aes_kernel_t* k = NULL;
+    unsigned int        i;
+
+    if (name != NULL) {
+        k = sub_find(name);
+    }
+    if (k == NULL) {
+        for (i=0; !sub_usable(&kernels[i]); i++);
+        k = &kernels[i];
+    }
+    sub_set(k);
+    return ((name == NULL) || (strcmp(name, k->name) == 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+
+static void sub_resolve(void) {
+    sub_choose(getenv("OTEAX_KERNEL"));
+}
+
+
+
+__attribute__((constructor)) static void sub_load(void) {
+    pthread_once(&resolved, &sub_resolve);
+}
+
+
+
+static AES_RETURN sub_first(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {
+    pthread_once(&resolved, &sub_resolve);
+    return aes_encrypt(in, out, cx);
+}
+
+
+
+AES_RETURN aes_encrypt(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {
+    if (INF_B(cx->inf,1) == AES_KERNEL_CT) {
+        return __atomic_load_n(&safe_fn, __ATOMIC_RELAXED)(in, out, cx);
+    }
+    return __atomic_load_n(&fast_fn, __ATOMIC_RELAXED)(in, out, cx);
+}
+
+
+
+void aes_kernel_resolve(void) {
+    pthread_once(&resolved, &sub_resolve);
+}
+
+
+
+AES_RETURN aes_kernel_select(const char* name) {
+    const aes_kernel_t* k;
+
+    pthread_once(&resolved, &sub_resolve);
+    if (name == NULL) {
+        return sub_choose(getenv("OTEAX_KERNEL"));
+    }
+    /* an unknown or unusable name leaves the kernel as it is */
+    k = sub_find(name);
+    if (k == NULL) {
+        return EXIT_FAILURE;
+    }
+    sub_set(k);
+    return EXIT_SUCCESS;
+}
+
+
+
+const char* aes_kernel_name(void) {
+    pthread_once(&resolved, &sub_resolve);
+    return __atomic_load_n(&sel, __ATOMIC_ACQUIRE)->name;
+}
+
+#undef NUM_KERNELS
+
+
+#else
+
+#if (OTEAX_OPTIMIZATION < 0)
+#   define KERNEL_NAME  "size"
+#elif (OTEAX_OPTIMIZATION == 0)
+#   define KERNEL_NAME  "normal"
+#else
+#   define KERNEL_NAME  "speed"
+#endif
+
+AES_RETURN aes_kernel_select(const char* name) {
+    const char* a = KERNEL_NAME;
+
+    if (name == NULL) {
+        return EXIT_SUCCESS;
+    }
+    while ((*a != 0) && (*a == *name)) {
+        a++;
+        name++;
+    }
+    return (*a == *name) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+
+const char* aes_kernel_name(void) {
+    return KERNEL_NAME;
+}
+
+
+
+/* With one kernel, the AES-NI paths for CTR and CBC-MAC go by the CPU alone */
+void aes_kernel_resolve(void) {
+#   if defined(AESNI_POSSIBLE)
+    aesni_enable(aesni_supported() ? 2 : 0);
+#   endif
+}
+
+#undef KERNEL_NAME
+
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#line 1 "main/aes_modes_m2.c"
+/*
+---------------------------------------------------------------------------
+Copyright (c) 1998-2010, Brian Gladman, Worcester, UK. All rights reserved.
+
+The redistribution and use of this software (with or without changes)
+is allowed without the payment of fees or royalties provided that:
+
+  source code distributions include the above copyright notice, this
+  list of conditions and the following disclaimer;
+
+  binary distributions include the above copyright notice, this list
+  of conditions and the following disclaimer in their documentation.
+
+This software is provided 'as is' with no explicit or implied warranties
+in respect of its operation, including, but not limited to, correctness
+and fitness for purpose.
+---------------------------------------------------------------------------
+*/
+
+/** @note [JP Norair, 25-Aug-2014] This is an edited version of aes_modes.c
+  * from 20/12/2007, but it only implemented the necessary AES modes for 
+  * OpenTag/DASH7.  In particular, this is AES-CTR which is used as the base
+  * cipher for EAX.  Additionally, any codeblocks specific to platforms not
+  * supported by OpenTag (or ever likely to be supported in the future) have
+  * been removed for readability purposes.  To compile for other AES modes,
+  * use legacy/aes_modes.c instead of this file.
+  */
+
+
+
+//#include <string.h>
+#include <assert.h>
+
+#include "oteax/aesopt.h"
+#include "oteax/mode_hdr.h"
+#include "oteax/aesni.h"
+
+#if defined( AES_MODES )
+
+#define BFR_BLOCKS      8
+
+/* These values are used to detect long word alignment in order to */
+/* speed up some buffer operations. This facility may not work on  */
+/* some machines so this define can be commented out if necessary  */
+
+#define FAST_BUFFER_OPERATIONS
+
+#define lp32(x)         ((uint_32t*)(x))
+
+
+
+#define aligned_array(type, name, no, stride) type name[no]
+#define aligned_auto(type, name, no, stride)  type name[no]
+
+#define via_cwd(cwd, ty, dir, len)              \
+    aligned_auto(unsigned long, cwd, 4, 16);    \
+    cwd[1] = cwd[2] = cwd[3] = 0;               \
+    cwd[0] = neh_##dir##_##ty##_key(len)
+
+
+/* test the code for detecting and setting pointer alignment */
+#ifndef __C2000__
+AES_RETURN aes_test_alignment_detection(unsigned int n)	/* 4 <= n <= 16 */
+{	uint_8t	p[16];
+    uint_32t i, count_eq = 0, count_neq = 0;
+
+    if(n < 4 || n > 16) {
+        return EXIT_FAILURE;
+    }
+    
+    for(i = 0; i < n; ++i) {
+        uint_8t *qf = ALIGN_FLOOR(p + i, n),
+                *qh =  ALIGN_CEIL(p + i, n);
+        
+        if(qh == qf)
+            ++count_eq;
+        else if(qh == qf + n)
+            ++count_neq;
+        else
+            return EXIT_FAILURE;
+    }
+    return (count_eq != 1 || count_neq != n - 1 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+#endif
+
+
+
+AES_RETURN aes_mode_reset(aes_encrypt_ctx ctx[1]) {
+    ///@note [JPN] changing inf access to support INF macro
+    //ctx->inf.b[2] = 0;
+    INF_B(ctx->inf, 2) = 0;
+    return EXIT_SUCCESS;
+}
+
+
+
+
+AES_RETURN aes_ecb_encrypt(const io_t *ibuf, io_t *obuf, int len, const aes_encrypt_ctx ctx[1]) {
+#if defined(__ALIGN32__)
+#   define _BLKSZ   (AES_BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   (AES_BLOCK_SIZE/1)
+#endif
+
+    int nb = len/_BLKSZ;
+
+    if (len & (_BLKSZ - 1))
+        return EXIT_FAILURE;
+
+    while (nb--) {
+        if (aes_encrypt(ibuf, obuf, ctx) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+            
+        ibuf = &ibuf[_BLKSZ];
+        obuf = &obuf[_BLKSZ];
+    }
+    
+    return EXIT_SUCCESS;
+    
+#undef _BLKSZ
+}
+
+
+
+
+AES_RETURN aes_ecb_decrypt(const io_t *ibuf, io_t *obuf, int len, const aes_decrypt_ctx ctx[1]) {
+#if defined(__ALIGN32__)
+#   define _BLKSZ   (AES_BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   (AES_BLOCK_SIZE/1)
+#endif
+
+    int nb = len/_BLKSZ;
+
+    if (len & (_BLKSZ - 1))
+        return EXIT_FAILURE;
+
+    while (nb--) {
+        if (aes_decrypt(ibuf, obuf, ctx) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+            
+        ibuf = &ibuf[_BLKSZ];
+        obuf = &obuf[_BLKSZ];
+    }
+
+    return EXIT_SUCCESS;
+    
+#undef _BLKSZ
+}
+
+
+
+
+/* CTR mode
+ * The counter is handled as four native 32 bit words, so a batch of counter
+ * blocks is produced with plain word adds instead of a byte-wise increment
+ * per block.  Whole blocks go through aesni_ctr_blocks() when the CPU has
+ * AES-NI, else through aes_encrypt() in batches of BFR_BLOCKS.
+ */
+
+#if defined(__ALIGN32__)
+#   define _BLKSZ   (AES_BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   (AES_BLOCK_SIZE/1)
+#endif
+
+static void sub_ctr_load(uint_32t w[4], const io_t* c) {
+#if defined(__ALIGN32__)
+    w[0] = NET_ENDIAN32(c[0]);
+    w[1] = NET_ENDIAN32(c[1]);
+    w[2] = NET_ENDIAN32(c[2]);
+    w[3] = NET_ENDIAN32(c[3]);
+#else
+    int i;
+    for (i=0; i<4; i++, c+=4) {
+        w[i] = ((uint_32t)c[0] << 24) | ((uint_32t)c[1] << 16) | ((uint_32t)c[2] << 8) | (uint_32t)c[3];
+    }
+#endif
+}
+
+
+
+static void sub_ctr_store(io_t* c, const uint_32t w[4]) {
+#if defined(__ALIGN32__)
+    c[0] = NET_ENDIAN32(w[0]);
+    c[1] = NET_ENDIAN32(w[1]);
+    c[2] = NET_ENDIAN32(w[2]);
+    c[3] = NET_ENDIAN32(w[3]);
+#else
+    int i;
+    for (i=0; i<4; i++, c+=4) {
+        c[0] = (uint_8t)(w[i] >> 24);
+        c[1] = (uint_8t)(w[i] >> 16);
+        c[2] = (uint_8t)(w[i] >> 8);
+        c[3] = (uint_8t)w[i];
+    }
+#endif
+}
+
+
+
+static void sub_ctr_inc(uint_32t w[4], int ctr_bits) {
+    if ((++w[3] == 0) && (ctr_bits > 32)) {
+        if ((++w[2] == 0) && (ctr_bits > 64)) {
+            if (++w[1] == 0) {
+                ++w[0];
+            }
+        }
+    }
+}
+
+
+
+AES_FLATTEN AES_RETURN aes_ctr_blocks(const io_t *ibuf, io_t *obuf, unsigned long blocks, io_t *ctr, int ctr_bits, const aes_encrypt_ctx ctx[1]) {
+    uint_32t        w[4];
+    uint_32t        buf[BFR_BLOCKS*4];
+    unsigned long   i, n;
+
+    if ((ctr_bits != 32) && (ctr_bits != 64) && (ctr_bits != 128)) {
+        return EXIT_FAILURE;
+    }
+
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_available()) {
+        aesni_ctr_blocks(ibuf, obuf, blocks, ctr, ctr_bits, ctx);
+        return EXIT_SUCCESS;
+    }
+#   endif
+
+    sub_ctr_load(w, ctr);
+
+    while (blocks != 0) {
+        n = (blocks > BFR_BLOCKS) ? BFR_BLOCKS : blocks;
+
+        for (i=0; i<n; i++) {
+            buf[4*i+0] = NET_ENDIAN32(w[0]);
+            buf[4*i+1] = NET_ENDIAN32(w[1]);
+            buf[4*i+2] = NET_ENDIAN32(w[2]);
+            buf[4*i+3] = NET_ENDIAN32(w[3]);
+            sub_ctr_inc(w, ctr_bits);
+        }
+        for (i=0; i<n; i++) {
+            aes_encrypt(IO_PTR(&buf[4*i]), IO_PTR(&buf[4*i]), ctx);
+        }
+
+#       if defined(__ALIGN32__)
+        for (i=0; i<(4*n); i++) {
+            obuf[i] = ibuf[i] ^ buf[i];
+        }
+#       else
+#       if !defined(__UNALIGNED_ACCESS__)
+        if (!ALIGN_OFFSET(ibuf, 4) && !ALIGN_OFFSET(obuf, 4)) {
+            for (i=0; i<(4*n); i++) {
+                lp32(obuf)[i] = lp32(ibuf)[i] ^ buf[i];
+            }
+        }
+        else
+#       endif
+        xor_bytes(obuf, ibuf, buf, 16*n);
+#       endif
+
+        ibuf    = &ibuf[n*_BLKSZ];
+        obuf    = &obuf[n*_BLKSZ];
+        blocks -= n;
+    }
+
+    sub_ctr_store(ctr, w);
+    return EXIT_SUCCESS;
+}
+
+
+
+AES_RETURN aes_ctr_init(const io_t *iv, int ctr_bits, aes_ctr_ctx cc[1]) {
+    if ((ctr_bits != 32) && (ctr_bits != 64) && (ctr_bits != 128)) {
+        return EXIT_FAILURE;
+    }
+    oteax_memcpy(cc->ctr, iv, AES_BLOCK_SIZE);
+    cc->b_pos       = _BLKSZ;
+    cc->ctr_bits    = (uint_8t)ctr_bits;
+    return EXIT_SUCCESS;
+}
+
+
+
+AES_RETURN aes_ctr_crypt(const io_t *ibuf, io_t *obuf, int len, aes_ctr_ctx cc[1], const aes_encrypt_ctx ctx[1]) {
+    int b_pos = cc->b_pos;
+
+    /* use up the key stream left over from the last call */
+    while ((b_pos < _BLKSZ) && (len > 0)) {
+        *obuf++ = *ibuf++ ^ IO_PTR(cc->ks)[b_pos++];
+        --len;
+    }
+
+    if (len >= _BLKSZ) {
+        unsigned long blocks = (unsigned long)len / _BLKSZ;
+
+        if (aes_ctr_blocks(ibuf, obuf, blocks, IO_PTR(cc->ctr), cc->ctr_bits, ctx) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+        ibuf    = &ibuf[blocks*_BLKSZ];
+        obuf    = &obuf[blocks*_BLKSZ];
+        len    -= (int)(blocks*_BLKSZ);
+    }
+
+    /* a trailing partial block keeps its key stream for the next call */
+    if (len > 0) {
+        uint_32t w[4];
+
+        if (aes_encrypt(IO_PTR(cc->ctr), IO_PTR(cc->ks), ctx) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+        sub_ctr_load(w, IO_PTR(cc->ctr));
+        sub_ctr_inc(w, cc->ctr_bits);
+        sub_ctr_store(IO_PTR(cc->ctr), w);
+
+        for (b_pos=0; len>0; --len) {
+            *obuf++ = *ibuf++ ^ IO_PTR(cc->ks)[b_pos++];
+        }
+    }
+
+    cc->b_pos = (uint_8t)b_pos;
+    return EXIT_SUCCESS;
+}
+
+#undef _BLKSZ
+
+#endif
+
+#line 1 "main/backend.c"
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/backend.c
+  * @brief      Software cipher backend
+  *
+  * The operations are written in terms of aes_encrypt(), so they work in
+  * every build configuration, including __ALIGN32__ and __OTF_KEYSCHED__.
+  ******************************************************************************
+  */
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (AES_BLOCK_SIZE/4)
+#   define _XOR     xor_block_aligned
+#else
+#   define _BLKSZ   AES_BLOCK_SIZE
+#   define _XOR     xor_block
+#endif
+
+
+
+static ret_type sw_block(const io_t* in, io_t* out, const aes_encrypt_ctx cx[1], void* hdl) {
+    (void)hdl;
+    return aes_encrypt(in, out, cx);
+}
+
+
+
+static ret_type sw_ecb(const io_t* in, io_t* out, unsigned long blocks, const aes_encrypt_ctx cx[1], void* hdl) {
+    (void)hdl;
+    while (blocks-- != 0) {
+        aes_encrypt(in, out, cx);
+        in  += _BLKSZ;
+        out += _BLKSZ;
+    }
+    return RETURN_GOOD;
+}
+
+
+
+static ret_type sw_ctr(io_t* data, unsigned long blocks, io_t* ctr, const aes_encrypt_ctx cx[1], void* hdl) {
+    eax_buf_t ks;
+
+    (void)hdl;
+    while (blocks-- != 0) {
+        aes_encrypt(ctr, IO_PTR(ks), cx);
+        inc_ctr(ctr);
+        _XOR(data, data, ks);
+        data += _BLKSZ;
+    }
+    return RETURN_GOOD;
+}
+
+
+
+static ret_type sw_cbcmac(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx cx[1], void* hdl) {
+    (void)hdl;
+    while (blocks-- != 0) {
+        aes_encrypt(cbc, cbc, cx);
+        _XOR(cbc, cbc, data);
+        data += _BLKSZ;
+    }
+    return RETURN_GOOD;
+}
+
+
+
+const eax_backend eax_backend_sw = {
+    "software",
+    &sw_block,
+    &sw_ecb,
+    &sw_ctr,
+    &sw_cbcmac,
+    NULL
+};
+
+#undef _XOR
+#undef _BLKSZ
+
+#line 1 "main/coproc.c"
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/coproc.c
+  * @brief      Simulated AES co-processor backend
+  *
+  * This behaves like a DMA-driven AES peripheral: operations are queued and
+  * the caller returns at once, a worker thread takes them in order, sleeps
+  * for the configured latency, and then does the work with the software
+  * backend.  It allows offload paths, and their overlap with CPU work, to be
+  * developed and benchmarked on an ordinary POSIX host.
+  ******************************************************************************
+  */
+
+#include "oteax.h"
+
+#if defined(COPROC_POSSIBLE)
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+/// Queue depth.  Submitting to a full queue blocks until a slot frees up.
+#define COPROC_QLEN     64
+
+typedef enum {
+    COPROC_BLOCK = 0,
+    COPROC_ECB,
+    COPROC_CTR,
+    COPROC_CBCMAC
+} coproc_op_t;
+
+typedef struct {
+    coproc_op_t             op;
+    const io_t*             in;
+    io_t*                   out;
+    io_t*                   state;
+    unsigned long           blocks;
+    const aes_encrypt_ctx*  cx;
+} coproc_job_t;
+
+typedef struct {
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    pthread_cond_t  done;
+    unsigned long   job_ns;
+    unsigned long   block_ns;
+    unsigned int    head;
+    unsigned int    tail;
+    int             quit;
+    coproc_job_t    queue[COPROC_QLEN];
+} coproc_t;
+
+
+
+static void sub_delay(unsigned long ns) {
+    struct timespec ts;
+
+    if (ns != 0) {
+        ts.tv_sec   = ns / 1000000000UL;
+        ts.tv_nsec  = ns % 1000000000UL;
+        while (nanosleep(&ts, &ts) != 0);
+    }
+}
+
+
+
+static void* sub_worker(void* arg) {
+    coproc_t* cp = (coproc_t*)arg;
+
+    pthread_mutex_lock(&cp->lock);
+    for (;;) {
+        coproc_job_t* job;
+
+        while ((cp->head == cp->tail) && !cp->quit) {
+            pthread_cond_wait(&cp->wake, &cp->lock);
+        }
+        if (cp->head == cp->tail) {
+            break;
+        }
+        job = &cp->queue[cp->head];
+        pthread_mutex_unlock(&cp->lock);
+
+        sub_delay(cp->job_ns + (job->blocks * cp->block_ns));
+
+        switch (job->op) {
+            case COPROC_BLOCK:  eax_backend_sw.block(job->in, job->out, job->cx, NULL);
+                                break;
+            case COPROC_ECB:    eax_backend_sw.ecb(job->in, job->out, job->blocks, job->cx, NULL);
+                                break;
+            case COPROC_CTR:    eax_backend_sw.ctr(job->out, job->blocks, job->state, job->cx, NULL);
+                                break;
+            case COPROC_CBCMAC: eax_backend_sw.cbcmac(job->in, job->blocks, job->state, job->cx, NULL);
+                                break;
+        }
+
+        pthread_mutex_lock(&cp->lock);
+        cp->head = (cp->head + 1) % COPROC_QLEN;
+        pthread_cond_broadcast(&cp->done);
+    }
+    pthread_mutex_unlock(&cp->lock);
+    return NULL;
+}
+
+
+
+static void sub_submit(coproc_t* cp, coproc_op_t op, const io_t* in, io_t* out, io_t* state,
+                        unsigned long blocks, const aes_encrypt_ctx* cx) {
+    coproc_job_t* job;
+
+    pthread_mutex_lock(&cp->lock);
+    while (((cp->tail + 1) % COPROC_QLEN) == cp->head) {
+        pthread_cond_wait(&cp->done, &cp->lock);
+    }
+    job         = &cp->queue[cp->tail];
+    job->op     = op;
+    job->in     = in;
+    job->out    = out;
+    job->state  = state;
+    job->blocks = blocks;
+    job->cx     = cx;
+    cp->tail    = (cp->tail + 1) % COPROC_QLEN;
+    pthread_cond_signal(&cp->wake);
+    pthread_mutex_unlock(&cp->lock);
+}
+
+
+
+static ret_type cp_sync(void* hdl) {
+    coproc_t* cp = (coproc_t*)hdl;
+
+    pthread_mutex_lock(&cp->lock);
+    while (cp->head != cp->tail) {
+        pthread_cond_wait(&cp->done, &cp->lock);
+    }
+    pthread_mutex_unlock(&cp->lock);
+    return RETURN_GOOD;
+}
+
+
+
+static ret_type cp_block(const io_t* in, io_t* out, const aes_encrypt_ctx cx[1], void* hdl) {
+    sub_submit((coproc_t*)hdl, COPROC_BLOCK, in, out, NULL, 1, cx);
+    return cp_sync(hdl);
+}
+
+
+
+static ret_type cp_ecb(const io_t* in, io_t* out, unsigned long blocks, const aes_encrypt_ctx cx[1], void* hdl) {
+    sub_submit((coproc_t*)hdl, COPROC_ECB, in, out, NULL, blocks, cx);
+    return RETURN_GOOD;
+}
+
+
+
+static ret_type cp_ctr(io_t* data, unsigned long blocks, io_t* ctr, const aes_encrypt_ctx cx[1], void* hdl) {
+    sub_submit((coproc_t*)hdl, COPROC_CTR, NULL, data, ctr, blocks, cx);
+    return RETURN_GOOD;
+}
+
+
+
+static ret_type cp_cbcmac(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx cx[1], void* hdl) {
+    sub_submit((coproc_t*)hdl, COPROC_CBCMAC, data, NULL, cbc, blocks, cx);
+    return RETURN_GOOD;
+}
+
+
+
+const eax_backend eax_backend_coproc = {
+    "coproc-sim",
+    &cp_block,
+    &cp_ecb,
+    &cp_ctr,
+    &cp_cbcmac,
+    &cp_sync
+};
+
+
+
+void* eax_coproc_open(unsigned long job_ns, unsigned long block_ns) {
+    coproc_t* cp;
+
+    cp = calloc(1, sizeof(coproc_t));
+    if (cp == NULL) {
+        return NULL;
+    }
+    cp->job_ns      = job_ns;
+    cp->block_ns    = block_ns;
+    pthread_mutex_init(&cp->lock, NULL);
+    pthread_cond_init(&cp->wake, NULL);
+    pthread_cond_init(&cp->done, NULL);
+
+    if (pthread_create(&cp->thread, NULL, &sub_worker, cp) != 0) {
+        pthread_cond_destroy(&cp->done);
+        pthread_cond_destroy(&cp->wake);
+        pthread_mutex_destroy(&cp->lock);
+        free(cp);
+        return NULL;
+    }
+    return cp;
+}
+
+
+
+void eax_coproc_close(void* hdl) {
+    coproc_t* cp = (coproc_t*)hdl;
+
+    if (cp == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&cp->lock);
+    cp->quit = 1;
+    pthread_cond_signal(&cp->wake);
+    pthread_mutex_unlock(&cp->lock);
+    pthread_join(cp->thread, NULL);
+
+    pthread_cond_destroy(&cp->done);
+    pthread_cond_destroy(&cp->wake);
+    pthread_mutex_destroy(&cp->lock);
+    free(cp);
+}
+
+#endif
+
+#line 1 "main/afalg.c"
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/afalg.c
+  * @brief      Linux AF_ALG kernel crypto offload for EAX
+  *
+  * Build with EXT_DEF=-D__AFALG__ to include this.  Messages at or above a
+  * length threshold have their CTR stage sent to the kernel's ctr(aes)
+  * transform and their ciphertext OMAC sent to cmac(aes).  This reaches AES
+  * accelerators that are registered with the Linux crypto API, and it works
+  * (slowly) with the stock aes-generic driver for testing.  Message data is
+  * moved into the kernel with vmsplice()/splice(), so it is not copied in
+  * userspace.  Small messages stay in software, where the socket overhead
+  * would dominate.
+  ******************************************************************************
+  */
+
+#if defined(__AFALG__) && defined(__linux__)
+#   ifndef _GNU_SOURCE
+#       define _GNU_SOURCE
+#   endif
+#endif
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+#include "oteax/afalg.h"
+
+#if defined(AFALG_POSSIBLE)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <pthread.h>
+#include <linux/if_alg.h>
+
+#ifndef AF_ALG
+#   define AF_ALG       38
+#endif
+#ifndef SOL_ALG
+#   define SOL_ALG      279
+#endif
+
+/// Data is moved through a pipe in chunks no larger than this.  It must be a
+/// multiple of the AES block size, and it should not exceed the pipe size.
+#define AFALG_CHUNK     (16 * 4096)
+
+/// Calibration sizes for the automatic threshold
+#define AFALG_CAL_MIN   256
+#define AFALG_CAL_MAX   AFALG_CHUNK
+
+
+typedef struct afalg_s {
+    struct afalg_s* next;
+    const eax_ctx*  owner;
+    int             ctr_tfm;
+    int             ctr_op;
+    int             mac_tfm;
+    int             mac_op;
+    int             pipe[2];
+    unsigned long   threshold;
+} afalg_t;
+
+/// Attached handles.  eax_init_and_key() may be given a context that was
+/// never initialized, so ctx->afalg is only trusted if it is on this list
+/// and was attached to that same context (not a copy of it).
+static afalg_t*         live;
+static pthread_mutex_t  live_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+static int sub_open_tfm(const char* type, const char* name, const void* key, int* op) {
+    struct sockaddr_alg sa;
+    int tfm;
+
+    oteax_memset(&sa, 0, sizeof(sa));
+    sa.salg_family = AF_ALG;
+    strncpy((char*)sa.salg_type, type, sizeof(sa.salg_type)-1);
+    strncpy((char*)sa.salg_name, name, sizeof(sa.salg_name)-1);
+
+    tfm = socket(AF_ALG, SOCK_SEQPACKET, 0);
+    if (tfm < 0) {
+        return -1;
+    }
+    if ((bind(tfm, (struct sockaddr*)&sa, sizeof(sa)) < 0)
+    ||  (setsockopt(tfm, SOL_ALG, ALG_SET_KEY, key, 16) < 0)
+    ||  ((*op = accept(tfm, NULL, 0)) < 0)) {
+        close(tfm);
+        return -1;
+    }
+    return tfm;
+}
+
+
+
+static void sub_close(afalg_t* hdl) {
+    if (hdl->ctr_op >= 0)   close(hdl->ctr_op);
+    if (hdl->ctr_tfm >= 0)  close(hdl->ctr_tfm);
+    if (hdl->mac_op >= 0)   close(hdl->mac_op);
+    if (hdl->mac_tfm >= 0)  close(hdl->mac_tfm);
+    if (hdl->pipe[0] >= 0)  close(hdl->pipe[0]);
+    if (hdl->pipe[1] >= 0)  close(hdl->pipe[1]);
+    free(hdl);
+}
+
+
+
+/** Move len bytes from buf into the op socket without copying.  If the kernel
+  * refuses splice for this socket, it falls back to an ordinary send.
+  * @note more is non-zero if more data will follow in the same operation.
+  */
+static int sub_splice(afalg_t* hdl, int op, const uint8_t* buf, size_t len, int more) {
+    while (len != 0) {
+        struct iovec    iov;
+        ssize_t         n, m;
+
+        iov.iov_base    = (void*)buf;
+        iov.iov_len     = len;
+        n = vmsplice(hdl->pipe[1], &iov, 1, 0);
+        if (n <= 0) {
+            break;
+        }
+        for (m=n; m>0; ) {
+            ssize_t s = splice(hdl->pipe[0], NULL, op, NULL, (size_t)m,
+                            (more || (m < (ssize_t)len)) ? SPLICE_F_MORE : 0);
+            if (s <= 0) {
+                return -1;
+            }
+            m -= s;
+        }
+        buf += n;
+        len -= n;
+    }
+
+    while (len != 0) {
+        ssize_t n = send(op, buf, len, more ? MSG_MORE : 0);
+        if (n <= 0) {
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+
+
+static int sub_read(int op, uint8_t* buf, size_t len) {
+    while (len != 0) {
+        ssize_t n = read(op, buf, len);
+        if (n <= 0) {
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+
+
+/** Add blocks to a big-endian 128 bit counter, as ctr(aes) does internally */
+static void sub_ctr_add(uint8_t* ctr, unsigned long blocks) {
+    int i;
+    for (i=15; (i>=0) && (blocks!=0); i--) {
+        blocks     += ctr[i];
+        ctr[i]      = (uint8_t)blocks;
+        blocks    >>= 8;
+    }
+}
+
+
+
+static int sub_ctr_crypt(afalg_t* hdl, uint8_t* data, unsigned long len, const uint8_t* ctr0) {
+    uint8_t ctr[16];
+
+    oteax_memcpy(ctr, ctr0, 16);
+
+    while (len != 0) {
+        char            cbuf[CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(sizeof(struct af_alg_iv) + 16)];
+        struct msghdr   msg;
+        struct cmsghdr* cmsg;
+        struct af_alg_iv* ivp;
+        size_t          chunk = (len > AFALG_CHUNK) ? AFALG_CHUNK : len;
+
+        oteax_memset(cbuf, 0, sizeof(cbuf));
+        oteax_memset(&msg, 0, sizeof(msg));
+        msg.msg_control     = cbuf;
+        msg.msg_controllen  = sizeof(cbuf);
+
+        cmsg                = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level    = SOL_ALG;
+        cmsg->cmsg_type     = ALG_SET_OP;
+        cmsg->cmsg_len      = CMSG_LEN(sizeof(uint32_t));
+        *(uint32_t*)CMSG_DATA(cmsg) = ALG_OP_ENCRYPT;
+
+        cmsg                = CMSG_NXTHDR(&msg, cmsg);
+        cmsg->cmsg_level    = SOL_ALG;
+        cmsg->cmsg_type     = ALG_SET_IV;
+        cmsg->cmsg_len      = CMSG_LEN(sizeof(struct af_alg_iv) + 16);
+        ivp                 = (struct af_alg_iv*)CMSG_DATA(cmsg);
+        ivp->ivlen          = 16;
+        oteax_memcpy(ivp->iv, ctr, 16);
+
+        if ((sendmsg(hdl->ctr_op, &msg, MSG_MORE) < 0)
+        ||  (sub_splice(hdl, hdl->ctr_op, data, chunk, 0) != 0)
+        ||  (sub_read(hdl->ctr_op, data, chunk) != 0)) {
+            return -1;
+        }
+
+        sub_ctr_add(ctr, chunk / 16);
+        data   += chunk;
+        len    -= chunk;
+    }
+    return 0;
+}
+
+
+
+/** OMAC^2(C) = CMAC([0..0 02] || C), and the nonce OMAC is already done, so
+  * the tag is just the XOR of the two.
+  */
+static int sub_compute_tag(afalg_t* hdl, const uint8_t* data, unsigned long len, uint8_t* tag, eax_ctx ctx[1]) {
+    static const uint8_t prefix[16] = { 0,0,0,0, 0,0,0,0, 0,0,0,0, 0,0,0,2 };
+    uint8_t mac[16];
+
+    if ((send(hdl->mac_op, prefix, 16, MSG_MORE) != 16)
+    ||  (sub_splice(hdl, hdl->mac_op, data, len, 1) != 0)
+    ||  (send(hdl->mac_op, NULL, 0, 0) < 0)
+    ||  (sub_read(hdl->mac_op, mac, 16) != 0)) {
+        return -1;
+    }
+    tag[0] = UI8_PTR(ctx->nce_cbc)[0] ^ mac[0];
+    tag[1] = UI8_PTR(ctx->nce_cbc)[1] ^ mac[1];
+    tag[2] = UI8_PTR(ctx->nce_cbc)[2] ^ mac[2];
+    tag[3] = UI8_PTR(ctx->nce_cbc)[3] ^ mac[3];
+    return 0;
+}
+
+
+
+ret_type afalg_eax_encrypt(const io_t* iv, io_t* msg, unsigned long msg_len, eax_ctx ctx[1]) {
+    afalg_t* hdl = (afalg_t*)ctx->afalg;
+
+    eax_init_message(iv, ctx);
+
+    if ((sub_ctr_crypt(hdl, msg, msg_len, UI8_PTR(ctx->ctr_val)) != 0)
+    ||  (sub_compute_tag(hdl, msg, msg_len, &msg[msg_len], ctx) != 0)) {
+        return RETURN_ERROR;
+    }
+
+    ctx->txt_ccnt = msg_len;
+    ctx->txt_acnt = msg_len;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type afalg_eax_decrypt(const io_t* iv, io_t* msg, unsigned long msg_len, eax_ctx ctx[1]) {
+    afalg_t*    hdl = (afalg_t*)ctx->afalg;
+    uint_32t    local_tag[1];
+    uint_32t    rx_tag;
+
+    eax_init_message(iv, ctx);
+
+    if ((sub_compute_tag(hdl, msg, msg_len, (uint8_t*)local_tag, ctx) != 0)
+    ||  (sub_ctr_crypt(hdl, msg, msg_len, UI8_PTR(ctx->ctr_val)) != 0)) {
+        return RETURN_ERROR;
+    }
+
+    oteax_memcpy(&rx_tag, &msg[msg_len], 4);
+    ctx->txt_ccnt = msg_len;
+    ctx->txt_acnt = msg_len;
+    return 0 - (ret_type)(tag_mask(&rx_tag, (const uint_32t*)local_tag, 1) ^ 1);
+}
+
+
+
+unsigned long afalg_threshold(void* hdl) {
+    return ((afalg_t*)hdl)->threshold;
+}
+
+
+
+static double sub_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (1e-9 * (double)ts.tv_nsec);
+}
+
+/** Find the smallest power-of-4 message length at which AF_ALG beats the
+  * software path for this context.  If it never does, AF_ALG is left idle.
+  */
+static unsigned long sub_calibrate(eax_ctx ctx[1]) {
+    static const uint8_t nonce[7] = { 0 };
+    eax_ctx         sw;
+    uint8_t*        buf;
+    unsigned long   size;
+    unsigned long   threshold = ULONG_MAX;
+
+    buf = calloc(1, AFALG_CAL_MAX + 4);
+    if (buf == NULL) {
+        return threshold;
+    }
+    oteax_memcpy(&sw, ctx, sizeof(eax_ctx));
+    sw.afalg = NULL;
+
+    for (size=AFALG_CAL_MIN; size<=AFALG_CAL_MAX; size*=4) {
+        double  t0, t_sw, t_hw;
+        int     i, reps = (int)(AFALG_CAL_MAX / size);
+
+        t0 = sub_now();
+        for (i=0; i<reps; i++) {
+            eax_encrypt_message(nonce, buf, size, &sw);
+        }
+        t_sw = sub_now() - t0;
+
+        t0 = sub_now();
+        for (i=0; i<reps; i++) {
+            if (afalg_eax_encrypt(nonce, buf, size, ctx) != RETURN_GOOD) {
+                free(buf);
+                return ULONG_MAX;
+            }
+        }
+        t_hw = sub_now() - t0;
+
+        if (t_hw < t_sw) {
+            threshold = size;
+            break;
+        }
+    }
+
+    free(buf);
+    return threshold;
+}
+
+
+
+/** The key given to eax_afalg_attach() must be the one the context was keyed
+  * with.  The key schedule layout depends on the kernel, so compare E(0)
+  * under each instead.
+  */
+static int sub_same_key(const void* key, eax_ctx ctx[1]) {
+    static const uint_32t zero[4] = { 0, 0, 0, 0 };
+    aes_encrypt_ctx cx[1];
+    uint_32t        a[4], b[4];
+    int             same;
+
+    if (aes_encrypt_key128((const io_t*)key, cx) != EXIT_SUCCESS) {
+        return 0;
+    }
+    aes_encrypt((const io_t*)zero, (io_t*)a, cx);
+    aes_encrypt((const io_t*)zero, (io_t*)b, ctx->aes);
+    same = (tag_mask(a, b, 4) == 15);
+    oteax_memset(cx, 0, sizeof(cx));
+    return same;
+}
+
+
+
+ret_type eax_afalg_attach(const void* key, unsigned long threshold, eax_ctx ctx[1]) {
+    afalg_t* hdl;
+
+    eax_afalg_detach(ctx);
+    if (!sub_same_key(key, ctx)) {
+        return RETURN_ERROR;
+    }
+
+    hdl = malloc(sizeof(afalg_t));
+    if (hdl == NULL) {
+        return RETURN_ERROR;
+    }
+    hdl->ctr_op     = -1;
+    hdl->mac_op     = -1;
+    hdl->pipe[0]    = -1;
+    hdl->pipe[1]    = -1;
+    hdl->ctr_tfm    = sub_open_tfm("skcipher", "ctr(aes)", key, &hdl->ctr_op);
+    hdl->mac_tfm    = sub_open_tfm("hash", "cmac(aes)", key, &hdl->mac_op);
+
+    if ((hdl->ctr_tfm < 0) || (hdl->mac_tfm < 0) || (pipe(hdl->pipe) != 0)) {
+        sub_close(hdl);
+        return RETURN_ERROR;
+    }
+
+    ctx->afalg = hdl;
+    hdl->threshold = (threshold != 0) ? threshold : sub_calibrate(ctx);
+
+    hdl->owner = ctx;
+    pthread_mutex_lock(&live_lock);
+    hdl->next  = live;
+    live       = hdl;
+    pthread_mutex_unlock(&live_lock);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_afalg_detach(eax_ctx ctx[1]) {
+    afalg_t**   pp;
+    afalg_t*    hdl = NULL;
+
+    pthread_mutex_lock(&live_lock);
+    for (pp=&live; *pp!=NULL; pp=&(*pp)->next) {
+        if ((*pp == (afalg_t*)ctx->afalg) && ((*pp)->owner == ctx)) {
+            hdl = *pp;
+            *pp = hdl->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&live_lock);
+
+    if (hdl != NULL) {
+        sub_close(hdl);
+    }
+    ctx->afalg = NULL;
+    return RETURN_GOOD;
+}
+
+#endif
+
+#line 1 "main/smallframe.c"
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/smallframe.c
+  * @brief      Unrolled EAX kernels for short frames
+  *
+  * Most DASH7 frames are 16 to 64 bytes, and at that size the alignment
+  * checks, position bookkeeping and tail loops of eax_auth_data() and
+  * eax_crypt_data() cost about as much as the AES itself.  Here a frame is
+  * known to start on a block boundary and to be the whole message, so each
+  * block is one CTR step and one CBC-MAC step with nothing else to decide.
+  * The two AES calls in a step are independent, and run interleaved where
+  * AES-NI is available.
+  ******************************************************************************
+  */
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+#include "oteax/aesni.h"
+#include "oteax/smallframe.h"
+
+#if defined(SMALLFRAME_POSSIBLE)
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ           (AES_BLOCK_SIZE/4)
+#   define _XOR(R, P, Q)    xor_block_aligned(R, P, Q)
+#else
+#   define _BLKSZ           AES_BLOCK_SIZE
+#   define _XOR(R, P, Q)    xor_block(R, P, Q)
+#endif
+
+typedef void (*smallframe_fn)(io_t* data, unsigned int last, eax_ctx* ctx);
+
+
+
+/* ks = E(ctr), cbc = E(cbc) */
+mh_decl void sub_aes_x2(io_t* ks, io_t* cbc, const aes_encrypt_ctx aes[1]) {
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_available()) {
+        aesni_encrypt_x2(ks, cbc, aes);
+        return;
+    }
+#   endif
+    aes_encrypt(ks, ks, aes);
+    aes_encrypt(cbc, cbc, aes);
+}
+
+
+
+mh_decl void sub_enc_block(io_t* d, eax_ctx* ctx) {
+    eax_buf_t ks;
+
+    oteax_memcpy(ks, ctx->ctr_val, AES_BLOCK_SIZE);
+    inc_ctr(ctx->ctr_val);
+    sub_aes_x2(IO_PTR(ks), IO_PTR(ctx->txt_cbc), ctx->aes);
+    _XOR(d, d, ks);
+    _XOR(ctx->txt_cbc, ctx->txt_cbc, d);
+}
+
+
+
+mh_decl void sub_dec_block(io_t* d, eax_ctx* ctx) {
+    eax_buf_t ks;
+
+    oteax_memcpy(ks, ctx->ctr_val, AES_BLOCK_SIZE);
+    inc_ctr(ctx->ctr_val);
+    sub_aes_x2(IO_PTR(ks), IO_PTR(ctx->txt_cbc), ctx->aes);
+    _XOR(ctx->txt_cbc, ctx->txt_cbc, d);
+    _XOR(d, d, ks);
+}
+
+
+
+/* The final block, "last" io_t units long (1 to _BLKSZ).  The key stream is
+   left in enc_ctr, as eax_crypt_data() would leave it.
+*/
+static void sub_enc_last(io_t* d, unsigned int last, eax_ctx* ctx) {
+    unsigned int i;
+
+    oteax_memcpy(ctx->enc_ctr, ctx->ctr_val, AES_BLOCK_SIZE);
+    inc_ctr(ctx->ctr_val);
+    sub_aes_x2(IO_PTR(ctx->enc_ctr), IO_PTR(ctx->txt_cbc), ctx->aes);
+    if (last == _BLKSZ) {
+        _XOR(d, d, ctx->enc_ctr);
+        _XOR(ctx->txt_cbc, ctx->txt_cbc, d);
+        return;
+    }
+    for (i=0; i<last; i++) {
+        d[i] ^= IO_PTR(ctx->enc_ctr)[i];
+        IO_PTR(ctx->txt_cbc)[i] ^= d[i];
+    }
+}
+
+
+
+static void sub_dec_last(io_t* d, unsigned int last, eax_ctx* ctx) {
+    unsigned int i;
+
+    oteax_memcpy(ctx->enc_ctr, ctx->ctr_val, AES_BLOCK_SIZE);
+    inc_ctr(ctx->ctr_val);
+    sub_aes_x2(IO_PTR(ctx->enc_ctr), IO_PTR(ctx->txt_cbc), ctx->aes);
+    if (last == _BLKSZ) {
+        _XOR(ctx->txt_cbc, ctx->txt_cbc, d);
+        _XOR(d, d, ctx->enc_ctr);
+        return;
+    }
+    for (i=0; i<last; i++) {
+        IO_PTR(ctx->txt_cbc)[i] ^= d[i];
+        d[i] ^= IO_PTR(ctx->enc_ctr)[i];
+    }
+}
+
+
+
+/* One kernel per block count: N-1 whole blocks, unrolled, then the final
+   block.  _REPn(f) expands to f(0); ... f(n-1);
+*/
+#define _REP0(f)
+#define _REP1(f)    _REP0(f)  f(0);
+#define _REP2(f)    _REP1(f)  f(1);
+#define _REP3(f)    _REP2(f)  f(2);
+#define _REP4(f)    _REP3(f)  f(3);
+#define _REP5(f)    _REP4(f)  f(4);
+#define _REP6(f)    _REP5(f)  f(5);
+#define _REP7(f)    _REP6(f)  f(6);
+#define _REP8(f)    _REP7(f)  f(7);
+#define _REP9(f)    _REP8(f)  f(8);
+#define _REP10(f)   _REP9(f)  f(9);
+#define _REP11(f)   _REP10(f) f(10);
+#define _REP12(f)   _REP11(f) f(11);
+#define _REP13(f)   _REP12(f) f(12);
+#define _REP14(f)   _REP13(f) f(13);
+#define _REP15(f)   _REP14(f) f(14);
+
+#define _ENC_STEP(I)    sub_enc_block(&data[(I)*_BLKSZ], ctx)
+#define _DEC_STEP(I)    sub_dec_block(&data[(I)*_BLKSZ], ctx)
+
+#define _KERNELS(N, REP)                                                        \
+static void sub_enc_##N(io_t* data, unsigned int last, eax_ctx* ctx) {          \
+    REP(_ENC_STEP)                                                              \
+    sub_enc_last(&data[((N)-1)*_BLKSZ], last, ctx);                             \
+}                                                                               \
+static void sub_dec_##N(io_t* data, unsigned int last, eax_ctx* ctx) {          \
+    REP(_DEC_STEP)                                                              \
+    sub_dec_last(&data[((N)-1)*_BLKSZ], last, ctx);                             \
+}
+
+_KERNELS(1,  _REP0)
+_KERNELS(2,  _REP1)
+_KERNELS(3,  _REP2)
+_KERNELS(4,  _REP3)
+_KERNELS(5,  _REP4)
+_KERNELS(6,  _REP5)
+_KERNELS(7,  _REP6)
+_KERNELS(8,  _REP7)
+_KERNELS(9,  _REP8)
+_KERNELS(10, _REP9)
+_KERNELS(11, _REP10)
+_KERNELS(12, _REP11)
+_KERNELS(13, _REP12)
+_KERNELS(14, _REP13)
+_KERNELS(15, _REP14)
+_KERNELS(16, _REP15)
+
+static const smallframe_fn enc_kernel[SMALLFRAME_BLOCKS] = {
+    &sub_enc_1,  &sub_enc_2,  &sub_enc_3,  &sub_enc_4,
+    &sub_enc_5,  &sub_enc_6,  &sub_enc_7,  &sub_enc_8,
+    &sub_enc_9,  &sub_enc_10, &sub_enc_11, &sub_enc_12,
+    &sub_enc_13, &sub_enc_14, &sub_enc_15, &sub_enc_16
+};
+
+static const smallframe_fn dec_kernel[SMALLFRAME_BLOCKS] = {
+    &sub_dec_1,  &sub_dec_2,  &sub_dec_3,  &sub_dec_4,
+    &sub_dec_5,  &sub_dec_6,  &sub_dec_7,  &sub_dec_8,
+    &sub_dec_9,  &sub_dec_10, &sub_dec_11, &sub_dec_12,
+    &sub_dec_13, &sub_dec_14, &sub_dec_15, &sub_dec_16
+};
+
+#undef _KERNELS
+#undef _DEC_STEP
+#undef _ENC_STEP
+
+
+
+static ret_type sub_run(const smallframe_fn* table, io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
+    unsigned long n = (data_len - 1) / _BLKSZ;
+
+    if ((data_len == 0) || (n >= SMALLFRAME_BLOCKS)) {
+        return RETURN_ERROR;
+    }
+    table[n](data, (unsigned int)(data_len - (n * _BLKSZ)), ctx);
+    ctx->txt_ccnt = (uint_32t)data_len;
+    ctx->txt_acnt = (uint_32t)data_len;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type smallframe_encrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
+    return sub_run(enc_kernel, data, data_len, ctx);
+}
+
+
+
+ret_type smallframe_decrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
+    return sub_run(dec_kernel, data, data_len, ctx);
+}
+
+#undef _XOR
+#undef _BLKSZ
+
+#endif
+
+#line 1 "main/cmac.c"
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/cmac.c
+  * @brief      AES-CMAC (OMAC1, RFC 4493 / SP 800-38B)
+  *
+  * EAX is built from three OMACs, so everything CMAC needs is already here:
+  * the pads from eax_init_and_key() are the CMAC subkeys K1 and K2, and the
+  * "lazy" CBC state of eax_auth_data() is the CMAC chaining value.  This
+  * file exposes that as plain CMAC, and it also holds the CBC-MAC kernels
+  * that eax_auth_data() uses for whole blocks.
+  ******************************************************************************
+  */
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+#include "oteax/aesni.h"
+#include "oteax/omac.h"
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (AES_BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   AES_BLOCK_SIZE
+#endif
+
+
+
+AES_FLATTEN static void sub_cbc_blocks(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx aes[1]) {
+#   if !defined(__C2000__) && !defined(__ALIGN32__)
+    if (ALIGN_OFFSET(data, 4) != 0) {
+        while (blocks-- != 0) {
+            aes_encrypt(cbc, cbc, aes);
+            xor_block(cbc, cbc, data);
+            data += _BLKSZ;
+        }
+        return;
+    }
+#   endif
+    while (blocks-- != 0) {
+        aes_encrypt(cbc, cbc, aes);
+        xor_block_aligned(cbc, cbc, data);
+        data += _BLKSZ;
+    }
+}
+
+
+
+void omac_cbc_blocks(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx aes[1]) {
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_available()) {
+        aesni_cbcmac_xn(&data, &cbc, 1, blocks, aes);
+        return;
+    }
+#   endif
+    sub_cbc_blocks(data, blocks, cbc, aes);
+}
+
+
+
+void omac_cbc_blocks_xn(const io_t* const data[], io_t* const cbc[], unsigned int n,
+                        unsigned long blocks, const aes_encrypt_ctx aes[1]) {
+    unsigned int i;
+
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_available()) {
+        aesni_cbcmac_xn(data, cbc, n, blocks, aes);
+        return;
+    }
+#   endif
+    for (i=0; i<n; i++) {
+        sub_cbc_blocks(data[i], blocks, cbc[i], aes);
+    }
+}
+
+
+
+
+/** Pad the final block in place and XOR in k_full (whole block) or k_part
+  * (partial block).  "used" is the number of io_t units in the final block,
+  * 0 to _BLKSZ.
+  */
+static void sub_finish_block(io_t* blk, unsigned int used, const io_t* k_full, const io_t* k_part) {
+    if (used < _BLKSZ) {
+#       if defined(__C2000__) || defined(__ALIGN32__)
+        blk[used] ^= NET_ENDIAN32(0x80000000);
+#       else
+        blk[used] ^= 0x80;
+#       endif
+        k_full = k_part;
+    }
+    xor_block_aligned(blk, blk, k_full);
+}
+
+
+
+void omac_message(const io_t* data, unsigned long len, io_t* mac,
+                  const io_t* k_full, const io_t* k_part, const aes_encrypt_ctx aes[1]) {
+    eax_buf_t       last;
+    unsigned long   nblk    = (len == 0) ? 0 : ((len - 1) / _BLKSZ);
+    unsigned int    used    = (unsigned int)(len - (nblk * _BLKSZ));
+
+    oteax_memset(last, 0, AES_BLOCK_SIZE);
+    oteax_memcpy(last, &data[nblk * _BLKSZ], used * sizeof(io_t));
+    sub_finish_block(IO_PTR(last), used, k_full, k_part);
+
+    if (nblk == 0) {
+        aes_encrypt(IO_PTR(last), mac, aes);
+        return;
+    }
+    oteax_memcpy(mac, data, AES_BLOCK_SIZE);
+    omac_cbc_blocks(&data[_BLKSZ], nblk - 1, mac, aes);
+    aes_encrypt(mac, mac, aes);
+    xor_block_aligned(mac, mac, last);
+    aes_encrypt(mac, mac, aes);
+}
+
+
+
+
+ret_type cmac_init_and_key(const void* key, cmac_ctx ctx[1]) {
+    oteax_memset(ctx, 0, sizeof(cmac_ctx));
+    return omac_init_and_key(key, EAX_KERNEL_FAST, IO_PTR(ctx->pad_xvv), ctx->aes);
+}
+
+
+
+ret_type cmac_init_and_key_ct(const void* key, cmac_ctx ctx[1]) {
+    oteax_memset(ctx, 0, sizeof(cmac_ctx));
+    return omac_init_and_key(key, EAX_KERNEL_CT, IO_PTR(ctx->pad_xvv), ctx->aes);
+}
+
+
+
+void omac_update(const io_t* data, unsigned long data_len, io_t* cbc, uint_32t* cnt, const aes_encrypt_ctx aes[1]) {
+    unsigned long   i       = 0;
+    uint_32t        b_pos   = *cnt & (_BLKSZ-1);
+
+    if (data_len == 0) {
+        return;
+    }
+
+    /* The block in cbc is only encrypted once more data arrives, because
+       the last block of the message is treated differently.  At the very
+       start there is nothing to encrypt, so the first block goes straight
+       in.
+    */
+    if ((b_pos != 0) || (*cnt == 0)) {
+        while ((i < data_len) && (b_pos < _BLKSZ)) {
+            cbc[b_pos++] ^= data[i++];
+        }
+    }
+
+    if ((data_len - i) >= _BLKSZ) {
+        unsigned long blocks = (data_len - i) / _BLKSZ;
+        omac_cbc_blocks(&data[i], blocks, cbc, aes);
+        i += blocks * _BLKSZ;
+    }
+
+    while (i < data_len) {
+        if ((b_pos == _BLKSZ) || (b_pos == 0)) {
+            aes_encrypt(cbc, cbc, aes);
+            b_pos = 0;
+        }
+        cbc[b_pos++] ^= data[i++];
+    }
+
+    *cnt += (uint_32t)data_len;
+}
+
+
+
+void omac_final(io_t* cbc, uint_32t cnt, const io_t* pad_xvv, const aes_encrypt_ctx aes[1]) {
+    unsigned int used = cnt & (_BLKSZ-1);
+
+    if ((used == 0) && (cnt != 0)) {
+        used = _BLKSZ;
+    }
+    sub_finish_block(cbc, used, pad_xvv, &pad_xvv[_BLKSZ]);
+    aes_encrypt(cbc, cbc, aes);
+}
+
+
+
+
+ret_type cmac_update(const void* data, unsigned long data_len, cmac_ctx ctx[1]) {
+    omac_update((const io_t*)data, data_len, IO_PTR(ctx->cbc), &ctx->cnt, ctx->aes);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type cmac_compute_tag(void* tag, cmac_ctx ctx[1]) {
+    omac_final(IO_PTR(ctx->cbc), ctx->cnt, IO_PTR(ctx->pad_xvv), ctx->aes);
+    oteax_memcpy(tag, ctx->cbc, AES_BLOCK_SIZE);
+
+    /* ready for the next message with the same key */
+    oteax_memset(ctx->cbc, 0, AES_BLOCK_SIZE);
+    ctx->cnt = 0;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type cmac_message(const void* msg, unsigned long msg_len, void* tag, cmac_ctx ctx[1]) {
+    eax_buf_t mac;
+
+    omac_message((const io_t*)msg, msg_len, IO_PTR(mac),
+                 IO_PTR(ctx->pad_xvv), &IO_PTR(ctx->pad_xvv)[_BLKSZ], ctx->aes);
+    oteax_memcpy(tag, mac, AES_BLOCK_SIZE);
+
+    oteax_memset(ctx->cbc, 0, AES_BLOCK_SIZE);
+    ctx->cnt = 0;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type cmac_messages(const void* const msg[], const unsigned long msg_len[], void* const tag[],
+                        unsigned long num_msgs, cmac_ctx ctx[1]) {
+    static const eax_buf_t zero = { 0 };
+
+    while (num_msgs != 0) {
+        eax_buf_t       cbc[OMAC_LANES];
+        eax_buf_t       last[OMAC_LANES];
+        const io_t*     d[OMAC_LANES];
+        io_t*           c[OMAC_LANES];
+        unsigned long   nblk[OMAC_LANES];
+        unsigned long   common;
+        unsigned int    i, m, n;
+
+        n = (num_msgs > OMAC_LANES) ? OMAC_LANES : (unsigned int)num_msgs;
+
+        /* Split each message into its leading whole blocks and a final
+           block, which is padded and has K1 or K2 mixed in up front.  The
+           first block is loaded as the initial chaining value.
+        */
+        common = ~0UL;
+        for (i=0; i<n; i++) {
+            const io_t*     src     = (const io_t*)msg[i];
+            unsigned long   len     = msg_len[i];
+            unsigned int    used;
+
+            nblk[i] = (len == 0) ? 0 : ((len - 1) / _BLKSZ);
+            used    = (unsigned int)(len - (nblk[i] * _BLKSZ));
+
+            oteax_memset(last[i], 0, AES_BLOCK_SIZE);
+            oteax_memcpy(last[i], &src[nblk[i] * _BLKSZ], used * sizeof(io_t));
+            sub_finish_block(IO_PTR(last[i]), used, IO_PTR(ctx->pad_xvv), &IO_PTR(ctx->pad_xvv)[_BLKSZ]);
+
+            if (nblk[i] != 0) {
+                oteax_memcpy(cbc[i], src, AES_BLOCK_SIZE);
+                common = (nblk[i]-1 < common) ? nblk[i]-1 : common;
+            }
+            else {
+                oteax_memcpy(cbc[i], last[i], AES_BLOCK_SIZE);
+                common = 0;
+            }
+            c[i] = IO_PTR(cbc[i]);
+        }
+
+        /* Whole blocks that every message has are run interleaved */
+        if (common != 0) {
+            for (i=0; i<n; i++) {
+                d[i] = &((const io_t*)msg[i])[_BLKSZ];
+            }
+            omac_cbc_blocks_xn(d, c, n, common, ctx->aes);
+        }
+
+        /* The rest of the whole blocks, one message at a time */
+        for (i=0; i<n; i++) {
+            if (nblk[i] > (common + 1)) {
+                omac_cbc_blocks(&((const io_t*)msg[i])[(common+1) * _BLKSZ],
+                                nblk[i] - (common + 1), c[i], ctx->aes);
+            }
+        }
+
+        /* Final block, for the messages that had more than one */
+        for (i=0, m=0; i<n; i++) {
+            if (nblk[i] != 0) {
+                d[m]    = IO_PTR(last[i]);
+                c[m]    = IO_PTR(cbc[i]);
+                m++;
+            }
+        }
+        if (m != 0) {
+            omac_cbc_blocks_xn(d, c, m, 1, ctx->aes);
+        }
+
+        /* Last encryption, E(cbc) ^ 0, for all of them */
+        for (i=0; i<n; i++) {
+            d[i] = IO_PTR(zero);
+            c[i] = IO_PTR(cbc[i]);
+        }
+        omac_cbc_blocks_xn(d, c, n, 1, ctx->aes);
+
+        for (i=0; i<n; i++) {
+            oteax_memcpy(tag[i], cbc[i], AES_BLOCK_SIZE);
+        }
+
+        msg         = &msg[n];
+        msg_len     = &msg_len[n];
+        tag         = &tag[n];
+        num_msgs   -= n;
+    }
+
+    return RETURN_GOOD;
+}
+
+#undef _BLKSZ
+
+#line 1 "main/oteax.c"
+/*
+---------------------------------------------------------------------------
+Copyright (c) 1998-2010, Brian Gladman, Worcester, UK. All rights reserved.
+
+The redistribution and use of this software (with or without changes)
+is allowed without the payment of fees or royalties provided that:
+
+  source code distributions include the above copyright notice, this
+  list of conditions and the following disclaimer;
+
+  binary distributions include the above copyright notice, this list
+  of conditions and the following disclaimer in their documentation.
+
+This software is provided 'as is' with no explicit or implied warranties
+in respect of its operation, including, but not limited to, correctness
+and fitness for purpose.
+---------------------------------------------------------------------------
+Issue Date: 21/07/2009
+
+ This code implements the EAX combined encryption and authentication mode
+ specified M. Bellare, P. Rogaway and D. Wagner.
+
+ This is a byte oriented version in which the nonce is of limited length
+*/
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+#include "oteax/aesopt.h"
+#include "oteax/aesni.h"
+#include "oteax/afalg.h"
+#include "oteax/omac.h"
+#include "oteax/smallframe.h"
+
+//#define OTEAX_TEST_INITKEY
+//#define OTEAX_TEST_INITMSG
+//#define OTEAX_TEST_CRYPT
+
+#if defined(OTEAX_TEST_INITKEY) \
+ || defined(OTEAX_TEST_INITMSG) \
+ || defined(OTEAX_TEST_CRYPT)
+#   include <stdio.h>
+    void sub_testprint(const char* header, io_t* input_data, size_t data_len) {
+        int zz;
+        uint8_t* data = (uint8_t*)input_data;
+        
+        printf("%s on %zu words:\n", header, data_len);
+        for (zz=0; zz<(data_len*sizeof(io_t)); ) {
+            printf("%02X ", data[zz]);
+            zz++;
+            if ((zz % 16) == 0) {
+                printf("\n");
+            }
+        }
+        if ((zz % 16) == 0) {
+            printf("\n");
+        }
+        else {
+            printf("\n\n");
+        }
+    }
+
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+    {
+#endif
+
+#define BLOCK_SIZE      AES_BLOCK_SIZE      /* block length                 */
+#define BLK_ADR_MASK    (BLOCK_SIZE - 1)    /* mask for 'in block' address  */
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define ALIGN_LENGTH(X)  ((X+3)>>2)
+#else
+#   define ALIGN_LENGTH(X)  (X)
+#endif
+
+/* R ^= P over N io_t units, for partial blocks */
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define XOR_IO(R, P, N)  \
+    do { unsigned long zz; for (zz=0; zz<(N); zz++) (R)[zz] ^= (P)[zz]; } while (0)
+#else
+#   define XOR_IO(R, P, N)  xor_bytes(R, R, P, N)
+#endif
+
+
+
+
+
+/** High-Level (User-Level) Encryption and Decryption routines for EAX
+  * ========================================================================<BR>
+  * - eax_encrypt_message()
+  * - eax_decrypt_message()
+  * - eax_cache_header()
+  * - eax_encrypt_message_hdr()
+  * - eax_decrypt_message_hdr()
+  * - eax_decrypt_messages()
+  * - eax_prime_encrypt_message()
+  * - eax_prime_decrypt_message()
+  * - eax_init_and_key()
+  * - eax_init_and_key_ct()
+  * - eax_init_and_keys()
+  */
+
+
+
+
+ret_type eax_encrypt_message(const void* iv_v, void* msg_v, unsigned long msg_len, eax_ctx ctx[1]) {
+    ///@note [JPN] Tag is always dealt-with as the data right after the message
+    unsigned long   aligned_msglen  = ALIGN_LENGTH(msg_len);
+    io_t*           tag             = &((io_t*)msg_v)[aligned_msglen];
+
+#   if defined(AFALG_POSSIBLE)
+    if ((ctx->afalg != NULL) && (msg_len >= afalg_threshold(ctx->afalg))) {
+        return afalg_eax_encrypt((const io_t*)iv_v, (io_t*)msg_v, msg_len, ctx);
+    }
+#   endif
+
+    eax_init_message((const io_t*)iv_v, ctx);
+#   if defined(SMALLFRAME_POSSIBLE)
+    if ((ctx->be == NULL) && (smallframe_encrypt((io_t*)msg_v, aligned_msglen, ctx) == RETURN_GOOD)) {
+        return eax_compute_tag(tag, ctx);
+    }
+#   endif
+    eax_encrypt((io_t*)msg_v, aligned_msglen, ctx);
+    return eax_compute_tag(tag, ctx);
+}
+
+
+
+ret_type eax_decrypt_message(const void* iv_v, void* msg_v, unsigned long msg_len, eax_ctx ctx[1]) {   
+    ret_type    rr;
+
+    ///@note [JPN] Tag is always dealt-with as the data right after the message
+#   if defined(__ALIGN32__) || defined(__C2000__)
+    io_t local_tag[1];
+    io_t tag[1];
+#   else
+    io_t local_tag[4];
+    io_t tag[4];
+#   endif
+    
+    msg_len = ALIGN_LENGTH(msg_len);
+    
+#   if defined(AFALG_POSSIBLE)
+    if ((ctx->afalg != NULL) && (msg_len >= afalg_threshold(ctx->afalg))) {
+        return afalg_eax_decrypt((const io_t*)iv_v, (io_t*)msg_v, msg_len, ctx);
+    }
+#   endif
+
+#   if defined (__UNALIGNED_ACCESS__)
+        mh_store32(tag, mh_load32(&((io_t*)msg_v)[msg_len]));
+#   elif defined(__ALIGN32__) || defined(__C2000__)
+        tag[0] = ((io_t*)msg_v)[msg_len];
+#   else
+    {   io_t *cursor;
+        cursor  = &((io_t*)msg_v)[msg_len];
+        tag[0]  = *cursor++;
+        tag[1]  = *cursor++;
+        tag[2]  = *cursor++;
+        tag[3]  = *cursor;
+    }
+#   endif
+    
+    // 1st pass decryption
+    eax_init_message(iv_v, ctx);
+#   if defined(SMALLFRAME_POSSIBLE)
+    if ((ctx->be != NULL) || (smallframe_decrypt((io_t*)msg_v, msg_len, ctx) != RETURN_GOOD))
+#   endif
+    eax_decrypt((io_t*)msg_v, msg_len, ctx);
+    
+    // 2nd pass tag computation and comparison
+    rr  = eax_compute_tag(local_tag, ctx);
+    rr -= (ret_type)(tag_mask((const uint_32t*)tag, (const uint_32t*)local_tag, 1) ^ 1);
+    return rr;
+}
+
+
+static void sub_header_start(io_t* cbc, uint_32t* cnt) {
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   BLOCK_SIZE
+#endif
+    /* OMAC^1: the tweak block [1] counts as the first block */
+    oteax_memset(cbc, 0, EAX_BLOCK_SIZE);
+    UI32_PTR(cbc)[3] = NET_ENDIAN32(1);
+    *cnt = _BLKSZ;
+#undef _BLKSZ
+}
+
+
+
+/* The message-level header calls XOR the header OMAC into the tag on the
+   way out (or in), so they also work with the AF_ALG path.
+*/
+static void sub_tag_xor(io_t* tag, const eax_hdr_t* hdr) {
+#   if defined(__ALIGN32__) || defined(__C2000__)
+    tag[0] ^= UI32_PTR(hdr->omac)[0];
+#   else
+    tag[0] ^= UI8_PTR(hdr->omac)[0];
+    tag[1] ^= UI8_PTR(hdr->omac)[1];
+    tag[2] ^= UI8_PTR(hdr->omac)[2];
+    tag[3] ^= UI8_PTR(hdr->omac)[3];
+#   endif
+}
+
+
+
+ret_type eax_cache_header(const void* hdr, unsigned long hdr_len, eax_hdr_t* cache, eax_ctx ctx[1]) {
+    uint_32t cnt;
+
+    sub_header_start(IO_PTR(cache->omac), &cnt);
+    omac_update((const io_t*)hdr, ALIGN_LENGTH(hdr_len), IO_PTR(cache->omac), &cnt, ctx->aes);
+    omac_final(IO_PTR(cache->omac), cnt, IO_PTR(ctx->pad_xvv), ctx->aes);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_encrypt_message_hdr(const void* iv, const eax_hdr_t* hdr, void* msg, unsigned long msg_len, eax_ctx ctx[1]) {
+    ret_type rr;
+
+    rr = eax_encrypt_message(iv, msg, msg_len, ctx);
+    sub_tag_xor(&((io_t*)msg)[ALIGN_LENGTH(msg_len)], hdr);
+    return rr;
+}
+
+
+
+ret_type eax_decrypt_message_hdr(const void* iv, const eax_hdr_t* hdr, void* msg, unsigned long msg_len, eax_ctx ctx[1]) {
+    ret_type rr;
+
+    sub_tag_xor(&((io_t*)msg)[ALIGN_LENGTH(msg_len)], hdr);
+    rr = eax_decrypt_message(iv, msg, msg_len, ctx);
+    sub_tag_xor(&((io_t*)msg)[ALIGN_LENGTH(msg_len)], hdr);
+    return rr;
+}
+
+
+
+ret_type eax_decrypt_messages(const void* const iv[], void* const msg[], const unsigned long msg_len[],
+                              unsigned int num_msgs, eax_ctx* const ctx[], uint_32t* pass) {
+    eax_buf_t       ctr[EAX_BATCH_MAX];
+    uint_32t        rx_tag[EAX_BATCH_MAX];
+    uint_32t        local_tag[EAX_BATCH_MAX];
+    uint_32t        mask;
+    unsigned int    i;
+
+    if ((num_msgs == 0) || (num_msgs > EAX_BATCH_MAX)) {
+        return RETURN_ERROR;
+    }
+
+    /* EAX authenticates the ciphertext, so every tag can be computed
+       before anything is decrypted
+    */
+    for (i=0; i<num_msgs; i++) {
+        unsigned long len = ALIGN_LENGTH(msg_len[i]);
+
+        oteax_memcpy(&rx_tag[i], &((io_t*)msg[i])[len], 4);
+        eax_init_message((const io_t*)iv[i], ctx[i]);
+        oteax_memcpy(ctr[i], ctx[i]->ctr_val, EAX_BLOCK_SIZE);
+        eax_auth_data((const io_t*)msg[i], len, ctx[i]);
+        eax_compute_tag((io_t*)&local_tag[i], ctx[i]);
+    }
+
+    mask = tag_mask(rx_tag, local_tag, num_msgs);
+
+    /* Frames that passed are decrypted from their saved counter start
+       value, since a context may be shared.  The others are left as they
+       came in.
+    */
+    for (i=0; i<num_msgs; i++) {
+        if (mask & ((uint_32t)1 << i)) {
+            oteax_memcpy(ctx[i]->ctr_val, ctr[i], EAX_BLOCK_SIZE);
+            ctx[i]->txt_ccnt = 0;
+            eax_crypt_data((io_t*)msg[i], ALIGN_LENGTH(msg_len[i]), ctx[i]);
+            BACKEND_SYNC(ctx[i]);
+        }
+    }
+
+    *pass = mask;
+    return (mask == (0xFFFFFFFFu >> (32 - num_msgs))) ? RETURN_GOOD : RETURN_ERROR;
+}
+
+
+
+/* EAX' (ANSI C12.22).  The nonce and header OMACs of EAX become one CMAC
+   over the cleartext, N', and the ciphertext OMAC drops its tweak block in
+   favour of swapped final block masks, C'.  The CTR start value is N' with
+   bits 31 and 15 cleared, and the tag is the last 4 bytes of N' ^ C'.
+*/
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _PRIME_K1(CTX)   IO_PTR((CTX)->pad_xvv)
+#   define _PRIME_K2(CTX)   &IO_PTR((CTX)->pad_xvv)[4]
+#else
+#   define _PRIME_K1(CTX)   IO_PTR((CTX)->pad_xvv)
+#   define _PRIME_K2(CTX)   &IO_PTR((CTX)->pad_xvv)[16]
+#endif
+
+static void sub_prime_start(const void* clr_v, unsigned long clr_len, eax_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    omac_message((const io_t*)clr_v, ALIGN_LENGTH(clr_len), IO_PTR(ctx->nce_cbc),
+                 _PRIME_K1(ctx), _PRIME_K2(ctx), ctx->aes);
+
+    oteax_memcpy(ctx->ctr_val, ctx->nce_cbc, EAX_BLOCK_SIZE);
+#   if defined(__C2000__) || defined(__ALIGN32__)
+    ctx->ctr_val[3] &= NET_ENDIAN32(0x7FFF7FFF);
+#   else
+    UI8_PTR(ctx->ctr_val)[12] &= 0x7F;
+    UI8_PTR(ctx->ctr_val)[14] &= 0x7F;
+#   endif
+    ctx->txt_ccnt = 0;
+    ctx->txt_acnt = 0;
+}
+
+
+
+static uint_32t sub_prime_tag(const io_t* ct, unsigned long ct_len, eax_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    omac_message(ct, ct_len, IO_PTR(ctx->txt_cbc),
+                 _PRIME_K2(ctx), _PRIME_K1(ctx), ctx->aes);
+    return UI32_PTR(ctx->nce_cbc)[3] ^ UI32_PTR(ctx->txt_cbc)[3];
+}
+
+
+
+ret_type eax_prime_encrypt_message(const void* clr_v, unsigned long clr_len,
+                                    void* msg_v, unsigned long msg_len, eax_ctx ctx[1]) {
+    unsigned long   aligned_msglen  = ALIGN_LENGTH(msg_len);
+    uint_32t        tag;
+
+    sub_prime_start(clr_v, clr_len, ctx);
+    eax_crypt_data((io_t*)msg_v, aligned_msglen, ctx);
+    tag = sub_prime_tag((const io_t*)msg_v, aligned_msglen, ctx);
+    oteax_memcpy(&((io_t*)msg_v)[aligned_msglen], &tag, 4);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_prime_decrypt_message(const void* clr_v, unsigned long clr_len,
+                                    void* msg_v, unsigned long msg_len, eax_ctx ctx[1]) {
+    unsigned long   aligned_msglen  = ALIGN_LENGTH(msg_len);
+    uint_32t        tag, rx_tag;
+
+    oteax_memcpy(&tag, &((io_t*)msg_v)[aligned_msglen], 4);
+    sub_prime_start(clr_v, clr_len, ctx);
+    rx_tag = sub_prime_tag((const io_t*)msg_v, aligned_msglen, ctx);
+    if (tag_mask(&rx_tag, &tag, 1) == 0) {
+        return RETURN_ERROR;
+    }
+    eax_crypt_data((io_t*)msg_v, aligned_msglen, ctx);
+    BACKEND_SYNC(ctx);
+    return RETURN_GOOD;
+}
+
+#undef _PRIME_K2
+#undef _PRIME_K1
+
+
+ret_type omac_init_and_key(const void* key_v, int kernel, io_t* pad_xvv, aes_encrypt_ctx aes[1]) {
+    uint_32t i;
+    io_t *p;
+#   if defined(__ALIGN32__)
+    uint_32t t;
+    uint_32t w[EAX_BLOCK_SIZE/4];
+#   elif defined(__C2000__)
+    uint32_t t;
+    static uint_32t x_t[1] = { NET_ENDIAN32(0x00870e87 ^ 0x0000000e) };
+#   else
+    uint_8t t;
+#   endif
+
+    /* pad_xvv must start as zero, for E(0)     */
+    oteax_memset(pad_xvv, 0, 2*EAX_BLOCK_SIZE);
+
+    /* set the AES key                          */
+    //aes_encrypt_key(key, key_len, aes);
+    if (kernel == EAX_KERNEL_CT) {
+        aes_encrypt_key128_ct(IO_PTR(key_v), aes);
+    }
+    else {
+        aes_encrypt_key(IO_PTR(key_v), 16, aes);
+    }
+
+    /* compute E(0) (needed for the pad values) */
+    aes_encrypt(IO_PTR(pad_xvv), IO_PTR(pad_xvv), aes);
+
+    /* compute {02} * {E(0)} and {04} * {E(0)}  */
+    /* GF(2^128) mod x^128 + x^7 + x^2 + x + 1  */
+#   if defined(__ALIGN32__)
+    /* Done on whole words: in host order, w[0] holds the most significant
+       bits of the block, so each doubling is a 128 bit left shift with the
+       carry taken from the top bit of the next word.
+    */
+    p   = IO_PTR(pad_xvv);
+    for (i=0; i<(EAX_BLOCK_SIZE/4); ++i) {
+        w[i] = NET_ENDIAN32(p[i]);
+    }
+    for (t=0; t<2; ++t) {
+        uint_32t c = 0x87 & (0 - (w[0] >> 31));
+        for (i=0; i<((EAX_BLOCK_SIZE/4)-1); ++i) {
+            w[i] = (w[i] << 1) | (w[i+1] >> 31);
+        }
+        w[i] = (w[i] << 1) ^ c;
+        for (i=0; i<(EAX_BLOCK_SIZE/4); ++i) {
+            p[(t*(EAX_BLOCK_SIZE/4)) + i] = NET_ENDIAN32(w[i]);
+        }
+    }
+
+    ///@note This version uses C2000 byte intrinsic, but it isn't 32bit clean.
+    ///      Above version for __ALIGN32__ will also work on C2000.
+#   elif defined(__C2000__)
+    p   = IO_PTR(pad_xvv);
+    t   = __byte(p, 0) >> 6;
+    for(i=0; i<EAX_BLOCK_SIZE-1; ++i) {
+        io_t a0 = __byte(p, i);
+        io_t b0 = __byte(p, i+1);
+        io_t a1 = ((a0 << 1) | (b0 >> 7)) & 0xFF;
+        io_t b1 = ((a0 << 2) | (b0 >> 6)) & 0xFF;
+        
+        __byte(p, i)    = a1;
+        __byte(p, i+16) = b1;
+    }
+    {   
+        __byte(p,i+16)  = ((__byte(p,i) << 2) ^ __byte(x,t)) & 0xFF;
+        __byte(p,i+15)  = __byte(p,i+15) ^ (t >>= 1);
+        __byte(p,i)     = (__byte(p,i) << 1) ^ __byte(x,t);
+    }
+    
+#   else
+    p=UI8_PTR(pad_xvv);
+    t=(*p>>6);
+    for(i=0; i<EAX_BLOCK_SIZE-1; ++i, ++p) {
+#       ifdef OTEAX_TEST_INITKEY
+        printf("Input: %02X \n", *p);
+#       endif
+    
+        *(p+16) = (*p<<2) | (*(p+1) >> 6);
+        *p      = (*p<<1) | (*(p+1) >> 7);
+
+#       ifdef OTEAX_TEST_INITKEY
+        printf("Output: %02X\n", *p);
+        printf("Output: %02X\n\n", *(p+16));
+#       endif
+    }
+#   ifdef OTEAX_TEST_INITKEY
+    printf("Input: %02X \n", *p);
+#   endif
+    /* the reduction bytes {00, 87, 0e, 89}[t] without a lookup on E(0) */
+    *(p+16)  = (*p << 2) ^ (0x0e & (0 - (t >> 1))) ^ (0x87 & (0 - (t & 1)));
+    *(p+15) ^= (t >>= 1);
+    *p       = (*p << 1) ^ (0x87 & (0 - t));
+#   ifdef OTEAX_TEST_INITKEY
+    printf("Output: %02X\n", *p);
+    printf("Output: %02X\n\n", *(p+15));
+    printf("Output: %02X\n\n", *(p+16));
+#   endif
+    
+#   endif
+
+    
+    // Test print-out of pad_xvv
+    // Requires byte-addressable machine
+#   ifdef OTEAX_TEST_INITKEY
+    {   for (i=0; i<(2*EAX_BLOCK_SIZE); ) {
+            printf("%02X ", ((uint8_t*)pad_xvv)[i++]);
+            if ((i % 16) == 0) {
+                printf("\n");
+            }
+        }
+        if ((i % 16) != 0) {
+            printf("\n\n");
+        }
+        else {
+            printf("\n");
+        }
+    }
+#   endif
+
+    return RETURN_GOOD;
+}
+
+
+
+
+
+ret_type eax_init_and_key(const void* key_v, eax_ctx ctx[1]) {
+    /* close any AF_ALG handle on the old key, then zero the context */
+#   if defined(AFALG_POSSIBLE)
+    eax_afalg_detach(ctx);
+#   endif
+    memset(ctx, 0, sizeof(eax_ctx));
+
+    return omac_init_and_key(key_v, EAX_KERNEL_FAST, IO_PTR(ctx->pad_xvv), ctx->aes);
+}
+
+
+
+ret_type eax_init_and_key_ct(const void* key_v, eax_ctx ctx[1]) {
+#   if defined(AFALG_POSSIBLE)
+    eax_afalg_detach(ctx);
+#   endif
+    memset(ctx, 0, sizeof(eax_ctx));
+
+    return omac_init_and_key(key_v, EAX_KERNEL_CT, IO_PTR(ctx->pad_xvv), ctx->aes);
+}
+
+
+
+int eax_kernel(const eax_ctx ctx[1]) {
+    return INF_B(ctx->aes->inf, 1);
+}
+
+
+
+
+
+ret_type eax_init_and_keys(const void* keys_v, unsigned long num_keys, eax_ctx ctx[]) {
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _KEYSZ   (16/4)
+#else
+#   define _KEYSZ   16
+#endif
+    const io_t*     keys    = (const io_t*)keys_v;
+    unsigned long   i       = 0;
+
+    ///@note The AES-NI path keys four contexts per call, with the four key
+    ///      expansions, E(0) encryptions and pad doublings interleaved.  The
+    ///      remainder (and non-x86 builds) go through eax_init_and_key().
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_available()) {
+        for (; (i+4) <= num_keys; i += 4) {
+            aes_encrypt_ctx*    cx[4];
+            io_t*               pad[4];
+            int                 j;
+            
+            for (j=0; j<4; j++) {
+#               if defined(AFALG_POSSIBLE)
+                eax_afalg_detach(&ctx[i+j]);
+#               endif
+                oteax_memset(&ctx[i+j], 0, sizeof(eax_ctx));
+                cx[j]   = ctx[i+j].aes;
+                pad[j]  = IO_PTR(ctx[i+j].pad_xvv);
+            }
+            aesni_omac_key128_x4(&keys[i*_KEYSZ], cx, pad);
+        }
+    }
+#   endif
+
+    for (; i<num_keys; ++i) {
+        eax_init_and_key(&keys[i*_KEYSZ], &ctx[i]);
+    }
+    
+    return RETURN_GOOD;
+    
+#undef _KEYSZ
+}
+
+
+
+
+
+/** Low-Level (Expert-Only) routines for EAX
+  * ========================================================================<BR>
+  */
+
+ret_type eax_init_message(const io_t* iv, eax_ctx ctx[1]) {
+#if defined(__ALIGN32__)
+#   define _EAX_BLKSZ   (EAX_BLOCK_SIZE/4)
+#else
+#   define _EAX_BLKSZ   EAX_BLOCK_SIZE
+#endif
+    uint_32t i = 0;
+    uint_32t n_pos = 0;
+    io_t *p;
+
+    BACKEND_SYNC(ctx);
+
+    /* Initialize nonce and cipher-text block buffers */
+    oteax_memset(ctx->nce_cbc, 0, EAX_BLOCK_SIZE);
+    oteax_memset(ctx->txt_cbc, 0, EAX_BLOCK_SIZE);
+
+    /* set the ciphertext CBC start value       */
+#   if defined(__ALIGN32__)
+        ctx->txt_cbc[_EAX_BLKSZ-1] = NET_ENDIAN32(0x00000002);
+#   elif defined(__C2000__)
+        __byte(ctx->txt_cbc, EAX_BLOCK_SIZE-1) = 2;
+#   else
+        UI8_PTR(ctx->txt_cbc)[_EAX_BLKSZ - 1] = 2;
+#   endif
+    ctx->txt_ccnt = 0;  /* encryption count     */
+    ctx->txt_acnt = 0;  /* authentication count */
+
+    /* no header until eax_auth_header() or eax_set_header() */
+    oteax_memset(ctx->hdr_cbc, 0, EAX_BLOCK_SIZE);
+    ctx->hdr_cnt  = 0;
+
+    /* compile the OMAC value for the nonce     */
+#   if defined(__ALIGN32__)
+    n_pos = 7;
+    BACKEND_ENCRYPT(IO_PTR(ctx->nce_cbc), IO_PTR(ctx->nce_cbc), ctx);
+    ctx->nce_cbc[0] ^= iv[0];
+    ctx->nce_cbc[1] ^= (iv[1] & NET_ENDIAN32(0xFFFFFF00));
+    
+    ///@note This version is not 32 bit clean.
+    ///      Above version for __ALIGN32__ will also work for C2000
+#   else // Not 32bit clean
+    n_pos = 16;
+    i = 0;
+    while (i < 7) {
+        if (n_pos == EAX_BLOCK_SIZE) {
+            BACKEND_ENCRYPT(IO_PTR(ctx->nce_cbc), IO_PTR(ctx->nce_cbc), ctx);
+            n_pos = 0;
+        }
+#       if defined(__C2000__)
+            __byte(ctx->nce_cbc, n_pos) ^= __byte(iv, i);
+            i++;
+            n_pos++;
+#       else
+            UI8_PTR(ctx->nce_cbc)[n_pos++] ^= iv[i++];
+#       endif
+    }
+#   endif
+
+#   ifdef OTEAX_TEST_INITMSG
+    printf("Nonce Stage 1:\n%02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X\n\n", 
+            ((uint8_t*)ctx->nce_cbc)[0], ((uint8_t*)ctx->nce_cbc)[1], ((uint8_t*)ctx->nce_cbc)[2], ((uint8_t*)ctx->nce_cbc)[3], 
+            ((uint8_t*)ctx->nce_cbc)[4], ((uint8_t*)ctx->nce_cbc)[5], ((uint8_t*)ctx->nce_cbc)[6], ((uint8_t*)ctx->nce_cbc)[7],
+            ((uint8_t*)ctx->nce_cbc)[8], ((uint8_t*)ctx->nce_cbc)[9], ((uint8_t*)ctx->nce_cbc)[10], ((uint8_t*)ctx->nce_cbc)[11],
+            ((uint8_t*)ctx->nce_cbc)[12], ((uint8_t*)ctx->nce_cbc)[13], ((uint8_t*)ctx->nce_cbc)[14], ((uint8_t*)ctx->nce_cbc)[15]
+        );
+    printf("n_pos = %d\n", n_pos);
+#   endif
+
+    /* do the OMAC padding for the nonce        */
+    ///@todo can probably optimize this for word-align XOR
+    p = IO_PTR(ctx->pad_xvv);
+    if (n_pos < EAX_BLOCK_SIZE) {
+#       if defined(__ALIGN32__)
+            // Take advantage of fact that we know for sure: n_pos == 7
+            ctx->nce_cbc[1] ^= NET_ENDIAN32(0x00000080);
+            p = &p[4];
+            
+#       elif defined(__C2000__)     // Not 32bit clean
+            __byte(ctx->nce_cbc, n_pos) ^= 0x80;
+            p = &p[4];
+            
+#       else                        // Not 32bit clean
+            UI8_PTR(ctx->nce_cbc)[n_pos] ^= 0x80;
+            p = &UI8_PTR(p)[16];
+            
+#       endif
+    }
+
+#   ifdef OTEAX_TEST_INITMSG
+    printf("Nonce Stage 2:\n%02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X\n\n", 
+            ((uint8_t*)ctx->nce_cbc)[0], ((uint8_t*)ctx->nce_cbc)[1], ((uint8_t*)ctx->nce_cbc)[2], ((uint8_t*)ctx->nce_cbc)[3], 
+            ((uint8_t*)ctx->nce_cbc)[4], ((uint8_t*)ctx->nce_cbc)[5], ((uint8_t*)ctx->nce_cbc)[6], ((uint8_t*)ctx->nce_cbc)[7],
+            ((uint8_t*)ctx->nce_cbc)[8], ((uint8_t*)ctx->nce_cbc)[9], ((uint8_t*)ctx->nce_cbc)[10], ((uint8_t*)ctx->nce_cbc)[11],
+            ((uint8_t*)ctx->nce_cbc)[12], ((uint8_t*)ctx->nce_cbc)[13], ((uint8_t*)ctx->nce_cbc)[14], ((uint8_t*)ctx->nce_cbc)[15]
+        );
+#   endif
+
+    ///@note this has been optimized for word-aligned XOR
+    for(i=0; i<_EAX_BLKSZ; ++i) {
+#   if defined(__ALIGN32__) || defined(__C2000__)
+        UI32_PTR(ctx->nce_cbc)[i] ^= UI32_PTR(p)[i];
+#   else
+        UI8_PTR(ctx->nce_cbc)[i] ^= p[i];
+#   endif
+    }
+    
+#   ifdef OTEAX_TEST_INITMSG
+    printf("Nonce Stage 3:\n%02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X\n\n", 
+            ((uint8_t*)ctx->nce_cbc)[0], ((uint8_t*)ctx->nce_cbc)[1], ((uint8_t*)ctx->nce_cbc)[2], ((uint8_t*)ctx->nce_cbc)[3], 
+            ((uint8_t*)ctx->nce_cbc)[4], ((uint8_t*)ctx->nce_cbc)[5], ((uint8_t*)ctx->nce_cbc)[6], ((uint8_t*)ctx->nce_cbc)[7],
+            ((uint8_t*)ctx->nce_cbc)[8], ((uint8_t*)ctx->nce_cbc)[9], ((uint8_t*)ctx->nce_cbc)[10], ((uint8_t*)ctx->nce_cbc)[11],
+            ((uint8_t*)ctx->nce_cbc)[12], ((uint8_t*)ctx->nce_cbc)[13], ((uint8_t*)ctx->nce_cbc)[14], ((uint8_t*)ctx->nce_cbc)[15]
+        );
+#   endif
+    
+    /* compute the OMAC*(nonce) value           */
+    BACKEND_ENCRYPT(IO_PTR(ctx->nce_cbc), IO_PTR(ctx->nce_cbc), ctx);
+
+#   ifdef OTEAX_TEST_INITMSG
+    printf("Nonce Stage 4:\n%02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X\n\n", 
+            ((uint8_t*)ctx->nce_cbc)[0], ((uint8_t*)ctx->nce_cbc)[1], ((uint8_t*)ctx->nce_cbc)[2], ((uint8_t*)ctx->nce_cbc)[3], 
+            ((uint8_t*)ctx->nce_cbc)[4], ((uint8_t*)ctx->nce_cbc)[5], ((uint8_t*)ctx->nce_cbc)[6], ((uint8_t*)ctx->nce_cbc)[7],
+            ((uint8_t*)ctx->nce_cbc)[8], ((uint8_t*)ctx->nce_cbc)[9], ((uint8_t*)ctx->nce_cbc)[10], ((uint8_t*)ctx->nce_cbc)[11],
+            ((uint8_t*)ctx->nce_cbc)[12], ((uint8_t*)ctx->nce_cbc)[13], ((uint8_t*)ctx->nce_cbc)[14], ((uint8_t*)ctx->nce_cbc)[15]
+        );
+#   endif
+
+    /* copy value into counter for CTR          */
+    oteax_memcpy(ctx->ctr_val, ctx->nce_cbc, EAX_BLOCK_SIZE);
+    return RETURN_GOOD;
+    
+#undef _EAX_BLKSZ
+}
+
+
+
+
+
+ret_type eax_auth_data(const io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BUFINC  (BUF_INC/4)
+#   define _BLKSZ   (BLOCK_SIZE/4)
+#   define _BUFMASK ((BUF_INC/4)-1)
+#else
+#   define _BUFINC  BUF_INC
+#   define _BLKSZ   BLOCK_SIZE
+#   define _BUFMASK BUF_ADRMASK
+#endif
+
+    uint_32t cnt    = 0;
+    uint_32t b_pos  = ctx->txt_acnt & (_BLKSZ-1);
+
+    if (!data_len) {
+        return RETURN_GOOD;
+    }
+
+    if (ctx->be != NULL) {
+        if (b_pos != 0) {
+            BACKEND_SYNC(ctx);
+            cnt = ((_BLKSZ - b_pos) < data_len) ? (_BLKSZ - b_pos) : (uint_32t)data_len;
+            XOR_IO(&IO_PTR(ctx->txt_cbc)[b_pos], data, cnt);
+            b_pos += cnt;
+        }
+        if ((data_len - cnt) >= _BLKSZ) {
+            unsigned long blocks = (data_len - cnt) / _BLKSZ;
+            ctx->be->cbcmac(&data[cnt], blocks, IO_PTR(ctx->txt_cbc), ctx->aes, ctx->be_hdl);
+            cnt += blocks * _BLKSZ;
+        }
+        if (cnt < data_len) {
+            BACKEND_SYNC(ctx);
+        }
+    }
+    /* Where unaligned loads are allowed (see brg_endian.h) the XORs work
+       on any buffer at full width, so there is no need to tell congruent
+       buffers apart
+    */
+#   if !defined(__UNALIGNED_ACCESS__)
+    else if (((data - &(IO_PTR(ctx->txt_cbc))[b_pos]) & _BUFMASK) == 0) {
+        if (b_pos != 0) {
+            while (cnt < data_len && (b_pos & _BUFMASK)) {
+               IO_PTR(ctx->txt_cbc)[b_pos++] ^= data[cnt++];
+            }
+            while(cnt + _BUFINC <= data_len && b_pos <= _BLKSZ - _BUFINC) {
+                *UINT_PTR(&(IO_PTR(ctx->txt_cbc))[b_pos]) ^= *UINT_PTR(&data[cnt]);
+                cnt += _BUFINC; 
+                b_pos += _BUFINC;
+            }
+        }
+        if ((data_len - cnt) >= _BLKSZ) {
+            unsigned long blocks = (data_len - cnt) / _BLKSZ;
+            omac_cbc_blocks(&data[cnt], blocks, IO_PTR(ctx->txt_cbc), ctx->aes);
+            cnt += blocks * _BLKSZ;
+        }
+    }
+#   endif
+    ///@note this "else" section will never run when IO is aligned with the
+    ///      crypto-compute buffer (32 bit alignment)
+#   if !defined(__ALIGN32__) && !defined(__C2000__)
+    else {
+        if (b_pos != 0) {
+            cnt = ((_BLKSZ - b_pos) < data_len) ? (_BLKSZ - b_pos) : (uint_32t)data_len;
+            XOR_IO(&IO_PTR(ctx->txt_cbc)[b_pos], data, cnt);
+            b_pos += cnt;
+        }
+        if ((data_len - cnt) >= _BLKSZ) {
+            unsigned long blocks = (data_len - cnt) / _BLKSZ;
+            omac_cbc_blocks(&data[cnt], blocks, IO_PTR(ctx->txt_cbc), ctx->aes);
+            cnt += blocks * _BLKSZ;
+        }
+    }
+#   endif
+
+    while (cnt < data_len) {
+        uint_32t n;
+        if ((b_pos == _BLKSZ) || (b_pos == 0)) {
+            BACKEND_ENCRYPT(IO_PTR(ctx->txt_cbc), IO_PTR(ctx->txt_cbc), ctx);
+            b_pos = 0;
+        }
+        n = ((_BLKSZ - b_pos) < (data_len - cnt)) ? (_BLKSZ - b_pos) : (uint_32t)(data_len - cnt);
+        XOR_IO(&IO_PTR(ctx->txt_cbc)[b_pos], &data[cnt], n);
+        cnt   += n;
+        b_pos += n;
+    }
+
+    ctx->txt_acnt += cnt;
+    return RETURN_GOOD;
+
+#undef _BUFMASK
+#undef _BLKSZ
+#undef _BUFINC
+}
+
+
+
+
+ret_type eax_crypt_data(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   BLOCK_SIZE
+#endif
+#ifdef OTEAX_TEST_CRYPT
+#   define EAX_CRYPT_DATA_PRINT(HDR, SRC, SIZE)   sub_testprint(HDR, SRC, SIZE)
+#else
+#   define EAX_CRYPT_DATA_PRINT(HDR, SRC, SIZE);
+#endif
+
+    uint_32t cnt    = 0;
+    uint_32t b_pos  = ctx->txt_ccnt & (_BLKSZ-1);
+    
+    EAX_CRYPT_DATA_PRINT("eax_crypt_data() data input", data, data_len);
+    
+    if (data_len == 0) {
+        return RETURN_GOOD;
+    }
+
+    /* use up the key stream block left over from the last call */
+    if (b_pos != 0) {
+        BACKEND_SYNC(ctx);
+        cnt = ((_BLKSZ - b_pos) < data_len) ? (_BLKSZ - b_pos) : (uint_32t)data_len;
+        XOR_IO(data, &IO_PTR(ctx->enc_ctr)[b_pos], cnt);
+        b_pos += cnt;
+    }
+
+    /* whole blocks go to the backend, else to the batched CTR engine */
+    if ((data_len - cnt) >= _BLKSZ) {
+        unsigned long blocks = (data_len - cnt) / _BLKSZ;
+
+        EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
+        if (ctx->be != NULL) {
+            ctx->be->ctr(&data[cnt], blocks, IO_PTR(ctx->ctr_val), ctx->aes, ctx->be_hdl);
+        }
+        else {
+            aes_ctr_blocks(&data[cnt], &data[cnt], blocks, IO_PTR(ctx->ctr_val), 128, ctx->aes);
+        }
+        cnt += blocks * _BLKSZ;
+    }
+
+    if (cnt < data_len) {
+        BACKEND_SYNC(ctx);
+    }
+    while (cnt < data_len) {
+        uint_32t n;
+        if ((b_pos == _BLKSZ) || (b_pos == 0)) {
+            BACKEND_ENCRYPT(IO_PTR(ctx->ctr_val), IO_PTR(ctx->enc_ctr), ctx);
+            b_pos = 0;
+            inc_ctr(ctx->ctr_val);
+        }
+        n = ((_BLKSZ - b_pos) < (data_len - cnt)) ? (_BLKSZ - b_pos) : (uint_32t)(data_len - cnt);
+        XOR_IO(&data[cnt], &IO_PTR(ctx->enc_ctr)[b_pos], n);
+        cnt   += n;
+        b_pos += n;
+    }
+
+    ctx->txt_ccnt += cnt;
+    return RETURN_GOOD;
+
+#undef EAX_CRYPT_DATA_PRINT
+#undef _BLKSZ
+}
+
+
+
+ret_type eax_compute_tag(io_t* tag, eax_ctx ctx[1]) {   
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   BLOCK_SIZE
+#endif
+
+    uint_32t i;
+    io_t *p;
+
+    BACKEND_SYNC(ctx);
+
+    if ((ctx->txt_acnt != ctx->txt_ccnt) && ctx->txt_ccnt > 0) {
+        return RETURN_ERROR;
+    }
+
+    /* complete OMAC* for ciphertext value  */
+    p = IO_PTR(ctx->pad_xvv);
+    i = ctx->txt_acnt & (_BLKSZ-1);
+    if (i != 0) {
+#   if defined(__C2000__) || defined(__ALIGN32__)
+        //__byte(ctx->txt_cbc, i*4) ^= 0x80;
+        ctx->txt_cbc[i] ^= NET_ENDIAN32(0x80000000);
+        p = &p[4];
+#   else
+        UI8_PTR(ctx->txt_cbc)[i] ^= 0x80;
+        p += 16;
+#   endif
+    }
+
+    xor_block_aligned(ctx->txt_cbc, ctx->txt_cbc, p);
+    BACKEND_ENCRYPT(IO_PTR(ctx->txt_cbc), IO_PTR(ctx->txt_cbc), ctx);
+
+    /* complete OMAC* for the header, if there is one in progress.  With no
+       header hdr_cbc is zero, and the tag is the DASH7 form.
+    */
+    if (ctx->hdr_cnt != 0) {
+        omac_final(IO_PTR(ctx->hdr_cbc), ctx->hdr_cnt, IO_PTR(ctx->pad_xvv), ctx->aes);
+        ctx->hdr_cnt = 0;
+    }
+    xor_block_aligned(ctx->txt_cbc, ctx->txt_cbc, ctx->hdr_cbc);
+
+    /* compute final authentication tag     */
+    ///@todo Aligned XOR should be possible in any case
+#   if defined(__C2000__) || defined(__ALIGN32__)
+        tag[0] = UI32_PTR(ctx->nce_cbc)[0] ^ UI32_PTR(ctx->txt_cbc)[0];
+#   else
+        tag[0] = UI8_PTR(ctx->nce_cbc)[0] ^ UI8_PTR(ctx->txt_cbc)[0];
+        tag[1] = UI8_PTR(ctx->nce_cbc)[1] ^ UI8_PTR(ctx->txt_cbc)[1];
+        tag[2] = UI8_PTR(ctx->nce_cbc)[2] ^ UI8_PTR(ctx->txt_cbc)[2];
+        tag[3] = UI8_PTR(ctx->nce_cbc)[3] ^ UI8_PTR(ctx->txt_cbc)[3];
+#   endif
+    
+    
+    ///@note changed to 0 - (ctx->txt_ccnt != ctx->txt_acnt)
+    //return (ctx->txt_ccnt == ctx->txt_acnt) ? RETURN_GOOD : RETURN_WARN;
+    return 0 - (ctx->txt_ccnt != ctx->txt_acnt);
+    
+#undef _BUFMASK
+#undef _BLKSZ
+#undef _BUFINC
+}
+
+
+
+ret_type eax_end(eax_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+#   if defined(AFALG_POSSIBLE)
+    eax_afalg_detach(ctx);
+#   endif
+    oteax_memset(ctx, 0, sizeof(eax_ctx));
+    return RETURN_GOOD;
+}
+
+ret_type eax_set_backend(const eax_backend* be, void* hdl, eax_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    ctx->be     = be;
+    ctx->be_hdl = hdl;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_sync(eax_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_auth_header(const io_t* hdr, unsigned long hdr_len, eax_ctx ctx[1]) {
+    if (ctx->hdr_cnt == 0) {
+        sub_header_start(IO_PTR(ctx->hdr_cbc), &ctx->hdr_cnt);
+    }
+    omac_update(hdr, hdr_len, IO_PTR(ctx->hdr_cbc), &ctx->hdr_cnt, ctx->aes);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_set_header(const eax_hdr_t* hdr, eax_ctx ctx[1]) {
+    oteax_memcpy(ctx->hdr_cbc, hdr->omac, EAX_BLOCK_SIZE);
+    ctx->hdr_cnt = 0;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_encrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
+    eax_crypt_data(data, data_len, ctx);
+    eax_auth_data(data, data_len, ctx);
+    return RETURN_GOOD;
+}
+
+ret_type eax_decrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
+    eax_auth_data(data, data_len, ctx);
+    eax_crypt_data(data, data_len, ctx);
+    return RETURN_GOOD;
+}
+
+
+
+
+
+#if defined(__cplusplus)
+    }
+#endif
+
+#line 1 "main/gcm.c"
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/gcm.c
+  * @brief      AES-GCM (SP 800-38D) on the OTEAX AES code
+  *
+  * GCM uses the same AES key schedule, CTR engine and cipher backends as
+  * EAX.  GHASH uses PCLMULQDQ on x86 hosts that have it, and otherwise a
+  * 4 bit table (Shoup's method) built at keying time, which is 256 bytes
+  * per context and needs only 32 bit arithmetic.
+  ******************************************************************************
+  */
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+#include "oteax/aesni.h"
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (AES_BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   AES_BLOCK_SIZE
+#endif
+
+/// Octets per io_t unit
+#define _UNIT       (AES_BLOCK_SIZE/_BLKSZ)
+
+
+
+/** GHASH, portable version
+  * ========================================================================<BR>
+  * Blocks are handled as four big-endian 32 bit words, w[0] most significant.
+  * htab[i] is H times the 4 bit polynomial i, in GCM's reflected bit order.
+  */
+
+static const uint_32t last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+
+static void sub_load_be(uint_32t* w, const io_t* src) {
+#   if defined(__C2000__) || defined(__ALIGN32__)
+    w[0] = NET_ENDIAN32(src[0]);
+    w[1] = NET_ENDIAN32(src[1]);
+    w[2] = NET_ENDIAN32(src[2]);
+    w[3] = NET_ENDIAN32(src[3]);
+#   else
+    int i;
+    for (i=0; i<4; i++, src+=4) {
+        w[i] = ((uint_32t)src[0] << 24) | ((uint_32t)src[1] << 16) | ((uint_32t)src[2] << 8) | src[3];
+    }
+#   endif
+}
+
+
+static void sub_store_be(io_t* dst, const uint_32t* w) {
+#   if defined(__C2000__) || defined(__ALIGN32__)
+    dst[0] = NET_ENDIAN32(w[0]);
+    dst[1] = NET_ENDIAN32(w[1]);
+    dst[2] = NET_ENDIAN32(w[2]);
+    dst[3] = NET_ENDIAN32(w[3]);
+#   else
+    int i;
+    for (i=0; i<4; i++, dst+=4) {
+        dst[0] = (io_t)(w[i] >> 24);
+        dst[1] = (io_t)(w[i] >> 16);
+        dst[2] = (io_t)(w[i] >> 8);
+        dst[3] = (io_t)(w[i]);
+    }
+#   endif
+}
+
+
+static void sub_gen_table(uint_32t htab[16][4], const io_t* h) {
+    int i, j, k;
+
+    oteax_memset(htab[0], 0, 16);
+    sub_load_be(htab[8], h);
+
+    for (i=4; i>0; i>>=1) {
+        uint_32t r = (htab[2*i][3] & 1) ? 0xe1000000 : 0;
+        htab[i][3] = (htab[2*i][3] >> 1) | (htab[2*i][2] << 31);
+        htab[i][2] = (htab[2*i][2] >> 1) | (htab[2*i][1] << 31);
+        htab[i][1] = (htab[2*i][1] >> 1) | (htab[2*i][0] << 31);
+        htab[i][0] = (htab[2*i][0] >> 1) ^ r;
+    }
+    for (i=2; i<=8; i*=2) {
+        for (j=1; j<i; j++) {
+            for (k=0; k<4; k++) {
+                htab[i+j][k] = htab[i][k] ^ htab[j][k];
+            }
+        }
+    }
+}
+
+
+static void sub_shift4(uint_32t* z, const uint_32t* m) {
+    uint_32t rem = z[3] & 0xF;
+    z[3] = ((z[3] >> 4) | (z[2] << 28)) ^ m[3];
+    z[2] = ((z[2] >> 4) | (z[1] << 28)) ^ m[2];
+    z[1] = ((z[1] >> 4) | (z[0] << 28)) ^ m[1];
+    z[0] = ((z[0] >> 4) ^ (last4[rem] << 16)) ^ m[0];
+}
+
+
+static void sub_gmult(uint_32t* x, const uint_32t htab[16][4]) {
+    uint_32t z[4];
+    int i, k;
+
+    for (i=15; i>=0; i--) {
+        uint_32t b = (x[i>>2] >> (24 - 8*(i&3))) & 0xFF;
+        if (i == 15) {
+            for (k=0; k<4; k++) {
+                z[k] = htab[b & 0xF][k];
+            }
+        }
+        else {
+            sub_shift4(z, htab[b & 0xF]);
+        }
+        sub_shift4(z, htab[b >> 4]);
+    }
+    for (k=0; k<4; k++) {
+        x[k] = z[k];
+    }
+}
+
+
+
+/* y = (y ^ data[i]) * H over whole blocks */
+static void sub_ghash_blocks(const io_t* data, unsigned long blocks, gcm_ctx ctx[1]) {
+    uint_32t y[4], d[4];
+    int k;
+
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_clmul_available()) {
+        aesni_ghash_blocks(data, blocks, IO_PTR(ctx->ghash), IO_PTR(ctx->htab));
+        return;
+    }
+#   endif
+
+    sub_load_be(y, IO_PTR(ctx->ghash));
+    while (blocks-- != 0) {
+        sub_load_be(d, data);
+        for (k=0; k<4; k++) {
+            y[k] ^= d[k];
+        }
+        sub_gmult(y, (const uint_32t (*)[4])ctx->htab);
+        data += _BLKSZ;
+    }
+    sub_store_be(IO_PTR(ctx->ghash), y);
+}
+
+
+
+/* Multiply in the partial block that has been XORed into ghash */
+static void sub_ghash_close(gcm_ctx ctx[1]) {
+    static const eax_buf_t zero = { 0 };
+    sub_ghash_blocks(IO_PTR(zero), 1, ctx);
+}
+
+
+
+static void sub_ghash_data(const io_t* data, unsigned long data_len, uint_32t* cnt, gcm_ctx ctx[1]) {
+    unsigned long   i       = 0;
+    uint_32t        b_pos   = *cnt & (_BLKSZ-1);
+
+    if (b_pos != 0) {
+        while ((i < data_len) && (b_pos < _BLKSZ)) {
+            IO_PTR(ctx->ghash)[b_pos++] ^= data[i++];
+        }
+        if (b_pos == _BLKSZ) {
+            sub_ghash_close(ctx);
+        }
+    }
+    if ((data_len - i) >= _BLKSZ) {
+        unsigned long blocks = (data_len - i) / _BLKSZ;
+        sub_ghash_blocks(&data[i], blocks, ctx);
+        i += blocks * _BLKSZ;
+    }
+    for (b_pos=0; i<data_len; ) {
+        IO_PTR(ctx->ghash)[b_pos++] ^= data[i++];
+    }
+
+    *cnt += data_len;
+}
+
+
+
+
+/** Counter handling
+  * ========================================================================<BR>
+  * GCM increments only the low 32 bits of the counter block.  ctr_lo keeps a
+  * host order copy of them, so the wrap point is known without reading
+  * ctr_val while a backend may be updating it.
+  */
+
+static void sub_put_ctr_lo(gcm_ctx ctx[1]) {
+    UI32_PTR(ctx->ctr_val)[3] = NET_ENDIAN32(ctx->ctr_lo);
+}
+
+
+static void sub_ctr_blocks(io_t* data, unsigned long blocks, gcm_ctx ctx[1]) {
+    if (ctx->be == NULL) {
+        aes_ctr_blocks(data, data, blocks, IO_PTR(ctx->ctr_val), 32, ctx->aes);
+        ctx->ctr_lo += (uint_32t)blocks;
+        return;
+    }
+
+    /* Backends step a 128 bit counter, so a run that reaches the 32 bit wrap
+       is cut there and the upper 96 bits are put back afterwards.
+    */
+    while (blocks != 0) {
+        uint_64t        room    = ((uint_64t)1 << 32) - ctx->ctr_lo;
+        unsigned long   n       = ((uint_64t)blocks < room) ? blocks : (unsigned long)room;
+
+        if ((uint_64t)n < room) {
+            ctx->be->ctr(data, n, IO_PTR(ctx->ctr_val), ctx->aes, ctx->be_hdl);
+            ctx->ctr_lo += (uint_32t)n;
+        }
+        else {
+            uint_32t upper[3];
+            BACKEND_SYNC(ctx);
+            oteax_memcpy(upper, ctx->ctr_val, 12);
+            ctx->be->ctr(data, n, IO_PTR(ctx->ctr_val), ctx->aes, ctx->be_hdl);
+            BACKEND_SYNC(ctx);
+            oteax_memcpy(ctx->ctr_val, upper, 12);
+            ctx->ctr_lo = 0;
+            sub_put_ctr_lo(ctx);
+        }
+        data   += n * _BLKSZ;
+        blocks -= n;
+    }
+}
+
+
+
+
+/** Keying and context management
+  * ========================================================================<BR>
+  */
+
+ret_type gcm_init_and_key(const void* key, gcm_ctx ctx[1]) {
+    oteax_memset(ctx, 0, sizeof(gcm_ctx));
+    aes_encrypt_key(IO_PTR(key), 16, ctx->aes);
+
+    /* H = E(0) */
+    aes_encrypt(IO_PTR(ctx->hkey), IO_PTR(ctx->hkey), ctx->aes);
+
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_clmul_available()) {
+        aesni_ghash_init(IO_PTR(ctx->hkey), IO_PTR(ctx->htab));
+        return RETURN_GOOD;
+    }
+#   endif
+    sub_gen_table(ctx->htab, IO_PTR(ctx->hkey));
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_init_and_keys(const void* keys, unsigned long num_keys, gcm_ctx ctx[]) {
+    unsigned long i;
+
+    for (i=0; i<num_keys; i++) {
+        gcm_init_and_key(&((const io_t*)keys)[i * _BLKSZ], &ctx[i]);
+    }
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_end(gcm_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    oteax_memset(ctx, 0, sizeof(gcm_ctx));
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_set_backend(const eax_backend* be, void* hdl, gcm_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    ctx->be     = be;
+    ctx->be_hdl = hdl;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_sync(gcm_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    return RETURN_GOOD;
+}
+
+
+
+
+/** Streaming API
+  * ========================================================================<BR>
+  */
+
+ret_type gcm_init_message(const io_t* iv, unsigned long iv_len, gcm_ctx ctx[1]) {
+    uint_32t w[4];
+
+    BACKEND_SYNC(ctx);
+    oteax_memset(ctx->ghash, 0, AES_BLOCK_SIZE);
+    ctx->hdr_cnt    = 0;
+    ctx->txt_ccnt   = 0;
+    ctx->txt_acnt   = 0;
+
+    /* J0 = IV || 0^31 || 1 for a 96 bit IV, else GHASH(IV, [len(IV)]) */
+    if ((iv_len * _UNIT) == 12) {
+        oteax_memcpy(ctx->ctr_val, iv, 12);
+        UI32_PTR(ctx->ctr_val)[3] = NET_ENDIAN32(1);
+    }
+    else {
+        uint_32t ivcnt = 0;
+        sub_ghash_data(iv, iv_len, &ivcnt, ctx);
+        if ((ivcnt & (_BLKSZ-1)) != 0) {
+            sub_ghash_close(ctx);
+        }
+        w[0] = 0;
+        w[1] = 0;
+        w[2] = (uint_32t)((iv_len * _UNIT) >> 29);
+        w[3] = (uint_32t)((iv_len * _UNIT) << 3);
+        sub_store_be(IO_PTR(ctx->tag_pad), w);
+        sub_ghash_blocks(IO_PTR(ctx->tag_pad), 1, ctx);
+        oteax_memcpy(ctx->ctr_val, ctx->ghash, AES_BLOCK_SIZE);
+        oteax_memset(ctx->ghash, 0, AES_BLOCK_SIZE);
+    }
+
+    /* E(J0) masks the tag; data starts at inc32(J0) */
+    BACKEND_ENCRYPT(IO_PTR(ctx->ctr_val), IO_PTR(ctx->tag_pad), ctx);
+    ctx->ctr_lo = NET_ENDIAN32(UI32_PTR(ctx->ctr_val)[3]) + 1;
+    sub_put_ctr_lo(ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_auth_header(const io_t* hdr, unsigned long hdr_len, gcm_ctx ctx[1]) {
+    if ((ctx->txt_acnt != 0) || (ctx->txt_ccnt != 0)) {
+        return RETURN_ERROR;
+    }
+    sub_ghash_data(hdr, hdr_len, &ctx->hdr_cnt, ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_auth_data(const io_t* data, unsigned long data_len, gcm_ctx ctx[1]) {
+    if (data_len == 0) {
+        return RETURN_GOOD;
+    }
+    BACKEND_SYNC(ctx);
+    if ((ctx->txt_acnt == 0) && ((ctx->hdr_cnt & (_BLKSZ-1)) != 0)) {
+        sub_ghash_close(ctx);
+    }
+    sub_ghash_data(data, data_len, &ctx->txt_acnt, ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_crypt_data(io_t* data, unsigned long data_len, gcm_ctx ctx[1]) {
+    unsigned long   cnt     = 0;
+    uint_32t        b_pos   = ctx->txt_ccnt & (_BLKSZ-1);
+
+    if (data_len == 0) {
+        return RETURN_GOOD;
+    }
+
+    if (b_pos != 0) {
+        BACKEND_SYNC(ctx);
+        while ((cnt < data_len) && (b_pos < _BLKSZ)) {
+            data[cnt++] ^= IO_PTR(ctx->enc_ctr)[b_pos++];
+        }
+    }
+
+    if ((data_len - cnt) >= _BLKSZ) {
+        unsigned long blocks = (data_len - cnt) / _BLKSZ;
+        sub_ctr_blocks(&data[cnt], blocks, ctx);
+        cnt += blocks * _BLKSZ;
+    }
+
+    if (cnt < data_len) {
+        BACKEND_SYNC(ctx);
+    }
+    while (cnt < data_len) {
+        if ((b_pos == _BLKSZ) || (b_pos == 0)) {
+            BACKEND_ENCRYPT(IO_PTR(ctx->ctr_val), IO_PTR(ctx->enc_ctr), ctx);
+            ctx->ctr_lo++;
+            sub_put_ctr_lo(ctx);
+            b_pos = 0;
+        }
+        data[cnt++] ^= IO_PTR(ctx->enc_ctr)[b_pos++];
+    }
+
+    ctx->txt_ccnt += (uint_32t)cnt;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_encrypt(io_t* data, unsigned long data_len, gcm_ctx ctx[1]) {
+    gcm_crypt_data(data, data_len, ctx);
+    gcm_auth_data(data, data_len, ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_decrypt(io_t* data, unsigned long data_len, gcm_ctx ctx[1]) {
+    gcm_auth_data(data, data_len, ctx);
+    gcm_crypt_data(data, data_len, ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_compute_tag(io_t* tag, gcm_ctx ctx[1]) {
+    uint_32t w[4];
+    eax_buf_t lens;
+
+    BACKEND_SYNC(ctx);
+
+    if ((ctx->txt_acnt != ctx->txt_ccnt) && (ctx->txt_ccnt > 0)) {
+        return RETURN_ERROR;
+    }
+
+    if (ctx->txt_acnt == 0) {
+        if ((ctx->hdr_cnt & (_BLKSZ-1)) != 0) {
+            sub_ghash_close(ctx);
+        }
+    }
+    else if ((ctx->txt_acnt & (_BLKSZ-1)) != 0) {
+        sub_ghash_close(ctx);
+    }
+
+    /* [len(A)]64 || [len(C)]64, in bits */
+    w[0] = (uint_32t)(((uint_64t)ctx->hdr_cnt * _UNIT) >> 29);
+    w[1] = (uint_32t)(((uint_64t)ctx->hdr_cnt * _UNIT) << 3);
+    w[2] = (uint_32t)(((uint_64t)ctx->txt_acnt * _UNIT) >> 29);
+    w[3] = (uint_32t)(((uint_64t)ctx->txt_acnt * _UNIT) << 3);
+    sub_store_be(IO_PTR(lens), w);
+    sub_ghash_blocks(IO_PTR(lens), 1, ctx);
+
+    xor_block_aligned(ctx->ghash, ctx->ghash, ctx->tag_pad);
+    oteax_memcpy(tag, ctx->ghash, AES_BLOCK_SIZE);
+
+    return 0 - (ctx->txt_ccnt != ctx->txt_acnt);
+}
+
+
+
+
+/** Single-call message API
+  * ========================================================================<BR>
+  */
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define ALIGN_LENGTH(X)  ((X+3)>>2)
+#else
+#   define ALIGN_LENGTH(X)  (X)
+#endif
+
+ret_type gcm_encrypt_message(const void* iv, const void* hdr, unsigned long hdr_len,
+                             void* msg, unsigned long msg_len, gcm_ctx ctx[1]) {
+    unsigned long aligned_msglen = ALIGN_LENGTH(msg_len);
+
+    gcm_init_message((const io_t*)iv, 12/_UNIT, ctx);
+    gcm_auth_header((const io_t*)hdr, ALIGN_LENGTH(hdr_len), ctx);
+    gcm_encrypt((io_t*)msg, aligned_msglen, ctx);
+    return gcm_compute_tag(&((io_t*)msg)[aligned_msglen], ctx);
+}
+
+
+
+ret_type gcm_decrypt_message(const void* iv, const void* hdr, unsigned long hdr_len,
+                             void* msg, unsigned long msg_len, gcm_ctx ctx[1]) {
+    unsigned long   aligned_msglen = ALIGN_LENGTH(msg_len);
+    const io_t*     tag = &((const io_t*)msg)[aligned_msglen];
+    eax_buf_t       local_tag;
+    uint_32t        diff;
+    int             i;
+
+    /* Authenticate first, then decrypt only if the tag matches */
+    gcm_init_message((const io_t*)iv, 12/_UNIT, ctx);
+    gcm_auth_header((const io_t*)hdr, ALIGN_LENGTH(hdr_len), ctx);
+    gcm_auth_data((const io_t*)msg, aligned_msglen, ctx);
+    gcm_compute_tag(IO_PTR(local_tag), ctx);
+
+    for (i=0, diff=0; i<_BLKSZ; i++) {
+        diff |= (uint_32t)(IO_PTR(local_tag)[i] ^ tag[i]);
+    }
+    if (diff != 0) {
+        return RETURN_ERROR;
+    }
+
+    /* Authentication leaves the counter at inc32(J0) */
+    gcm_crypt_data((io_t*)msg, aligned_msglen, ctx);
+    BACKEND_SYNC(ctx);
+    return RETURN_GOOD;
+}
+
+#undef ALIGN_LENGTH
+#undef _UNIT
+#undef _BLKSZ
+
@@ -33,6 +33,7 @@ and fitness for purpose.
 
 #include "oteax/aesopt.h"
 #include "oteax/mode_hdr.h"
+#include "oteax/aesni.h"
 
 #if defined( AES_MODES )
 
@@ -150,120 +151,177 @@ AES_RETURN aes_ecb_decrypt(const io_t *ibuf, io_t *obuf, int len, const aes_decr
 
 
 
-#include <stdio.h>
+/* CTR mode
+ * The counter is handled as four native 32 bit words, so a batch of counter
+ * blocks is produced with plain word adds instead of a byte-wise increment
+ * per block.  Whole blocks go through aesni_ctr_blocks() when the CPU has
+ * AES-NI, else through aes_encrypt() in batches of BFR_BLOCKS.
+ */
 
-///@todo in addition to the basic functions, aes_ecb_...(), aes_ctr_crypt is 
-///      probably the only function we need here, isolate it.
-
-#define BFR_LENGTH  (BFR_BLOCKS * AES_BLOCK_SIZE)
-
-AES_RETURN aes_ctr_crypt(const io_t *ibuf, io_t *obuf, int len, io_t *cbuf, cbuf_inc ctr_inc, aes_encrypt_ctx ctx[1]) {   
 #if defined(__ALIGN32__)
 #   define _BLKSZ   (AES_BLOCK_SIZE/4)
-#   define _BFRLEN  (BFR_LENGTH/4)
-#   define _128BIT  4
 #else
 #   define _BLKSZ   (AES_BLOCK_SIZE/1)
-#   define _BFRLEN  BFR_LENGTH
-#   define _128BIT  4
 #endif
 
-    io_t*   ip;
-    int     i, blen, b_pos;
-    io_t    buf[_BFRLEN];
-    
-    ///@note [JPN] changing inf access to support INF macro
-    //b_pos = (int)(ctx->inf.b[2]);
-    b_pos = (int)INF_B(ctx->inf, 2);
+static void sub_ctr_load(uint_32t w[4], const io_t* c) {
+#if defined(__ALIGN32__)
+    w[0] = NET_ENDIAN32(c[0]);
+    w[1] = NET_ENDIAN32(c[1]);
+    w[2] = NET_ENDIAN32(c[2]);
+    w[3] = NET_ENDIAN32(c[3]);
+#else
+    int i;
+    for (i=0; i<4; i++, c+=4) {
+        w[i] = ((uint_32t)c[0] << 24) | ((uint_32t)c[1] << 16) | ((uint_32t)c[2] << 8) | (uint_32t)c[3];
+    }
+#endif
+}
 
-    printf("b_pos=%d\n", b_pos);
 
-    if (b_pos) {
-        oteax_memcpy( buf, cbuf, AES_BLOCK_SIZE);
-        if(aes_ecb_encrypt(buf, buf, _BLKSZ, ctx) != EXIT_SUCCESS)
-            return EXIT_FAILURE;
 
-        while ((b_pos < _BLKSZ) && len) {
-            *obuf++ = *ibuf++ ^ buf[b_pos++];
-            --len;
+static void sub_ctr_store(io_t* c, const uint_32t w[4]) {
+#if defined(__ALIGN32__)
+    c[0] = NET_ENDIAN32(w[0]);
+    c[1] = NET_ENDIAN32(w[1]);
+    c[2] = NET_ENDIAN32(w[2]);
+    c[3] = NET_ENDIAN32(w[3]);
+#else
+    int i;
+    for (i=0; i<4; i++, c+=4) {
+        c[0] = (uint_8t)(w[i] >> 24);
+        c[1] = (uint_8t)(w[i] >> 16);
+        c[2] = (uint_8t)(w[i] >> 8);
+        c[3] = (uint_8t)w[i];
+    }
+#endif
+}
+
+
+
+static void sub_ctr_inc(uint_32t w[4], int ctr_bits) {
+    if ((++w[3] == 0) && (ctr_bits > 32)) {
+        if ((++w[2] == 0) && (ctr_bits > 64)) {
+            if (++w[1] == 0) {
+                ++w[0];
+            }
         }
+    }
+}
+
 
-        if (len)
-            ctr_inc(cbuf), b_pos = 0;
+
+AES_FLATTEN AES_RETURN aes_ctr_blocks(const io_t *ibuf, io_t *obuf, unsigned long blocks, io_t *ctr, int ctr_bits, const aes_encrypt_ctx ctx[1]) {
+    uint_32t        w[4];
+    uint_32t        buf[BFR_BLOCKS*4];
+    unsigned long   i, n;
+
+    if ((ctr_bits != 32) && (ctr_bits != 64) && (ctr_bits != 128)) {
+        return EXIT_FAILURE;
     }
 
-    while (len) {
-        blen = (len > _BFRLEN ? _BFRLEN : len), len -= blen;
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_available()) {
+        aesni_ctr_blocks(ibuf, obuf, blocks, ctr, ctr_bits, ctx);
+        return EXIT_SUCCESS;
+    }
+#   endif
 
-        for (i=0, ip=buf; i<(blen/_128BIT); ++i) {
-            oteax_memcpy(ip, cbuf, AES_BLOCK_SIZE);
-            ctr_inc(cbuf);
-            ip = &ip[_BLKSZ];
-        }
+    sub_ctr_load(w, ctr);
 
-        if (blen & (_BLKSZ - 1))
-            oteax_memcpy(ip, cbuf, AES_BLOCK_SIZE), i++;
+    while (blocks != 0) {
+        n = (blocks > BFR_BLOCKS) ? BFR_BLOCKS : blocks;
 
-        if (aes_ecb_encrypt(buf, buf, i*_BLKSZ, ctx) != EXIT_SUCCESS)
-            return EXIT_FAILURE;
+        for (i=0; i<n; i++) {
+            buf[4*i+0] = NET_ENDIAN32(w[0]);
+            buf[4*i+1] = NET_ENDIAN32(w[1]);
+            buf[4*i+2] = NET_ENDIAN32(w[2]);
+            buf[4*i+3] = NET_ENDIAN32(w[3]);
+            sub_ctr_inc(w, ctr_bits);
+        }
+        for (i=0; i<n; i++) {
+            aes_encrypt(IO_PTR(&buf[4*i]), IO_PTR(&buf[4*i]), ctx);
+        }
 
-        i = 0; ip = buf;
-        
-#       if defined(FAST_BUFFER_OPERATIONS) || defined(__ALIGN32__)
-#       if !defined(__ALIGN32__)
-        if (!ALIGN_OFFSET( ibuf, 4 ) && !ALIGN_OFFSET( obuf, 4 ) && !ALIGN_OFFSET( ip, 4 ))
-#       endif
-        {   while (i+_BLKSZ <= blen) {
-                lp32(obuf)[0] = lp32(ibuf)[0] ^ lp32(ip)[0];
-                lp32(obuf)[1] = lp32(ibuf)[1] ^ lp32(ip)[1];
-                lp32(obuf)[2] = lp32(ibuf)[2] ^ lp32(ip)[2];
-                lp32(obuf)[3] = lp32(ibuf)[3] ^ lp32(ip)[3];
-                i      += _BLKSZ;
-                ip      = &ip[_BLKSZ];
-                ibuf    = &ibuf[_BLKSZ];
-                obuf    = &obuf[_BLKSZ];
+#       if defined(__ALIGN32__)
+        for (i=0; i<(4*n); i++) {
+            obuf[i] = ibuf[i] ^ buf[i];
+        }
+#       else
+#       if !defined(__UNALIGNED_ACCESS__)
+        if (!ALIGN_OFFSET(ibuf, 4) && !ALIGN_OFFSET(obuf, 4)) {
+            for (i=0; i<(4*n); i++) {
+                lp32(obuf)[i] = lp32(ibuf)[i] ^ buf[i];
             }
         }
-#       if !defined(__ALIGN32__)
-        else 
+        else
 #       endif
+        xor_bytes(obuf, ibuf, buf, 16*n);
 #       endif
-        {    while (i + AES_BLOCK_SIZE <= blen) {
-                obuf[ 0] = ibuf[ 0] ^ ip[ 0]; 
-                obuf[ 1] = ibuf[ 1] ^ ip[ 1];
-                obuf[ 2] = ibuf[ 2] ^ ip[ 2]; 
-                obuf[ 3] = ibuf[ 3] ^ ip[ 3];
-                obuf[ 4] = ibuf[ 4] ^ ip[ 4]; 
-                obuf[ 5] = ibuf[ 5] ^ ip[ 5];
-                obuf[ 6] = ibuf[ 6] ^ ip[ 6]; 
-                obuf[ 7] = ibuf[ 7] ^ ip[ 7];
-                obuf[ 8] = ibuf[ 8] ^ ip[ 8]; 
-                obuf[ 9] = ibuf[ 9] ^ ip[ 9];
-                obuf[10] = ibuf[10] ^ ip[10]; 
-                obuf[11] = ibuf[11] ^ ip[11];
-                obuf[12] = ibuf[12] ^ ip[12]; 
-                obuf[13] = ibuf[13] ^ ip[13];
-                obuf[14] = ibuf[14] ^ ip[14]; 
-                obuf[15] = ibuf[15] ^ ip[15];
-                i += AES_BLOCK_SIZE;
-                ip += AES_BLOCK_SIZE;
-                ibuf += AES_BLOCK_SIZE;
-                obuf += AES_BLOCK_SIZE;
-            }
+
+        ibuf    = &ibuf[n*_BLKSZ];
+        obuf    = &obuf[n*_BLKSZ];
+        blocks -= n;
+    }
+
+    sub_ctr_store(ctr, w);
+    return EXIT_SUCCESS;
+}
+
+
+
+AES_RETURN aes_ctr_init(const io_t *iv, int ctr_bits, aes_ctr_ctx cc[1]) {
+    if ((ctr_bits != 32) && (ctr_bits != 64) && (ctr_bits != 128)) {
+        return EXIT_FAILURE;
+    }
+    oteax_memcpy(cc->ctr, iv, AES_BLOCK_SIZE);
+    cc->b_pos       = _BLKSZ;
+    cc->ctr_bits    = (uint_8t)ctr_bits;
+    return EXIT_SUCCESS;
+}
+
+
+
+AES_RETURN aes_ctr_crypt(const io_t *ibuf, io_t *obuf, int len, aes_ctr_ctx cc[1], const aes_encrypt_ctx ctx[1]) {
+    int b_pos = cc->b_pos;
+
+    /* use up the key stream left over from the last call */
+    while ((b_pos < _BLKSZ) && (len > 0)) {
+        *obuf++ = *ibuf++ ^ IO_PTR(cc->ks)[b_pos++];
+        --len;
+    }
+
+    if (len >= _BLKSZ) {
+        unsigned long blocks = (unsigned long)len / _BLKSZ;
+
+        if (aes_ctr_blocks(ibuf, obuf, blocks, IO_PTR(cc->ctr), cc->ctr_bits, ctx) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
         }
-        
-        while(i++ < blen)
-            *obuf++ = *ibuf++ ^ ip[b_pos++];
+        ibuf    = &ibuf[blocks*_BLKSZ];
+        obuf    = &obuf[blocks*_BLKSZ];
+        len    -= (int)(blocks*_BLKSZ);
     }
 
-    ///@note [JPN] changing inf access to support INF macro
-    //ctx->inf.b[2] = (uint_8t)b_pos;
-    INF_B(ctx->inf, 2) = (uint_8t)b_pos;
+    /* a trailing partial block keeps its key stream for the next call */
+    if (len > 0) {
+        uint_32t w[4];
+
+        if (aes_encrypt(IO_PTR(cc->ctr), IO_PTR(cc->ks), ctx) != EXIT_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+        sub_ctr_load(w, IO_PTR(cc->ctr));
+        sub_ctr_inc(w, cc->ctr_bits);
+        sub_ctr_store(IO_PTR(cc->ctr), w);
+
+        for (b_pos=0; len>0; --len) {
+            *obuf++ = *ibuf++ ^ IO_PTR(cc->ks)[b_pos++];
+        }
+    }
+
+    cc->b_pos = (uint_8t)b_pos;
     return EXIT_SUCCESS;
-    
-#undef _BLKSZ
-#undef _BFRLEN
-#undef _128BIT
 }
 
+#undef _BLKSZ
+
 #endif
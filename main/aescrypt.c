@@ -17,7 +17,7 @@ and fitness for purpose.
 ---------------------------------------------------------------------------
 Issue Date: 20/12/2007
 */
-
+
 #include "oteax/brg_types.h"
 #include "oteax/aesopt.h"
 #include "oteax/aestab.h"
@@ -87,8 +87,71 @@ extern "C"
 #   define fwd_lrnd(y,x,k,c)   (s(y,c) = (k)[c] ^ no_table(x,t_use(s,box),fwd_var,rf1,c))
 #endif
 
-AES_RETURN aes_encrypt(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {   
-    uint_32t         locals(bb0, bb1);
+#if defined(__OTF_KEYSCHED__)
+
+/* On-the-fly key scheduling: the context holds only the cipher key, so each
+   round key is derived from the previous one (same step as ke4() in aeskey.c)
+   immediately before the round that uses it.
+*/
+#define otf_ke4(k,i) \
+{   k[0] ^= ls_box(k[3],3) ^ t_use(r,c)[i]; \
+    k[1] ^= k[0]; \
+    k[2] ^= k[1]; \
+    k[3] ^= k[2]; \
+}
+
+AES_RETURN aes_encrypt(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {
+    uint_32t         locals(bb0, bb1);
+    uint_32t         rk[4];
+#if defined( dec_fmvars )
+    dec_fmvars; /* declare variables for fwd_mcol() if needed */
+#endif
+
+    if( INF_B(cx->inf,0) != 10 * 16 )
+        return EXIT_FAILURE;
+#if !defined( AES_DISPATCH )
+    if( INF_B(cx->inf,1) == AES_KERNEL_CT )
+        return aes_encrypt_ct(in, out, cx);
+#endif
+
+    rk[0] = cx->ks[0];
+    rk[1] = cx->ks[1];
+    rk[2] = cx->ks[2];
+    rk[3] = cx->ks[3];
+    state_in(bb0, in, rk);
+
+#if (ENC_UNROLL == FULL)
+    otf_ke4(rk, 0); round(fwd_rnd,  bb1, bb0, rk);
+    otf_ke4(rk, 1); round(fwd_rnd,  bb0, bb1, rk);
+    otf_ke4(rk, 2); round(fwd_rnd,  bb1, bb0, rk);
+    otf_ke4(rk, 3); round(fwd_rnd,  bb0, bb1, rk);
+    otf_ke4(rk, 4); round(fwd_rnd,  bb1, bb0, rk);
+    otf_ke4(rk, 5); round(fwd_rnd,  bb0, bb1, rk);
+    otf_ke4(rk, 6); round(fwd_rnd,  bb1, bb0, rk);
+    otf_ke4(rk, 7); round(fwd_rnd,  bb0, bb1, rk);
+    otf_ke4(rk, 8); round(fwd_rnd,  bb1, bb0, rk);
+    otf_ke4(rk, 9); round(fwd_lrnd, bb0, bb1, rk);
+
+#else
+    {   uint_32t    rnd;
+        for(rnd = 0; rnd < 9; ++rnd)
+        {
+            otf_ke4(rk, rnd);
+            round(fwd_rnd, bb1, bb0, rk);
+            l_copy(bb0, bb1);
+        }
+        otf_ke4(rk, 9);
+        round(fwd_lrnd, bb0, bb1, rk);
+    }
+#endif
+
+    state_out(out, bb0);
+    return EXIT_SUCCESS;
+}
+
+#else
+AES_RETURN aes_encrypt(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {   
+    uint_32t         locals(bb0, bb1);
     const uint_32t   *kp;
 #if defined( dec_fmvars )
     dec_fmvars; /* declare variables for fwd_mcol() if needed */
@@ -96,8 +159,19 @@ AES_RETURN aes_encrypt(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {
     
     ///@note [JPN] changing inf access to support INF macro
     //if( cx->inf.b[0] != 10 * 16 && cx->inf.b[0] != 12 * 16 && cx->inf.b[0] != 14 * 16 )
+    ///@note [JPN] with AES-128 alone there is one valid round count, and
+    ///      the compiler can fold it into the round code below
+#if defined( AES_VAR ) || defined( AES_192 ) || defined( AES_256 )
     if( INF_B(cx->inf,0) != 10 * 16 && INF_B(cx->inf,0) != 12 * 16 && INF_B(cx->inf,0) != 14 * 16 )
         return EXIT_FAILURE;
+#else
+    if( INF_B(cx->inf,0) != 10 * 16 )
+        return EXIT_FAILURE;
+#endif
+#if !defined( AES_DISPATCH )
+    if( INF_B(cx->inf,1) == AES_KERNEL_CT )
+        return aes_encrypt_ct(in, out, cx);
+#endif
 
     kp = cx->ks;
     state_in(bb0, in, kp);
@@ -163,6 +237,7 @@ AES_RETURN aes_encrypt(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {
     state_out(out, bb0);
     return EXIT_SUCCESS;
 }
+#endif
 
 #endif
 
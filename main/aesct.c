@@ -0,0 +1,255 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/aesct.c
+  * @brief      Constant-time AES-128 kernel
+  *
+  * The table-driven code in aescrypt.c indexes its tables with state bytes,
+  * so its cache footprint depends on the key and data.  This kernel has no
+  * lookups or branches that depend on secret values: the S-box is a logic
+  * circuit run on all 16 state bytes at once in bit-sliced form, and the
+  * rest of the round works on column words, as the NO_TABLES code does.  It
+  * is several times slower than the tables.
+  *
+  * The key schedule is in the same layout as aes_encrypt_key128(), and
+  * INF_B(cx->inf,1) marks the context, so aes_encrypt() comes here for
+  * every block of a context keyed by aes_encrypt_key128_ct().  The AES-NI
+  * paths are constant-time already, and they are still used where present.
+  ******************************************************************************
+  */
+
+#include "oteax/brg_types.h"
+#include "oteax/aesopt.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/* bytes of one row within a column word */
+#define CT_ROW0     bytes2word(0xFF, 0, 0, 0)
+#define CT_ROW1     bytes2word(0, 0xFF, 0, 0)
+#define CT_ROW2     bytes2word(0, 0, 0xFF, 0)
+#define CT_ROW3     bytes2word(0, 0, 0, 0xFF)
+
+
+
+/* S-box on the bytes of w[0] to w[n-1], n <= 8.  The bytes are sliced into
+   eight bit planes, one bit per byte per plane, and the planes go through
+   the Boyar-Peralta S-box circuit (113 gates), so every byte costs the same.
+*/
+static void sub_sbox(uint_32t* w, unsigned int n) {
+    uint_32t q[8];
+    uint_32t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint_32t y1, y2, y3, y4, y5, y6, y7, y8, y9, y10, y11;
+    uint_32t y12, y13, y14, y15, y16, y17, y18, y19, y20, y21;
+    uint_32t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint_32t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint_32t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint_32t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint_32t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint_32t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint_32t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint_32t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint_32t t60, t61, t62, t63, t64, t65, t66, t67;
+    unsigned int i, j;
+
+    for (j=0; j<8; j++) {
+        q[j] = 0;
+        for (i=0; i<n; i++) {
+            q[j] |= ((w[i] >> j) & 0x01010101) << i;
+        }
+    }
+
+    x0 = q[7];  x1 = q[6];  x2 = q[5];  x3 = q[4];
+    x4 = q[3];  x5 = q[2];  x6 = q[1];  x7 = q[0];
+
+    /* top linear transformation */
+    y14 = x3 ^ x5;      y13 = x0 ^ x6;      y9  = x0 ^ x3;
+    y8  = x0 ^ x5;      t0  = x1 ^ x2;      y1  = t0 ^ x7;
+    y4  = y1 ^ x3;      y12 = y13 ^ y14;    y2  = y1 ^ x0;
+    y5  = y1 ^ x6;      y3  = y5 ^ y8;      t1  = x4 ^ y12;
+    y15 = t1 ^ x5;      y20 = t1 ^ x1;      y6  = y15 ^ x7;
+    y10 = y15 ^ t0;     y11 = y20 ^ y9;     y7  = x7 ^ y11;
+    y17 = y10 ^ y11;    y19 = y10 ^ y8;     y16 = t0 ^ y11;
+    y21 = y13 ^ y16;    y18 = x0 ^ y16;
+
+    /* non-linear section */
+    t2  = y12 & y15;    t3  = y3 & y6;      t4  = t3 ^ t2;
+    t5  = y4 & x7;      t6  = t5 ^ t2;      t7  = y13 & y16;
+    t8  = y5 & y1;      t9  = t8 ^ t7;      t10 = y2 & y7;
+    t11 = t10 ^ t7;     t12 = y9 & y11;     t13 = y14 & y17;
+    t14 = t13 ^ t12;    t15 = y8 & y10;     t16 = t15 ^ t12;
+    t17 = t4 ^ t14;     t18 = t6 ^ t16;     t19 = t9 ^ t14;
+    t20 = t11 ^ t16;    t21 = t17 ^ y20;    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;    t26 = t21 & t23;    t27 = t24 ^ t26;
+    t28 = t25 & t27;    t29 = t28 ^ t22;    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;    t32 = t31 & t30;    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;    t35 = t27 ^ t33;    t36 = t24 & t35;
+    t37 = t36 ^ t34;    t38 = t27 ^ t36;    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;    t42 = t29 ^ t33;    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;    t45 = t42 ^ t41;
+    z0  = t44 & y15;    z1  = t37 & y6;     z2  = t33 & x7;
+    z3  = t43 & y16;    z4  = t40 & y1;     z5  = t29 & y7;
+    z6  = t42 & y11;    z7  = t45 & y17;    z8  = t41 & y10;
+    z9  = t44 & y12;    z10 = t37 & y3;     z11 = t33 & y4;
+    z12 = t43 & y13;    z13 = t40 & y5;     z14 = t29 & y2;
+    z15 = t42 & y9;     z16 = t45 & y14;    z17 = t41 & y8;
+
+    /* bottom linear transformation */
+    t46 = z15 ^ z16;    t47 = z10 ^ z11;    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;     t50 = z2 ^ z12;     t51 = z2 ^ z5;
+    t52 = z7 ^ z8;      t53 = z0 ^ z3;      t54 = z6 ^ z7;
+    t55 = z16 ^ z17;    t56 = z12 ^ t48;    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;     t59 = z3 ^ t54;     t60 = t46 ^ t57;
+    t61 = z14 ^ t57;    t62 = t52 ^ t58;    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;     t65 = t61 ^ t62;    t66 = z1 ^ t63;
+    q[7] = t59 ^ t63;
+    q[1] = t56 ^ ~t62;
+    q[0] = t48 ^ ~t60;
+    t67  = t64 ^ t65;
+    q[4] = t53 ^ t66;
+    q[3] = t51 ^ t66;
+    q[2] = t47 ^ t65;
+    q[6] = t64 ^ ~q[4];
+    q[5] = t55 ^ ~t67;
+
+    for (i=0; i<n; i++) {
+        w[i] = 0;
+        for (j=0; j<8; j++) {
+            w[i] |= ((q[j] >> i) & 0x01010101) << j;
+        }
+    }
+}
+
+
+
+static uint_32t sub_mix_col(uint_32t x) {
+    uint_32t g2 = gf_mulx(x);
+    return g2 ^ upr(x ^ g2, 3) ^ upr(x, 2) ^ upr(x, 1);
+}
+
+
+
+/* Next round key from k, in place, with round constant rc */
+static void sub_next_key(uint_32t* k, uint_32t rc) {
+    uint_32t t = upr(k[3], 3);
+
+    sub_sbox(&t, 1);
+    k[0] ^= t ^ bytes2word(rc, 0, 0, 0);
+    k[1] ^= k[0];
+    k[2] ^= k[1];
+    k[3] ^= k[2];
+}
+
+
+
+AES_RETURN aes_encrypt_key128_ct(const io_t *key, aes_encrypt_ctx cx[1]) {
+    cx->ks[0] = word_in(key, 0);
+    cx->ks[1] = word_in(key, 1);
+    cx->ks[2] = word_in(key, 2);
+    cx->ks[3] = word_in(key, 3);
+
+#   if !defined(__OTF_KEYSCHED__)
+    {   uint_32t i, rc;
+        for (i=4, rc=1; i<KS_LENGTH; i+=4) {
+            cx->ks[i+0] = cx->ks[i-4];
+            cx->ks[i+1] = cx->ks[i-3];
+            cx->ks[i+2] = cx->ks[i-2];
+            cx->ks[i+3] = cx->ks[i-1];
+            sub_next_key(&cx->ks[i], rc);
+            rc = ((rc << 1) ^ ((rc >> 7) * BPOLY)) & 0xFF;
+        }
+    }
+#   endif
+
+    cx->inf.l = 0;
+    INF_B(cx->inf,0) = 10 * 16;
+    INF_B(cx->inf,1) = AES_KERNEL_CT;
+    return EXIT_SUCCESS;
+}
+
+
+
+AES_RETURN aes_encrypt_ct(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {
+    uint_32t s[4], t[4];
+    uint_32t rnd, c;
+#   if defined(__OTF_KEYSCHED__)
+    uint_32t k[4];
+    uint_32t rc = 1;
+#   else
+    const uint_32t* k;
+#   endif
+
+    if (INF_B(cx->inf,0) != 10 * 16)
+        return EXIT_FAILURE;
+
+#   if defined(__OTF_KEYSCHED__)
+    k[0] = cx->ks[0];
+    k[1] = cx->ks[1];
+    k[2] = cx->ks[2];
+    k[3] = cx->ks[3];
+#   else
+    k = cx->ks;
+#   endif
+
+    for (c=0; c<4; c++) {
+        s[c] = word_in(in, c) ^ k[c];
+    }
+
+    for (rnd=1; rnd<=10; rnd++) {
+        sub_sbox(s, 4);
+        for (c=0; c<4; c++) {
+            t[c] = (s[c] & CT_ROW0) | (s[(c+1)&3] & CT_ROW1)
+                 | (s[(c+2)&3] & CT_ROW2) | (s[(c+3)&3] & CT_ROW3);
+        }
+        if (rnd != 10) {
+            for (c=0; c<4; c++) {
+                t[c] = sub_mix_col(t[c]);
+            }
+        }
+
+#       if defined(__OTF_KEYSCHED__)
+        sub_next_key(k, rc);
+        rc = ((rc << 1) ^ ((rc >> 7) * BPOLY)) & 0xFF;
+#       else
+        k += N_COLS;
+#       endif
+
+        for (c=0; c<4; c++) {
+            s[c] = t[c] ^ k[c];
+        }
+    }
+
+    word_out(out, 0, s[0]);
+    word_out(out, 1, s[1]);
+    word_out(out, 2, s[2]);
+    word_out(out, 3, s[3]);
+    return EXIT_SUCCESS;
+}
+
+#undef CT_ROW0
+#undef CT_ROW1
+#undef CT_ROW2
+#undef CT_ROW3
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,245 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/aesdisp.c
+  * @brief      aes_encrypt() kernel dispatch
+  *
+  * With AES_DISPATCH, aes_encrypt() is defined here and calls through a
+  * pointer to the selected kernel.  The kernel is resolved when the library
+  * is loaded, by a constructor that reads OTEAX_KERNEL and the CPU features,
+  * so threads never race to make the first choice.  Code that runs before
+  * the constructor (another library's constructor, say) finds a stub that
+  * resolves through the same pthread_once().  The pointers, and the AES-NI
+  * setting in aesni.c, are atomic, so aes_kernel_select() can change them
+  * while other threads encrypt: each block goes through one kernel or the
+  * other, and both give the same result.  Contexts keyed for the
+  * constant-time kernel go to a second pointer, which is AES-NI when that is
+  * selected (it is constant-time too) and aes_encrypt_ct() otherwise.
+  *
+  * There is no separate portable multi-block entry.  Without AES-NI, the
+  * multi-block CTR and CBC-MAC loops (aes_ctr_blocks(), cmac_messages())
+  * are portable C that batch blocks through whichever table kernel is
+  * selected here, so they come with every table kernel in the list.
+  ******************************************************************************
+  */
+
+#include "oteax/aesopt.h"
+#include "oteax/aesni.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#if defined(AES_DISPATCH)
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+typedef AES_RETURN (*aes_kernel_fn)(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]);
+
+typedef struct {
+    const char*     name;
+    aes_kernel_fn   encrypt;
+    int             simd;           /* for aesni_enable(): 1 AES-NI, 2 with VAES */
+} aes_kernel_t;
+
+/* In order of preference */
+static const aes_kernel_t kernels[] = {
+#   if defined(VAES_POSSIBLE)
+    { "vaes",   &aesni_encrypt,         2 },
+#   endif
+#   if defined(AESNI_POSSIBLE)
+    { "aesni",  &aesni_encrypt,         1 },
+#   endif
+    { "speed",  &aes_encrypt_speed,     0 },
+    { "normal", &aes_encrypt_normal,    0 },
+    { "size",   &aes_encrypt_size,      0 }
+};
+
+#define NUM_KERNELS (sizeof(kernels) / sizeof(aes_kernel_t))
+
+static AES_RETURN sub_first(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]);
+
+static pthread_once_t       resolved    = PTHREAD_ONCE_INIT;
+static const aes_kernel_t*  sel         = NULL;
+static aes_kernel_fn        fast_fn     = &sub_first;
+static aes_kernel_fn        safe_fn     = &sub_first;
+
+
+
+static int sub_usable(const aes_kernel_t* k) {
+#   if defined(AESNI_POSSIBLE)
+    if (k->simd > 1) {
+        return aesni_supported() && aesni_vaes_supported();
+    }
+    if (k->simd) {
+        return aesni_supported();
+    }
+#   endif
+    return 1;
+}
+
+
+
+static const aes_kernel_t* sub_find(const char* name) {
+    unsigned int i;
+
+    for (i=0; i<NUM_KERNELS; i++) {
+        if ((strcmp(name, kernels[i].name) == 0) && sub_usable(&kernels[i])) {
+            return &kernels[i];
+        }
+    }
+    return NULL;
+}
+
+
+
+static void sub_set(const aes_kernel_t* k) {
+    __atomic_store_n(&fast_fn, k->encrypt, __ATOMIC_RELAXED);
+    __atomic_store_n(&safe_fn, (k->simd ? k->encrypt : &aes_encrypt_ct), __ATOMIC_RELAXED);
+#   if defined(AESNI_POSSIBLE)
+    aesni_enable(k->simd);
+#   endif
+    __atomic_store_n(&sel, k, __ATOMIC_RELEASE);
+}
+
+
+
+/* The kernel named, or the first usable one if name is NULL or can't be used */
+static AES_RETURN sub_choose(const char* name) {
+    const aes_kernel_t* k = NULL;
+    unsigned int        i;
+
+    if (name != NULL) {
+        k = sub_find(name);
+    }
+    if (k == NULL) {
+        for (i=0; !sub_usable(&kernels[i]); i++);
+        k = &kernels[i];
+    }
+    sub_set(k);
+    return ((name == NULL) || (strcmp(name, k->name) == 0)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+
+static void sub_resolve(void) {
+    sub_choose(getenv("OTEAX_KERNEL"));
+}
+
+
+
+__attribute__((constructor)) static void sub_load(void) {
+    pthread_once(&resolved, &sub_resolve);
+}
+
+
+
+static AES_RETURN sub_first(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {
+    pthread_once(&resolved, &sub_resolve);
+    return aes_encrypt(in, out, cx);
+}
+
+
+
+AES_RETURN aes_encrypt(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]) {
+    if (INF_B(cx->inf,1) == AES_KERNEL_CT) {
+        return __atomic_load_n(&safe_fn, __ATOMIC_RELAXED)(in, out, cx);
+    }
+    return __atomic_load_n(&fast_fn, __ATOMIC_RELAXED)(in, out, cx);
+}
+
+
+
+void aes_kernel_resolve(void) {
+    pthread_once(&resolved, &sub_resolve);
+}
+
+
+
+AES_RETURN aes_kernel_select(const char* name) {
+    const aes_kernel_t* k;
+
+    pthread_once(&resolved, &sub_resolve);
+    if (name == NULL) {
+        return sub_choose(getenv("OTEAX_KERNEL"));
+    }
+    /* an unknown or unusable name leaves the kernel as it is */
+    k = sub_find(name);
+    if (k == NULL) {
+        return EXIT_FAILURE;
+    }
+    sub_set(k);
+    return EXIT_SUCCESS;
+}
+
+
+
+const char* aes_kernel_name(void) {
+    pthread_once(&resolved, &sub_resolve);
+    return __atomic_load_n(&sel, __ATOMIC_ACQUIRE)->name;
+}
+
+#undef NUM_KERNELS
+
+
+#else
+
+#if (OTEAX_OPTIMIZATION < 0)
+#   define KERNEL_NAME  "size"
+#elif (OTEAX_OPTIMIZATION == 0)
+#   define KERNEL_NAME  "normal"
+#else
+#   define KERNEL_NAME  "speed"
+#endif
+
+AES_RETURN aes_kernel_select(const char* name) {
+    const char* a = KERNEL_NAME;
+
+    if (name == NULL) {
+        return EXIT_SUCCESS;
+    }
+    while ((*a != 0) && (*a == *name)) {
+        a++;
+        name++;
+    }
+    return (*a == *name) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+
+const char* aes_kernel_name(void) {
+    return KERNEL_NAME;
+}
+
+
+
+/* With one kernel, the AES-NI paths for CTR and CBC-MAC go by the CPU alone */
+void aes_kernel_resolve(void) {
+#   if defined(AESNI_POSSIBLE)
+    aesni_enable(aesni_supported() ? 2 : 0);
+#   endif
+}
+
+#undef KERNEL_NAME
+
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,34 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/aeskern_size.c
+  * @brief      aes_encrypt_size(), the size-optimized (OTEAX_OPTIMIZATION = -1): no tables, partial unrolling
+  *
+  * Compiled only with AES_DISPATCH (see aesdisp.h).  The tables are static
+  * to this unit, whatever OPTIMIZE the rest of the library is built with.
+  ******************************************************************************
+  */
+
+#include "oteax/aesdisp.h"
+
+#if defined(AES_DISPATCH)
+#   undef  OTEAX_OPTIMIZATION
+#   define OTEAX_OPTIMIZATION   -1
+#   define AES_KERNEL_TU
+#   define aes_encrypt          aes_encrypt_size
+#   include "aestab.c"
+#   include "aescrypt.c"
+#endif
@@ -68,6 +68,21 @@ extern "C"
     k[4*(i)+7] = ss[3] ^= ss[2]; \
 }
 
+#if defined(__OTF_KEYSCHED__)
+///@note With on-the-fly key scheduling, only the cipher key is stored.  The
+///      round keys are derived by aes_encrypt() as it runs each round.
+AES_RETURN aes_encrypt_key128(const io_t *key, aes_encrypt_ctx cx[1]) {
+    cx->ks[0] = word_in(key, 0);
+    cx->ks[1] = word_in(key, 1);
+    cx->ks[2] = word_in(key, 2);
+    cx->ks[3] = word_in(key, 3);
+    cx->inf.l = 0;
+    INF_B(cx->inf,0) = 10 * 16;
+
+    return EXIT_SUCCESS;
+}
+
+#else
 AES_RETURN aes_encrypt_key128(const io_t *key, aes_encrypt_ctx cx[1]) {   
     uint_32t    ss[4];
 
@@ -100,6 +115,7 @@ AES_RETURN aes_encrypt_key128(const io_t *key, aes_encrypt_ctx cx[1]) {
 
     return EXIT_SUCCESS;
 }
+#endif
 
 #endif
 
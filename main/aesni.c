@@ -0,0 +1,654 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/aesni.c
+  * @brief      x86 AES-NI code paths, selected at runtime
+  *
+  * Everything in this file is compiled only for GCC-compatible x86 builds
+  * (see AESNI_POSSIBLE in aesni.h).  Other targets, including C2000 and
+  * Cortex-M, compile it to nothing.  Buffers are io_t, which is a 32 bit
+  * word in __ALIGN32__ builds, so offsets in here are always taken in bytes.
+  ******************************************************************************
+  */
+
+#include "oteax/aesni.h"
+#include "oteax/aesdisp.h"
+
+#if defined(AESNI_POSSIBLE)
+
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+#if defined(VAES_POSSIBLE)
+#   include <immintrin.h>
+#endif
+
+#define AESNI_TARGET    __attribute__((target("aes,ssse3")))
+#define CLMUL_TARGET    __attribute__((target("pclmul,ssse3")))
+#define VAES_TARGET     __attribute__((target("aes,ssse3,avx512f,avx512bw,vaes")))
+
+/* Set only through aesni_enable(), by aes_kernel_resolve() and
+   aes_kernel_select(); -1 until the kernel is settled.  The CPUID caches
+   below are filled by whichever thread gets there first, with the same
+   value, so they are atomic too.
+*/
+static int aesni_on = -1;
+
+int aesni_supported(void) {
+    static int avail = -1;
+    int a = __atomic_load_n(&avail, __ATOMIC_RELAXED);
+
+    if (a < 0) {
+        __builtin_cpu_init();
+        a = (__builtin_cpu_supports("aes") && __builtin_cpu_supports("ssse3"));
+        __atomic_store_n(&avail, a, __ATOMIC_RELAXED);
+    }
+    return a;
+}
+
+
+
+int aesni_available(void) {
+    int on = __atomic_load_n(&aesni_on, __ATOMIC_ACQUIRE);
+
+    if (on < 0) {
+        aes_kernel_resolve();
+        on = __atomic_load_n(&aesni_on, __ATOMIC_ACQUIRE);
+    }
+    return (on > 0);
+}
+
+
+
+void aesni_enable(int on) {
+    __atomic_store_n(&aesni_on, on, __ATOMIC_RELEASE);
+}
+
+
+
+int aesni_vaes_supported(void) {
+#   if defined(VAES_POSSIBLE)
+    static int avail = -1;
+    int a = __atomic_load_n(&avail, __ATOMIC_RELAXED);
+
+    if (a < 0) {
+        __builtin_cpu_init();
+        a = (__builtin_cpu_supports("vaes") && __builtin_cpu_supports("avx512f")
+          && __builtin_cpu_supports("avx512bw"));
+        __atomic_store_n(&avail, a, __ATOMIC_RELAXED);
+    }
+    return a;
+#   else
+    return 0;
+#   endif
+}
+
+
+
+/* aesni_available() has been checked by the caller */
+static int sub_vaes_on(void) {
+    return (__atomic_load_n(&aesni_on, __ATOMIC_RELAXED) > 1) && aesni_vaes_supported();
+}
+
+
+
+int aesni_clmul_available(void) {
+    static int avail = -1;
+
+    int a = __atomic_load_n(&avail, __ATOMIC_RELAXED);
+
+    if (a < 0) {
+        __builtin_cpu_init();
+        a = (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3"));
+        __atomic_store_n(&avail, a, __ATOMIC_RELAXED);
+    }
+    return a;
+}
+
+
+
+/* One step of the AES-128 key expansion.  RCON must be an immediate value,
+   so the expansion is always fully unrolled.
+*/
+#define KEXP128(K, RCON) do {                                   \
+        __m128i _t = _mm_aeskeygenassist_si128((K), (RCON));    \
+        _t  = _mm_shuffle_epi32(_t, 0xFF);                      \
+        (K) = _mm_xor_si128((K), _mm_slli_si128((K), 4));       \
+        (K) = _mm_xor_si128((K), _mm_slli_si128((K), 4));       \
+        (K) = _mm_xor_si128((K), _mm_slli_si128((K), 4));       \
+        (K) = _mm_xor_si128((K), _t);                           \
+    } while (0)
+
+/* Expand round R for all four lanes, store the round keys and advance the
+   E(0) computation in each lane by one round.
+*/
+#define KEXP128_X4(R, RCON) do {                                \
+        KEXP128(k0, RCON); KEXP128(k1, RCON);                   \
+        KEXP128(k2, RCON); KEXP128(k3, RCON);                   \
+        _mm_storeu_si128((__m128i*)&cx[0]->ks[4*(R)], k0);      \
+        _mm_storeu_si128((__m128i*)&cx[1]->ks[4*(R)], k1);      \
+        _mm_storeu_si128((__m128i*)&cx[2]->ks[4*(R)], k2);      \
+        _mm_storeu_si128((__m128i*)&cx[3]->ks[4*(R)], k3);      \
+        if ((R) < 10) {                                         \
+            s0 = _mm_aesenc_si128(s0, k0);                      \
+            s1 = _mm_aesenc_si128(s1, k1);                      \
+            s2 = _mm_aesenc_si128(s2, k2);                      \
+            s3 = _mm_aesenc_si128(s3, k3);                      \
+        }                                                       \
+        else {                                                  \
+            s0 = _mm_aesenclast_si128(s0, k0);                  \
+            s1 = _mm_aesenclast_si128(s1, k1);                  \
+            s2 = _mm_aesenclast_si128(s2, k2);                  \
+            s3 = _mm_aesenclast_si128(s3, k3);                  \
+        }                                                       \
+    } while (0)
+
+
+
+/* Multiply by {02} in GF(2^128) mod x^128 + x^7 + x^2 + x + 1.  The input
+   and output are the block byte-reversed, so that the 128 bit shift can be
+   done on two little-endian 64 bit lanes.  This is branch-free.
+*/
+AESNI_TARGET static inline __m128i sub_gf128_dbl(__m128i x) {
+    __m128i carry   = _mm_srli_epi64(x, 63);
+    __m128i msb     = _mm_shuffle_epi32(_mm_srai_epi32(x, 31), 0xFF);
+
+    x = _mm_slli_epi64(x, 1);
+    x = _mm_or_si128(x, _mm_slli_si128(carry, 8));
+    return _mm_xor_si128(x, _mm_and_si128(msb, _mm_set_epi32(0, 0, 0, 0x87)));
+}
+
+AESNI_TARGET static inline void sub_store_pads(io_t* pad, __m128i e0) {
+    const __m128i bswap = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    __m128i x;
+
+    x = sub_gf128_dbl(_mm_shuffle_epi8(e0, bswap));
+    _mm_storeu_si128((__m128i*)&pad[0], _mm_shuffle_epi8(x, bswap));
+    x = sub_gf128_dbl(x);
+    _mm_storeu_si128((__m128i*)&((uint_8t*)pad)[16], _mm_shuffle_epi8(x, bswap));
+}
+
+
+
+AESNI_TARGET
+void aesni_omac_key128_x4(const io_t* key, aes_encrypt_ctx* const cx[4], io_t* const pad[4]) {
+    __m128i k0, k1, k2, k3;
+    __m128i s0, s1, s2, s3;
+
+    /* round 0: the plaintext is zero, so the state is just the round key */
+    s0 = k0 = _mm_loadu_si128((const __m128i*)&key[0]);
+    s1 = k1 = _mm_loadu_si128((const __m128i*)&((const uint_8t*)key)[16]);
+    s2 = k2 = _mm_loadu_si128((const __m128i*)&((const uint_8t*)key)[32]);
+    s3 = k3 = _mm_loadu_si128((const __m128i*)&((const uint_8t*)key)[48]);
+    _mm_storeu_si128((__m128i*)&cx[0]->ks[0], k0);
+    _mm_storeu_si128((__m128i*)&cx[1]->ks[0], k1);
+    _mm_storeu_si128((__m128i*)&cx[2]->ks[0], k2);
+    _mm_storeu_si128((__m128i*)&cx[3]->ks[0], k3);
+
+    KEXP128_X4(1, 0x01);
+    KEXP128_X4(2, 0x02);
+    KEXP128_X4(3, 0x04);
+    KEXP128_X4(4, 0x08);
+    KEXP128_X4(5, 0x10);
+    KEXP128_X4(6, 0x20);
+    KEXP128_X4(7, 0x40);
+    KEXP128_X4(8, 0x80);
+    KEXP128_X4(9, 0x1b);
+    KEXP128_X4(10, 0x36);
+
+    cx[0]->inf.l = 0;   INF_B(cx[0]->inf, 0) = 10 * 16;
+    cx[1]->inf.l = 0;   INF_B(cx[1]->inf, 0) = 10 * 16;
+    cx[2]->inf.l = 0;   INF_B(cx[2]->inf, 0) = 10 * 16;
+    cx[3]->inf.l = 0;   INF_B(cx[3]->inf, 0) = 10 * 16;
+
+    sub_store_pads(pad[0], s0);
+    sub_store_pads(pad[1], s1);
+    sub_store_pads(pad[2], s2);
+    sub_store_pads(pad[3], s3);
+}
+
+
+
+/* Counter blocks are kept byte-reversed, so that the low 64 bits of the
+   big-endian counter sit in lane 0 and can be stepped with one SIMD add.  A
+   32 bit counter uses a 32 bit add and a 64 bit counter a 64 bit add, which
+   wrap within the counter field by themselves.  A 128 bit counter also uses
+   the 64 bit add, and the rare carry into the top half is done separately.
+*/
+#define CTR_ADD(C, N)   ((ctr_bits == 32) ? _mm_add_epi32((C), _mm_cvtsi32_si128(N)) \
+                                          : _mm_add_epi64((C), _mm_cvtsi32_si128(N)))
+#define CTR_ADD4(C, V)  ((ctr_bits == 32) ? _mm512_add_epi32((C), (V)) : _mm512_add_epi64((C), (V)))
+
+AESNI_TARGET static inline __m128i sub_ctr_inc128(__m128i c) {
+    uint_64t lo;
+
+    c = _mm_add_epi64(c, _mm_cvtsi32_si128(1));
+    _mm_storel_epi64((__m128i*)&lo, c);
+    if (lo == 0) {
+        c = _mm_add_epi64(c, _mm_set_epi32(0, 1, 0, 0));
+    }
+    return c;
+}
+
+
+
+#if defined(VAES_POSSIBLE)
+/* The VAES engine puts four counter blocks in each 512 bit register and
+   keeps eight registers in flight.  It runs whole groups of four blocks
+   and returns how many it did, leaving the rest to the AES-NI code.  It
+   also stops early when a 128 bit counter is close to carrying into its
+   top half.
+*/
+VAES_TARGET
+static unsigned long sub_vaes_ctr(const uint_8t* in, uint_8t* out, unsigned long blocks, io_t* ctr, int ctr_bits, const aes_encrypt_ctx cx[1]) {
+    const __m512i bswap = _mm512_broadcast_i32x4(_mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15));
+    const __m512i lanes = _mm512_set_epi32(0,0,0,3, 0,0,0,2, 0,0,0,1, 0,0,0,0);
+    const __m512i four  = _mm512_set_epi32(0,0,0,4, 0,0,0,4, 0,0,0,4, 0,0,0,4);
+    __m512i rk[11];
+    __m512i c, b[8];
+    unsigned long done = 0;
+    uint_64t lo;
+    int i, r, n;
+
+    for (r=0; r<11; r++) {
+        rk[r] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&cx->ks[4*r]));
+    }
+    c = _mm512_shuffle_epi8(_mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)ctr)), bswap);
+    c = CTR_ADD4(c, lanes);
+
+    while ((blocks - done) >= 4) {
+        n = ((blocks - done) >= 32) ? 8 : 1;
+        _mm_storel_epi64((__m128i*)&lo, _mm512_castsi512_si128(c));
+        if ((ctr_bits == 128) && (lo > (~(uint_64t)0 - 32))) {
+            break;
+        }
+
+        for (i=0; i<n; i++) {
+            b[i]    = _mm512_xor_si512(_mm512_shuffle_epi8(c, bswap), rk[0]);
+            c       = CTR_ADD4(c, four);
+        }
+        for (r=1; r<10; r++) {
+            for (i=0; i<n; i++) {
+                b[i] = _mm512_aesenc_epi128(b[i], rk[r]);
+            }
+        }
+        for (i=0; i<n; i++) {
+            b[i] = _mm512_aesenclast_epi128(b[i], rk[10]);
+            b[i] = _mm512_xor_si512(b[i], _mm512_loadu_si512((const void*)&in[64*i]));
+            _mm512_storeu_si512((void*)&out[64*i], b[i]);
+        }
+
+        in      = &in[n*64];
+        out     = &out[n*64];
+        done   += 4*n;
+    }
+
+    /* lane 0 holds the next counter */
+    _mm_storeu_si128((__m128i*)ctr, _mm_shuffle_epi8(_mm512_castsi512_si128(c), _mm512_castsi512_si128(bswap)));
+    return done;
+}
+#endif
+
+
+
+AESNI_TARGET
+void aesni_ctr_blocks(const io_t* in_v, io_t* out_v, unsigned long blocks, io_t* ctr, int ctr_bits, const aes_encrypt_ctx cx[1]) {
+    const __m128i bswap = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    const uint_8t* in = (const uint_8t*)in_v;
+    uint_8t* out = (uint_8t*)out_v;
+    __m128i rk[11];
+    __m128i c, b[8];
+    uint_64t lo;
+    int i, r;
+
+#   if defined(VAES_POSSIBLE)
+    if ((blocks >= 16) && sub_vaes_on()) {
+        unsigned long done = sub_vaes_ctr(in, out, blocks, ctr, ctr_bits, cx);
+        in      = &in[16*done];
+        out     = &out[16*done];
+        blocks -= done;
+    }
+#   endif
+
+    for (r=0; r<11; r++) {
+        rk[r] = _mm_loadu_si128((const __m128i*)&cx->ks[4*r]);
+    }
+    c = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)ctr), bswap);
+
+    /* Eight blocks at a time keeps the AES unit pipeline full */
+    while (blocks >= 8) {
+        _mm_storel_epi64((__m128i*)&lo, c);
+        if ((ctr_bits == 128) && (lo > (~(uint_64t)0 - 8))) {
+            for (i=0; i<8; i++) {
+                b[i]    = _mm_shuffle_epi8(c, bswap);
+                c       = sub_ctr_inc128(c);
+            }
+        }
+        else {
+            for (i=0; i<8; i++) {
+                b[i]    = _mm_shuffle_epi8(CTR_ADD(c, i), bswap);
+            }
+            c = CTR_ADD(c, 8);
+        }
+
+        for (i=0; i<8; i++) {
+            b[i] = _mm_xor_si128(b[i], rk[0]);
+        }
+        for (r=1; r<10; r++) {
+            for (i=0; i<8; i++) {
+                b[i] = _mm_aesenc_si128(b[i], rk[r]);
+            }
+        }
+        for (i=0; i<8; i++) {
+            b[i] = _mm_aesenclast_si128(b[i], rk[10]);
+            b[i] = _mm_xor_si128(b[i], _mm_loadu_si128((const __m128i*)&in[16*i]));
+            _mm_storeu_si128((__m128i*)&out[16*i], b[i]);
+        }
+
+        in      = &in[8*16];
+        out     = &out[8*16];
+        blocks -= 8;
+    }
+
+    while (blocks != 0) {
+        b[0] = _mm_xor_si128(_mm_shuffle_epi8(c, bswap), rk[0]);
+        c    = (ctr_bits == 128) ? sub_ctr_inc128(c) : CTR_ADD(c, 1);
+        for (r=1; r<10; r++) {
+            b[0] = _mm_aesenc_si128(b[0], rk[r]);
+        }
+        b[0] = _mm_aesenclast_si128(b[0], rk[10]);
+        b[0] = _mm_xor_si128(b[0], _mm_loadu_si128((const __m128i*)in));
+        _mm_storeu_si128((__m128i*)out, b[0]);
+
+        in      = &in[16];
+        out     = &out[16];
+        blocks -= 1;
+    }
+
+    _mm_storeu_si128((__m128i*)ctr, _mm_shuffle_epi8(c, bswap));
+}
+
+#undef CTR_ADD
+#undef CTR_ADD4
+
+
+
+AESNI_TARGET
+AES_RETURN aesni_encrypt(const io_t* in, io_t* out, const aes_encrypt_ctx cx[1]) {
+    __m128i s;
+    int r;
+
+    if (INF_B(cx->inf,0) != 10 * 16) {
+        return 1;
+    }
+    s = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), _mm_loadu_si128((const __m128i*)&cx->ks[0]));
+    for (r=1; r<10; r++) {
+        s = _mm_aesenc_si128(s, _mm_loadu_si128((const __m128i*)&cx->ks[4*r]));
+    }
+    s = _mm_aesenclast_si128(s, _mm_loadu_si128((const __m128i*)&cx->ks[40]));
+    _mm_storeu_si128((__m128i*)out, s);
+    return 0;
+}
+
+
+
+AESNI_TARGET
+void aesni_encrypt_x2(io_t* a, io_t* b, const aes_encrypt_ctx cx[1]) {
+    __m128i s0, s1, k;
+    int r;
+
+    k   = _mm_loadu_si128((const __m128i*)&cx->ks[0]);
+    s0  = _mm_xor_si128(_mm_loadu_si128((const __m128i*)a), k);
+    s1  = _mm_xor_si128(_mm_loadu_si128((const __m128i*)b), k);
+    for (r=1; r<10; r++) {
+        k   = _mm_loadu_si128((const __m128i*)&cx->ks[4*r]);
+        s0  = _mm_aesenc_si128(s0, k);
+        s1  = _mm_aesenc_si128(s1, k);
+    }
+    k   = _mm_loadu_si128((const __m128i*)&cx->ks[40]);
+    _mm_storeu_si128((__m128i*)a, _mm_aesenclast_si128(s0, k));
+    _mm_storeu_si128((__m128i*)b, _mm_aesenclast_si128(s1, k));
+}
+
+
+
+AESNI_TARGET
+static void sub_cbcmac_x8(const io_t* const data[], io_t* const cbc[], unsigned int n,
+                          unsigned long blocks, const aes_encrypt_ctx cx[1]) {
+    __m128i rk[11];
+    __m128i s[8];
+    unsigned long k;
+    unsigned int i;
+    int r;
+
+    for (r=0; r<11; r++) {
+        rk[r] = _mm_loadu_si128((const __m128i*)&cx->ks[4*r]);
+    }
+    for (i=0; i<n; i++) {
+        s[i] = _mm_loadu_si128((const __m128i*)cbc[i]);
+    }
+
+    for (k=0; k<blocks; k++) {
+        for (i=0; i<n; i++) {
+            s[i] = _mm_xor_si128(s[i], rk[0]);
+        }
+        for (r=1; r<10; r++) {
+            for (i=0; i<n; i++) {
+                s[i] = _mm_aesenc_si128(s[i], rk[r]);
+            }
+        }
+        for (i=0; i<n; i++) {
+            s[i] = _mm_aesenclast_si128(s[i], rk[10]);
+            s[i] = _mm_xor_si128(s[i], _mm_loadu_si128((const __m128i*)&((const uint_8t*)data[i])[16*k]));
+        }
+    }
+
+    for (i=0; i<n; i++) {
+        _mm_storeu_si128((__m128i*)cbc[i], s[i]);
+    }
+}
+
+
+
+#if defined(VAES_POSSIBLE)
+/* Chain j is in lane j%4 of register j/4.  Unused lanes of the last
+   register run on a copy of chain 0, and are not stored.
+*/
+VAES_TARGET
+static void sub_vaes_cbcmac(const io_t* const data[], io_t* const cbc[], unsigned int n,
+                            unsigned long blocks, const aes_encrypt_ctx cx[1]) {
+    const uint_8t* d[32];
+    __m512i rk[11];
+    __m512i s[8];
+    __m128i t[4];
+    unsigned long k;
+    unsigned int i, g;
+    int r;
+
+    g = (n + 3) / 4;
+    for (i=0; i<(4*g); i++) {
+        d[i] = (const uint_8t*)data[(i < n) ? i : 0];
+    }
+    for (r=0; r<11; r++) {
+        rk[r] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)&cx->ks[4*r]));
+    }
+    for (i=0; i<g; i++) {
+        s[i] = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i*)cbc[4*i]));
+        s[i] = _mm512_inserti32x4(s[i], _mm_loadu_si128((const __m128i*)cbc[(4*i+1 < n) ? 4*i+1 : 0]), 1);
+        s[i] = _mm512_inserti32x4(s[i], _mm_loadu_si128((const __m128i*)cbc[(4*i+2 < n) ? 4*i+2 : 0]), 2);
+        s[i] = _mm512_inserti32x4(s[i], _mm_loadu_si128((const __m128i*)cbc[(4*i+3 < n) ? 4*i+3 : 0]), 3);
+    }
+
+    for (k=0; k<blocks; k++) {
+        for (i=0; i<g; i++) {
+            s[i] = _mm512_xor_si512(s[i], rk[0]);
+        }
+        for (r=1; r<10; r++) {
+            for (i=0; i<g; i++) {
+                s[i] = _mm512_aesenc_epi128(s[i], rk[r]);
+            }
+        }
+        for (i=0; i<g; i++) {
+            __m512i x;
+            x = _mm512_castsi128_si512(_mm_loadu_si128((const __m128i*)&d[4*i][16*k]));
+            x = _mm512_inserti32x4(x, _mm_loadu_si128((const __m128i*)&d[4*i+1][16*k]), 1);
+            x = _mm512_inserti32x4(x, _mm_loadu_si128((const __m128i*)&d[4*i+2][16*k]), 2);
+            x = _mm512_inserti32x4(x, _mm_loadu_si128((const __m128i*)&d[4*i+3][16*k]), 3);
+            s[i] = _mm512_xor_si512(_mm512_aesenclast_epi128(s[i], rk[10]), x);
+        }
+    }
+
+    for (i=0; i<n; i++) {
+        if ((i & 3) == 0) {
+            _mm512_storeu_si512((void*)t, s[i/4]);
+        }
+        _mm_storeu_si128((__m128i*)cbc[i], t[i & 3]);
+    }
+}
+#endif
+
+
+
+void aesni_cbcmac_xn(const io_t* const data[], io_t* const cbc[], unsigned int n,
+                     unsigned long blocks, const aes_encrypt_ctx cx[1]) {
+    unsigned int i;
+
+#   if defined(VAES_POSSIBLE)
+    if ((n > 4) && sub_vaes_on()) {
+        sub_vaes_cbcmac(data, cbc, n, blocks, cx);
+        return;
+    }
+#   endif
+    for (i=0; i<n; i+=8) {
+        sub_cbcmac_x8(&data[i], &cbc[i], ((n-i) > 8) ? 8 : (n-i), blocks, cx);
+    }
+}
+
+
+
+
+/* GHASH is done on byte-reversed blocks, so that the bit-reflected GCM field
+   maps onto PCLMULQDQ with one left shift before the reduction.  Products
+   are accumulated unreduced, so several blocks share one reduction.
+*/
+CLMUL_TARGET static inline void sub_clmul_acc(__m128i a, __m128i b, __m128i* lo, __m128i* mid, __m128i* hi) {
+    *lo     = _mm_xor_si128(*lo, _mm_clmulepi64_si128(a, b, 0x00));
+    *hi     = _mm_xor_si128(*hi, _mm_clmulepi64_si128(a, b, 0x11));
+    *mid    = _mm_xor_si128(*mid, _mm_clmulepi64_si128(a, b, 0x10));
+    *mid    = _mm_xor_si128(*mid, _mm_clmulepi64_si128(a, b, 0x01));
+}
+
+
+
+CLMUL_TARGET static inline __m128i sub_clmul_reduce(__m128i lo, __m128i mid, __m128i hi) {
+    __m128i t0, t1, t2;
+
+    lo  = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi  = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    /* shift the 256 bit product left by one */
+    t0  = _mm_srli_epi32(lo, 31);
+    t1  = _mm_srli_epi32(hi, 31);
+    lo  = _mm_slli_epi32(lo, 1);
+    hi  = _mm_slli_epi32(hi, 1);
+    t2  = _mm_srli_si128(t0, 12);
+    t1  = _mm_slli_si128(t1, 4);
+    t0  = _mm_slli_si128(t0, 4);
+    lo  = _mm_or_si128(lo, t0);
+    hi  = _mm_or_si128(hi, t1);
+    hi  = _mm_or_si128(hi, t2);
+
+    /* reduce modulo x^128 + x^7 + x^2 + x + 1 */
+    t0  = _mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30));
+    t0  = _mm_xor_si128(t0, _mm_slli_epi32(lo, 25));
+    t1  = _mm_srli_si128(t0, 4);
+    t0  = _mm_slli_si128(t0, 12);
+    lo  = _mm_xor_si128(lo, t0);
+    t2  = _mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2));
+    t2  = _mm_xor_si128(t2, _mm_srli_epi32(lo, 7));
+    t2  = _mm_xor_si128(t2, t1);
+    lo  = _mm_xor_si128(lo, t2);
+    return _mm_xor_si128(hi, lo);
+}
+
+
+
+CLMUL_TARGET static inline __m128i sub_clmul_mul(__m128i a, __m128i b) {
+    __m128i lo  = _mm_setzero_si128();
+    __m128i mid = _mm_setzero_si128();
+    __m128i hi  = _mm_setzero_si128();
+
+    sub_clmul_acc(a, b, &lo, &mid, &hi);
+    return sub_clmul_reduce(lo, mid, hi);
+}
+
+
+
+CLMUL_TARGET
+void aesni_ghash_init(const io_t* h, io_t* hpow) {
+    const __m128i bswap = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    __m128i p[4];
+    int i;
+
+    p[0] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)h), bswap);
+    for (i=1; i<4; i++) {
+        p[i] = sub_clmul_mul(p[i-1], p[0]);
+    }
+    for (i=0; i<4; i++) {
+        _mm_storeu_si128((__m128i*)&((uint_8t*)hpow)[16*i], p[i]);
+    }
+}
+
+
+
+CLMUL_TARGET
+void aesni_ghash_blocks(const io_t* data_v, unsigned long blocks, io_t* y, const io_t* hpow) {
+    const __m128i bswap = _mm_set_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+    const uint_8t* data = (const uint_8t*)data_v;
+    __m128i h[4];
+    __m128i x, lo, mid, hi;
+    int i;
+
+    for (i=0; i<4; i++) {
+        h[i] = _mm_loadu_si128((const __m128i*)&((const uint_8t*)hpow)[16*i]);
+    }
+    x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)y), bswap);
+
+    /* Y = (Y ^ X0)H^4 ^ X1 H^3 ^ X2 H^2 ^ X3 H, with one reduction */
+    while (blocks >= 4) {
+        lo = mid = hi = _mm_setzero_si128();
+        for (i=0; i<4; i++) {
+            __m128i d = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&data[16*i]), bswap);
+            if (i == 0) {
+                d = _mm_xor_si128(d, x);
+            }
+            sub_clmul_acc(d, h[3-i], &lo, &mid, &hi);
+        }
+        x       = sub_clmul_reduce(lo, mid, hi);
+        data    = &data[4*16];
+        blocks -= 4;
+    }
+
+    while (blocks != 0) {
+        x       = _mm_xor_si128(x, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)data), bswap));
+        x       = sub_clmul_mul(x, h[0]);
+        data    = &data[16];
+        blocks -= 1;
+    }
+
+    _mm_storeu_si128((__m128i*)y, _mm_shuffle_epi8(x, bswap));
+}
+
+#endif
@@ -185,10 +185,12 @@ extern "C"
 
 /* implemented in case of wrong call for fixed tables */
 
+#if !defined(AES_KERNEL_TU)
 AES_RETURN aes_init(void)
 {
     return EXIT_SUCCESS;
 }
+#endif
 
 #else   /*  Generate the tables for the dynamic table option */
 
@@ -0,0 +1,436 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/afalg.c
+  * @brief      Linux AF_ALG kernel crypto offload for EAX
+  *
+  * Build with EXT_DEF=-D__AFALG__ to include this.  Messages at or above a
+  * length threshold have their CTR stage sent to the kernel's ctr(aes)
+  * transform and their ciphertext OMAC sent to cmac(aes).  This reaches AES
+  * accelerators that are registered with the Linux crypto API, and it works
+  * (slowly) with the stock aes-generic driver for testing.  Message data is
+  * moved into the kernel with vmsplice()/splice(), so it is not copied in
+  * userspace.  Small messages stay in software, where the socket overhead
+  * would dominate.
+  ******************************************************************************
+  */
+
+#if defined(__AFALG__) && defined(__linux__)
+#   ifndef _GNU_SOURCE
+#       define _GNU_SOURCE
+#   endif
+#endif
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+#include "oteax/afalg.h"
+
+#if defined(AFALG_POSSIBLE)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <pthread.h>
+#include <linux/if_alg.h>
+
+#ifndef AF_ALG
+#   define AF_ALG       38
+#endif
+#ifndef SOL_ALG
+#   define SOL_ALG      279
+#endif
+
+/// Data is moved through a pipe in chunks no larger than this.  It must be a
+/// multiple of the AES block size, and it should not exceed the pipe size.
+#define AFALG_CHUNK     (16 * 4096)
+
+/// Calibration sizes for the automatic threshold
+#define AFALG_CAL_MIN   256
+#define AFALG_CAL_MAX   AFALG_CHUNK
+
+
+typedef struct afalg_s {
+    struct afalg_s* next;
+    const eax_ctx*  owner;
+    int             ctr_tfm;
+    int             ctr_op;
+    int             mac_tfm;
+    int             mac_op;
+    int             pipe[2];
+    unsigned long   threshold;
+} afalg_t;
+
+/// Attached handles.  eax_init_and_key() may be given a context that was
+/// never initialized, so ctx->afalg is only trusted if it is on this list
+/// and was attached to that same context (not a copy of it).
+static afalg_t*         live;
+static pthread_mutex_t  live_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+
+static int sub_open_tfm(const char* type, const char* name, const void* key, int* op) {
+    struct sockaddr_alg sa;
+    int tfm;
+
+    oteax_memset(&sa, 0, sizeof(sa));
+    sa.salg_family = AF_ALG;
+    strncpy((char*)sa.salg_type, type, sizeof(sa.salg_type)-1);
+    strncpy((char*)sa.salg_name, name, sizeof(sa.salg_name)-1);
+
+    tfm = socket(AF_ALG, SOCK_SEQPACKET, 0);
+    if (tfm < 0) {
+        return -1;
+    }
+    if ((bind(tfm, (struct sockaddr*)&sa, sizeof(sa)) < 0)
+    ||  (setsockopt(tfm, SOL_ALG, ALG_SET_KEY, key, 16) < 0)
+    ||  ((*op = accept(tfm, NULL, 0)) < 0)) {
+        close(tfm);
+        return -1;
+    }
+    return tfm;
+}
+
+
+
+static void sub_close(afalg_t* hdl) {
+    if (hdl->ctr_op >= 0)   close(hdl->ctr_op);
+    if (hdl->ctr_tfm >= 0)  close(hdl->ctr_tfm);
+    if (hdl->mac_op >= 0)   close(hdl->mac_op);
+    if (hdl->mac_tfm >= 0)  close(hdl->mac_tfm);
+    if (hdl->pipe[0] >= 0)  close(hdl->pipe[0]);
+    if (hdl->pipe[1] >= 0)  close(hdl->pipe[1]);
+    free(hdl);
+}
+
+
+
+/** Move len bytes from buf into the op socket without copying.  If the kernel
+  * refuses splice for this socket, it falls back to an ordinary send.
+  * @note more is non-zero if more data will follow in the same operation.
+  */
+static int sub_splice(afalg_t* hdl, int op, const uint8_t* buf, size_t len, int more) {
+    while (len != 0) {
+        struct iovec    iov;
+        ssize_t         n, m;
+
+        iov.iov_base    = (void*)buf;
+        iov.iov_len     = len;
+        n = vmsplice(hdl->pipe[1], &iov, 1, 0);
+        if (n <= 0) {
+            break;
+        }
+        for (m=n; m>0; ) {
+            ssize_t s = splice(hdl->pipe[0], NULL, op, NULL, (size_t)m,
+                            (more || (m < (ssize_t)len)) ? SPLICE_F_MORE : 0);
+            if (s <= 0) {
+                return -1;
+            }
+            m -= s;
+        }
+        buf += n;
+        len -= n;
+    }
+
+    while (len != 0) {
+        ssize_t n = send(op, buf, len, more ? MSG_MORE : 0);
+        if (n <= 0) {
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+
+
+static int sub_read(int op, uint8_t* buf, size_t len) {
+    while (len != 0) {
+        ssize_t n = read(op, buf, len);
+        if (n <= 0) {
+            return -1;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
+
+
+
+/** Add blocks to a big-endian 128 bit counter, as ctr(aes) does internally */
+static void sub_ctr_add(uint8_t* ctr, unsigned long blocks) {
+    int i;
+    for (i=15; (i>=0) && (blocks!=0); i--) {
+        blocks     += ctr[i];
+        ctr[i]      = (uint8_t)blocks;
+        blocks    >>= 8;
+    }
+}
+
+
+
+static int sub_ctr_crypt(afalg_t* hdl, uint8_t* data, unsigned long len, const uint8_t* ctr0) {
+    uint8_t ctr[16];
+
+    oteax_memcpy(ctr, ctr0, 16);
+
+    while (len != 0) {
+        char            cbuf[CMSG_SPACE(sizeof(uint32_t)) + CMSG_SPACE(sizeof(struct af_alg_iv) + 16)];
+        struct msghdr   msg;
+        struct cmsghdr* cmsg;
+        struct af_alg_iv* ivp;
+        size_t          chunk = (len > AFALG_CHUNK) ? AFALG_CHUNK : len;
+
+        oteax_memset(cbuf, 0, sizeof(cbuf));
+        oteax_memset(&msg, 0, sizeof(msg));
+        msg.msg_control     = cbuf;
+        msg.msg_controllen  = sizeof(cbuf);
+
+        cmsg                = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level    = SOL_ALG;
+        cmsg->cmsg_type     = ALG_SET_OP;
+        cmsg->cmsg_len      = CMSG_LEN(sizeof(uint32_t));
+        *(uint32_t*)CMSG_DATA(cmsg) = ALG_OP_ENCRYPT;
+
+        cmsg                = CMSG_NXTHDR(&msg, cmsg);
+        cmsg->cmsg_level    = SOL_ALG;
+        cmsg->cmsg_type     = ALG_SET_IV;
+        cmsg->cmsg_len      = CMSG_LEN(sizeof(struct af_alg_iv) + 16);
+        ivp                 = (struct af_alg_iv*)CMSG_DATA(cmsg);
+        ivp->ivlen          = 16;
+        oteax_memcpy(ivp->iv, ctr, 16);
+
+        if ((sendmsg(hdl->ctr_op, &msg, MSG_MORE) < 0)
+        ||  (sub_splice(hdl, hdl->ctr_op, data, chunk, 0) != 0)
+        ||  (sub_read(hdl->ctr_op, data, chunk) != 0)) {
+            return -1;
+        }
+
+        sub_ctr_add(ctr, chunk / 16);
+        data   += chunk;
+        len    -= chunk;
+    }
+    return 0;
+}
+
+
+
+/** OMAC^2(C) = CMAC([0..0 02] || C), and the nonce OMAC is already done, so
+  * the tag is just the XOR of the two.
+  */
+static int sub_compute_tag(afalg_t* hdl, const uint8_t* data, unsigned long len, uint8_t* tag, eax_ctx ctx[1]) {
+    static const uint8_t prefix[16] = { 0,0,0,0, 0,0,0,0, 0,0,0,0, 0,0,0,2 };
+    uint8_t mac[16];
+
+    if ((send(hdl->mac_op, prefix, 16, MSG_MORE) != 16)
+    ||  (sub_splice(hdl, hdl->mac_op, data, len, 1) != 0)
+    ||  (send(hdl->mac_op, NULL, 0, 0) < 0)
+    ||  (sub_read(hdl->mac_op, mac, 16) != 0)) {
+        return -1;
+    }
+    tag[0] = UI8_PTR(ctx->nce_cbc)[0] ^ mac[0];
+    tag[1] = UI8_PTR(ctx->nce_cbc)[1] ^ mac[1];
+    tag[2] = UI8_PTR(ctx->nce_cbc)[2] ^ mac[2];
+    tag[3] = UI8_PTR(ctx->nce_cbc)[3] ^ mac[3];
+    return 0;
+}
+
+
+
+ret_type afalg_eax_encrypt(const io_t* iv, io_t* msg, unsigned long msg_len, eax_ctx ctx[1]) {
+    afalg_t* hdl = (afalg_t*)ctx->afalg;
+
+    eax_init_message(iv, ctx);
+
+    if ((sub_ctr_crypt(hdl, msg, msg_len, UI8_PTR(ctx->ctr_val)) != 0)
+    ||  (sub_compute_tag(hdl, msg, msg_len, &msg[msg_len], ctx) != 0)) {
+        return RETURN_ERROR;
+    }
+
+    ctx->txt_ccnt = msg_len;
+    ctx->txt_acnt = msg_len;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type afalg_eax_decrypt(const io_t* iv, io_t* msg, unsigned long msg_len, eax_ctx ctx[1]) {
+    afalg_t*    hdl = (afalg_t*)ctx->afalg;
+    uint_32t    local_tag[1];
+    uint_32t    rx_tag;
+
+    eax_init_message(iv, ctx);
+
+    if ((sub_compute_tag(hdl, msg, msg_len, (uint8_t*)local_tag, ctx) != 0)
+    ||  (sub_ctr_crypt(hdl, msg, msg_len, UI8_PTR(ctx->ctr_val)) != 0)) {
+        return RETURN_ERROR;
+    }
+
+    oteax_memcpy(&rx_tag, &msg[msg_len], 4);
+    ctx->txt_ccnt = msg_len;
+    ctx->txt_acnt = msg_len;
+    return 0 - (ret_type)(tag_mask(&rx_tag, (const uint_32t*)local_tag, 1) ^ 1);
+}
+
+
+
+unsigned long afalg_threshold(void* hdl) {
+    return ((afalg_t*)hdl)->threshold;
+}
+
+
+
+static double sub_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (1e-9 * (double)ts.tv_nsec);
+}
+
+/** Find the smallest power-of-4 message length at which AF_ALG beats the
+  * software path for this context.  If it never does, AF_ALG is left idle.
+  */
+static unsigned long sub_calibrate(eax_ctx ctx[1]) {
+    static const uint8_t nonce[7] = { 0 };
+    eax_ctx         sw;
+    uint8_t*        buf;
+    unsigned long   size;
+    unsigned long   threshold = ULONG_MAX;
+
+    buf = calloc(1, AFALG_CAL_MAX + 4);
+    if (buf == NULL) {
+        return threshold;
+    }
+    oteax_memcpy(&sw, ctx, sizeof(eax_ctx));
+    sw.afalg = NULL;
+
+    for (size=AFALG_CAL_MIN; size<=AFALG_CAL_MAX; size*=4) {
+        double  t0, t_sw, t_hw;
+        int     i, reps = (int)(AFALG_CAL_MAX / size);
+
+        t0 = sub_now();
+        for (i=0; i<reps; i++) {
+            eax_encrypt_message(nonce, buf, size, &sw);
+        }
+        t_sw = sub_now() - t0;
+
+        t0 = sub_now();
+        for (i=0; i<reps; i++) {
+            if (afalg_eax_encrypt(nonce, buf, size, ctx) != RETURN_GOOD) {
+                free(buf);
+                return ULONG_MAX;
+            }
+        }
+        t_hw = sub_now() - t0;
+
+        if (t_hw < t_sw) {
+            threshold = size;
+            break;
+        }
+    }
+
+    free(buf);
+    return threshold;
+}
+
+
+
+/** The key given to eax_afalg_attach() must be the one the context was keyed
+  * with.  The key schedule layout depends on the kernel, so compare E(0)
+  * under each instead.
+  */
+static int sub_same_key(const void* key, eax_ctx ctx[1]) {
+    static const uint_32t zero[4] = { 0, 0, 0, 0 };
+    aes_encrypt_ctx cx[1];
+    uint_32t        a[4], b[4];
+    int             same;
+
+    if (aes_encrypt_key128((const io_t*)key, cx) != EXIT_SUCCESS) {
+        return 0;
+    }
+    aes_encrypt((const io_t*)zero, (io_t*)a, cx);
+    aes_encrypt((const io_t*)zero, (io_t*)b, ctx->aes);
+    same = (tag_mask(a, b, 4) == 15);
+    oteax_memset(cx, 0, sizeof(cx));
+    return same;
+}
+
+
+
+ret_type eax_afalg_attach(const void* key, unsigned long threshold, eax_ctx ctx[1]) {
+    afalg_t* hdl;
+
+    eax_afalg_detach(ctx);
+    if (!sub_same_key(key, ctx)) {
+        return RETURN_ERROR;
+    }
+
+    hdl = malloc(sizeof(afalg_t));
+    if (hdl == NULL) {
+        return RETURN_ERROR;
+    }
+    hdl->ctr_op     = -1;
+    hdl->mac_op     = -1;
+    hdl->pipe[0]    = -1;
+    hdl->pipe[1]    = -1;
+    hdl->ctr_tfm    = sub_open_tfm("skcipher", "ctr(aes)", key, &hdl->ctr_op);
+    hdl->mac_tfm    = sub_open_tfm("hash", "cmac(aes)", key, &hdl->mac_op);
+
+    if ((hdl->ctr_tfm < 0) || (hdl->mac_tfm < 0) || (pipe(hdl->pipe) != 0)) {
+        sub_close(hdl);
+        return RETURN_ERROR;
+    }
+
+    ctx->afalg = hdl;
+    hdl->threshold = (threshold != 0) ? threshold : sub_calibrate(ctx);
+
+    hdl->owner = ctx;
+    pthread_mutex_lock(&live_lock);
+    hdl->next  = live;
+    live       = hdl;
+    pthread_mutex_unlock(&live_lock);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_afalg_detach(eax_ctx ctx[1]) {
+    afalg_t**   pp;
+    afalg_t*    hdl = NULL;
+
+    pthread_mutex_lock(&live_lock);
+    for (pp=&live; *pp!=NULL; pp=&(*pp)->next) {
+        if ((*pp == (afalg_t*)ctx->afalg) && ((*pp)->owner == ctx)) {
+            hdl = *pp;
+            *pp = hdl->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&live_lock);
+
+    if (hdl != NULL) {
+        sub_close(hdl);
+    }
+    ctx->afalg = NULL;
+    return RETURN_GOOD;
+}
+
+#endif
@@ -0,0 +1,94 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/backend.c
+  * @brief      Software cipher backend
+  *
+  * The operations are written in terms of aes_encrypt(), so they work in
+  * every build configuration, including __ALIGN32__ and __OTF_KEYSCHED__.
+  ******************************************************************************
+  */
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (AES_BLOCK_SIZE/4)
+#   define _XOR     xor_block_aligned
+#else
+#   define _BLKSZ   AES_BLOCK_SIZE
+#   define _XOR     xor_block
+#endif
+
+
+
+static ret_type sw_block(const io_t* in, io_t* out, const aes_encrypt_ctx cx[1], void* hdl) {
+    (void)hdl;
+    return aes_encrypt(in, out, cx);
+}
+
+
+
+static ret_type sw_ecb(const io_t* in, io_t* out, unsigned long blocks, const aes_encrypt_ctx cx[1], void* hdl) {
+    (void)hdl;
+    while (blocks-- != 0) {
+        aes_encrypt(in, out, cx);
+        in  += _BLKSZ;
+        out += _BLKSZ;
+    }
+    return RETURN_GOOD;
+}
+
+
+
+static ret_type sw_ctr(io_t* data, unsigned long blocks, io_t* ctr, const aes_encrypt_ctx cx[1], void* hdl) {
+    eax_buf_t ks;
+
+    (void)hdl;
+    while (blocks-- != 0) {
+        aes_encrypt(ctr, IO_PTR(ks), cx);
+        inc_ctr(ctr);
+        _XOR(data, data, ks);
+        data += _BLKSZ;
+    }
+    return RETURN_GOOD;
+}
+
+
+
+static ret_type sw_cbcmac(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx cx[1], void* hdl) {
+    (void)hdl;
+    while (blocks-- != 0) {
+        aes_encrypt(cbc, cbc, cx);
+        _XOR(cbc, cbc, data);
+        data += _BLKSZ;
+    }
+    return RETURN_GOOD;
+}
+
+
+
+const eax_backend eax_backend_sw = {
+    "software",
+    &sw_block,
+    &sw_ecb,
+    &sw_ctr,
+    &sw_cbcmac,
+    NULL
+};
+
+#undef _XOR
+#undef _BLKSZ
@@ -0,0 +1,322 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/cmac.c
+  * @brief      AES-CMAC (OMAC1, RFC 4493 / SP 800-38B)
+  *
+  * EAX is built from three OMACs, so everything CMAC needs is already here:
+  * the pads from eax_init_and_key() are the CMAC subkeys K1 and K2, and the
+  * "lazy" CBC state of eax_auth_data() is the CMAC chaining value.  This
+  * file exposes that as plain CMAC, and it also holds the CBC-MAC kernels
+  * that eax_auth_data() uses for whole blocks.
+  ******************************************************************************
+  */
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+#include "oteax/aesni.h"
+#include "oteax/omac.h"
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (AES_BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   AES_BLOCK_SIZE
+#endif
+
+
+
+AES_FLATTEN static void sub_cbc_blocks(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx aes[1]) {
+#   if !defined(__C2000__) && !defined(__ALIGN32__)
+    if (ALIGN_OFFSET(data, 4) != 0) {
+        while (blocks-- != 0) {
+            aes_encrypt(cbc, cbc, aes);
+            xor_block(cbc, cbc, data);
+            data += _BLKSZ;
+        }
+        return;
+    }
+#   endif
+    while (blocks-- != 0) {
+        aes_encrypt(cbc, cbc, aes);
+        xor_block_aligned(cbc, cbc, data);
+        data += _BLKSZ;
+    }
+}
+
+
+
+void omac_cbc_blocks(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx aes[1]) {
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_available()) {
+        aesni_cbcmac_xn(&data, &cbc, 1, blocks, aes);
+        return;
+    }
+#   endif
+    sub_cbc_blocks(data, blocks, cbc, aes);
+}
+
+
+
+void omac_cbc_blocks_xn(const io_t* const data[], io_t* const cbc[], unsigned int n,
+                        unsigned long blocks, const aes_encrypt_ctx aes[1]) {
+    unsigned int i;
+
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_available()) {
+        aesni_cbcmac_xn(data, cbc, n, blocks, aes);
+        return;
+    }
+#   endif
+    for (i=0; i<n; i++) {
+        sub_cbc_blocks(data[i], blocks, cbc[i], aes);
+    }
+}
+
+
+
+
+/** Pad the final block in place and XOR in k_full (whole block) or k_part
+  * (partial block).  "used" is the number of io_t units in the final block,
+  * 0 to _BLKSZ.
+  */
+static void sub_finish_block(io_t* blk, unsigned int used, const io_t* k_full, const io_t* k_part) {
+    if (used < _BLKSZ) {
+#       if defined(__C2000__) || defined(__ALIGN32__)
+        blk[used] ^= NET_ENDIAN32(0x80000000);
+#       else
+        blk[used] ^= 0x80;
+#       endif
+        k_full = k_part;
+    }
+    xor_block_aligned(blk, blk, k_full);
+}
+
+
+
+void omac_message(const io_t* data, unsigned long len, io_t* mac,
+                  const io_t* k_full, const io_t* k_part, const aes_encrypt_ctx aes[1]) {
+    eax_buf_t       last;
+    unsigned long   nblk    = (len == 0) ? 0 : ((len - 1) / _BLKSZ);
+    unsigned int    used    = (unsigned int)(len - (nblk * _BLKSZ));
+
+    oteax_memset(last, 0, AES_BLOCK_SIZE);
+    oteax_memcpy(last, &data[nblk * _BLKSZ], used * sizeof(io_t));
+    sub_finish_block(IO_PTR(last), used, k_full, k_part);
+
+    if (nblk == 0) {
+        aes_encrypt(IO_PTR(last), mac, aes);
+        return;
+    }
+    oteax_memcpy(mac, data, AES_BLOCK_SIZE);
+    omac_cbc_blocks(&data[_BLKSZ], nblk - 1, mac, aes);
+    aes_encrypt(mac, mac, aes);
+    xor_block_aligned(mac, mac, last);
+    aes_encrypt(mac, mac, aes);
+}
+
+
+
+
+ret_type cmac_init_and_key(const void* key, cmac_ctx ctx[1]) {
+    oteax_memset(ctx, 0, sizeof(cmac_ctx));
+    return omac_init_and_key(key, EAX_KERNEL_FAST, IO_PTR(ctx->pad_xvv), ctx->aes);
+}
+
+
+
+ret_type cmac_init_and_key_ct(const void* key, cmac_ctx ctx[1]) {
+    oteax_memset(ctx, 0, sizeof(cmac_ctx));
+    return omac_init_and_key(key, EAX_KERNEL_CT, IO_PTR(ctx->pad_xvv), ctx->aes);
+}
+
+
+
+void omac_update(const io_t* data, unsigned long data_len, io_t* cbc, uint_32t* cnt, const aes_encrypt_ctx aes[1]) {
+    unsigned long   i       = 0;
+    uint_32t        b_pos   = *cnt & (_BLKSZ-1);
+
+    if (data_len == 0) {
+        return;
+    }
+
+    /* The block in cbc is only encrypted once more data arrives, because
+       the last block of the message is treated differently.  At the very
+       start there is nothing to encrypt, so the first block goes straight
+       in.
+    */
+    if ((b_pos != 0) || (*cnt == 0)) {
+        while ((i < data_len) && (b_pos < _BLKSZ)) {
+            cbc[b_pos++] ^= data[i++];
+        }
+    }
+
+    if ((data_len - i) >= _BLKSZ) {
+        unsigned long blocks = (data_len - i) / _BLKSZ;
+        omac_cbc_blocks(&data[i], blocks, cbc, aes);
+        i += blocks * _BLKSZ;
+    }
+
+    while (i < data_len) {
+        if ((b_pos == _BLKSZ) || (b_pos == 0)) {
+            aes_encrypt(cbc, cbc, aes);
+            b_pos = 0;
+        }
+        cbc[b_pos++] ^= data[i++];
+    }
+
+    *cnt += (uint_32t)data_len;
+}
+
+
+
+void omac_final(io_t* cbc, uint_32t cnt, const io_t* pad_xvv, const aes_encrypt_ctx aes[1]) {
+    unsigned int used = cnt & (_BLKSZ-1);
+
+    if ((used == 0) && (cnt != 0)) {
+        used = _BLKSZ;
+    }
+    sub_finish_block(cbc, used, pad_xvv, &pad_xvv[_BLKSZ]);
+    aes_encrypt(cbc, cbc, aes);
+}
+
+
+
+
+ret_type cmac_update(const void* data, unsigned long data_len, cmac_ctx ctx[1]) {
+    omac_update((const io_t*)data, data_len, IO_PTR(ctx->cbc), &ctx->cnt, ctx->aes);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type cmac_compute_tag(void* tag, cmac_ctx ctx[1]) {
+    omac_final(IO_PTR(ctx->cbc), ctx->cnt, IO_PTR(ctx->pad_xvv), ctx->aes);
+    oteax_memcpy(tag, ctx->cbc, AES_BLOCK_SIZE);
+
+    /* ready for the next message with the same key */
+    oteax_memset(ctx->cbc, 0, AES_BLOCK_SIZE);
+    ctx->cnt = 0;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type cmac_message(const void* msg, unsigned long msg_len, void* tag, cmac_ctx ctx[1]) {
+    eax_buf_t mac;
+
+    omac_message((const io_t*)msg, msg_len, IO_PTR(mac),
+                 IO_PTR(ctx->pad_xvv), &IO_PTR(ctx->pad_xvv)[_BLKSZ], ctx->aes);
+    oteax_memcpy(tag, mac, AES_BLOCK_SIZE);
+
+    oteax_memset(ctx->cbc, 0, AES_BLOCK_SIZE);
+    ctx->cnt = 0;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type cmac_messages(const void* const msg[], const unsigned long msg_len[], void* const tag[],
+                        unsigned long num_msgs, cmac_ctx ctx[1]) {
+    static const eax_buf_t zero = { 0 };
+
+    while (num_msgs != 0) {
+        eax_buf_t       cbc[OMAC_LANES];
+        eax_buf_t       last[OMAC_LANES];
+        const io_t*     d[OMAC_LANES];
+        io_t*           c[OMAC_LANES];
+        unsigned long   nblk[OMAC_LANES];
+        unsigned long   common;
+        unsigned int    i, m, n;
+
+        n = (num_msgs > OMAC_LANES) ? OMAC_LANES : (unsigned int)num_msgs;
+
+        /* Split each message into its leading whole blocks and a final
+           block, which is padded and has K1 or K2 mixed in up front.  The
+           first block is loaded as the initial chaining value.
+        */
+        common = ~0UL;
+        for (i=0; i<n; i++) {
+            const io_t*     src     = (const io_t*)msg[i];
+            unsigned long   len     = msg_len[i];
+            unsigned int    used;
+
+            nblk[i] = (len == 0) ? 0 : ((len - 1) / _BLKSZ);
+            used    = (unsigned int)(len - (nblk[i] * _BLKSZ));
+
+            oteax_memset(last[i], 0, AES_BLOCK_SIZE);
+            oteax_memcpy(last[i], &src[nblk[i] * _BLKSZ], used * sizeof(io_t));
+            sub_finish_block(IO_PTR(last[i]), used, IO_PTR(ctx->pad_xvv), &IO_PTR(ctx->pad_xvv)[_BLKSZ]);
+
+            if (nblk[i] != 0) {
+                oteax_memcpy(cbc[i], src, AES_BLOCK_SIZE);
+                common = (nblk[i]-1 < common) ? nblk[i]-1 : common;
+            }
+            else {
+                oteax_memcpy(cbc[i], last[i], AES_BLOCK_SIZE);
+                common = 0;
+            }
+            c[i] = IO_PTR(cbc[i]);
+        }
+
+        /* Whole blocks that every message has are run interleaved */
+        if (common != 0) {
+            for (i=0; i<n; i++) {
+                d[i] = &((const io_t*)msg[i])[_BLKSZ];
+            }
+            omac_cbc_blocks_xn(d, c, n, common, ctx->aes);
+        }
+
+        /* The rest of the whole blocks, one message at a time */
+        for (i=0; i<n; i++) {
+            if (nblk[i] > (common + 1)) {
+                omac_cbc_blocks(&((const io_t*)msg[i])[(common+1) * _BLKSZ],
+                                nblk[i] - (common + 1), c[i], ctx->aes);
+            }
+        }
+
+        /* Final block, for the messages that had more than one */
+        for (i=0, m=0; i<n; i++) {
+            if (nblk[i] != 0) {
+                d[m]    = IO_PTR(last[i]);
+                c[m]    = IO_PTR(cbc[i]);
+                m++;
+            }
+        }
+        if (m != 0) {
+            omac_cbc_blocks_xn(d, c, m, 1, ctx->aes);
+        }
+
+        /* Last encryption, E(cbc) ^ 0, for all of them */
+        for (i=0; i<n; i++) {
+            d[i] = IO_PTR(zero);
+            c[i] = IO_PTR(cbc[i]);
+        }
+        omac_cbc_blocks_xn(d, c, n, 1, ctx->aes);
+
+        for (i=0; i<n; i++) {
+            oteax_memcpy(tag[i], cbc[i], AES_BLOCK_SIZE);
+        }
+
+        msg         = &msg[n];
+        msg_len     = &msg_len[n];
+        tag         = &tag[n];
+        num_msgs   -= n;
+    }
+
+    return RETURN_GOOD;
+}
+
+#undef _BLKSZ
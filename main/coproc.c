@@ -0,0 +1,238 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/coproc.c
+  * @brief      Simulated AES co-processor backend
+  *
+  * This behaves like a DMA-driven AES peripheral: operations are queued and
+  * the caller returns at once, a worker thread takes them in order, sleeps
+  * for the configured latency, and then does the work with the software
+  * backend.  It allows offload paths, and their overlap with CPU work, to be
+  * developed and benchmarked on an ordinary POSIX host.
+  ******************************************************************************
+  */
+
+#include "oteax.h"
+
+#if defined(COPROC_POSSIBLE)
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+/// Queue depth.  Submitting to a full queue blocks until a slot frees up.
+#define COPROC_QLEN     64
+
+typedef enum {
+    COPROC_BLOCK = 0,
+    COPROC_ECB,
+    COPROC_CTR,
+    COPROC_CBCMAC
+} coproc_op_t;
+
+typedef struct {
+    coproc_op_t             op;
+    const io_t*             in;
+    io_t*                   out;
+    io_t*                   state;
+    unsigned long           blocks;
+    const aes_encrypt_ctx*  cx;
+} coproc_job_t;
+
+typedef struct {
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    pthread_cond_t  done;
+    unsigned long   job_ns;
+    unsigned long   block_ns;
+    unsigned int    head;
+    unsigned int    tail;
+    int             quit;
+    coproc_job_t    queue[COPROC_QLEN];
+} coproc_t;
+
+
+
+static void sub_delay(unsigned long ns) {
+    struct timespec ts;
+
+    if (ns != 0) {
+        ts.tv_sec   = ns / 1000000000UL;
+        ts.tv_nsec  = ns % 1000000000UL;
+        while (nanosleep(&ts, &ts) != 0);
+    }
+}
+
+
+
+static void* sub_worker(void* arg) {
+    coproc_t* cp = (coproc_t*)arg;
+
+    pthread_mutex_lock(&cp->lock);
+    for (;;) {
+        coproc_job_t* job;
+
+        while ((cp->head == cp->tail) && !cp->quit) {
+            pthread_cond_wait(&cp->wake, &cp->lock);
+        }
+        if (cp->head == cp->tail) {
+            break;
+        }
+        job = &cp->queue[cp->head];
+        pthread_mutex_unlock(&cp->lock);
+
+        sub_delay(cp->job_ns + (job->blocks * cp->block_ns));
+
+        switch (job->op) {
+            case COPROC_BLOCK:  eax_backend_sw.block(job->in, job->out, job->cx, NULL);
+                                break;
+            case COPROC_ECB:    eax_backend_sw.ecb(job->in, job->out, job->blocks, job->cx, NULL);
+                                break;
+            case COPROC_CTR:    eax_backend_sw.ctr(job->out, job->blocks, job->state, job->cx, NULL);
+                                break;
+            case COPROC_CBCMAC: eax_backend_sw.cbcmac(job->in, job->blocks, job->state, job->cx, NULL);
+                                break;
+        }
+
+        pthread_mutex_lock(&cp->lock);
+        cp->head = (cp->head + 1) % COPROC_QLEN;
+        pthread_cond_broadcast(&cp->done);
+    }
+    pthread_mutex_unlock(&cp->lock);
+    return NULL;
+}
+
+
+
+static void sub_submit(coproc_t* cp, coproc_op_t op, const io_t* in, io_t* out, io_t* state,
+                        unsigned long blocks, const aes_encrypt_ctx* cx) {
+    coproc_job_t* job;
+
+    pthread_mutex_lock(&cp->lock);
+    while (((cp->tail + 1) % COPROC_QLEN) == cp->head) {
+        pthread_cond_wait(&cp->done, &cp->lock);
+    }
+    job         = &cp->queue[cp->tail];
+    job->op     = op;
+    job->in     = in;
+    job->out    = out;
+    job->state  = state;
+    job->blocks = blocks;
+    job->cx     = cx;
+    cp->tail    = (cp->tail + 1) % COPROC_QLEN;
+    pthread_cond_signal(&cp->wake);
+    pthread_mutex_unlock(&cp->lock);
+}
+
+
+
+static ret_type cp_sync(void* hdl) {
+    coproc_t* cp = (coproc_t*)hdl;
+
+    pthread_mutex_lock(&cp->lock);
+    while (cp->head != cp->tail) {
+        pthread_cond_wait(&cp->done, &cp->lock);
+    }
+    pthread_mutex_unlock(&cp->lock);
+    return RETURN_GOOD;
+}
+
+
+
+static ret_type cp_block(const io_t* in, io_t* out, const aes_encrypt_ctx cx[1], void* hdl) {
+    sub_submit((coproc_t*)hdl, COPROC_BLOCK, in, out, NULL, 1, cx);
+    return cp_sync(hdl);
+}
+
+
+
+static ret_type cp_ecb(const io_t* in, io_t* out, unsigned long blocks, const aes_encrypt_ctx cx[1], void* hdl) {
+    sub_submit((coproc_t*)hdl, COPROC_ECB, in, out, NULL, blocks, cx);
+    return RETURN_GOOD;
+}
+
+
+
+static ret_type cp_ctr(io_t* data, unsigned long blocks, io_t* ctr, const aes_encrypt_ctx cx[1], void* hdl) {
+    sub_submit((coproc_t*)hdl, COPROC_CTR, NULL, data, ctr, blocks, cx);
+    return RETURN_GOOD;
+}
+
+
+
+static ret_type cp_cbcmac(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx cx[1], void* hdl) {
+    sub_submit((coproc_t*)hdl, COPROC_CBCMAC, data, NULL, cbc, blocks, cx);
+    return RETURN_GOOD;
+}
+
+
+
+const eax_backend eax_backend_coproc = {
+    "coproc-sim",
+    &cp_block,
+    &cp_ecb,
+    &cp_ctr,
+    &cp_cbcmac,
+    &cp_sync
+};
+
+
+
+void* eax_coproc_open(unsigned long job_ns, unsigned long block_ns) {
+    coproc_t* cp;
+
+    cp = calloc(1, sizeof(coproc_t));
+    if (cp == NULL) {
+        return NULL;
+    }
+    cp->job_ns      = job_ns;
+    cp->block_ns    = block_ns;
+    pthread_mutex_init(&cp->lock, NULL);
+    pthread_cond_init(&cp->wake, NULL);
+    pthread_cond_init(&cp->done, NULL);
+
+    if (pthread_create(&cp->thread, NULL, &sub_worker, cp) != 0) {
+        pthread_cond_destroy(&cp->done);
+        pthread_cond_destroy(&cp->wake);
+        pthread_mutex_destroy(&cp->lock);
+        free(cp);
+        return NULL;
+    }
+    return cp;
+}
+
+
+
+void eax_coproc_close(void* hdl) {
+    coproc_t* cp = (coproc_t*)hdl;
+
+    if (cp == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&cp->lock);
+    cp->quit = 1;
+    pthread_cond_signal(&cp->wake);
+    pthread_mutex_unlock(&cp->lock);
+    pthread_join(cp->thread, NULL);
+
+    pthread_cond_destroy(&cp->done);
+    pthread_cond_destroy(&cp->wake);
+    pthread_mutex_destroy(&cp->lock);
+    free(cp);
+}
+
+#endif
@@ -0,0 +1,520 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/gcm.c
+  * @brief      AES-GCM (SP 800-38D) on the OTEAX AES code
+  *
+  * GCM uses the same AES key schedule, CTR engine and cipher backends as
+  * EAX.  GHASH uses PCLMULQDQ on x86 hosts that have it, and otherwise a
+  * 4 bit table (Shoup's method) built at keying time, which is 256 bytes
+  * per context and needs only 32 bit arithmetic.
+  ******************************************************************************
+  */
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+#include "oteax/aesni.h"
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (AES_BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   AES_BLOCK_SIZE
+#endif
+
+/// Octets per io_t unit
+#define _UNIT       (AES_BLOCK_SIZE/_BLKSZ)
+
+
+
+/** GHASH, portable version
+  * ========================================================================<BR>
+  * Blocks are handled as four big-endian 32 bit words, w[0] most significant.
+  * htab[i] is H times the 4 bit polynomial i, in GCM's reflected bit order.
+  */
+
+static const uint_32t last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+
+static void sub_load_be(uint_32t* w, const io_t* src) {
+#   if defined(__C2000__) || defined(__ALIGN32__)
+    w[0] = NET_ENDIAN32(src[0]);
+    w[1] = NET_ENDIAN32(src[1]);
+    w[2] = NET_ENDIAN32(src[2]);
+    w[3] = NET_ENDIAN32(src[3]);
+#   else
+    int i;
+    for (i=0; i<4; i++, src+=4) {
+        w[i] = ((uint_32t)src[0] << 24) | ((uint_32t)src[1] << 16) | ((uint_32t)src[2] << 8) | src[3];
+    }
+#   endif
+}
+
+
+static void sub_store_be(io_t* dst, const uint_32t* w) {
+#   if defined(__C2000__) || defined(__ALIGN32__)
+    dst[0] = NET_ENDIAN32(w[0]);
+    dst[1] = NET_ENDIAN32(w[1]);
+    dst[2] = NET_ENDIAN32(w[2]);
+    dst[3] = NET_ENDIAN32(w[3]);
+#   else
+    int i;
+    for (i=0; i<4; i++, dst+=4) {
+        dst[0] = (io_t)(w[i] >> 24);
+        dst[1] = (io_t)(w[i] >> 16);
+        dst[2] = (io_t)(w[i] >> 8);
+        dst[3] = (io_t)(w[i]);
+    }
+#   endif
+}
+
+
+static void sub_gen_table(uint_32t htab[16][4], const io_t* h) {
+    int i, j, k;
+
+    oteax_memset(htab[0], 0, 16);
+    sub_load_be(htab[8], h);
+
+    for (i=4; i>0; i>>=1) {
+        uint_32t r = (htab[2*i][3] & 1) ? 0xe1000000 : 0;
+        htab[i][3] = (htab[2*i][3] >> 1) | (htab[2*i][2] << 31);
+        htab[i][2] = (htab[2*i][2] >> 1) | (htab[2*i][1] << 31);
+        htab[i][1] = (htab[2*i][1] >> 1) | (htab[2*i][0] << 31);
+        htab[i][0] = (htab[2*i][0] >> 1) ^ r;
+    }
+    for (i=2; i<=8; i*=2) {
+        for (j=1; j<i; j++) {
+            for (k=0; k<4; k++) {
+                htab[i+j][k] = htab[i][k] ^ htab[j][k];
+            }
+        }
+    }
+}
+
+
+static void sub_shift4(uint_32t* z, const uint_32t* m) {
+    uint_32t rem = z[3] & 0xF;
+    z[3] = ((z[3] >> 4) | (z[2] << 28)) ^ m[3];
+    z[2] = ((z[2] >> 4) | (z[1] << 28)) ^ m[2];
+    z[1] = ((z[1] >> 4) | (z[0] << 28)) ^ m[1];
+    z[0] = ((z[0] >> 4) ^ (last4[rem] << 16)) ^ m[0];
+}
+
+
+static void sub_gmult(uint_32t* x, const uint_32t htab[16][4]) {
+    uint_32t z[4];
+    int i, k;
+
+    for (i=15; i>=0; i--) {
+        uint_32t b = (x[i>>2] >> (24 - 8*(i&3))) & 0xFF;
+        if (i == 15) {
+            for (k=0; k<4; k++) {
+                z[k] = htab[b & 0xF][k];
+            }
+        }
+        else {
+            sub_shift4(z, htab[b & 0xF]);
+        }
+        sub_shift4(z, htab[b >> 4]);
+    }
+    for (k=0; k<4; k++) {
+        x[k] = z[k];
+    }
+}
+
+
+
+/* y = (y ^ data[i]) * H over whole blocks */
+static void sub_ghash_blocks(const io_t* data, unsigned long blocks, gcm_ctx ctx[1]) {
+    uint_32t y[4], d[4];
+    int k;
+
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_clmul_available()) {
+        aesni_ghash_blocks(data, blocks, IO_PTR(ctx->ghash), IO_PTR(ctx->htab));
+        return;
+    }
+#   endif
+
+    sub_load_be(y, IO_PTR(ctx->ghash));
+    while (blocks-- != 0) {
+        sub_load_be(d, data);
+        for (k=0; k<4; k++) {
+            y[k] ^= d[k];
+        }
+        sub_gmult(y, (const uint_32t (*)[4])ctx->htab);
+        data += _BLKSZ;
+    }
+    sub_store_be(IO_PTR(ctx->ghash), y);
+}
+
+
+
+/* Multiply in the partial block that has been XORed into ghash */
+static void sub_ghash_close(gcm_ctx ctx[1]) {
+    static const eax_buf_t zero = { 0 };
+    sub_ghash_blocks(IO_PTR(zero), 1, ctx);
+}
+
+
+
+static void sub_ghash_data(const io_t* data, unsigned long data_len, uint_32t* cnt, gcm_ctx ctx[1]) {
+    unsigned long   i       = 0;
+    uint_32t        b_pos   = *cnt & (_BLKSZ-1);
+
+    if (b_pos != 0) {
+        while ((i < data_len) && (b_pos < _BLKSZ)) {
+            IO_PTR(ctx->ghash)[b_pos++] ^= data[i++];
+        }
+        if (b_pos == _BLKSZ) {
+            sub_ghash_close(ctx);
+        }
+    }
+    if ((data_len - i) >= _BLKSZ) {
+        unsigned long blocks = (data_len - i) / _BLKSZ;
+        sub_ghash_blocks(&data[i], blocks, ctx);
+        i += blocks * _BLKSZ;
+    }
+    for (b_pos=0; i<data_len; ) {
+        IO_PTR(ctx->ghash)[b_pos++] ^= data[i++];
+    }
+
+    *cnt += data_len;
+}
+
+
+
+
+/** Counter handling
+  * ========================================================================<BR>
+  * GCM increments only the low 32 bits of the counter block.  ctr_lo keeps a
+  * host order copy of them, so the wrap point is known without reading
+  * ctr_val while a backend may be updating it.
+  */
+
+static void sub_put_ctr_lo(gcm_ctx ctx[1]) {
+    UI32_PTR(ctx->ctr_val)[3] = NET_ENDIAN32(ctx->ctr_lo);
+}
+
+
+static void sub_ctr_blocks(io_t* data, unsigned long blocks, gcm_ctx ctx[1]) {
+    if (ctx->be == NULL) {
+        aes_ctr_blocks(data, data, blocks, IO_PTR(ctx->ctr_val), 32, ctx->aes);
+        ctx->ctr_lo += (uint_32t)blocks;
+        return;
+    }
+
+    /* Backends step a 128 bit counter, so a run that reaches the 32 bit wrap
+       is cut there and the upper 96 bits are put back afterwards.
+    */
+    while (blocks != 0) {
+        uint_64t        room    = ((uint_64t)1 << 32) - ctx->ctr_lo;
+        unsigned long   n       = ((uint_64t)blocks < room) ? blocks : (unsigned long)room;
+
+        if ((uint_64t)n < room) {
+            ctx->be->ctr(data, n, IO_PTR(ctx->ctr_val), ctx->aes, ctx->be_hdl);
+            ctx->ctr_lo += (uint_32t)n;
+        }
+        else {
+            uint_32t upper[3];
+            BACKEND_SYNC(ctx);
+            oteax_memcpy(upper, ctx->ctr_val, 12);
+            ctx->be->ctr(data, n, IO_PTR(ctx->ctr_val), ctx->aes, ctx->be_hdl);
+            BACKEND_SYNC(ctx);
+            oteax_memcpy(ctx->ctr_val, upper, 12);
+            ctx->ctr_lo = 0;
+            sub_put_ctr_lo(ctx);
+        }
+        data   += n * _BLKSZ;
+        blocks -= n;
+    }
+}
+
+
+
+
+/** Keying and context management
+  * ========================================================================<BR>
+  */
+
+ret_type gcm_init_and_key(const void* key, gcm_ctx ctx[1]) {
+    oteax_memset(ctx, 0, sizeof(gcm_ctx));
+    aes_encrypt_key(IO_PTR(key), 16, ctx->aes);
+
+    /* H = E(0) */
+    aes_encrypt(IO_PTR(ctx->hkey), IO_PTR(ctx->hkey), ctx->aes);
+
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_clmul_available()) {
+        aesni_ghash_init(IO_PTR(ctx->hkey), IO_PTR(ctx->htab));
+        return RETURN_GOOD;
+    }
+#   endif
+    sub_gen_table(ctx->htab, IO_PTR(ctx->hkey));
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_init_and_keys(const void* keys, unsigned long num_keys, gcm_ctx ctx[]) {
+    unsigned long i;
+
+    for (i=0; i<num_keys; i++) {
+        gcm_init_and_key(&((const io_t*)keys)[i * _BLKSZ], &ctx[i]);
+    }
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_end(gcm_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    oteax_memset(ctx, 0, sizeof(gcm_ctx));
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_set_backend(const eax_backend* be, void* hdl, gcm_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    ctx->be     = be;
+    ctx->be_hdl = hdl;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_sync(gcm_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    return RETURN_GOOD;
+}
+
+
+
+
+/** Streaming API
+  * ========================================================================<BR>
+  */
+
+ret_type gcm_init_message(const io_t* iv, unsigned long iv_len, gcm_ctx ctx[1]) {
+    uint_32t w[4];
+
+    BACKEND_SYNC(ctx);
+    oteax_memset(ctx->ghash, 0, AES_BLOCK_SIZE);
+    ctx->hdr_cnt    = 0;
+    ctx->txt_ccnt   = 0;
+    ctx->txt_acnt   = 0;
+
+    /* J0 = IV || 0^31 || 1 for a 96 bit IV, else GHASH(IV, [len(IV)]) */
+    if ((iv_len * _UNIT) == 12) {
+        oteax_memcpy(ctx->ctr_val, iv, 12);
+        UI32_PTR(ctx->ctr_val)[3] = NET_ENDIAN32(1);
+    }
+    else {
+        uint_32t ivcnt = 0;
+        sub_ghash_data(iv, iv_len, &ivcnt, ctx);
+        if ((ivcnt & (_BLKSZ-1)) != 0) {
+            sub_ghash_close(ctx);
+        }
+        w[0] = 0;
+        w[1] = 0;
+        w[2] = (uint_32t)((iv_len * _UNIT) >> 29);
+        w[3] = (uint_32t)((iv_len * _UNIT) << 3);
+        sub_store_be(IO_PTR(ctx->tag_pad), w);
+        sub_ghash_blocks(IO_PTR(ctx->tag_pad), 1, ctx);
+        oteax_memcpy(ctx->ctr_val, ctx->ghash, AES_BLOCK_SIZE);
+        oteax_memset(ctx->ghash, 0, AES_BLOCK_SIZE);
+    }
+
+    /* E(J0) masks the tag; data starts at inc32(J0) */
+    BACKEND_ENCRYPT(IO_PTR(ctx->ctr_val), IO_PTR(ctx->tag_pad), ctx);
+    ctx->ctr_lo = NET_ENDIAN32(UI32_PTR(ctx->ctr_val)[3]) + 1;
+    sub_put_ctr_lo(ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_auth_header(const io_t* hdr, unsigned long hdr_len, gcm_ctx ctx[1]) {
+    if ((ctx->txt_acnt != 0) || (ctx->txt_ccnt != 0)) {
+        return RETURN_ERROR;
+    }
+    sub_ghash_data(hdr, hdr_len, &ctx->hdr_cnt, ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_auth_data(const io_t* data, unsigned long data_len, gcm_ctx ctx[1]) {
+    if (data_len == 0) {
+        return RETURN_GOOD;
+    }
+    BACKEND_SYNC(ctx);
+    if ((ctx->txt_acnt == 0) && ((ctx->hdr_cnt & (_BLKSZ-1)) != 0)) {
+        sub_ghash_close(ctx);
+    }
+    sub_ghash_data(data, data_len, &ctx->txt_acnt, ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_crypt_data(io_t* data, unsigned long data_len, gcm_ctx ctx[1]) {
+    unsigned long   cnt     = 0;
+    uint_32t        b_pos   = ctx->txt_ccnt & (_BLKSZ-1);
+
+    if (data_len == 0) {
+        return RETURN_GOOD;
+    }
+
+    if (b_pos != 0) {
+        BACKEND_SYNC(ctx);
+        while ((cnt < data_len) && (b_pos < _BLKSZ)) {
+            data[cnt++] ^= IO_PTR(ctx->enc_ctr)[b_pos++];
+        }
+    }
+
+    if ((data_len - cnt) >= _BLKSZ) {
+        unsigned long blocks = (data_len - cnt) / _BLKSZ;
+        sub_ctr_blocks(&data[cnt], blocks, ctx);
+        cnt += blocks * _BLKSZ;
+    }
+
+    if (cnt < data_len) {
+        BACKEND_SYNC(ctx);
+    }
+    while (cnt < data_len) {
+        if ((b_pos == _BLKSZ) || (b_pos == 0)) {
+            BACKEND_ENCRYPT(IO_PTR(ctx->ctr_val), IO_PTR(ctx->enc_ctr), ctx);
+            ctx->ctr_lo++;
+            sub_put_ctr_lo(ctx);
+            b_pos = 0;
+        }
+        data[cnt++] ^= IO_PTR(ctx->enc_ctr)[b_pos++];
+    }
+
+    ctx->txt_ccnt += (uint_32t)cnt;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_encrypt(io_t* data, unsigned long data_len, gcm_ctx ctx[1]) {
+    gcm_crypt_data(data, data_len, ctx);
+    gcm_auth_data(data, data_len, ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_decrypt(io_t* data, unsigned long data_len, gcm_ctx ctx[1]) {
+    gcm_auth_data(data, data_len, ctx);
+    gcm_crypt_data(data, data_len, ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type gcm_compute_tag(io_t* tag, gcm_ctx ctx[1]) {
+    uint_32t w[4];
+    eax_buf_t lens;
+
+    BACKEND_SYNC(ctx);
+
+    if ((ctx->txt_acnt != ctx->txt_ccnt) && (ctx->txt_ccnt > 0)) {
+        return RETURN_ERROR;
+    }
+
+    if (ctx->txt_acnt == 0) {
+        if ((ctx->hdr_cnt & (_BLKSZ-1)) != 0) {
+            sub_ghash_close(ctx);
+        }
+    }
+    else if ((ctx->txt_acnt & (_BLKSZ-1)) != 0) {
+        sub_ghash_close(ctx);
+    }
+
+    /* [len(A)]64 || [len(C)]64, in bits */
+    w[0] = (uint_32t)(((uint_64t)ctx->hdr_cnt * _UNIT) >> 29);
+    w[1] = (uint_32t)(((uint_64t)ctx->hdr_cnt * _UNIT) << 3);
+    w[2] = (uint_32t)(((uint_64t)ctx->txt_acnt * _UNIT) >> 29);
+    w[3] = (uint_32t)(((uint_64t)ctx->txt_acnt * _UNIT) << 3);
+    sub_store_be(IO_PTR(lens), w);
+    sub_ghash_blocks(IO_PTR(lens), 1, ctx);
+
+    xor_block_aligned(ctx->ghash, ctx->ghash, ctx->tag_pad);
+    oteax_memcpy(tag, ctx->ghash, AES_BLOCK_SIZE);
+
+    return 0 - (ctx->txt_ccnt != ctx->txt_acnt);
+}
+
+
+
+
+/** Single-call message API
+  * ========================================================================<BR>
+  */
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define ALIGN_LENGTH(X)  ((X+3)>>2)
+#else
+#   define ALIGN_LENGTH(X)  (X)
+#endif
+
+ret_type gcm_encrypt_message(const void* iv, const void* hdr, unsigned long hdr_len,
+                             void* msg, unsigned long msg_len, gcm_ctx ctx[1]) {
+    unsigned long aligned_msglen = ALIGN_LENGTH(msg_len);
+
+    gcm_init_message((const io_t*)iv, 12/_UNIT, ctx);
+    gcm_auth_header((const io_t*)hdr, ALIGN_LENGTH(hdr_len), ctx);
+    gcm_encrypt((io_t*)msg, aligned_msglen, ctx);
+    return gcm_compute_tag(&((io_t*)msg)[aligned_msglen], ctx);
+}
+
+
+
+ret_type gcm_decrypt_message(const void* iv, const void* hdr, unsigned long hdr_len,
+                             void* msg, unsigned long msg_len, gcm_ctx ctx[1]) {
+    unsigned long   aligned_msglen = ALIGN_LENGTH(msg_len);
+    const io_t*     tag = &((const io_t*)msg)[aligned_msglen];
+    eax_buf_t       local_tag;
+    uint_32t        diff;
+    int             i;
+
+    /* Authenticate first, then decrypt only if the tag matches */
+    gcm_init_message((const io_t*)iv, 12/_UNIT, ctx);
+    gcm_auth_header((const io_t*)hdr, ALIGN_LENGTH(hdr_len), ctx);
+    gcm_auth_data((const io_t*)msg, aligned_msglen, ctx);
+    gcm_compute_tag(IO_PTR(local_tag), ctx);
+
+    for (i=0, diff=0; i<_BLKSZ; i++) {
+        diff |= (uint_32t)(IO_PTR(local_tag)[i] ^ tag[i]);
+    }
+    if (diff != 0) {
+        return RETURN_ERROR;
+    }
+
+    /* Authentication leaves the counter at inc32(J0) */
+    gcm_crypt_data((io_t*)msg, aligned_msglen, ctx);
+    BACKEND_SYNC(ctx);
+    return RETURN_GOOD;
+}
+
+#undef ALIGN_LENGTH
+#undef _UNIT
+#undef _BLKSZ
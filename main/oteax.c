@@ -26,6 +26,10 @@ Issue Date: 21/07/2009
 #include "oteax.h"
 #include "oteax/mode_hdr.h"
 #include "oteax/aesopt.h"
+#include "oteax/aesni.h"
+#include "oteax/afalg.h"
+#include "oteax/omac.h"
+#include "oteax/smallframe.h"
 
 //#define OTEAX_TEST_INITKEY
 //#define OTEAX_TEST_INITMSG
@@ -65,62 +69,18 @@ extern "C"
 #define BLOCK_SIZE      AES_BLOCK_SIZE      /* block length                 */
 #define BLK_ADR_MASK    (BLOCK_SIZE - 1)    /* mask for 'in block' address  */
 
-///@note it seems plausible to do in 32bit alignment, but not guaranteed
-#if defined(__ALIGN32__)
-#   define inc_ctr(x)  \
-    do {    \
-        int zz; \
-        for (zz=(BLOCK_SIZE/4)-1; zz>=0; zz--) {            \
-            x[zz] = NET_ENDIAN32((NET_ENDIAN32(x[zz]) + 1));    \
-            if (x[zz] != 0) \
-                break;   \
-        }   \
-    } while (0)
-
-#   define dec_ctr(x)  \
-    do {    \
-        int zz; \
-        for (zz=(BLOCK_SIZE/4)-1; zz>=0; zz--) {            \
-            if (x[zz] != 0) \
-                break;   \
-            x[zz] = NET_ENDIAN32((NET_ENDIAN32(x[zz]) - 1));    \
-        }   \
-    } while (0)
-        
-#elif defined(__C2000__)
-#   define inc_ctr(x)   do {    \
-                            int i; \
-                            for (i=BLOCK_SIZE-1; i>=0; i--) {      \
-                                __byte((int*)x, i) += 1;            \
-                                if ( __byte((int*)x, i) == 0 ) {    \
-                                    break;                          \
-                                }                                   \
-                            }   \
-                        while (0)
-
-#   define dec_ctr(x)   do {    \
-                            int i;  \
-                            for (i=BLOCK_SIZE-1; i>=0; i--) {      \
-                                if ( __byte((int*)x, i) == 0 ) {    \
-                                    break;                          \
-                                }                                   \
-                                __byte((int*)x, i) -= 1;            \
-                            }   \
-                        while (0)
-                        
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define ALIGN_LENGTH(X)  ((X+3)>>2)
 #else
-#   define inc_ctr(x)  \
-        {   int i = BLOCK_SIZE; while(i-- > 0 && !++(UI8_PTR(x)[i])) ; }
-#   define dec_ctr(x)  \
-        {   int i = BLOCK_SIZE; while(i-- > 0 && !(UI8_PTR(x)[i])--) ; }
+#   define ALIGN_LENGTH(X)  (X)
 #endif
 
-
-
+/* R ^= P over N io_t units, for partial blocks */
 #if defined(__C2000__) || defined(__ALIGN32__)
-#   define ALIGN_LENGTH(X)  ((X+3)>>2)
+#   define XOR_IO(R, P, N)  \
+    do { unsigned long zz; for (zz=0; zz<(N); zz++) (R)[zz] ^= (P)[zz]; } while (0)
 #else
-#   define ALIGN_LENGTH(X)  (X)
+#   define XOR_IO(R, P, N)  xor_bytes(R, R, P, N)
 #endif
 
 
@@ -131,15 +91,37 @@ extern "C"
   * ========================================================================<BR>
   * - eax_encrypt_message()
   * - eax_decrypt_message()
+  * - eax_cache_header()
+  * - eax_encrypt_message_hdr()
+  * - eax_decrypt_message_hdr()
+  * - eax_decrypt_messages()
+  * - eax_prime_encrypt_message()
+  * - eax_prime_decrypt_message()
   * - eax_init_and_key()
+  * - eax_init_and_key_ct()
+  * - eax_init_and_keys()
   */
 
+
+
+
 ret_type eax_encrypt_message(const void* iv_v, void* msg_v, unsigned long msg_len, eax_ctx ctx[1]) {
     ///@note [JPN] Tag is always dealt-with as the data right after the message
     unsigned long   aligned_msglen  = ALIGN_LENGTH(msg_len);
     io_t*           tag             = &((io_t*)msg_v)[aligned_msglen];
 
+#   if defined(AFALG_POSSIBLE)
+    if ((ctx->afalg != NULL) && (msg_len >= afalg_threshold(ctx->afalg))) {
+        return afalg_eax_encrypt((const io_t*)iv_v, (io_t*)msg_v, msg_len, ctx);
+    }
+#   endif
+
     eax_init_message((const io_t*)iv_v, ctx);
+#   if defined(SMALLFRAME_POSSIBLE)
+    if ((ctx->be == NULL) && (smallframe_encrypt((io_t*)msg_v, aligned_msglen, ctx) == RETURN_GOOD)) {
+        return eax_compute_tag(tag, ctx);
+    }
+#   endif
     eax_encrypt((io_t*)msg_v, aligned_msglen, ctx);
     return eax_compute_tag(tag, ctx);
 }
@@ -160,9 +142,14 @@ ret_type eax_decrypt_message(const void* iv_v, void* msg_v, unsigned long msg_le
     
     msg_len = ALIGN_LENGTH(msg_len);
     
-    ///@todo Cortex-M supports non-aligned memory access.  I need to test it.
+#   if defined(AFALG_POSSIBLE)
+    if ((ctx->afalg != NULL) && (msg_len >= afalg_threshold(ctx->afalg))) {
+        return afalg_eax_decrypt((const io_t*)iv_v, (io_t*)msg_v, msg_len, ctx);
+    }
+#   endif
+
 #   if defined (__UNALIGNED_ACCESS__)
-        *((uint_32t*)tag) = *((uint_32t*)(msg + msg_len)); 
+        mh_store32(tag, mh_load32(&((io_t*)msg_v)[msg_len]));
 #   elif defined(__ALIGN32__) || defined(__C2000__)
         tag[0] = ((io_t*)msg_v)[msg_len];
 #   else
@@ -177,90 +164,255 @@ ret_type eax_decrypt_message(const void* iv_v, void* msg_v, unsigned long msg_le
     
     // 1st pass decryption
     eax_init_message(iv_v, ctx);
+#   if defined(SMALLFRAME_POSSIBLE)
+    if ((ctx->be != NULL) || (smallframe_decrypt((io_t*)msg_v, msg_len, ctx) != RETURN_GOOD))
+#   endif
     eax_decrypt((io_t*)msg_v, msg_len, ctx);
     
     // 2nd pass tag computation and comparison
     rr  = eax_compute_tag(local_tag, ctx);
-    rr -= ( *(uint_32t*)tag != *(uint_32t*)local_tag );
+    rr -= (ret_type)(tag_mask((const uint_32t*)tag, (const uint_32t*)local_tag, 1) ^ 1);
     return rr;
 }
 
 
-ret_type eax_init_and_key(const void* key_v, eax_ctx ctx[1]) {
+static void sub_header_start(io_t* cbc, uint_32t* cnt) {
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (BLOCK_SIZE/4)
+#else
+#   define _BLKSZ   BLOCK_SIZE
+#endif
+    /* OMAC^1: the tweak block [1] counts as the first block */
+    oteax_memset(cbc, 0, EAX_BLOCK_SIZE);
+    UI32_PTR(cbc)[3] = NET_ENDIAN32(1);
+    *cnt = _BLKSZ;
+#undef _BLKSZ
+}
+
+
+
+/* The message-level header calls XOR the header OMAC into the tag on the
+   way out (or in), so they also work with the AF_ALG path.
+*/
+static void sub_tag_xor(io_t* tag, const eax_hdr_t* hdr) {
+#   if defined(__ALIGN32__) || defined(__C2000__)
+    tag[0] ^= UI32_PTR(hdr->omac)[0];
+#   else
+    tag[0] ^= UI8_PTR(hdr->omac)[0];
+    tag[1] ^= UI8_PTR(hdr->omac)[1];
+    tag[2] ^= UI8_PTR(hdr->omac)[2];
+    tag[3] ^= UI8_PTR(hdr->omac)[3];
+#   endif
+}
+
+
+
+ret_type eax_cache_header(const void* hdr, unsigned long hdr_len, eax_hdr_t* cache, eax_ctx ctx[1]) {
+    uint_32t cnt;
+
+    sub_header_start(IO_PTR(cache->omac), &cnt);
+    omac_update((const io_t*)hdr, ALIGN_LENGTH(hdr_len), IO_PTR(cache->omac), &cnt, ctx->aes);
+    omac_final(IO_PTR(cache->omac), cnt, IO_PTR(ctx->pad_xvv), ctx->aes);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_encrypt_message_hdr(const void* iv, const eax_hdr_t* hdr, void* msg, unsigned long msg_len, eax_ctx ctx[1]) {
+    ret_type rr;
+
+    rr = eax_encrypt_message(iv, msg, msg_len, ctx);
+    sub_tag_xor(&((io_t*)msg)[ALIGN_LENGTH(msg_len)], hdr);
+    return rr;
+}
+
+
+
+ret_type eax_decrypt_message_hdr(const void* iv, const eax_hdr_t* hdr, void* msg, unsigned long msg_len, eax_ctx ctx[1]) {
+    ret_type rr;
+
+    sub_tag_xor(&((io_t*)msg)[ALIGN_LENGTH(msg_len)], hdr);
+    rr = eax_decrypt_message(iv, msg, msg_len, ctx);
+    sub_tag_xor(&((io_t*)msg)[ALIGN_LENGTH(msg_len)], hdr);
+    return rr;
+}
+
+
+
+ret_type eax_decrypt_messages(const void* const iv[], void* const msg[], const unsigned long msg_len[],
+                              unsigned int num_msgs, eax_ctx* const ctx[], uint_32t* pass) {
+    eax_buf_t       ctr[EAX_BATCH_MAX];
+    uint_32t        rx_tag[EAX_BATCH_MAX];
+    uint_32t        local_tag[EAX_BATCH_MAX];
+    uint_32t        mask;
+    unsigned int    i;
+
+    if ((num_msgs == 0) || (num_msgs > EAX_BATCH_MAX)) {
+        return RETURN_ERROR;
+    }
+
+    /* EAX authenticates the ciphertext, so every tag can be computed
+       before anything is decrypted
+    */
+    for (i=0; i<num_msgs; i++) {
+        unsigned long len = ALIGN_LENGTH(msg_len[i]);
+
+        oteax_memcpy(&rx_tag[i], &((io_t*)msg[i])[len], 4);
+        eax_init_message((const io_t*)iv[i], ctx[i]);
+        oteax_memcpy(ctr[i], ctx[i]->ctr_val, EAX_BLOCK_SIZE);
+        eax_auth_data((const io_t*)msg[i], len, ctx[i]);
+        eax_compute_tag((io_t*)&local_tag[i], ctx[i]);
+    }
+
+    mask = tag_mask(rx_tag, local_tag, num_msgs);
+
+    /* Frames that passed are decrypted from their saved counter start
+       value, since a context may be shared.  The others are left as they
+       came in.
+    */
+    for (i=0; i<num_msgs; i++) {
+        if (mask & ((uint_32t)1 << i)) {
+            oteax_memcpy(ctx[i]->ctr_val, ctr[i], EAX_BLOCK_SIZE);
+            ctx[i]->txt_ccnt = 0;
+            eax_crypt_data((io_t*)msg[i], ALIGN_LENGTH(msg_len[i]), ctx[i]);
+            BACKEND_SYNC(ctx[i]);
+        }
+    }
+
+    *pass = mask;
+    return (mask == (0xFFFFFFFFu >> (32 - num_msgs))) ? RETURN_GOOD : RETURN_ERROR;
+}
+
+
+
+/* EAX' (ANSI C12.22).  The nonce and header OMACs of EAX become one CMAC
+   over the cleartext, N', and the ciphertext OMAC drops its tweak block in
+   favour of swapped final block masks, C'.  The CTR start value is N' with
+   bits 31 and 15 cleared, and the tag is the last 4 bytes of N' ^ C'.
+*/
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _PRIME_K1(CTX)   IO_PTR((CTX)->pad_xvv)
+#   define _PRIME_K2(CTX)   &IO_PTR((CTX)->pad_xvv)[4]
+#else
+#   define _PRIME_K1(CTX)   IO_PTR((CTX)->pad_xvv)
+#   define _PRIME_K2(CTX)   &IO_PTR((CTX)->pad_xvv)[16]
+#endif
+
+static void sub_prime_start(const void* clr_v, unsigned long clr_len, eax_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    omac_message((const io_t*)clr_v, ALIGN_LENGTH(clr_len), IO_PTR(ctx->nce_cbc),
+                 _PRIME_K1(ctx), _PRIME_K2(ctx), ctx->aes);
+
+    oteax_memcpy(ctx->ctr_val, ctx->nce_cbc, EAX_BLOCK_SIZE);
+#   if defined(__C2000__) || defined(__ALIGN32__)
+    ctx->ctr_val[3] &= NET_ENDIAN32(0x7FFF7FFF);
+#   else
+    UI8_PTR(ctx->ctr_val)[12] &= 0x7F;
+    UI8_PTR(ctx->ctr_val)[14] &= 0x7F;
+#   endif
+    ctx->txt_ccnt = 0;
+    ctx->txt_acnt = 0;
+}
+
+
+
+static uint_32t sub_prime_tag(const io_t* ct, unsigned long ct_len, eax_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    omac_message(ct, ct_len, IO_PTR(ctx->txt_cbc),
+                 _PRIME_K2(ctx), _PRIME_K1(ctx), ctx->aes);
+    return UI32_PTR(ctx->nce_cbc)[3] ^ UI32_PTR(ctx->txt_cbc)[3];
+}
+
+
+
+ret_type eax_prime_encrypt_message(const void* clr_v, unsigned long clr_len,
+                                    void* msg_v, unsigned long msg_len, eax_ctx ctx[1]) {
+    unsigned long   aligned_msglen  = ALIGN_LENGTH(msg_len);
+    uint_32t        tag;
+
+    sub_prime_start(clr_v, clr_len, ctx);
+    eax_crypt_data((io_t*)msg_v, aligned_msglen, ctx);
+    tag = sub_prime_tag((const io_t*)msg_v, aligned_msglen, ctx);
+    oteax_memcpy(&((io_t*)msg_v)[aligned_msglen], &tag, 4);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_prime_decrypt_message(const void* clr_v, unsigned long clr_len,
+                                    void* msg_v, unsigned long msg_len, eax_ctx ctx[1]) {
+    unsigned long   aligned_msglen  = ALIGN_LENGTH(msg_len);
+    uint_32t        tag, rx_tag;
+
+    oteax_memcpy(&tag, &((io_t*)msg_v)[aligned_msglen], 4);
+    sub_prime_start(clr_v, clr_len, ctx);
+    rx_tag = sub_prime_tag((const io_t*)msg_v, aligned_msglen, ctx);
+    if (tag_mask(&rx_tag, &tag, 1) == 0) {
+        return RETURN_ERROR;
+    }
+    eax_crypt_data((io_t*)msg_v, aligned_msglen, ctx);
+    BACKEND_SYNC(ctx);
+    return RETURN_GOOD;
+}
+
+#undef _PRIME_K2
+#undef _PRIME_K1
+
+
+ret_type omac_init_and_key(const void* key_v, int kernel, io_t* pad_xvv, aes_encrypt_ctx aes[1]) {
     uint_32t i;
     io_t *p;
-#   if defined(__C2000__) || defined(__ALIGN32__)
+#   if defined(__ALIGN32__)
+    uint_32t t;
+    uint_32t w[EAX_BLOCK_SIZE/4];
+#   elif defined(__C2000__)
     uint32_t t;
     static uint_32t x_t[1] = { NET_ENDIAN32(0x00870e87 ^ 0x0000000e) };
 #   else
     uint_8t t;
-    static uint_8t x_t[4] = { 0x00, 0x87, 0x0e, 0x87 ^ 0x0e };
 #   endif
 
-    /* set the context to all zeroes            */
-    memset(ctx, 0, sizeof(eax_ctx));
+    /* pad_xvv must start as zero, for E(0)     */
+    oteax_memset(pad_xvv, 0, 2*EAX_BLOCK_SIZE);
 
     /* set the AES key                          */
-    //aes_encrypt_key(key, key_len, ctx->aes);
-    aes_encrypt_key(IO_PTR(key_v), 16, ctx->aes);
+    //aes_encrypt_key(key, key_len, aes);
+    if (kernel == EAX_KERNEL_CT) {
+        aes_encrypt_key128_ct(IO_PTR(key_v), aes);
+    }
+    else {
+        aes_encrypt_key(IO_PTR(key_v), 16, aes);
+    }
 
     /* compute E(0) (needed for the pad values) */
-    aes_encrypt(IO_PTR(ctx->pad_xvv), IO_PTR(ctx->pad_xvv), ctx->aes);
+    aes_encrypt(IO_PTR(pad_xvv), IO_PTR(pad_xvv), aes);
 
     /* compute {02} * {E(0)} and {04} * {E(0)}  */
     /* GF(2^128) mod x^128 + x^7 + x^2 + x + 1  */
 #   if defined(__ALIGN32__)
-    p   = IO_PTR(ctx->pad_xvv);
-    t   = bval(p[0], 0) >> 6;
+    /* Done on whole words: in host order, w[0] holds the most significant
+       bits of the block, so each doubling is a 128 bit left shift with the
+       carry taken from the top bit of the next word.
+    */
+    p   = IO_PTR(pad_xvv);
     for (i=0; i<(EAX_BLOCK_SIZE/4); ++i) {
-        uint_8t m, n;
-        uint_8t b0, b1, b2, b3;
-        uint_8t b16, b17, b18, b19;
-
-#       ifdef OTEAX_TEST_INITKEY
-        printf("Input: %08X -- %02X %02X %02X %02X\n", p[i], bval(p[i], 0), bval(p[i], 1), bval(p[i], 2), bval(p[i], 3));
-#       endif
-
-        m   = bval(p[i], 0);
-        n   = bval(p[i], 1);
-        b0  = ((m << 1) | (n >> 7)) & 0xFF;
-        b16 = ((m << 2) | (n >> 6)) & 0xFF;
-
-        m   = n;
-        n   = bval(p[i], 2);
-        b1  = ((m << 1) | (n >> 7)) & 0xFF;
-        b17 = ((m << 2) | (n >> 6)) & 0xFF;
-        
-        m   = n;
-        n   = bval(p[i], 3);
-        b2  = ((m << 1) | (n >> 7)) & 0xFF;
-        b18 = ((m << 2) | (n >> 6)) & 0xFF;
-        
-        if (i != ((EAX_BLOCK_SIZE/4)-1)) {
-            m   = n;
-            n   = bval(p[i+1], 0);
-            b3  = ((m << 1) | (n >> 7)) & 0xFF;
-            b19 = ((m << 2) | (n >> 6)) & 0xFF;
+        w[i] = NET_ENDIAN32(p[i]);
+    }
+    for (t=0; t<2; ++t) {
+        uint_32t c = 0x87 & (0 - (w[0] >> 31));
+        for (i=0; i<((EAX_BLOCK_SIZE/4)-1); ++i) {
+            w[i] = (w[i] << 1) | (w[i+1] >> 31);
         }
-        else {
-            b19     = ((n << 2) ^ bval(x_t[0], t)) & 0xFF;     
-            b18    ^= (t >>= 1);
-            b3      = (n << 1) ^ bval(x_t[0], t);
+        w[i] = (w[i] << 1) ^ c;
+        for (i=0; i<(EAX_BLOCK_SIZE/4); ++i) {
+            p[(t*(EAX_BLOCK_SIZE/4)) + i] = NET_ENDIAN32(w[i]);
         }
-        
-        p[i]    = bytes2word(b0, b1, b2, b3);
-        p[i+4]  = bytes2word(b16, b17, b18, b19);
-        
-#       ifdef OTEAX_TEST_INITKEY
-        printf("Output: %08X -- %02X %02X %02X %02X\n", p[i], b0, b1, b2, b3);
-        printf("Output: %08X -- %02X %02X %02X %02X\n\n", p[i+4], b16, b17, b18, b19);
-#       endif
     }
 
     ///@note This version uses C2000 byte intrinsic, but it isn't 32bit clean.
     ///      Above version for __ALIGN32__ will also work on C2000.
 #   elif defined(__C2000__)
-    p   = IO_PTR(ctx->pad_xvv);
+    p   = IO_PTR(pad_xvv);
     t   = __byte(p, 0) >> 6;
     for(i=0; i<EAX_BLOCK_SIZE-1; ++i) {
         io_t a0 = __byte(p, i);
@@ -278,7 +430,7 @@ ret_type eax_init_and_key(const void* key_v, eax_ctx ctx[1]) {
     }
     
 #   else
-    p=UI8_PTR(ctx->pad_xvv);
+    p=UI8_PTR(pad_xvv);
     t=(*p>>6);
     for(i=0; i<EAX_BLOCK_SIZE-1; ++i, ++p) {
 #       ifdef OTEAX_TEST_INITKEY
@@ -296,9 +448,10 @@ ret_type eax_init_and_key(const void* key_v, eax_ctx ctx[1]) {
 #   ifdef OTEAX_TEST_INITKEY
     printf("Input: %02X \n", *p);
 #   endif
-    *(p+16)  = (*p << 2) ^ x_t[t];
+    /* the reduction bytes {00, 87, 0e, 89}[t] without a lookup on E(0) */
+    *(p+16)  = (*p << 2) ^ (0x0e & (0 - (t >> 1))) ^ (0x87 & (0 - (t & 1)));
     *(p+15) ^= (t >>= 1);
-    *p       = (*p << 1) ^ x_t[t];
+    *p       = (*p << 1) ^ (0x87 & (0 - t));
 #   ifdef OTEAX_TEST_INITKEY
     printf("Output: %02X\n", *p);
     printf("Output: %02X\n\n", *(p+15));
@@ -311,8 +464,8 @@ ret_type eax_init_and_key(const void* key_v, eax_ctx ctx[1]) {
     // Test print-out of pad_xvv
     // Requires byte-addressable machine
 #   ifdef OTEAX_TEST_INITKEY
-    {   for (i=0; i<sizeof(eax_dbuf_t); ) {
-            printf("%02X ", ((uint8_t*)ctx->pad_xvv)[i++]);
+    {   for (i=0; i<(2*EAX_BLOCK_SIZE); ) {
+            printf("%02X ", ((uint8_t*)pad_xvv)[i++]);
             if ((i % 16) == 0) {
                 printf("\n");
             }
@@ -333,6 +486,82 @@ ret_type eax_init_and_key(const void* key_v, eax_ctx ctx[1]) {
 
 
 
+ret_type eax_init_and_key(const void* key_v, eax_ctx ctx[1]) {
+    /* close any AF_ALG handle on the old key, then zero the context */
+#   if defined(AFALG_POSSIBLE)
+    eax_afalg_detach(ctx);
+#   endif
+    memset(ctx, 0, sizeof(eax_ctx));
+
+    return omac_init_and_key(key_v, EAX_KERNEL_FAST, IO_PTR(ctx->pad_xvv), ctx->aes);
+}
+
+
+
+ret_type eax_init_and_key_ct(const void* key_v, eax_ctx ctx[1]) {
+#   if defined(AFALG_POSSIBLE)
+    eax_afalg_detach(ctx);
+#   endif
+    memset(ctx, 0, sizeof(eax_ctx));
+
+    return omac_init_and_key(key_v, EAX_KERNEL_CT, IO_PTR(ctx->pad_xvv), ctx->aes);
+}
+
+
+
+int eax_kernel(const eax_ctx ctx[1]) {
+    return INF_B(ctx->aes->inf, 1);
+}
+
+
+
+
+
+ret_type eax_init_and_keys(const void* keys_v, unsigned long num_keys, eax_ctx ctx[]) {
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _KEYSZ   (16/4)
+#else
+#   define _KEYSZ   16
+#endif
+    const io_t*     keys    = (const io_t*)keys_v;
+    unsigned long   i       = 0;
+
+    ///@note The AES-NI path keys four contexts per call, with the four key
+    ///      expansions, E(0) encryptions and pad doublings interleaved.  The
+    ///      remainder (and non-x86 builds) go through eax_init_and_key().
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_available()) {
+        for (; (i+4) <= num_keys; i += 4) {
+            aes_encrypt_ctx*    cx[4];
+            io_t*               pad[4];
+            int                 j;
+            
+            for (j=0; j<4; j++) {
+#               if defined(AFALG_POSSIBLE)
+                eax_afalg_detach(&ctx[i+j]);
+#               endif
+                oteax_memset(&ctx[i+j], 0, sizeof(eax_ctx));
+                cx[j]   = ctx[i+j].aes;
+                pad[j]  = IO_PTR(ctx[i+j].pad_xvv);
+            }
+            aesni_omac_key128_x4(&keys[i*_KEYSZ], cx, pad);
+        }
+    }
+#   endif
+
+    for (; i<num_keys; ++i) {
+        eax_init_and_key(&keys[i*_KEYSZ], &ctx[i]);
+    }
+    
+    return RETURN_GOOD;
+    
+#undef _KEYSZ
+}
+
+
+
+
+
 /** Low-Level (Expert-Only) routines for EAX
   * ========================================================================<BR>
   */
@@ -347,6 +576,8 @@ ret_type eax_init_message(const io_t* iv, eax_ctx ctx[1]) {
     uint_32t n_pos = 0;
     io_t *p;
 
+    BACKEND_SYNC(ctx);
+
     /* Initialize nonce and cipher-text block buffers */
     oteax_memset(ctx->nce_cbc, 0, EAX_BLOCK_SIZE);
     oteax_memset(ctx->txt_cbc, 0, EAX_BLOCK_SIZE);
@@ -362,10 +593,14 @@ ret_type eax_init_message(const io_t* iv, eax_ctx ctx[1]) {
     ctx->txt_ccnt = 0;  /* encryption count     */
     ctx->txt_acnt = 0;  /* authentication count */
 
+    /* no header until eax_auth_header() or eax_set_header() */
+    oteax_memset(ctx->hdr_cbc, 0, EAX_BLOCK_SIZE);
+    ctx->hdr_cnt  = 0;
+
     /* compile the OMAC value for the nonce     */
 #   if defined(__ALIGN32__)
     n_pos = 7;
-    aes_encrypt(IO_PTR(ctx->nce_cbc), IO_PTR(ctx->nce_cbc), ctx->aes);
+    BACKEND_ENCRYPT(IO_PTR(ctx->nce_cbc), IO_PTR(ctx->nce_cbc), ctx);
     ctx->nce_cbc[0] ^= iv[0];
     ctx->nce_cbc[1] ^= (iv[1] & NET_ENDIAN32(0xFFFFFF00));
     
@@ -376,7 +611,7 @@ ret_type eax_init_message(const io_t* iv, eax_ctx ctx[1]) {
     i = 0;
     while (i < 7) {
         if (n_pos == EAX_BLOCK_SIZE) {
-            aes_encrypt(IO_PTR(ctx->nce_cbc), IO_PTR(ctx->nce_cbc), ctx->aes);
+            BACKEND_ENCRYPT(IO_PTR(ctx->nce_cbc), IO_PTR(ctx->nce_cbc), ctx);
             n_pos = 0;
         }
 #       if defined(__C2000__)
@@ -447,7 +682,7 @@ ret_type eax_init_message(const io_t* iv, eax_ctx ctx[1]) {
 #   endif
     
     /* compute the OMAC*(nonce) value           */
-    aes_encrypt(IO_PTR(ctx->nce_cbc), IO_PTR(ctx->nce_cbc), ctx->aes);
+    BACKEND_ENCRYPT(IO_PTR(ctx->nce_cbc), IO_PTR(ctx->nce_cbc), ctx);
 
 #   ifdef OTEAX_TEST_INITMSG
     printf("Nonce Stage 4:\n%02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X\n\n", 
@@ -487,7 +722,28 @@ ret_type eax_auth_data(const io_t* data, unsigned long data_len, eax_ctx ctx[1])
         return RETURN_GOOD;
     }
 
-    if (((data - &(IO_PTR(ctx->txt_cbc))[b_pos]) & _BUFMASK) == 0) {
+    if (ctx->be != NULL) {
+        if (b_pos != 0) {
+            BACKEND_SYNC(ctx);
+            cnt = ((_BLKSZ - b_pos) < data_len) ? (_BLKSZ - b_pos) : (uint_32t)data_len;
+            XOR_IO(&IO_PTR(ctx->txt_cbc)[b_pos], data, cnt);
+            b_pos += cnt;
+        }
+        if ((data_len - cnt) >= _BLKSZ) {
+            unsigned long blocks = (data_len - cnt) / _BLKSZ;
+            ctx->be->cbcmac(&data[cnt], blocks, IO_PTR(ctx->txt_cbc), ctx->aes, ctx->be_hdl);
+            cnt += blocks * _BLKSZ;
+        }
+        if (cnt < data_len) {
+            BACKEND_SYNC(ctx);
+        }
+    }
+    /* Where unaligned loads are allowed (see brg_endian.h) the XORs work
+       on any buffer at full width, so there is no need to tell congruent
+       buffers apart
+    */
+#   if !defined(__UNALIGNED_ACCESS__)
+    else if (((data - &(IO_PTR(ctx->txt_cbc))[b_pos]) & _BUFMASK) == 0) {
         if (b_pos != 0) {
             while (cnt < data_len && (b_pos & _BUFMASK)) {
                IO_PTR(ctx->txt_cbc)[b_pos++] ^= data[cnt++];
@@ -498,35 +754,40 @@ ret_type eax_auth_data(const io_t* data, unsigned long data_len, eax_ctx ctx[1])
                 b_pos += _BUFINC;
             }
         }
-        while (cnt + _BLKSZ <= data_len) {
-            aes_encrypt(IO_PTR(ctx->txt_cbc), IO_PTR(ctx->txt_cbc), ctx->aes);
-            xor_block_aligned(ctx->txt_cbc, ctx->txt_cbc, &data[cnt]);
-            cnt += _BLKSZ;
+        if ((data_len - cnt) >= _BLKSZ) {
+            unsigned long blocks = (data_len - cnt) / _BLKSZ;
+            omac_cbc_blocks(&data[cnt], blocks, IO_PTR(ctx->txt_cbc), ctx->aes);
+            cnt += blocks * _BLKSZ;
         }
     }
+#   endif
     ///@note this "else" section will never run when IO is aligned with the
     ///      crypto-compute buffer (32 bit alignment)
 #   if !defined(__ALIGN32__) && !defined(__C2000__)
     else {
         if (b_pos != 0) {
-            while ((cnt < data_len) && (b_pos < _BLKSZ)) {
-               IO_PTR(ctx->txt_cbc)[b_pos++] ^= data[cnt++];
-            }
+            cnt = ((_BLKSZ - b_pos) < data_len) ? (_BLKSZ - b_pos) : (uint_32t)data_len;
+            XOR_IO(&IO_PTR(ctx->txt_cbc)[b_pos], data, cnt);
+            b_pos += cnt;
         }
-        while ((cnt + _BLKSZ) <= data_len) {
-            aes_encrypt(IO_PTR(ctx->txt_cbc), IO_PTR(ctx->txt_cbc), ctx->aes);
-            xor_block(ctx->txt_cbc, ctx->txt_cbc, &data[cnt]);
-            cnt += _BLKSZ;
+        if ((data_len - cnt) >= _BLKSZ) {
+            unsigned long blocks = (data_len - cnt) / _BLKSZ;
+            omac_cbc_blocks(&data[cnt], blocks, IO_PTR(ctx->txt_cbc), ctx->aes);
+            cnt += blocks * _BLKSZ;
         }
     }
 #   endif
 
     while (cnt < data_len) {
+        uint_32t n;
         if ((b_pos == _BLKSZ) || (b_pos == 0)) {
-            aes_encrypt(IO_PTR(ctx->txt_cbc), IO_PTR(ctx->txt_cbc), ctx->aes);
+            BACKEND_ENCRYPT(IO_PTR(ctx->txt_cbc), IO_PTR(ctx->txt_cbc), ctx);
             b_pos = 0;
         }
-        IO_PTR(ctx->txt_cbc)[b_pos++] ^= data[cnt++];
+        n = ((_BLKSZ - b_pos) < (data_len - cnt)) ? (_BLKSZ - b_pos) : (uint_32t)(data_len - cnt);
+        XOR_IO(&IO_PTR(ctx->txt_cbc)[b_pos], &data[cnt], n);
+        cnt   += n;
+        b_pos += n;
     }
 
     ctx->txt_acnt += cnt;
@@ -540,63 +801,12 @@ ret_type eax_auth_data(const io_t* data, unsigned long data_len, eax_ctx ctx[1])
 
 
 
-#if defined(__ALIGN32__)
 ret_type eax_crypt_data(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
-#define _BUFINC  (BUF_INC/4)
-#define _BLKSZ   (BLOCK_SIZE/4)
-#define _BUFMASK ((BUF_INC/4)-1)
-#ifdef OTEAX_TEST_CRYPT
-#   define EAX_CRYPT_DATA_PRINT(...)   sub_testprint(...)
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ   (BLOCK_SIZE/4)
 #else
-#   define EAX_CRYPT_DATA_PRINT(...);
+#   define _BLKSZ   BLOCK_SIZE
 #endif
-
-    uint_32t cnt    = 0;
-    uint_32t b_pos  = ctx->txt_ccnt & _BUFMASK;
-    
-    EAX_CRYPT_DATA_PRINT("eax_crypt_data() data input", data, data_len);
-    
-    if (data_len == 0) {
-        return RETURN_GOOD;
-    }
-
-    while(cnt + _BLKSZ <= data_len) {
-        EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
-        EAX_CRYPT_DATA_PRINT("ctx->enc_ctr", IO_PTR(ctx->enc_ctr), sizeof(ctx->enc_ctr)/sizeof(io_t));
-        
-        aes_encrypt(IO_PTR(ctx->ctr_val), IO_PTR(ctx->enc_ctr), ctx->aes);
-        EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
-        
-        inc_ctr(ctx->ctr_val);
-        EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
-        
-        xor_block_aligned( &data[cnt], &data[cnt], ctx->enc_ctr);
-        cnt += _BLKSZ;
-    }
-
-    while(cnt < data_len) {
-        if(b_pos == _BLKSZ || (b_pos == 0)) {
-            aes_encrypt(IO_PTR(ctx->ctr_val), IO_PTR(ctx->enc_ctr), ctx->aes);
-            b_pos = 0;
-            inc_ctr(ctx->ctr_val);
-        }
-        data[cnt++] ^= IO_PTR(ctx->enc_ctr)[b_pos++];
-    }
-
-    ctx->txt_ccnt += cnt;
-    return RETURN_GOOD;
-
-#undef EAX_CRYPT_DATA_PRINT
-#undef _BUFMASK
-#undef _BLKSZ
-#undef _BUFINC
-}
-
-#else
-ret_type eax_crypt_data(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
-#define _BUFINC  BUF_INC
-#define _BLKSZ   BLOCK_SIZE
-#define _BUFMASK BUF_ADRMASK
 #ifdef OTEAX_TEST_CRYPT
 #   define EAX_CRYPT_DATA_PRINT(HDR, SRC, SIZE)   sub_testprint(HDR, SRC, SIZE)
 #else
@@ -604,7 +814,7 @@ ret_type eax_crypt_data(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
 #endif
 
     uint_32t cnt    = 0;
-    uint_32t b_pos  = ctx->txt_ccnt & _BUFMASK;
+    uint_32t b_pos  = ctx->txt_ccnt & (_BLKSZ-1);
     
     EAX_CRYPT_DATA_PRINT("eax_crypt_data() data input", data, data_len);
     
@@ -612,75 +822,51 @@ ret_type eax_crypt_data(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
         return RETURN_GOOD;
     }
 
-    if(((data - &(IO_PTR(ctx->enc_ctr))[b_pos]) & _BUFMASK) == 0) {
-        if (b_pos != 0) {
-            while (cnt < data_len && (b_pos & _BUFMASK)) {
-                data[cnt++] ^= IO_PTR(ctx->enc_ctr)[b_pos++];
-              }
-
-            while (cnt + _BUFINC <= data_len && b_pos <= _BLKSZ - _BUFINC) {
-                *UINT_PTR(&IO_PTR(data)[cnt]) ^= *UINT_PTR(&IO_PTR(ctx->enc_ctr)[b_pos]);
-                cnt += _BUFINC;
-                b_pos += _BUFINC;
-            }
-        }
-
-        while(cnt + _BLKSZ <= data_len) {
-            EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
-            EAX_CRYPT_DATA_PRINT("ctx->enc_ctr", IO_PTR(ctx->enc_ctr), sizeof(ctx->enc_ctr)/sizeof(io_t));
-            
-            aes_encrypt(IO_PTR(ctx->ctr_val), IO_PTR(ctx->enc_ctr), ctx->aes);
-            EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
-            
-            inc_ctr(ctx->ctr_val);
-            EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
-            
-            xor_block_aligned( &data[cnt], &data[cnt], ctx->enc_ctr);
-            cnt += _BLKSZ;
-        }
+    /* use up the key stream block left over from the last call */
+    if (b_pos != 0) {
+        BACKEND_SYNC(ctx);
+        cnt = ((_BLKSZ - b_pos) < data_len) ? (_BLKSZ - b_pos) : (uint_32t)data_len;
+        XOR_IO(data, &IO_PTR(ctx->enc_ctr)[b_pos], cnt);
+        b_pos += cnt;
     }
-    
-    else {
-        if (b_pos != 0)
-            while(cnt < data_len && b_pos < _BLKSZ)
-                data[cnt++] ^= UI8_PTR(ctx->enc_ctr)[b_pos++];
 
-        while(cnt + _BLKSZ <= data_len) {
-            EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
-            EAX_CRYPT_DATA_PRINT("ctx->enc_ctr", IO_PTR(ctx->enc_ctr), sizeof(ctx->enc_ctr)/sizeof(io_t));
-            
-            aes_encrypt(UI8_PTR(ctx->ctr_val), UI8_PTR(ctx->enc_ctr), ctx->aes);
-            EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
+    /* whole blocks go to the backend, else to the batched CTR engine */
+    if ((data_len - cnt) >= _BLKSZ) {
+        unsigned long blocks = (data_len - cnt) / _BLKSZ;
 
-            inc_ctr(ctx->ctr_val);
-            EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
-            
-            xor_block(data + cnt, data + cnt, ctx->enc_ctr);
-            cnt += _BLKSZ;
+        EAX_CRYPT_DATA_PRINT("ctx->ctr_val", IO_PTR(ctx->ctr_val), sizeof(ctx->ctr_val)/sizeof(io_t));
+        if (ctx->be != NULL) {
+            ctx->be->ctr(&data[cnt], blocks, IO_PTR(ctx->ctr_val), ctx->aes, ctx->be_hdl);
+        }
+        else {
+            aes_ctr_blocks(&data[cnt], &data[cnt], blocks, IO_PTR(ctx->ctr_val), 128, ctx->aes);
         }
+        cnt += blocks * _BLKSZ;
     }
 
-
-    while(cnt < data_len) {
-        if(b_pos == _BLKSZ || (b_pos == 0)) {
-            aes_encrypt(IO_PTR(ctx->ctr_val), IO_PTR(ctx->enc_ctr), ctx->aes);
+    if (cnt < data_len) {
+        BACKEND_SYNC(ctx);
+    }
+    while (cnt < data_len) {
+        uint_32t n;
+        if ((b_pos == _BLKSZ) || (b_pos == 0)) {
+            BACKEND_ENCRYPT(IO_PTR(ctx->ctr_val), IO_PTR(ctx->enc_ctr), ctx);
             b_pos = 0;
             inc_ctr(ctx->ctr_val);
         }
-        data[cnt++] ^= IO_PTR(ctx->enc_ctr)[b_pos++];
+        n = ((_BLKSZ - b_pos) < (data_len - cnt)) ? (_BLKSZ - b_pos) : (uint_32t)(data_len - cnt);
+        XOR_IO(&data[cnt], &IO_PTR(ctx->enc_ctr)[b_pos], n);
+        cnt   += n;
+        b_pos += n;
     }
 
     ctx->txt_ccnt += cnt;
     return RETURN_GOOD;
 
 #undef EAX_CRYPT_DATA_PRINT
-#undef _BUFMASK
 #undef _BLKSZ
-#undef _BUFINC
 }
 
-#endif
-
 
 
 ret_type eax_compute_tag(io_t* tag, eax_ctx ctx[1]) {   
@@ -693,6 +879,8 @@ ret_type eax_compute_tag(io_t* tag, eax_ctx ctx[1]) {
     uint_32t i;
     io_t *p;
 
+    BACKEND_SYNC(ctx);
+
     if ((ctx->txt_acnt != ctx->txt_ccnt) && ctx->txt_ccnt > 0) {
         return RETURN_ERROR;
     }
@@ -712,7 +900,16 @@ ret_type eax_compute_tag(io_t* tag, eax_ctx ctx[1]) {
     }
 
     xor_block_aligned(ctx->txt_cbc, ctx->txt_cbc, p);
-    aes_encrypt(IO_PTR(ctx->txt_cbc), IO_PTR(ctx->txt_cbc), ctx->aes);
+    BACKEND_ENCRYPT(IO_PTR(ctx->txt_cbc), IO_PTR(ctx->txt_cbc), ctx);
+
+    /* complete OMAC* for the header, if there is one in progress.  With no
+       header hdr_cbc is zero, and the tag is the DASH7 form.
+    */
+    if (ctx->hdr_cnt != 0) {
+        omac_final(IO_PTR(ctx->hdr_cbc), ctx->hdr_cnt, IO_PTR(ctx->pad_xvv), ctx->aes);
+        ctx->hdr_cnt = 0;
+    }
+    xor_block_aligned(ctx->txt_cbc, ctx->txt_cbc, ctx->hdr_cbc);
 
     /* compute final authentication tag     */
     ///@todo Aligned XOR should be possible in any case
@@ -738,10 +935,48 @@ ret_type eax_compute_tag(io_t* tag, eax_ctx ctx[1]) {
 
 
 ret_type eax_end(eax_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+#   if defined(AFALG_POSSIBLE)
+    eax_afalg_detach(ctx);
+#   endif
     oteax_memset(ctx, 0, sizeof(eax_ctx));
     return RETURN_GOOD;
 }
 
+ret_type eax_set_backend(const eax_backend* be, void* hdl, eax_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    ctx->be     = be;
+    ctx->be_hdl = hdl;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_sync(eax_ctx ctx[1]) {
+    BACKEND_SYNC(ctx);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_auth_header(const io_t* hdr, unsigned long hdr_len, eax_ctx ctx[1]) {
+    if (ctx->hdr_cnt == 0) {
+        sub_header_start(IO_PTR(ctx->hdr_cbc), &ctx->hdr_cnt);
+    }
+    omac_update(hdr, hdr_len, IO_PTR(ctx->hdr_cbc), &ctx->hdr_cnt, ctx->aes);
+    return RETURN_GOOD;
+}
+
+
+
+ret_type eax_set_header(const eax_hdr_t* hdr, eax_ctx ctx[1]) {
+    oteax_memcpy(ctx->hdr_cbc, hdr->omac, EAX_BLOCK_SIZE);
+    ctx->hdr_cnt = 0;
+    return RETURN_GOOD;
+}
+
+
+
 ret_type eax_encrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
     eax_crypt_data(data, data_len, ctx);
     eax_auth_data(data, data_len, ctx);
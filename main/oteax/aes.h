@@ -63,13 +63,53 @@ extern "C"
 #   define KS_LENGTH    44
 #endif
 
-#define AES_RETURN INT_RETURN
+/* When __OTF_KEYSCHED__ is defined, the encryption context holds   */
+/* only the 128 bit cipher key (4 32-bit words) and aes_encrypt()   */
+/* computes each round key on-the-fly as it runs the rounds.  This  */
+/* trades a little compute per block for a context that is about    */
+/* 1/9 the size, which is useful when many keys must stay resident. */
+/* Only AES-128 is supported in this mode.                          */
+
+#if defined( __OTF_KEYSCHED__ )
+#   if defined( AES_VAR ) || defined( AES_192 ) || defined( AES_256 )
+#       error "__OTF_KEYSCHED__ supports only AES-128 keys"
+#   endif
+#   define EKS_LENGTH   4
+#else
+#   define EKS_LENGTH   KS_LENGTH
+#endif
+
+/* The amalgamated build (OTEAX_AMALGAMATION, see the Makefile) has */
+/* the whole library in one translation unit, and the AES functions  */
+/* are given internal linkage there, as are the internal functions   */
+/* shared between source files, whose prototypes are marked          */
+/* OTEAX_INTERNAL.  The block loops of the modes are marked          */
+/* AES_FLATTEN, so that the compiler inlines the cipher into them;   */
+/* elsewhere a call costs less than the code it saves.               */
+
+#if defined( OTEAX_AMALGAMATION ) && defined( __GNUC__ )
+#   define OTEAX_INTERNAL   static __attribute__((unused))
+#   define AES_FLATTEN      __attribute__((flatten))
+#elif defined( OTEAX_AMALGAMATION )
+#   define OTEAX_INTERNAL   static
+#   define AES_FLATTEN
+#else
+#   define OTEAX_INTERNAL
+#   define AES_FLATTEN
+#endif
+
+#if defined( OTEAX_AMALGAMATION )
+#   define AES_RETURN   OTEAX_INTERNAL int
+#else
+#   define AES_RETURN   INT_RETURN
+#endif
 
 
 
 /* the character array 'inf' in the following structures is used    */
 /* to hold AES context information. This AES code uses cx->inf.b[0] */
-/* to hold the number of rounds multiplied by 16. The other three   */
+/* to hold the number of rounds multiplied by 16, and cx->inf.b[1]  */
+/* to select the kernel (see AES_KERNEL_CT below). The other two    */
 /* elements can be used by code that implements additional modes    */
 #if defined(__C2000__)
     typedef union {   
@@ -89,7 +129,7 @@ extern "C"
 
 
 typedef struct {   
-    uint_32t ks[KS_LENGTH];
+    uint_32t ks[EKS_LENGTH];
     aes_inf inf;
 } aes_encrypt_ctx;
 
@@ -129,6 +169,33 @@ AES_RETURN aes_init(void);
 #   endif
 #endif
 
+/* Constant-time kernel, chosen per key.  A context keyed with      */
+/* aes_encrypt_key128_ct() is marked in INF_B(inf,1), and from then */
+/* on aes_encrypt() runs it through aes_encrypt_ct(), which has no  */
+/* table lookups or branches that depend on the key or the data.    */
+/* It costs several times more per block than the table kernels.    */
+
+#define AES_KERNEL_FAST     0
+#define AES_KERNEL_CT       1
+
+#if defined( AES_ENCRYPT )
+    AES_RETURN aes_encrypt_key128_ct(const io_t *key, aes_encrypt_ctx cx[1]);
+    AES_RETURN aes_encrypt_ct(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]);
+#endif
+
+/* Kernel selection.  Hosted builds (AES_DISPATCH in aesdisp.h) have */
+/* several kernels behind aes_encrypt(), and use the fastest one the */
+/* CPU can run, unless the environment variable OTEAX_KERNEL names   */
+/* another.  aes_kernel_select() does the same at runtime: "vaes",   */
+/* "aesni", "speed", "normal" or "size", or NULL for the automatic   */
+/* choice.  The choice also decides whether the multi-block CTR and  */
+/* CBC-MAC paths use VAES and AES-NI.  Builds without dispatch have  */
+/* only the kernel set by OTEAX_OPTIMIZATION, and accept only its    */
+/* name.                                                             */
+
+OTEAX_INTERNAL const char* aes_kernel_name(void);
+AES_RETURN  aes_kernel_select(const char* name);
+
 
 
 #if defined( AES_DECRYPT )
@@ -204,12 +271,28 @@ AES_RETURN aes_ofb_crypt(cubyte *ibuf, unsigned char *obuf,
                     int len, unsigned char *iv, aes_encrypt_ctx cx[1]);
 */
 
-typedef void cbuf_inc(io_t *cbuf);
+/* CTR mode keeps its own state, so one AES key may drive any number of  */
+/* CTR streams at once.  The counter is the low 32, 64 or 128 bits of   */
+/* the big-endian counter block, and it wraps within that field.  Whole */
+/* blocks are encrypted in batches, with AES-NI where it is available. */
+/* Lengths are in io_t units, like the other calls here.               */
+
+typedef struct {
+    uint_32t    ctr[4];             /* next counter block (as io_t)     */
+    uint_32t    ks[4];              /* current key stream block         */
+    uint_8t     b_pos;              /* key stream units already used    */
+    uint_8t     ctr_bits;           /* counter width: 32, 64 or 128     */
+} aes_ctr_ctx;
 
 #define aes_ctr_encrypt aes_ctr_crypt
 #define aes_ctr_decrypt aes_ctr_crypt
 
-AES_RETURN aes_ctr_crypt(const io_t *ibuf, io_t *obuf, int len, io_t *cbuf, cbuf_inc ctr_inc, aes_encrypt_ctx cx[1]);
+AES_RETURN aes_ctr_init(const io_t *iv, int ctr_bits, aes_ctr_ctx cc[1]);
+
+AES_RETURN aes_ctr_crypt(const io_t *ibuf, io_t *obuf, int len, aes_ctr_ctx cc[1], const aes_encrypt_ctx cx[1]);
+
+/* Stateless bulk form: whole blocks only, ctr is advanced by blocks    */
+AES_RETURN aes_ctr_blocks(const io_t *ibuf, io_t *obuf, unsigned long blocks, io_t *ctr, int ctr_bits, const aes_encrypt_ctx cx[1]);
 
 #endif
 
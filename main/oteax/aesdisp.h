@@ -0,0 +1,66 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/aesdisp.h
+  * @brief      Runtime selection of the aes_encrypt() kernel (INTERNAL)
+  *
+  * Builds for hosted GCC-compatible targets carry several block encryption
+  * kernels: the table code built for each OTEAX_OPTIMIZATION level (size,
+  * normal and speed), and AES-NI where the compiler can emit it.
+  * aes_encrypt() sends each block to the one picked when the library is
+  * loaded, so one binary runs at full speed on any CPU.  Each table kernel is its own
+  * translation unit (aeskern_*.c), which includes aestab.c and aescrypt.c
+  * with AES_KERNEL_TU defined, and keeps its tables private.
+  *
+  * Embedded builds have a single kernel, set by OTEAX_OPTIMIZATION, and no
+  * dispatch.  Define OTEAX_NO_DISPATCH to get the same on a host.
+  ******************************************************************************
+  */
+
+#ifndef _AESDISP_H
+#define _AESDISP_H
+
+#include "aes.h"
+
+#if defined(__GNUC__) && (defined(__unix__) || defined(__APPLE__) || defined(_WIN32)) \
+ && !defined(__C2000__) && !defined(__OPENTAG__) && !defined(OTEAX_NO_DISPATCH)
+#   define AES_DISPATCH
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/* Settles the kernel, and with it the AES-NI setting, if it has not been
+   settled yet.  Dispatch builds do this when the library is loaded.
+*/
+OTEAX_INTERNAL void aes_kernel_resolve(void);
+
+#if defined(AES_DISPATCH)
+
+/* Table kernels, built at OTEAX_OPTIMIZATION -1, 0 and 2 */
+AES_RETURN aes_encrypt_size(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]);
+AES_RETURN aes_encrypt_normal(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]);
+AES_RETURN aes_encrypt_speed(const io_t *in, io_t *out, const aes_encrypt_ctx cx[1]);
+
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
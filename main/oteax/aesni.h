@@ -0,0 +1,153 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/aesni.h
+  * @brief      x86 AES-NI code paths (INTERNAL)
+  *
+  * These are compiled with per-function target attributes, so the library
+  * itself does not need to be built with -maes, and they are only used after
+  * aesni_available() confirms CPU support at runtime.
+  *
+  * The AES-NI routines read and write key schedules in the same layout as
+  * aes_encrypt_key128(), so a context keyed by one may be used by the other.
+  * That layout equals the in-memory round key bytes only on a little-endian
+  * host, hence the conditions on AESNI_POSSIBLE.
+  ******************************************************************************
+  */
+
+#ifndef _AESNI_H
+#define _AESNI_H
+
+#include "aes.h"
+
+/* x86 is little-endian, so __ALIGN32__ word buffers have the same layout in
+   memory as byte buffers, and can use the same code.
+*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+ && !defined(__C2000__) && !defined(__OTF_KEYSCHED__)
+#   define AESNI_POSSIBLE
+/* VAES needs GCC 8 or clang 6 to emit.  It is used only where the CPU and
+   the OS support AVX-512.
+*/
+#   if (defined(__clang__) && (__clang_major__ >= 6)) || (!defined(__clang__) && (__GNUC__ >= 8))
+#       define VAES_POSSIBLE
+#   endif
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#if defined(AESNI_POSSIBLE)
+
+/** @brief Returns non-zero if the running CPU supports AES-NI and SSSE3.
+  * The result of the CPUID probe is cached after the first call.
+  */
+OTEAX_INTERNAL int aesni_supported(void);
+
+/** @brief Returns non-zero if the AES-NI paths are to be used: the CPU
+  * supports them, and they have not been turned off with aesni_enable(0).
+  */
+OTEAX_INTERNAL int aesni_available(void);
+
+/** @brief Returns non-zero if the running CPU and OS support VAES with
+  * AVX-512 (F and BW), so that four blocks go through one instruction.
+  */
+OTEAX_INTERNAL int aesni_vaes_supported(void);
+
+/** @brief Turn the AES-NI paths on or off, for aes_kernel_select()
+  * @param on       (int) 0 to use only the portable code, 1 for AES-NI, 2 for
+  *                 AES-NI with the VAES engine where the CPU has it
+  */
+OTEAX_INTERNAL void aesni_enable(int on);
+
+/** @brief Returns non-zero if the running CPU supports PCLMULQDQ and SSSE3.
+  */
+OTEAX_INTERNAL int aesni_clmul_available(void);
+
+/** @brief Expand four AES-128 keys and derive their OMAC pad values.
+  * @param key  (const io_t*) Four consecutive 16 byte keys
+  * @param cx   (aes_encrypt_ctx*[4]) Output key schedules, one per key
+  * @param pad  (io_t*[4]) Output pads, 32 bytes each: {02}E(0) || {04}E(0)
+  *
+  * The four key expansions, the four E(0) encryptions and the GF(2^128)
+  * doublings are interleaved so that the AES unit pipeline stays full.
+  */
+OTEAX_INTERNAL void aesni_omac_key128_x4(const io_t* key, aes_encrypt_ctx* const cx[4], io_t* const pad[4]);
+
+/** @brief CTR mode over whole blocks, eight blocks in flight at a time, or
+  * with VAES, 32 blocks in eight registers
+  * @param in       (const io_t*) Input, blocks*16 bytes
+  * @param out      (io_t*) Output, may be the same as in
+  * @param blocks   (unsigned long) Number of 16 byte blocks
+  * @param ctr      (io_t*) Big-endian counter block, advanced by blocks
+  * @param ctr_bits (int) Width of the counter field: 32, 64 or 128
+  * @param cx       (aes_encrypt_ctx*) AES-128 key schedule
+  */
+OTEAX_INTERNAL void aesni_ctr_blocks(const io_t* in, io_t* out, unsigned long blocks, io_t* ctr, int ctr_bits, const aes_encrypt_ctx cx[1]);
+
+/** @brief Single block encryption, as aes_encrypt()
+  * @param in       (const io_t*) 16 byte input block
+  * @param out      (io_t*) 16 byte output block, may be the same as in
+  * @param cx       (aes_encrypt_ctx*) AES-128 key schedule
+  * @retval         (AES_RETURN) 0 on success, or 1 if cx is not AES-128
+  */
+AES_RETURN aesni_encrypt(const io_t* in, io_t* out, const aes_encrypt_ctx cx[1]);
+
+/** @brief Encrypt two independent blocks in place, with the rounds interleaved
+  * @param a        (io_t*) First 16 byte block
+  * @param b        (io_t*) Second 16 byte block
+  * @param cx       (aes_encrypt_ctx*) AES-128 key schedule
+  */
+OTEAX_INTERNAL void aesni_encrypt_x2(io_t* a, io_t* b, const aes_encrypt_ctx cx[1]);
+
+/** @brief Lazy CBC-MAC, cbc = E(cbc) ^ data, on up to 32 chains at once
+  * @param data     (const io_t*[]) Input per chain, blocks*16 bytes each
+  * @param cbc      (io_t*[]) 16 byte chaining state per chain, in place
+  * @param n        (unsigned int) Number of chains, 1 to 32
+  * @param blocks   (unsigned long) Number of blocks on each chain
+  * @param cx       (aes_encrypt_ctx*) AES-128 key schedule
+  *
+  * With AES-NI alone the chains are run eight at a time.  With VAES, four
+  * chains share a register, and all of them are in flight together.
+  */
+OTEAX_INTERNAL void aesni_cbcmac_xn(const io_t* const data[], io_t* const cbc[], unsigned int n,
+                     unsigned long blocks, const aes_encrypt_ctx cx[1]);
+
+/** @brief Precompute H, H^2, H^3, H^4 for aesni_ghash_blocks()
+  * @param h        (const io_t*) GHASH key H = E(0), 16 bytes
+  * @param hpow     (io_t*) Output, 64 bytes, in the internal format
+  */
+OTEAX_INTERNAL void aesni_ghash_init(const io_t* h, io_t* hpow);
+
+/** @brief GHASH over whole blocks: y = (y ^ data[i]) * H
+  * @param data     (const io_t*) Input, blocks*16 bytes
+  * @param blocks   (unsigned long) Number of 16 byte blocks
+  * @param y        (io_t*) 16 byte GHASH state, in place
+  * @param hpow     (const io_t*) Table from aesni_ghash_init()
+  *
+  * Four blocks are multiplied by H^4..H and summed before a single reduction.
+  */
+OTEAX_INTERNAL void aesni_ghash_blocks(const io_t* data, unsigned long blocks, io_t* y, const io_t* hpow);
+
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -92,6 +92,7 @@ Issue Date: 20/12/2007
 #else
 #   include "aes.h"
 #endif
+#include "aesdisp.h"
 
 /*  PLATFORM SPECIFIC INCLUDES */
 
@@ -533,7 +534,16 @@ Issue Date: 20/12/2007
 /// = (ENCRYPTION_IN_C | ENC_KEYING_IN_C | DECRYPTION_IN_C | DEC_KEYING_IN_C )
 /// = (1 | 4 | 2 | 8)
 /// = 15
-#define FUNCS_IN_C  ( EFUNCS_IN_C | DFUNCS_IN_C )
+///@note With AES_DISPATCH, block encryption comes from the aeskern_*.c
+///      units, which build it (and the key schedule tables that on-the-fly
+///      keying needs) and nothing else.
+#if defined( AES_KERNEL_TU )
+#   define FUNCS_IN_C  ( EFUNCS_IN_C )
+#elif defined( AES_DISPATCH )
+#   define FUNCS_IN_C  ( (EFUNCS_IN_C & ~ENCRYPTION_IN_C) | DFUNCS_IN_C )
+#else
+#   define FUNCS_IN_C  ( EFUNCS_IN_C | DFUNCS_IN_C )
+#endif
 
 /* END OF CONFIGURATION OPTIONS */
 
@@ -620,6 +630,13 @@ Issue Date: 20/12/2007
 #   define word_in(x,c)    x[c]
 #   define word_out(x,c,v) { x[c] = v; }
 
+#elif defined( __UNALIGNED_ACCESS__ ) && !defined( _MSC_VER ) && ( ALGORITHM_BYTE_ORDER == PLATFORM_BYTE_ORDER )
+#   include <string.h>
+static inline uint_32t aes_ld32(const void* p) { uint_32t v; memcpy(&v, p, 4); return v; }
+static inline void aes_st32(void* p, uint_32t v) { memcpy(p, &v, 4); }
+#   define word_in(x,c)    aes_ld32((const uint_8t*)(x)+4*(c))
+#   define word_out(x,c,v) aes_st32((uint_8t*)(x)+4*(c), v)
+
 #elif defined( SAFE_IO )
 #   define word_in(x,c)    bytes2word(((const uint_8t*)(x)+4*c)[0], ((const uint_8t*)(x)+4*c)[1], \
                                    ((const uint_8t*)(x)+4*c)[2], ((const uint_8t*)(x)+4*c)[3])
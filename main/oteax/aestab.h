@@ -80,7 +80,9 @@ extern "C" {
 #  define CONST
 #endif
 
-#if defined(DO_TABLES)
+#if defined(AES_KERNEL_TU) || defined(OTEAX_AMALGAMATION)
+#  define EXTERN static
+#elif defined(DO_TABLES)
 #  define EXTERN
 #else
 #  define EXTERN extern
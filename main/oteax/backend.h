@@ -0,0 +1,124 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/backend.h
+  * @brief      Cipher backend interface for EAX
+  *
+  * A backend supplies the AES operations that EAX is built from: single
+  * block, multi-block ECB, a CTR run and a CBC-MAC run.  A backend may be
+  * attached to an eax_ctx with eax_set_backend(), in which case the bulk
+  * (whole block) work of eax_crypt_data() and eax_auth_data() is handed to
+  * it, and the odd blocks at the start and end of messages go through its
+  * block operation.  Contexts with no backend use the built-in code.
+  *
+  * The ecb, ctr and cbcmac operations may be asynchronous: they may return
+  * before the work is done, as long as the backend completes work in the
+  * order it was submitted.  The sync operation waits for everything that is
+  * outstanding.  The block operation is always synchronous.
+  *
+  * This file is included by oteax.h, which should be included instead.
+  ******************************************************************************
+  */
+
+#ifndef _BACKEND_H
+#define _BACKEND_H
+
+#include "aes.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+
+/** All lengths are in AES blocks.  "hdl" is the handle given to
+  * eax_set_backend(), for backends that need per-instance state.
+  *
+  * block   : out = E(in)
+  * ecb     : out[i] = E(in[i]), for i in 0..blocks-1
+  * ctr     : data[i] ^= E(ctr); ctr++, with ctr a 128 bit big-endian counter
+  *           that is left pointing at the next unused value.
+  * cbcmac  : cbc = E(cbc); cbc ^= data[i].  This is the "lazy" form that EAX
+  *           keeps in txt_cbc, where the last XOR is not yet encrypted.
+  * sync    : wait until all submitted operations are complete.  May be NULL
+  *           for backends that are always synchronous.
+  */
+typedef struct {
+    const char* name;
+    ret_type    (*block)(const io_t* in, io_t* out, const aes_encrypt_ctx cx[1], void* hdl);
+    ret_type    (*ecb)(const io_t* in, io_t* out, unsigned long blocks, const aes_encrypt_ctx cx[1], void* hdl);
+    ret_type    (*ctr)(io_t* data, unsigned long blocks, io_t* ctr, const aes_encrypt_ctx cx[1], void* hdl);
+    ret_type    (*cbcmac)(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx cx[1], void* hdl);
+    ret_type    (*sync)(void* hdl);
+} eax_backend;
+
+
+/** Software backend.  It uses the same AES code as the built-in path, so it
+  * is mainly a reference for writing other backends.
+  */
+extern const eax_backend eax_backend_sw;
+
+
+
+/** Single block encryption for a context with aes, be and be_hdl members
+  * (eax_ctx, gcm_ctx), through its backend if it has one.  Any CPU access
+  * to state that a backend might be working on must be preceded by
+  * BACKEND_SYNC().
+  */
+#define BACKEND_ENCRYPT(IN, OUT, CTX)   \
+    (((CTX)->be == NULL) ? aes_encrypt(IN, OUT, (CTX)->aes) : (CTX)->be->block(IN, OUT, (CTX)->aes, (CTX)->be_hdl))
+
+#define BACKEND_SYNC(CTX)   \
+    do { if (((CTX)->be != NULL) && ((CTX)->be->sync != NULL)) (CTX)->be->sync((CTX)->be_hdl); } while (0)
+
+
+
+/** Simulated co-processor backend, for hosts with POSIX threads.
+  *
+  * Each handle owns a worker thread that takes operations from a queue, waits
+  * for the configured latency, then performs them in software.  The wait is
+  * a sleep, so the calling thread may use the CPU while the "co-processor" is
+  * busy, which is what a DMA-driven AES peripheral would allow.
+  */
+#if (defined(__unix__) || defined(__APPLE__)) \
+ && !defined(__C2000__) && !defined(__OPENTAG__)
+#   define COPROC_POSSIBLE
+#endif
+
+#if defined(COPROC_POSSIBLE)
+
+extern const eax_backend eax_backend_coproc;
+
+/** @brief Start a simulated co-processor
+  * @param job_ns   (unsigned long) Fixed latency per operation, nanoseconds
+  * @param block_ns (unsigned long) Additional latency per AES block
+  * @retval         (void*) Handle for eax_set_backend(), or NULL on failure
+  */
+void* eax_coproc_open(unsigned long job_ns, unsigned long block_ns);
+
+/** @brief Wait for a simulated co-processor to go idle, then stop it
+  * @param hdl      (void*) Handle from eax_coproc_open()
+  */
+void eax_coproc_close(void* hdl);
+
+#endif
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -28,7 +28,7 @@ Issue Date: 20/12/2007
 
 ///@note [JP Norair 25-Aug-2014] THis is a hack for STM32L CM3 on OpenTag
 #if (defined(__opentag__) || defined (__OPENTAG__))
-#   include <platform/config.h>
+#   include <platform/config.h>
 
 #elif defined( __sun )
 #   include <sys/isa_defs.h>
@@ -133,4 +133,14 @@ Issue Date: 20/12/2007
 
 #endif
 
+/*  Targets where 32 and 64 bit loads and stores need not be aligned.  Other
+    targets that allow it (e.g. Cortex-M3/M4) can be built with
+    __UNALIGNED_ACCESS__ defined.  Word I/O builds never need it.
+*/
+#if !defined( __UNALIGNED_ACCESS__ ) && !defined( __ALIGN32__ ) && !defined( __C2000__ ) && \
+    ( defined( __i386__ ) || defined( __x86_64__ ) || defined( _M_IX86 ) || defined( _M_X64 ) || \
+      defined( __aarch64__ ) || defined( __ARM_FEATURE_UNALIGNED ) )
+#  define __UNALIGNED_ACCESS__
+#endif
+
 #endif
@@ -280,16 +280,70 @@ mh_decl uint_64t bswap_64(uint_64t x) {
 #define f_copy(n,p,q)     p[n] = q[n]
 #define f_xor(n,r,p,q,c)  r[n] = c(p[n] ^ q[n])
 
+/*  Where the target has 128 bit vectors (SSE2 on x86, NEON on ARM) the
+    block operations use them, with unaligned loads and stores, so the
+    "aligned" versions are the same as the others.  Byte builds with 64 bit
+    words, or with __UNALIGNED_ACCESS__ (see brg_endian.h), otherwise go
+    through memcpy(), which compilers turn into plain unaligned loads.
+*/
+#if defined(__SSE2__) && !defined(__C2000__)
+#   include <emmintrin.h>
+#   define MH_SSE2
+#   define mh_load128(p)        _mm_loadu_si128((const __m128i*)(p))
+#   define mh_store128(p, v)    _mm_storeu_si128((__m128i*)(p), v)
+#   define mh_xor128(a, b)      _mm_xor_si128(a, b)
+#elif defined(__ARM_NEON) && !defined(__C2000__)
+#   include <arm_neon.h>
+#   define MH_NEON
+#   define mh_load128(p)        vld1q_u8((const uint8_t*)(p))
+#   define mh_store128(p, v)    vst1q_u8((uint8_t*)(p), v)
+#   define mh_xor128(a, b)      veorq_u8(a, b)
+#endif
+
+#if defined(mh_load128)
+#   define MH_SIMD128
+#endif
+
+#if defined(__UNALIGNED_ACCESS__)
+mh_decl uint_32t mh_load32(const void* p) {
+    uint_32t v;
+    oteax_memcpy(&v, p, 4);
+    return v;
+}
+
+mh_decl void mh_store32(void* p, uint_32t v) {
+    oteax_memcpy(p, &v, 4);
+}
+#endif
+
+#if UINT_BITS == 64
+mh_decl uint_64t mh_load64(const void* p) {
+    uint_64t v;
+    oteax_memcpy(&v, p, 8);
+    return v;
+}
+
+mh_decl void mh_store64(void* p, uint_64t v) {
+    oteax_memcpy(p, &v, 8);
+}
+#endif
+
 
 
 mh_decl void copy_block(void* p, const void* q) {
+#if defined(MH_SIMD128)
+    mh_store128(p, mh_load128(q));
+#else
     oteax_memcpy(p, q, 16);
+#endif
 }
 
 
 
 mh_decl void copy_block_aligned(void *p, const void *q) {
-#if UINT_BITS == 8
+#if defined(MH_SIMD128)
+    mh_store128(p, mh_load128(q));
+#elif UINT_BITS == 8
     oteax_memcpy(p, q, 16);
 #elif UINT_BITS == 32
     rep2_u4(f_copy,UINT_PTR(p),UINT_PTR(q));
@@ -302,14 +356,23 @@ mh_decl void copy_block_aligned(void *p, const void *q) {
 
 
 mh_decl void xor_block(void *r, const void* p, const void* q) {
+#if defined(MH_SIMD128)
+    mh_store128(r, mh_xor128(mh_load128(p), mh_load128(q)));
+#elif UINT_BITS == 64
+    mh_store64(UI8_PTR(r),   mh_load64(UI8_PTR(p))   ^ mh_load64(UI8_PTR(q)));
+    mh_store64(UI8_PTR(r)+8, mh_load64(UI8_PTR(p)+8) ^ mh_load64(UI8_PTR(q)+8));
+#else
     rep3_u16(f_xor, UI8_PTR(r), UI8_PTR(p), UI8_PTR(q), UI8_VAL);
+#endif
 }
 
 
 
 
 mh_decl void xor_block_aligned(void *r, const void *p, const void *q) {
-#if UINT_BITS == 8
+#if defined(MH_SIMD128)
+    mh_store128(r, mh_xor128(mh_load128(p), mh_load128(q)));
+#elif UINT_BITS == 8
     rep3_u16(f_xor, UINT_PTR(r), UINT_PTR(p), UINT_PTR(q), UINT_VAL);
 #elif UINT_BITS == 32
     rep3_u4(f_xor, UINT_PTR(r), UINT_PTR(p), UINT_PTR(q), UINT_VAL);
@@ -321,6 +384,63 @@ mh_decl void xor_block_aligned(void *r, const void *p, const void *q) {
 
 
 
+/* Tag comparison, in constant time: bit i of the result is set when
+   a[i] == b[i], for i < n <= 32.  Four tags at a time where there is SIMD.
+*/
+mh_decl uint_32t tag_mask(const uint_32t* a, const uint_32t* b, unsigned int n) {
+    uint_32t        mask    = 0;
+    unsigned int    i       = 0;
+
+#if defined(MH_SSE2)
+    for (; (i+4) <= n; i+=4) {
+        __m128i eq = _mm_cmpeq_epi32(mh_load128(&a[i]), mh_load128(&b[i]));
+        mask |= (uint_32t)_mm_movemask_ps(_mm_castsi128_ps(eq)) << i;
+    }
+#elif defined(MH_NEON) && defined(__aarch64__)
+    static const uint32_t lane_bit[4] = { 1, 2, 4, 8 };
+    for (; (i+4) <= n; i+=4) {
+        uint32x4_t eq = vceqq_u32(vld1q_u32(&a[i]), vld1q_u32(&b[i]));
+        mask |= vaddvq_u32(vandq_u32(eq, vld1q_u32(lane_bit))) << i;
+    }
+#endif
+    for (; i<n; i++) {
+        uint_32t d = a[i] ^ b[i];
+        mask |= (((d | (0u - d)) >> 31) ^ 1) << i;
+    }
+    return mask;
+}
+
+
+
+
+/* r = p ^ q over n bytes, with no alignment required of any of them */
+mh_decl void xor_bytes(void* r, const void* p, const void* q, unsigned long n) {
+    uint_8t* rr = (uint_8t*)r;
+    const uint_8t* pp = (const uint_8t*)p;
+    const uint_8t* qq = (const uint_8t*)q;
+
+#if defined(MH_SIMD128)
+    for (; n >= 16; n -= 16, rr += 16, pp += 16, qq += 16) {
+        mh_store128(rr, mh_xor128(mh_load128(pp), mh_load128(qq)));
+    }
+#endif
+#if UINT_BITS == 64
+    for (; n >= 8; n -= 8, rr += 8, pp += 8, qq += 8) {
+        mh_store64(rr, mh_load64(pp) ^ mh_load64(qq));
+    }
+#elif defined(__UNALIGNED_ACCESS__)
+    for (; n >= 4; n -= 4, rr += 4, pp += 4, qq += 4) {
+        mh_store32(rr, mh_load32(pp) ^ mh_load32(qq));
+    }
+#endif
+    while (n-- != 0) {
+        *rr++ = *pp++ ^ *qq++;
+    }
+}
+
+
+
+
 /* byte swap within 32-bit words in a 16 byte block; don't move 32-bit words */
 mh_decl void bswap32_block(void *d, const void* s) {
 #if UINT_BITS == 8
@@ -416,6 +536,69 @@ mh_decl void bswap128_block(void *d, const void* s) {
 
 
 
+/* big-endian increment and decrement of a 16 byte counter block */
+
+///@note In __ALIGN32__ builds the counter is four words that hold the
+///      big-endian bytes.  inc_ctr() steps the last byte in place, where
+///      NET_ENDIAN32(1) is 1 in that byte read as a host word, and only a
+///      carry out of it (1 in 256) goes through the byte-swapped add.
+#if defined(__ALIGN32__)
+#   define inc_ctr(x)  \
+    do {    \
+        if ((x[3] & NET_ENDIAN32(0xFF)) != NET_ENDIAN32(0xFF)) {    \
+            x[3] += NET_ENDIAN32(1);    \
+        }   \
+        else {  \
+            int zz; \
+            for (zz=3; zz>=0; zz--) {   \
+                x[zz] = NET_ENDIAN32((NET_ENDIAN32(x[zz]) + 1));    \
+                if (x[zz] != 0) \
+                    break;   \
+            }   \
+        }   \
+    } while (0)
+
+#   define dec_ctr(x)  \
+    do {    \
+        int zz; \
+        for (zz=3; zz>=0; zz--) {   \
+            if (x[zz] != 0) \
+                break;   \
+            x[zz] = NET_ENDIAN32((NET_ENDIAN32(x[zz]) - 1));    \
+        }   \
+    } while (0)
+        
+#elif defined(__C2000__)
+#   define inc_ctr(x)   do {    \
+                            int i; \
+                            for (i=16-1; i>=0; i--) {      \
+                                __byte((int*)x, i) += 1;            \
+                                if ( __byte((int*)x, i) == 0 ) {    \
+                                    break;                          \
+                                }                                   \
+                            }   \
+                        } while (0)
+
+#   define dec_ctr(x)   do {    \
+                            int i;  \
+                            for (i=16-1; i>=0; i--) {      \
+                                if ( __byte((int*)x, i) == 0 ) {    \
+                                    break;                          \
+                                }                                   \
+                                __byte((int*)x, i) -= 1;            \
+                            }   \
+                        } while (0)
+                        
+#else
+#   define inc_ctr(x)  \
+        {   int i = 16; while(i-- > 0 && !++(UI8_PTR(x)[i])) ; }
+#   define dec_ctr(x)  \
+        {   int i = 16; while(i-- > 0 && !(UI8_PTR(x)[i])--) ; }
+#endif
+
+
+
+
 #if defined(__cplusplus)
 }
 #endif
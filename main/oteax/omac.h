@@ -0,0 +1,109 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/omac.h
+  * @brief      OMAC (CMAC) building blocks shared by EAX and CMAC (INTERNAL)
+  ******************************************************************************
+  */
+
+#ifndef _OMAC_H
+#define _OMAC_H
+
+#include "../oteax.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/** @brief Key AES and derive the OMAC pads, {02}E(0) || {04}E(0)
+  * @param key      (const void*) AES-128 key
+  * @param kernel   (int) EAX_KERNEL_FAST or EAX_KERNEL_CT
+  * @param pad_xvv  (io_t*) 32 byte output, as in eax_ctx.pad_xvv
+  * @param aes      (aes_encrypt_ctx*) Key schedule output
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * Defined in oteax.c, where it is the body of eax_init_and_key().
+  */
+OTEAX_INTERNAL ret_type omac_init_and_key(const void* key, int kernel, io_t* pad_xvv, aes_encrypt_ctx aes[1]);
+
+
+/** @brief Lazy CBC-MAC over whole blocks: cbc = E(cbc) ^ data[i]
+  * @param data     (const io_t*) Input blocks
+  * @param blocks   (unsigned long) Number of blocks
+  * @param cbc      (io_t*) Chaining state, in place
+  * @param aes      (aes_encrypt_ctx*) Key schedule
+  */
+OTEAX_INTERNAL void omac_cbc_blocks(const io_t* data, unsigned long blocks, io_t* cbc, const aes_encrypt_ctx aes[1]);
+
+
+/** @brief Lazy CBC-MAC run on up to OMAC_LANES independent chains at once
+  * @param data     (const io_t*[]) Input blocks per chain, each advanced
+  *                 by one block per step
+  * @param cbc      (io_t*[]) Chaining state per chain, in place
+  * @param n        (unsigned int) Number of chains, 1 to OMAC_LANES
+  * @param blocks   (unsigned long) Number of blocks to run on every chain
+  * @param aes      (aes_encrypt_ctx*) Key schedule, shared by all chains
+  *
+  * CBC-MAC is serial within one chain, so the only way to keep a pipelined
+  * AES unit busy is to interleave several chains.
+  */
+#define OMAC_LANES  32
+OTEAX_INTERNAL void omac_cbc_blocks_xn(const io_t* const data[], io_t* const cbc[], unsigned int n,
+                        unsigned long blocks, const aes_encrypt_ctx aes[1]);
+
+
+/** @brief Add data to an OMAC in progress, in the lazy form
+  * @param data     (const io_t*) Input
+  * @param data_len (unsigned long) Length of data in io_t units
+  * @param cbc      (io_t*) Chaining state, in place
+  * @param cnt      (uint_32t*) io_t units so far, updated
+  * @param aes      (aes_encrypt_ctx*) Key schedule
+  *
+  * Starting with cbc = 0 and cnt = 0 gives CMAC.  EAX's OMAC^t starts with
+  * cbc = [t] and cnt = one block, as if the tweak block had been added.
+  */
+OTEAX_INTERNAL void omac_update(const io_t* data, unsigned long data_len, io_t* cbc, uint_32t* cnt, const aes_encrypt_ctx aes[1]);
+
+
+/** @brief Pad, mask and encrypt the last block of an omac_update() run
+  * @param cbc      (io_t*) Chaining state, replaced by the OMAC value
+  * @param cnt      (uint_32t) io_t units added in total
+  * @param pad_xvv  (const io_t*) {02}E(0) || {04}E(0)
+  * @param aes      (aes_encrypt_ctx*) Key schedule
+  */
+OTEAX_INTERNAL void omac_final(io_t* cbc, uint_32t cnt, const io_t* pad_xvv, const aes_encrypt_ctx aes[1]);
+
+
+/** @brief Complete OMAC of a message, with the final block masks given
+  * @param data     (const io_t*) Message
+  * @param len      (unsigned long) Length of data in io_t units
+  * @param mac      (io_t*) 16 byte output
+  * @param k_full   (const io_t*) Mask for a whole final block
+  * @param k_part   (const io_t*) Mask for a padded final block
+  * @param aes      (aes_encrypt_ctx*) Key schedule
+  *
+  * With k_full = {02}E(0) and k_part = {04}E(0) this is CMAC.  EAX' uses the
+  * same with the masks swapped, as its domain separation for the ciphertext.
+  */
+OTEAX_INTERNAL void omac_message(const io_t* data, unsigned long len, io_t* mac,
+                  const io_t* k_full, const io_t* k_part, const aes_encrypt_ctx aes[1]);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -0,0 +1,68 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/smallframe.h
+  * @brief      Unrolled EAX kernels for short frames (INTERNAL)
+  ******************************************************************************
+  */
+
+#ifndef _SMALLFRAME_H
+#define _SMALLFRAME_H
+
+#include "../oteax.h"
+
+/* The kernels trade code size for speed, so size-optimized builds leave
+   them out and use the general eax_encrypt() and eax_decrypt() loops.
+*/
+#if !defined(OTEAX_OPTIMIZATION) || (OTEAX_OPTIMIZATION >= 0)
+#   define SMALLFRAME_POSSIBLE
+#endif
+
+/* Longest frame handled by the kernels, in 16 byte blocks */
+#define SMALLFRAME_BLOCKS   16
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#if defined(SMALLFRAME_POSSIBLE)
+
+/** @brief Encrypt and authenticate a whole short frame
+  * @param data     (io_t*) Frame text, in place
+  * @param data_len (unsigned long) Length of data in io_t units, 1 to
+  *                 SMALLFRAME_BLOCKS blocks
+  * @param ctx      (eax_ctx*) Context, just after eax_init_message()
+  * @retval         (ret_type) returns 0 on success.
+  *
+  * Leaves ctx as eax_encrypt() would, ready for eax_compute_tag().  There is
+  * one fully unrolled kernel per block count, picked from a table, so the
+  * only loop left is over the final partial block.  The context must not
+  * have a backend attached.
+  */
+OTEAX_INTERNAL ret_type smallframe_encrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]);
+
+/** @brief Decrypt and authenticate a whole short frame, as smallframe_encrypt()
+  */
+OTEAX_INTERNAL ret_type smallframe_decrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]);
+
+#endif
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
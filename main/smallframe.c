@@ -0,0 +1,225 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/smallframe.c
+  * @brief      Unrolled EAX kernels for short frames
+  *
+  * Most DASH7 frames are 16 to 64 bytes, and at that size the alignment
+  * checks, position bookkeeping and tail loops of eax_auth_data() and
+  * eax_crypt_data() cost about as much as the AES itself.  Here a frame is
+  * known to start on a block boundary and to be the whole message, so each
+  * block is one CTR step and one CBC-MAC step with nothing else to decide.
+  * The two AES calls in a step are independent, and run interleaved where
+  * AES-NI is available.
+  ******************************************************************************
+  */
+
+#include "oteax.h"
+#include "oteax/mode_hdr.h"
+#include "oteax/aesni.h"
+#include "oteax/smallframe.h"
+
+#if defined(SMALLFRAME_POSSIBLE)
+
+#if defined(__C2000__) || defined(__ALIGN32__)
+#   define _BLKSZ           (AES_BLOCK_SIZE/4)
+#   define _XOR(R, P, Q)    xor_block_aligned(R, P, Q)
+#else
+#   define _BLKSZ           AES_BLOCK_SIZE
+#   define _XOR(R, P, Q)    xor_block(R, P, Q)
+#endif
+
+typedef void (*smallframe_fn)(io_t* data, unsigned int last, eax_ctx* ctx);
+
+
+
+/* ks = E(ctr), cbc = E(cbc) */
+mh_decl void sub_aes_x2(io_t* ks, io_t* cbc, const aes_encrypt_ctx aes[1]) {
+#   if defined(AESNI_POSSIBLE)
+    if (aesni_available()) {
+        aesni_encrypt_x2(ks, cbc, aes);
+        return;
+    }
+#   endif
+    aes_encrypt(ks, ks, aes);
+    aes_encrypt(cbc, cbc, aes);
+}
+
+
+
+mh_decl void sub_enc_block(io_t* d, eax_ctx* ctx) {
+    eax_buf_t ks;
+
+    oteax_memcpy(ks, ctx->ctr_val, AES_BLOCK_SIZE);
+    inc_ctr(ctx->ctr_val);
+    sub_aes_x2(IO_PTR(ks), IO_PTR(ctx->txt_cbc), ctx->aes);
+    _XOR(d, d, ks);
+    _XOR(ctx->txt_cbc, ctx->txt_cbc, d);
+}
+
+
+
+mh_decl void sub_dec_block(io_t* d, eax_ctx* ctx) {
+    eax_buf_t ks;
+
+    oteax_memcpy(ks, ctx->ctr_val, AES_BLOCK_SIZE);
+    inc_ctr(ctx->ctr_val);
+    sub_aes_x2(IO_PTR(ks), IO_PTR(ctx->txt_cbc), ctx->aes);
+    _XOR(ctx->txt_cbc, ctx->txt_cbc, d);
+    _XOR(d, d, ks);
+}
+
+
+
+/* The final block, "last" io_t units long (1 to _BLKSZ).  The key stream is
+   left in enc_ctr, as eax_crypt_data() would leave it.
+*/
+static void sub_enc_last(io_t* d, unsigned int last, eax_ctx* ctx) {
+    unsigned int i;
+
+    oteax_memcpy(ctx->enc_ctr, ctx->ctr_val, AES_BLOCK_SIZE);
+    inc_ctr(ctx->ctr_val);
+    sub_aes_x2(IO_PTR(ctx->enc_ctr), IO_PTR(ctx->txt_cbc), ctx->aes);
+    if (last == _BLKSZ) {
+        _XOR(d, d, ctx->enc_ctr);
+        _XOR(ctx->txt_cbc, ctx->txt_cbc, d);
+        return;
+    }
+    for (i=0; i<last; i++) {
+        d[i] ^= IO_PTR(ctx->enc_ctr)[i];
+        IO_PTR(ctx->txt_cbc)[i] ^= d[i];
+    }
+}
+
+
+
+static void sub_dec_last(io_t* d, unsigned int last, eax_ctx* ctx) {
+    unsigned int i;
+
+    oteax_memcpy(ctx->enc_ctr, ctx->ctr_val, AES_BLOCK_SIZE);
+    inc_ctr(ctx->ctr_val);
+    sub_aes_x2(IO_PTR(ctx->enc_ctr), IO_PTR(ctx->txt_cbc), ctx->aes);
+    if (last == _BLKSZ) {
+        _XOR(ctx->txt_cbc, ctx->txt_cbc, d);
+        _XOR(d, d, ctx->enc_ctr);
+        return;
+    }
+    for (i=0; i<last; i++) {
+        IO_PTR(ctx->txt_cbc)[i] ^= d[i];
+        d[i] ^= IO_PTR(ctx->enc_ctr)[i];
+    }
+}
+
+
+
+/* One kernel per block count: N-1 whole blocks, unrolled, then the final
+   block.  _REPn(f) expands to f(0); ... f(n-1);
+*/
+#define _REP0(f)
+#define _REP1(f)    _REP0(f)  f(0);
+#define _REP2(f)    _REP1(f)  f(1);
+#define _REP3(f)    _REP2(f)  f(2);
+#define _REP4(f)    _REP3(f)  f(3);
+#define _REP5(f)    _REP4(f)  f(4);
+#define _REP6(f)    _REP5(f)  f(5);
+#define _REP7(f)    _REP6(f)  f(6);
+#define _REP8(f)    _REP7(f)  f(7);
+#define _REP9(f)    _REP8(f)  f(8);
+#define _REP10(f)   _REP9(f)  f(9);
+#define _REP11(f)   _REP10(f) f(10);
+#define _REP12(f)   _REP11(f) f(11);
+#define _REP13(f)   _REP12(f) f(12);
+#define _REP14(f)   _REP13(f) f(13);
+#define _REP15(f)   _REP14(f) f(14);
+
+#define _ENC_STEP(I)    sub_enc_block(&data[(I)*_BLKSZ], ctx)
+#define _DEC_STEP(I)    sub_dec_block(&data[(I)*_BLKSZ], ctx)
+
+#define _KERNELS(N, REP)                                                        \
+static void sub_enc_##N(io_t* data, unsigned int last, eax_ctx* ctx) {          \
+    REP(_ENC_STEP)                                                              \
+    sub_enc_last(&data[((N)-1)*_BLKSZ], last, ctx);                             \
+}                                                                               \
+static void sub_dec_##N(io_t* data, unsigned int last, eax_ctx* ctx) {          \
+    REP(_DEC_STEP)                                                              \
+    sub_dec_last(&data[((N)-1)*_BLKSZ], last, ctx);                             \
+}
+
+_KERNELS(1,  _REP0)
+_KERNELS(2,  _REP1)
+_KERNELS(3,  _REP2)
+_KERNELS(4,  _REP3)
+_KERNELS(5,  _REP4)
+_KERNELS(6,  _REP5)
+_KERNELS(7,  _REP6)
+_KERNELS(8,  _REP7)
+_KERNELS(9,  _REP8)
+_KERNELS(10, _REP9)
+_KERNELS(11, _REP10)
+_KERNELS(12, _REP11)
+_KERNELS(13, _REP12)
+_KERNELS(14, _REP13)
+_KERNELS(15, _REP14)
+_KERNELS(16, _REP15)
+
+static const smallframe_fn enc_kernel[SMALLFRAME_BLOCKS] = {
+    &sub_enc_1,  &sub_enc_2,  &sub_enc_3,  &sub_enc_4,
+    &sub_enc_5,  &sub_enc_6,  &sub_enc_7,  &sub_enc_8,
+    &sub_enc_9,  &sub_enc_10, &sub_enc_11, &sub_enc_12,
+    &sub_enc_13, &sub_enc_14, &sub_enc_15, &sub_enc_16
+};
+
+static const smallframe_fn dec_kernel[SMALLFRAME_BLOCKS] = {
+    &sub_dec_1,  &sub_dec_2,  &sub_dec_3,  &sub_dec_4,
+    &sub_dec_5,  &sub_dec_6,  &sub_dec_7,  &sub_dec_8,
+    &sub_dec_9,  &sub_dec_10, &sub_dec_11, &sub_dec_12,
+    &sub_dec_13, &sub_dec_14, &sub_dec_15, &sub_dec_16
+};
+
+#undef _KERNELS
+#undef _DEC_STEP
+#undef _ENC_STEP
+
+
+
+static ret_type sub_run(const smallframe_fn* table, io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
+    unsigned long n = (data_len - 1) / _BLKSZ;
+
+    if ((data_len == 0) || (n >= SMALLFRAME_BLOCKS)) {
+        return RETURN_ERROR;
+    }
+    table[n](data, (unsigned int)(data_len - (n * _BLKSZ)), ctx);
+    ctx->txt_ccnt = (uint_32t)data_len;
+    ctx->txt_acnt = (uint_32t)data_len;
+    return RETURN_GOOD;
+}
+
+
+
+ret_type smallframe_encrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
+    return sub_run(enc_kernel, data, data_len, ctx);
+}
+
+
+
+ret_type smallframe_decrypt(io_t* data, unsigned long data_len, eax_ctx ctx[1]) {
+    return sub_run(dec_kernel, data, data_len, ctx);
+}
+
+#undef _XOR
+#undef _BLKSZ
+
+#endif
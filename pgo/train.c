@@ -0,0 +1,202 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/pgo/train.c
+  * @version    R100
+  * @brief      OTEAX training workload for the profile-guided build
+  *
+  * Runs a mix of DASH7 frames through EAX in both directions: each frame is
+  * encrypted as a transmitter would, then decrypted as the receiver would,
+  * with a few frames damaged on the way so that tag checks fail too.  Frame
+  * lengths follow a DASH7 gateway's traffic: mostly short acks, queries and
+  * sensor reports, fewer file transfers, and rare frames near the 256 byte
+  * limit.  Frames sit at varying offsets in the radio buffer, and some go
+  * through the streaming calls in two pieces, so that the alignment checks
+  * and partial block code see their usual share of the work.
+  *
+  * Usage: train [frames]
+  * It prints the time per frame, and exits non-zero if any frame decrypts
+  * wrongly.  The Makefile uses it to train OPTIMIZE=pgo and to compare that
+  * build with OPTIMIZE=speed.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <oteax.h>
+
+#define UNIT        sizeof(io_t)
+#define NUM_KEYS    4
+#define MAX_FRAME   256
+#define DEF_FRAMES  400000
+
+/* Payload lengths in bytes, and their share of the traffic in percent */
+static const struct {
+    unsigned int    len;
+    unsigned int    weight;
+} mix[] = {
+    {   7, 12 },    // acks
+    {  13, 16 },    // queries and beacons
+    {  21, 20 },    // sensor reports
+    {  33, 18 },
+    {  47, 12 },
+    {  64,  8 },
+    {  97,  6 },    // file data
+    { 128,  4 },
+    { 173,  2 },
+    { 249,  2 }     // near the frame limit
+};
+
+#define NUM_MIX     (sizeof(mix) / sizeof(mix[0]))
+
+
+
+static uint32_t sub_rand(uint32_t* x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+
+
+static unsigned int sub_pick_len(uint32_t r) {
+    unsigned int i;
+
+    r %= 100;
+    for (i=0; i<(NUM_MIX-1); i++) {
+        if (r < mix[i].weight) {
+            break;
+        }
+        r -= mix[i].weight;
+    }
+    return mix[i].len;
+}
+
+
+
+/* Receive in two pieces with the streaming calls.  Returns 0 if the tag is good. */
+static int sub_stream_rx(const uint32_t* nonce, io_t* msg, unsigned long units, unsigned long split, eax_ctx ctx[1]) {
+    uint32_t tag[4];
+
+    eax_init_message((const io_t*)nonce, ctx);
+    eax_decrypt(msg, split, ctx);
+    eax_decrypt(&msg[split], units - split, ctx);
+    eax_compute_tag((io_t*)tag, ctx);
+    return memcmp(tag, &msg[units], 4) != 0;
+}
+
+
+
+int main(int argc, char** argv) {
+    static uint32_t radio[(MAX_FRAME + 16) / 4];
+    static uint32_t ref[(MAX_FRAME + 16) / 4];
+
+    eax_ctx         ctx[NUM_KEYS];
+    uint32_t        keys[NUM_KEYS][4];
+    uint32_t        nonce[2];
+    uint32_t        seed = 0x9E3779B9;
+    unsigned long   frames = DEF_FRAMES;
+    unsigned long   bytes = 0;
+    unsigned long   n;
+    int             errors = 0;
+    int             i;
+    struct timespec t0, t1;
+    double          ns;
+
+    if (argc > 1) {
+        frames = strtoul(argv[1], NULL, 10);
+    }
+
+    for (i=0; i<NUM_KEYS; i++) {
+        keys[i][0] = sub_rand(&seed);
+        keys[i][1] = sub_rand(&seed);
+        keys[i][2] = sub_rand(&seed);
+        keys[i][3] = sub_rand(&seed);
+    }
+    eax_init_and_keys(keys, NUM_KEYS, ctx);
+    for (i=0; i<(int)sizeof(ref); i++) {
+        ((uint8_t*)ref)[i] = (uint8_t)(i * 29);
+    }
+    nonce[0] = sub_rand(&seed);
+    nonce[1] = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    for (n=0; n<frames; n++) {
+        uint32_t        r       = sub_rand(&seed);
+        unsigned int    len     = sub_pick_len(r);
+        eax_ctx*        c       = &ctx[(r >> 8) % NUM_KEYS];
+        unsigned long   units   = (len + UNIT - 1) / UNIT;
+        unsigned int    off     = 0;
+        int             damaged = ((r >> 12) % 64) == 0;
+        int             stream  = ((r >> 18) % 8) == 0;
+        io_t*           msg;
+        int             bad;
+
+        /* Byte builds see frames at any offset in the radio buffer */
+        if (UNIT == 1) {
+            off = (r >> 24) & 3;
+        }
+        msg = (io_t*)&((uint8_t*)radio)[off];
+        memcpy(msg, ref, len);
+
+        nonce[1] = (uint32_t)n & 0x00FFFFFF;
+
+        // Transmit
+        eax_encrypt_message(nonce, msg, len, c);
+
+        if (damaged) {
+            ((uint8_t*)msg)[(r >> 4) % len] ^= 0x10;
+        }
+
+        // Receive
+        if (stream && (units > 1)) {
+            bad = sub_stream_rx(nonce, msg, units, (r >> 21) % units, c);
+        }
+        else {
+            bad = (eax_decrypt_message(nonce, msg, len, c) != 0);
+        }
+
+        if (bad != damaged) {
+            errors++;
+        }
+        else if (!damaged && (memcmp(msg, ref, len) != 0)) {
+            errors++;
+        }
+        bytes += len;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ns = ((double)(t1.tv_sec - t0.tv_sec) * 1e9) + (double)(t1.tv_nsec - t0.tv_nsec);
+
+    for (i=0; i<NUM_KEYS; i++) {
+        eax_end(&ctx[i]);
+    }
+
+    printf("%lu frames (%lu payload bytes, each way): %.1f ns/frame, %.1f MB/s\n",
+            frames, bytes, ns / (double)frames, ((double)bytes * 1e3) / ns);
+    if (errors != 0) {
+        printf("%d frames did not decrypt as expected\n", errors);
+    }
+    return (errors != 0);
+}
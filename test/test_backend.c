@@ -0,0 +1,150 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_backend.c
+  * @version    R100
+  * @brief      OTEAX Test program for cipher backends
+  *
+  * Encrypts and decrypts messages of several lengths with the built-in code,
+  * the software backend and the simulated co-processor, and checks that all
+  * of them agree.  The streaming calls are also run in uneven pieces through
+  * each one, to exercise the partial block hand-offs.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+
+#define MAX_LEN     1000
+
+static const uint8_t key[16] = {
+    0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6,
+    0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C
+};
+
+static const uint8_t nonce[8] = {
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0x00
+};
+
+static const unsigned long lengths[] = { 0, 1, 7, 16, 17, 31, 32, 100, 256, MAX_LEN };
+
+
+
+static int sub_check(const char* name, const eax_backend* be, void* hdl) {
+    int i;
+    int errors = 0;
+
+    eax_ctx ref, ctx;
+    uint32_t a[(MAX_LEN+8)/4];
+    uint32_t b[(MAX_LEN+8)/4];
+
+    eax_init_and_key(key, &ref);
+    eax_init_and_key(key, &ctx);
+    eax_set_backend(be, hdl, &ctx);
+
+    for (i=0; i<sizeof(lengths)/sizeof(lengths[0]); i++) {
+        unsigned long j, len = lengths[i];
+
+        memset(a, 0, sizeof(a));
+        for (j=0; j<len; j++) {
+            ((uint8_t*)a)[j] = (uint8_t)(j ^ (j >> 3) ^ i);
+        }
+        memcpy(b, a, sizeof(a));
+
+        eax_encrypt_message(nonce, a, len, &ref);
+        eax_encrypt_message(nonce, b, len, &ctx);
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            printf("%s, length %lu: encrypt mismatch\n", name, len);
+            errors++;
+        }
+
+#       if !defined(__ALIGN32__)
+        // Streaming in uneven pieces
+        {   uint8_t         tag[4];
+            unsigned long   pos, step;
+
+            for (j=0; j<len; j++) {
+                ((uint8_t*)b)[j] = (uint8_t)(j ^ (j >> 3) ^ i);
+            }
+            eax_init_message(nonce, &ctx);
+            for (pos=0, step=5; pos<len; pos+=step, step+=11) {
+                if (step > (len-pos)) {
+                    step = len-pos;
+                }
+                eax_encrypt(&((uint8_t*)b)[pos], step, &ctx);
+            }
+            eax_compute_tag(tag, &ctx);
+            if ((memcmp(a, b, len) != 0) || (memcmp(tag, &((uint8_t*)a)[len], 4) != 0)) {
+                printf("%s, length %lu: streaming encrypt mismatch\n", name, len);
+                errors++;
+            }
+        }
+#       endif
+
+        if (eax_decrypt_message(nonce, b, len, &ctx) != 0) {
+            printf("%s, length %lu: decrypt failed authentication\n", name, len);
+            errors++;
+        }
+        for (j=0; j<len; j++) {
+            if (((uint8_t*)b)[j] != (uint8_t)(j ^ (j >> 3) ^ i)) {
+                printf("%s, length %lu: plaintext mismatch at %lu\n", name, len, j);
+                errors++;
+                break;
+            }
+        }
+    }
+
+    eax_end(&ctx);
+    eax_end(&ref);
+    return errors;
+}
+
+
+
+int main(void) {
+    int errors = 0;
+
+    errors += sub_check("built-in", NULL, NULL);
+    errors += sub_check("software", &eax_backend_sw, NULL);
+
+#   if defined(COPROC_POSSIBLE)
+    {   void* cp;
+        cp = eax_coproc_open(2000, 10);
+        if (cp == NULL) {
+            printf("Could not start simulated co-processor\n");
+            errors++;
+        }
+        else {
+            errors += sub_check("coproc-sim", &eax_backend_coproc, cp);
+            eax_coproc_close(cp);
+        }
+    }
+#   endif
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
@@ -0,0 +1,163 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_batch.c
+  * @version    R100
+  * @brief      OTEAX Test program for batch decryption
+  *
+  * Encrypts a batch of frames under two keys with eax_encrypt_message(),
+  * corrupts a few of them (text or tag), and checks that
+  * eax_decrypt_messages() reports exactly those in its pass mask, decrypts
+  * the rest, and leaves the corrupted ones untouched.  Lengths are multiples
+  * of four bytes so that the same test runs in __ALIGN32__ builds.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+#define NUM_MSGS    EAX_BATCH_MAX
+#define MAX_BYTES   96
+
+static const uint8_t keys[32] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+
+
+int main(void) {
+    int errors = 0;
+    unsigned int i;
+    size_t j;
+
+    eax_ctx         ctx[2];
+    uint32_t        kbuf[8];
+    uint32_t        nonce[NUM_MSGS][2];
+    uint32_t        frame[NUM_MSGS][(MAX_BYTES/4) + 1];
+    uint32_t        sent[NUM_MSGS][(MAX_BYTES/4) + 1];
+    const void*     iv[NUM_MSGS];
+    void*           msg[NUM_MSGS];
+    unsigned long   msg_len[NUM_MSGS];
+    eax_ctx*        cx[NUM_MSGS];
+    uint_32t        bad, pass;
+
+    memcpy(kbuf, keys, 32);
+    eax_init_and_keys(kbuf, 2, ctx);
+
+    for (i=0; i<NUM_MSGS; i++) {
+        nonce[i][0] = 0x01020304u * (i+1);
+        nonce[i][1] = i;
+        msg_len[i]  = (unsigned long)(4 * ((i * 7) % 25));
+        iv[i]       = nonce[i];
+        msg[i]      = frame[i];
+        cx[i]       = &ctx[i & 1];
+        for (j=0; j<msg_len[i]; j++) {
+            ((uint8_t*)frame[i])[j] = (uint8_t)(i + j);
+        }
+        eax_encrypt_message(iv[i], frame[i], msg_len[i], cx[i]);
+        memcpy(sent[i], frame[i], msg_len[i] + 4);
+    }
+
+    // All good
+    if ((eax_decrypt_messages(iv, msg, msg_len, NUM_MSGS, cx, &pass) != 0)
+    ||  (pass != 0xFFFFFFFFu)) {
+        printf("Clean batch: pass mask %08X\n", pass);
+        errors++;
+    }
+    for (i=0; i<NUM_MSGS; i++) {
+        for (j=0; j<msg_len[i]; j++) {
+            if (((uint8_t*)frame[i])[j] != (uint8_t)(i + j)) {
+                printf("Clean batch, frame %u: decryption mismatch\n", i);
+                errors++;
+                break;
+            }
+        }
+    }
+
+    // Corrupt the tag of every fifth frame, and the text of every seventh
+    bad = 0;
+    for (i=0; i<NUM_MSGS; i++) {
+        memcpy(frame[i], sent[i], msg_len[i] + 4);
+        if ((i % 5) == 1) {
+            ((uint8_t*)frame[i])[msg_len[i] + (i & 3)] ^= 0x10;
+            bad |= (uint_32t)1 << i;
+        }
+        else if (((i % 7) == 3) && (msg_len[i] != 0)) {
+            ((uint8_t*)frame[i])[msg_len[i] - 1] ^= 0x01;
+            bad |= (uint_32t)1 << i;
+        }
+        else if ((i % 7) == 3) {
+            cx[i] = &ctx[(i & 1) ^ 1];
+            bad |= (uint_32t)1 << i;
+        }
+        memcpy(sent[i], frame[i], msg_len[i] + 4);
+    }
+    if ((eax_decrypt_messages(iv, msg, msg_len, NUM_MSGS, cx, &pass) == 0)
+    ||  (pass != ~bad)) {
+        printf("Corrupted batch: pass mask %08X, expected %08X\n", pass, ~bad);
+        errors++;
+    }
+    for (i=0; i<NUM_MSGS; i++) {
+        if (bad & ((uint_32t)1 << i)) {
+            if (memcmp(frame[i], sent[i], msg_len[i] + 4) != 0) {
+                printf("Corrupted batch, frame %u: rejected frame was modified\n", i);
+                errors++;
+            }
+            continue;
+        }
+        for (j=0; j<msg_len[i]; j++) {
+            if (((uint8_t*)frame[i])[j] != (uint8_t)(i + j)) {
+                printf("Corrupted batch, frame %u: decryption mismatch\n", i);
+                errors++;
+                break;
+            }
+        }
+    }
+
+    // A short batch, and the limits
+    for (i=0; i<3; i++) {
+        cx[i] = &ctx[i & 1];
+        eax_encrypt_message(iv[i], frame[i], msg_len[i], cx[i]);
+    }
+    if ((eax_decrypt_messages(iv, msg, msg_len, 3, cx, &pass) != 0) || (pass != 7)) {
+        printf("Short batch: pass mask %08X\n", pass);
+        errors++;
+    }
+    if ((eax_decrypt_messages(iv, msg, msg_len, 0, cx, &pass) == 0)
+    ||  (eax_decrypt_messages(iv, msg, msg_len, EAX_BATCH_MAX+1, cx, &pass) == 0)) {
+        printf("Batch size limits not enforced\n");
+        errors++;
+    }
+
+    eax_end(&ctx[0]);
+    eax_end(&ctx[1]);
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
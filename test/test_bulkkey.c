@@ -0,0 +1,88 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_bulkkey.c
+  * @version    R100
+  * @brief      OTEAX Test program for eax_init_and_keys()
+  *
+  * Keys a batch of contexts with eax_init_and_keys() and checks that each
+  * one is identical to a context keyed individually by eax_init_and_key().
+  * The batch size is not a multiple of four, so both the four-wide path and
+  * the remainder path are exercised.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+
+#define NUM_KEYS    11
+
+
+int main(void) {
+    int i, j;
+    int errors = 0;
+
+    uint8_t keys[NUM_KEYS * 16];
+    eax_ctx bulk[NUM_KEYS];
+    eax_ctx single;
+
+    // Deterministic pseudo-random keys
+    {   uint32_t x = 0x2545F491;
+        for (i=0; i<sizeof(keys); i++) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            keys[i] = (uint8_t)x;
+        }
+    }
+
+    eax_init_and_keys(keys, NUM_KEYS, bulk);
+
+    for (i=0; i<NUM_KEYS; i++) {
+        eax_init_and_key(&keys[i*16], &single);
+
+        if (memcmp(single.aes, bulk[i].aes, sizeof(single.aes)) != 0) {
+            printf("Key %d: key schedule mismatch\n", i);
+            errors++;
+        }
+        if (memcmp(single.pad_xvv, bulk[i].pad_xvv, sizeof(single.pad_xvv)) != 0) {
+            printf("Key %d: pad mismatch\n", i);
+            for (j=0; j<sizeof(single.pad_xvv); j++) {
+                printf("%02X ", ((uint8_t*)single.pad_xvv)[j]);
+            }
+            putchar('\n');
+            for (j=0; j<sizeof(single.pad_xvv); j++) {
+                printf("%02X ", ((uint8_t*)bulk[i].pad_xvv)[j]);
+            }
+            putchar('\n');
+            errors++;
+        }
+    }
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
@@ -0,0 +1,156 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_cmac.c
+  * @version    R100
+  * @brief      OTEAX Test program for AES-CMAC
+  *
+  * Checks cmac_message() against the four RFC 4493 examples, then checks that
+  * streaming with cmac_update() in uneven pieces and batching with
+  * cmac_messages() give the same tags as cmac_message() for a spread of
+  * lengths.  Lengths are multiples of four bytes so that the same test runs
+  * in __ALIGN32__ builds.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+#define UNIT        sizeof(io_t)
+#define NUM_MSGS    27
+#define MAX_BYTES   (4 * 4 * NUM_MSGS)
+
+static const uint8_t key[16] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+
+static const uint8_t rfc_msg[64] = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+};
+
+static const struct {
+    unsigned int    len;
+    uint8_t         tag[16];
+} rfc_vec[4] = {
+    {  0, { 0xbb, 0x1d, 0x69, 0x29, 0xe9, 0x59, 0x37, 0x28, 0x7f, 0xa3, 0x7d, 0x12, 0x9b, 0x75, 0x67, 0x46 } },
+    { 16, { 0x07, 0x0a, 0x16, 0xb4, 0x6b, 0x4d, 0x41, 0x44, 0xf7, 0x9b, 0xdd, 0x9d, 0xd0, 0x4a, 0x28, 0x7c } },
+    { 40, { 0xdf, 0xa6, 0x67, 0x47, 0xde, 0x9a, 0xe6, 0x30, 0x30, 0xca, 0x32, 0x61, 0x14, 0x97, 0xc8, 0x27 } },
+    { 64, { 0x51, 0xf0, 0xbe, 0xbf, 0x7e, 0x3b, 0x9d, 0x92, 0xfc, 0x49, 0x74, 0x17, 0x79, 0x36, 0x3c, 0xfe } }
+};
+
+
+
+int main(void) {
+    int i;
+    int errors = 0;
+
+    cmac_ctx        ctx[1];
+    uint32_t        kbuf[4];
+    uint32_t        mbuf[16];
+    uint32_t        tag[4];
+    uint32_t        data[MAX_BYTES/4];
+    uint32_t        one[NUM_MSGS][4];
+    uint32_t        many[NUM_MSGS][4];
+    const void*     msg[NUM_MSGS];
+    unsigned long   msg_len[NUM_MSGS];
+    void*           tags[NUM_MSGS];
+
+    memcpy(kbuf, key, 16);
+    memcpy(mbuf, rfc_msg, 64);
+    cmac_init_and_key(kbuf, ctx);
+
+    // RFC 4493 section 4
+    for (i=0; i<4; i++) {
+        cmac_message(mbuf, rfc_vec[i].len/UNIT, tag, ctx);
+        if (memcmp(tag, rfc_vec[i].tag, 16) != 0) {
+            printf("RFC 4493 example %d (%u bytes): tag mismatch\n", i+1, rfc_vec[i].len);
+            errors++;
+        }
+    }
+
+    // Messages of 0, 12, 24 ... bytes, each starting at a different offset
+    for (i=0; i<(MAX_BYTES/4); i++) {
+        data[i] = (uint32_t)(i * 0x9E3779B9u);
+    }
+    for (i=0; i<NUM_MSGS; i++) {
+        msg[i]      = &data[i];
+        msg_len[i]  = (unsigned long)(12 * i) / UNIT;
+        tags[i]     = many[i];
+        cmac_message(msg[i], msg_len[i], one[i], ctx);
+    }
+
+    // Streaming, in pieces of 4, 8, 12 ... bytes
+    for (i=0; i<NUM_MSGS; i++) {
+        unsigned long pos, step;
+        for (pos=0, step=4/UNIT; pos<msg_len[i]; pos+=step, step+=4/UNIT) {
+            if (step > (msg_len[i]-pos)) {
+                step = msg_len[i]-pos;
+            }
+            cmac_update(&((const io_t*)msg[i])[pos], step, ctx);
+        }
+        cmac_compute_tag(tag, ctx);
+        if (memcmp(tag, one[i], 16) != 0) {
+            printf("Streaming, %lu bytes: tag mismatch\n", msg_len[i]*UNIT);
+            errors++;
+        }
+    }
+
+    // Batch, in order and with the longest messages first
+    cmac_messages(msg, msg_len, tags, NUM_MSGS, ctx);
+    for (i=0; i<NUM_MSGS; i++) {
+        if (memcmp(many[i], one[i], 16) != 0) {
+            printf("Batch, %lu bytes: tag mismatch\n", msg_len[i]*UNIT);
+            errors++;
+        }
+    }
+    for (i=0; i<(NUM_MSGS/2); i++) {
+        const void*     m = msg[i];
+        unsigned long   l = msg_len[i];
+        uint32_t        t[4];
+        msg[i]                  = msg[NUM_MSGS-1-i];
+        msg_len[i]              = msg_len[NUM_MSGS-1-i];
+        msg[NUM_MSGS-1-i]       = m;
+        msg_len[NUM_MSGS-1-i]   = l;
+        memcpy(t, one[i], 16);
+        memcpy(one[i], one[NUM_MSGS-1-i], 16);
+        memcpy(one[NUM_MSGS-1-i], t, 16);
+    }
+    memset(many, 0, sizeof(many));
+    cmac_messages(msg, msg_len, tags, NUM_MSGS, ctx);
+    for (i=0; i<NUM_MSGS; i++) {
+        if (memcmp(many[i], one[i], 16) != 0) {
+            printf("Batch (reversed), %lu bytes: tag mismatch\n", msg_len[i]*UNIT);
+            errors++;
+        }
+    }
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
@@ -0,0 +1,179 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_ct.c
+  * @version    R100
+  * @brief      OTEAX Test program for the constant-time AES kernel
+  *
+  * Checks aes_encrypt_ct() against the FIPS-197 AES-128 example and against
+  * the table kernel for a spread of keys and blocks.  Then checks that EAX
+  * and CMAC contexts keyed with the constant-time kernel produce the same
+  * frames and tags as normal ones, with and without the software backend
+  * (which sends every block through aes_encrypt()).  Lengths are multiples
+  * of four bytes so that the same test runs in __ALIGN32__ builds.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+#define NUM_KEYS    64
+#define MAX_MSG     72
+
+static const uint8_t fips_key[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+static const uint8_t fips_pt[16] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+
+static const uint8_t fips_ct[16] = {
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+    0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+
+
+static uint32_t sub_rand(uint32_t* x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+
+
+int main(void) {
+    int errors = 0;
+    int k, b;
+    size_t msg_len, i;
+    uint32_t seed = 0x2545F491;
+
+    aes_encrypt_ctx fast[1], ct[1];
+    eax_ctx         e_fast[1], e_ct[1];
+    cmac_ctx        c_fast[1], c_ct[1];
+    uint32_t        kbuf[4], nbuf[2];
+    uint32_t        in[4], out1[4], out2[4];
+    uint32_t        pt[MAX_MSG/4];
+    uint32_t        frame1[(MAX_MSG/4) + 1];
+    uint32_t        frame2[(MAX_MSG/4) + 1];
+
+    // FIPS-197 appendix C.1
+    memcpy(kbuf, fips_key, 16);
+    memcpy(in, fips_pt, 16);
+    aes_encrypt_key128_ct((io_t*)kbuf, ct);
+    aes_encrypt_ct((io_t*)in, (io_t*)out1, ct);
+    aes_encrypt((io_t*)in, (io_t*)out2, ct);
+    if ((memcmp(out1, fips_ct, 16) != 0) || (memcmp(out2, fips_ct, 16) != 0)) {
+        printf("FIPS-197 example: ciphertext mismatch\n");
+        errors++;
+    }
+
+    // Random keys and blocks against the table kernel
+    for (k=0; k<NUM_KEYS; k++) {
+        for (i=0; i<4; i++) {
+            kbuf[i] = sub_rand(&seed);
+        }
+        aes_encrypt_key((io_t*)kbuf, 16, fast);
+        aes_encrypt_key128_ct((io_t*)kbuf, ct);
+        if (memcmp(fast->ks, ct->ks, sizeof(fast->ks)) != 0) {
+            printf("Key %d: key schedule mismatch\n", k);
+            errors++;
+        }
+        for (b=0; b<16; b++) {
+            for (i=0; i<4; i++) {
+                in[i] = sub_rand(&seed);
+            }
+            aes_encrypt((io_t*)in, (io_t*)out1, fast);
+            aes_encrypt_ct((io_t*)in, (io_t*)out2, ct);
+            if (memcmp(out1, out2, 16) != 0) {
+                printf("Key %d, block %d: ciphertext mismatch\n", k, b);
+                errors++;
+                break;
+            }
+        }
+    }
+
+    // EAX and CMAC, constant-time contexts against normal ones
+    memcpy(kbuf, fips_key, 16);
+    nbuf[0] = 0x03020100;
+    nbuf[1] = 0x00060504;
+    eax_init_and_key(kbuf, e_fast);
+    eax_init_and_key_ct(kbuf, e_ct);
+    cmac_init_and_key(kbuf, c_fast);
+    cmac_init_and_key_ct(kbuf, c_ct);
+    if ((eax_kernel(e_fast) != EAX_KERNEL_FAST) || (eax_kernel(e_ct) != EAX_KERNEL_CT)) {
+        printf("eax_kernel() does not report the kernel given at keying\n");
+        errors++;
+    }
+    if (memcmp(e_fast->pad_xvv, e_ct->pad_xvv, sizeof(e_fast->pad_xvv)) != 0) {
+        printf("OMAC pad mismatch\n");
+        errors++;
+    }
+
+    for (i=0; i<MAX_MSG; i++) {
+        ((uint8_t*)pt)[i] = (uint8_t)(i * 11);
+    }
+    for (b=0; b<2; b++) {
+        if (b != 0) {
+            eax_set_backend(&eax_backend_sw, NULL, e_ct);
+        }
+        for (msg_len=0; msg_len<=MAX_MSG; msg_len+=4) {
+            memcpy(frame1, pt, msg_len);
+            memcpy(frame2, pt, msg_len);
+            eax_encrypt_message(nbuf, frame1, msg_len, e_fast);
+            eax_encrypt_message(nbuf, frame2, msg_len, e_ct);
+            if (memcmp(frame1, frame2, msg_len+4) != 0) {
+                printf("EAX, %zu bytes%s: frame mismatch\n", msg_len, b ? " (backend)" : "");
+                errors++;
+                continue;
+            }
+            if ((eax_decrypt_message(nbuf, frame2, msg_len, e_ct) != 0)
+            ||  (memcmp(frame2, pt, msg_len) != 0)) {
+                printf("EAX, %zu bytes%s: decryption failed\n", msg_len, b ? " (backend)" : "");
+                errors++;
+            }
+        }
+    }
+
+    for (msg_len=0; msg_len<=MAX_MSG; msg_len+=12) {
+        cmac_message(pt, msg_len/sizeof(io_t), out1, c_fast);
+        cmac_message(pt, msg_len/sizeof(io_t), out2, c_ct);
+        if (memcmp(out1, out2, 16) != 0) {
+            printf("CMAC, %zu bytes: tag mismatch\n", msg_len);
+            errors++;
+        }
+    }
+
+    eax_end(e_fast);
+    eax_end(e_ct);
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
@@ -0,0 +1,171 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_ctr.c
+  * @version    R100
+  * @brief      OTEAX Test program for the AES-CTR engine
+  *
+  * Checks aes_ctr_crypt() against the NIST SP 800-38A F.5.1 vector, then
+  * against a block-at-a-time reference for 32, 64 and 128 bit counters that
+  * are started just below their wrap points, with the input fed in uneven
+  * pieces to exercise the saved partial block, and then in one piece, which
+  * is long enough for the wide VAES path where the CPU has it.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+#define UNIT        sizeof(io_t)
+#define MAX_BYTES   (16 * 41)
+
+static const uint8_t key[16] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+
+static const uint8_t sp800_iv[16] = {
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+    0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+
+static const uint8_t sp800_pt[64] = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+};
+
+static const uint8_t sp800_ct[64] = {
+    0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26, 0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+    0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff, 0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+    0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e, 0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+    0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1, 0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee
+};
+
+
+
+/* Reference: one block at a time, byte-wise increment of the counter field */
+static void sub_ref_ctr(uint8_t* data, size_t len, const uint8_t* iv, int ctr_bits, aes_encrypt_ctx* cx) {
+    uint32_t    ctr[4], ks[4];
+    size_t      i;
+    int         j;
+
+    memcpy(ctr, iv, 16);
+    for (i=0; i<len; i++) {
+        if ((i & 15) == 0) {
+            aes_encrypt((io_t*)ctr, (io_t*)ks, cx);
+            for (j=15; j>=(16-(ctr_bits/8)); j--) {
+                if (++((uint8_t*)ctr)[j] != 0) {
+                    break;
+                }
+            }
+        }
+        data[i] ^= ((uint8_t*)ks)[i & 15];
+    }
+}
+
+
+
+int main(void) {
+    static const int widths[3] = { 32, 64, 128 };
+    int w;
+    int errors = 0;
+
+    aes_encrypt_ctx cx[1];
+    aes_ctr_ctx     cc[1];
+    uint32_t        kbuf[4];
+    uint32_t        ivbuf[4];
+    uint32_t        a[MAX_BYTES/4];
+    uint32_t        b[MAX_BYTES/4];
+
+    memcpy(kbuf, key, 16);
+    aes_encrypt_key((io_t*)kbuf, 16, cx);
+
+    // NIST SP 800-38A F.5.1, in two uneven pieces
+    memcpy(ivbuf, sp800_iv, 16);
+    memcpy(a, sp800_pt, 64);
+    aes_ctr_init((io_t*)ivbuf, 128, cc);
+    aes_ctr_crypt((io_t*)a, (io_t*)a, 20/UNIT, cc, cx);
+    aes_ctr_crypt((io_t*)&((uint8_t*)a)[20], (io_t*)&((uint8_t*)a)[20], 44/UNIT, cc, cx);
+    if (memcmp(a, sp800_ct, 64) != 0) {
+        printf("SP 800-38A F.5.1 mismatch\n");
+        errors++;
+    }
+
+    // Counter wrap at each width
+    for (w=0; w<3; w++) {
+        size_t  pos, step, i;
+        uint8_t iv[16];
+
+        for (i=0; i<16; i++) {
+            iv[i] = (uint8_t)(0xA0 + i);
+        }
+        for (i=16-(widths[w]/8); i<16; i++) {
+            iv[i] = 0xFF;
+        }
+        iv[15] = 0xFB;
+        for (i=0; i<MAX_BYTES; i++) {
+            ((uint8_t*)a)[i] = (uint8_t)(i * 13);
+        }
+        memcpy(b, a, MAX_BYTES);
+
+        sub_ref_ctr((uint8_t*)a, MAX_BYTES, iv, widths[w], cx);
+
+        memcpy(ivbuf, iv, 16);
+        aes_ctr_init((io_t*)ivbuf, widths[w], cc);
+        for (pos=0, step=4; pos<MAX_BYTES; pos+=step, step+=36) {
+            if (step > (MAX_BYTES-pos)) {
+                step = MAX_BYTES-pos;
+            }
+            aes_ctr_crypt((io_t*)&((uint8_t*)b)[pos], (io_t*)&((uint8_t*)b)[pos], (int)(step/UNIT), cc, cx);
+        }
+
+        if (memcmp(a, b, MAX_BYTES) != 0) {
+            printf("%d bit counter: mismatch with reference\n", widths[w]);
+            errors++;
+        }
+
+        for (i=0; i<MAX_BYTES; i++) {
+            ((uint8_t*)b)[i] = (uint8_t)(i * 13);
+        }
+        memcpy(ivbuf, iv, 16);
+        aes_ctr_init((io_t*)ivbuf, widths[w], cc);
+        aes_ctr_crypt((io_t*)b, (io_t*)b, MAX_BYTES/UNIT, cc, cx);
+        if (memcmp(a, b, MAX_BYTES) != 0) {
+            printf("%d bit counter, one piece: mismatch with reference\n", widths[w]);
+            errors++;
+        }
+    }
+
+    if (aes_ctr_init((io_t*)ivbuf, 48, cc) == EXIT_SUCCESS) {
+        printf("aes_ctr_init() accepted a 48 bit counter\n");
+        errors++;
+    }
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
@@ -0,0 +1,210 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_dispatch.c
+  * @version    R100
+  * @brief      OTEAX Test program for aes_encrypt() kernel selection
+  *
+  * Selects each kernel by name, and checks that aes_kernel_name() reports
+  * it, that it gives the FIPS-197 AES-128 example, and that EAX frames made
+  * with it match those made with the automatic choice.  Names the build or
+  * CPU does not have must be refused.  Then several threads encrypt the
+  * FIPS-197 block while one switches kernels under them, which must not
+  * change a single result.  Lengths are multiples of four bytes so that the
+  * same test runs in __ALIGN32__ builds.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <oteax.h>
+
+#define MAX_MSG     72
+#define THREADS     4
+#define ROUNDS      20000
+
+static const char* names[] = { "vaes", "aesni", "speed", "normal", "size" };
+
+static const uint8_t fips_key[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+static const uint8_t fips_pt[16] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+
+static const uint8_t fips_ct[16] = {
+    0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+    0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+
+
+static aes_encrypt_ctx  shared_aes[1];
+static int              switching;
+
+
+
+static void* sub_encrypt(void* arg) {
+    uint32_t    in[4], out[4];
+    long        i, bad = 0;
+
+    (void)arg;
+    memcpy(in, fips_pt, 16);
+    for (i=0; i<ROUNDS; i++) {
+        aes_encrypt((io_t*)in, (io_t*)out, shared_aes);
+        bad += (memcmp(out, fips_ct, 16) != 0);
+    }
+    return (void*)bad;
+}
+
+
+
+static void* sub_switch(void* arg) {
+    size_t k = 0;
+
+    (void)arg;
+    while (__atomic_load_n(&switching, __ATOMIC_RELAXED)) {
+        aes_kernel_select(names[k++ % (sizeof(names)/sizeof(names[0]))]);
+    }
+    return NULL;
+}
+
+
+
+int main(void) {
+    int errors = 0;
+    int selected = 0;
+    size_t k, msg_len, i;
+
+    aes_encrypt_ctx aes[1];
+    eax_ctx         ctx[1];
+    uint32_t        kbuf[4], nbuf[2];
+    uint32_t        in[4], out[4];
+    uint32_t        pt[MAX_MSG/4];
+    uint32_t        ref[MAX_MSG/4 + 1][(MAX_MSG/4) + 1];
+    uint32_t        frame[(MAX_MSG/4) + 1];
+    const char*     automatic;
+
+    memcpy(kbuf, fips_key, 16);
+    memcpy(in, fips_pt, 16);
+    nbuf[0] = 0x03020100;
+    nbuf[1] = 0x00060504;
+    for (i=0; i<MAX_MSG; i++) {
+        ((uint8_t*)pt)[i] = (uint8_t)(i * 7);
+    }
+
+    // Reference frames with the automatic choice
+    automatic = aes_kernel_name();
+    printf("Automatic kernel: %s\n", automatic);
+    eax_init_and_key(kbuf, ctx);
+    for (msg_len=0; msg_len<=MAX_MSG; msg_len+=4) {
+        memcpy(ref[msg_len/4], pt, msg_len);
+        eax_encrypt_message(nbuf, ref[msg_len/4], msg_len, ctx);
+    }
+    eax_end(ctx);
+
+    for (k=0; k<(sizeof(names)/sizeof(names[0])); k++) {
+        if (aes_kernel_select(names[k]) != EXIT_SUCCESS) {
+            if (strcmp(aes_kernel_name(), names[k]) == 0) {
+                printf("%s: refused, but reported as selected\n", names[k]);
+                errors++;
+            }
+            continue;
+        }
+        selected++;
+        if (strcmp(aes_kernel_name(), names[k]) != 0) {
+            printf("%s: selected, but %s is reported\n", names[k], aes_kernel_name());
+            errors++;
+        }
+
+        aes_encrypt_key((io_t*)kbuf, 16, aes);
+        aes_encrypt((io_t*)in, (io_t*)out, aes);
+        if (memcmp(out, fips_ct, 16) != 0) {
+            printf("%s: FIPS-197 ciphertext mismatch\n", names[k]);
+            errors++;
+        }
+
+        eax_init_and_key(kbuf, ctx);
+        for (msg_len=0; msg_len<=MAX_MSG; msg_len+=4) {
+            memcpy(frame, pt, msg_len);
+            eax_encrypt_message(nbuf, frame, msg_len, ctx);
+            if (memcmp(frame, ref[msg_len/4], msg_len+4) != 0) {
+                printf("%s, %zu bytes: frame mismatch\n", names[k], msg_len);
+                errors++;
+                continue;
+            }
+            if ((eax_decrypt_message(nbuf, frame, msg_len, ctx) != 0)
+            ||  (memcmp(frame, pt, msg_len) != 0)) {
+                printf("%s, %zu bytes: decryption failed\n", names[k], msg_len);
+                errors++;
+            }
+        }
+        eax_end(ctx);
+    }
+
+    if (selected == 0) {
+        printf("No kernel could be selected by name\n");
+        errors++;
+    }
+    if (aes_kernel_select("none") == EXIT_SUCCESS) {
+        printf("An unknown kernel name was accepted\n");
+        errors++;
+    }
+    if ((aes_kernel_select(NULL) != EXIT_SUCCESS) || (strcmp(aes_kernel_name(), automatic) != 0)) {
+        printf("Automatic selection did not restore %s\n", automatic);
+        errors++;
+    }
+
+    // Encrypt from several threads while the kernel changes under them
+    {
+        pthread_t   enc[THREADS], sw;
+        void*       bad;
+        int         t;
+
+        aes_encrypt_key((io_t*)kbuf, 16, shared_aes);
+        __atomic_store_n(&switching, 1, __ATOMIC_RELAXED);
+        pthread_create(&sw, NULL, &sub_switch, NULL);
+        for (t=0; t<THREADS; t++) {
+            pthread_create(&enc[t], NULL, &sub_encrypt, NULL);
+        }
+        for (t=0; t<THREADS; t++) {
+            pthread_join(enc[t], &bad);
+            if (bad != NULL) {
+                printf("Thread %d: %ld wrong blocks while switching kernels\n", t, (long)bad);
+                errors++;
+            }
+        }
+        __atomic_store_n(&switching, 0, __ATOMIC_RELAXED);
+        pthread_join(sw, NULL);
+        aes_kernel_select(NULL);
+    }
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
@@ -0,0 +1,266 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_eaxprime.c
+  * @version    R100
+  * @brief      OTEAX Test program for EAX'
+  *
+  * Checks eax_prime_encrypt_message() against fixed regression answers
+  * (not yet the published C12.22 vectors, see kats[]), and
+  * against a byte-wise reference written from the EAX' definition for a
+  * range of cleartext and message lengths, then checks that
+  * eax_prime_decrypt_message() restores the plaintext and that it rejects a corrupted frame without touching it.  Lengths are
+  * multiples of four bytes so that the same test runs in __ALIGN32__ builds.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+#define MAX_CLR     40
+#define MAX_MSG     72
+
+static const uint8_t key[16] = {
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10
+};
+
+/* Regression answers: ciphertext and tag for cleartext bytes 0x30 + 5i and
+   message bytes 0xa0 + 3i, under the key above.  These were computed with
+   a separate Python implementation of EAX' on pycryptodome's AES and
+   CMAC, so they don't depend on any code in this library, but they come
+   from the same reading of the EAX' definition as sub_ref_encrypt().
+   They are not interoperability vectors.
+   TODO: add the published test vectors of the EAX' paper (Moise, Beroset,
+   Phinney, Burns) / ANSI C12.22 here, which this tree does not yet have.
+*/
+typedef struct {
+    size_t          clr_len;
+    size_t          msg_len;
+    const uint8_t*  frame;
+} kat_t;
+
+static const uint8_t kat_4_0[4] = {
+    0xee, 0xd6, 0x97, 0xca
+};
+
+static const uint8_t kat_12_4[8] = {
+    0x37, 0x5a, 0x7d, 0x8f, 0x07, 0x34, 0x64, 0x33
+};
+
+static const uint8_t kat_16_16[20] = {
+    0x8f, 0x16, 0xcc, 0x9d, 0x2f, 0x6c, 0xcb, 0x4f,
+    0x58, 0x34, 0x5c, 0x75, 0xfa, 0x16, 0x2d, 0x01,
+    0xbe, 0x69, 0x34, 0x66
+};
+
+static const uint8_t kat_20_20[24] = {
+    0x8a, 0x9b, 0xc7, 0xae, 0x46, 0xfa, 0x4a, 0x34,
+    0x19, 0xb2, 0x29, 0x45, 0xbb, 0x6f, 0xc1, 0x2e,
+    0xde, 0x8f, 0xfe, 0xa4, 0x22, 0x56, 0x71, 0x39
+};
+
+static const uint8_t kat_32_36[40] = {
+    0x0c, 0x36, 0xee, 0xa0, 0x31, 0xbf, 0xf8, 0x2b,
+    0xa6, 0x0c, 0x45, 0xd6, 0xf7, 0x20, 0x24, 0xec,
+    0xd0, 0x39, 0x4e, 0xd8, 0x27, 0x15, 0xf5, 0x19,
+    0x76, 0x1d, 0x0a, 0xae, 0x5a, 0x88, 0x01, 0xb0,
+    0x2b, 0xde, 0xb9, 0xbb, 0xea, 0xfe, 0x14, 0x56
+};
+
+static const kat_t kats[] = {
+    {  4,  0, kat_4_0 },
+    { 12,  4, kat_12_4 },
+    { 16, 16, kat_16_16 },
+    { 20, 20, kat_20_20 },
+    { 32, 36, kat_32_36 },
+};
+
+
+
+static void sub_dbl(uint8_t* out, const uint8_t* in) {
+    int i;
+    uint8_t msb = in[0] & 0x80;
+
+    for (i=0; i<15; i++) {
+        out[i] = (uint8_t)((in[i] << 1) | (in[i+1] >> 7));
+    }
+    out[15] = (uint8_t)((in[15] << 1) ^ (msb ? 0x87 : 0));
+}
+
+
+
+/* CMAC with the whole-block and partial-block masks given explicitly */
+static void sub_ref_cmac(uint8_t* mac, const uint8_t* m, size_t len,
+                         const uint8_t* k_full, const uint8_t* k_part, aes_encrypt_ctx* cx) {
+    uint32_t    x[4];
+    size_t      nblk = (len == 0) ? 1 : ((len + 15) / 16);
+    size_t      b, i;
+
+    memset(x, 0, 16);
+    for (b=0; b<nblk; b++) {
+        size_t used = ((len - 16*b) < 16) ? (len - 16*b) : 16;
+        for (i=0; i<used; i++) {
+            ((uint8_t*)x)[i] ^= m[16*b + i];
+        }
+        if (b == (nblk-1)) {
+            const uint8_t* k = k_full;
+            if (used < 16) {
+                ((uint8_t*)x)[used] ^= 0x80;
+                k = k_part;
+            }
+            for (i=0; i<16; i++) {
+                ((uint8_t*)x)[i] ^= k[i];
+            }
+        }
+        aes_encrypt((io_t*)x, (io_t*)x, cx);
+    }
+    memcpy(mac, x, 16);
+}
+
+
+
+static void sub_ref_encrypt(uint8_t* out, const uint8_t* clr, size_t clr_len,
+                            const uint8_t* msg, size_t msg_len, aes_encrypt_ctx* cx) {
+    uint32_t    l[4], ctr[4], ks[4];
+    uint8_t     d[16], q[16], n[16], c[16];
+    size_t      i;
+    int         j;
+
+    memset(l, 0, 16);
+    aes_encrypt((io_t*)l, (io_t*)l, cx);
+    sub_dbl(d, (uint8_t*)l);
+    sub_dbl(q, d);
+
+    sub_ref_cmac(n, clr, clr_len, d, q, cx);
+
+    memcpy(ctr, n, 16);
+    ((uint8_t*)ctr)[12] &= 0x7F;
+    ((uint8_t*)ctr)[14] &= 0x7F;
+    for (i=0; i<msg_len; i++) {
+        if ((i & 15) == 0) {
+            aes_encrypt((io_t*)ctr, (io_t*)ks, cx);
+            for (j=15; j>=0; j--) {
+                if (++((uint8_t*)ctr)[j] != 0) {
+                    break;
+                }
+            }
+        }
+        out[i] = msg[i] ^ ((uint8_t*)ks)[i & 15];
+    }
+
+    sub_ref_cmac(c, out, msg_len, q, d, cx);
+    for (i=0; i<4; i++) {
+        out[msg_len + i] = n[12+i] ^ c[12+i];
+    }
+}
+
+
+
+int main(void) {
+    int errors = 0;
+    size_t clr_len, msg_len, i;
+
+    aes_encrypt_ctx cx[1];
+    eax_ctx         ctx[1];
+    uint32_t        kbuf[4];
+    uint32_t        clr[MAX_CLR/4];
+    uint32_t        pt[MAX_MSG/4];
+    uint32_t        ref[(MAX_MSG/4) + 1];
+    uint32_t        frame[(MAX_MSG/4) + 1];
+
+    memcpy(kbuf, key, 16);
+    aes_encrypt_key((io_t*)kbuf, 16, cx);
+    eax_init_and_key(kbuf, ctx);
+
+    for (i=0; i<MAX_CLR; i++) {
+        ((uint8_t*)clr)[i] = (uint8_t)(0x30 + i);
+    }
+    for (i=0; i<MAX_MSG; i++) {
+        ((uint8_t*)pt)[i] = (uint8_t)(i * 7);
+    }
+
+    for (i=0; i<(sizeof(kats)/sizeof(kat_t)); i++) {
+        uint32_t    kclr[MAX_CLR/4];
+        size_t      j;
+
+        for (j=0; j<kats[i].clr_len; j++) {
+            ((uint8_t*)kclr)[j] = (uint8_t)(0x30 + 5*j);
+        }
+        for (j=0; j<kats[i].msg_len; j++) {
+            ((uint8_t*)frame)[j] = (uint8_t)(0xa0 + 3*j);
+        }
+        eax_prime_encrypt_message(kclr, kats[i].clr_len, frame, kats[i].msg_len, ctx);
+        if (memcmp(frame, kats[i].frame, kats[i].msg_len+4) != 0) {
+            printf("clr %zu, msg %zu: known answer mismatch\n", kats[i].clr_len, kats[i].msg_len);
+            errors++;
+        }
+        else if (eax_prime_decrypt_message(kclr, kats[i].clr_len, frame, kats[i].msg_len, ctx) != 0) {
+            printf("clr %zu, msg %zu: known answer rejected\n", kats[i].clr_len, kats[i].msg_len);
+            errors++;
+        }
+    }
+
+    for (clr_len=4; clr_len<=MAX_CLR; clr_len+=12) {
+        for (msg_len=0; msg_len<=MAX_MSG; msg_len+=4) {
+            sub_ref_encrypt((uint8_t*)ref, (uint8_t*)clr, clr_len, (uint8_t*)pt, msg_len, cx);
+
+            memcpy(frame, pt, msg_len);
+            eax_prime_encrypt_message(clr, clr_len, frame, msg_len, ctx);
+            if (memcmp(frame, ref, msg_len+4) != 0) {
+                printf("clr %zu, msg %zu: encryption mismatch with reference\n", clr_len, msg_len);
+                errors++;
+                continue;
+            }
+
+            if (eax_prime_decrypt_message(clr, clr_len, frame, msg_len, ctx) != 0) {
+                printf("clr %zu, msg %zu: valid frame rejected\n", clr_len, msg_len);
+                errors++;
+            }
+            else if (memcmp(frame, pt, msg_len) != 0) {
+                printf("clr %zu, msg %zu: decryption mismatch\n", clr_len, msg_len);
+                errors++;
+            }
+
+            memcpy(frame, ref, msg_len+4);
+            ((uint8_t*)frame)[msg_len/2] ^= 0x01;
+            if (eax_prime_decrypt_message(clr, clr_len, frame, msg_len, ctx) == 0) {
+                printf("clr %zu, msg %zu: corrupted frame accepted\n", clr_len, msg_len);
+                errors++;
+            }
+            ((uint8_t*)frame)[msg_len/2] ^= 0x01;
+            if (memcmp(frame, ref, msg_len+4) != 0) {
+                printf("clr %zu, msg %zu: rejected frame was modified\n", clr_len, msg_len);
+                errors++;
+            }
+        }
+    }
+
+    eax_end(ctx);
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
@@ -0,0 +1,214 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_gcm.c
+  * @version    R100
+  * @brief      OTEAX Test program for AES-GCM
+  *
+  * Checks the streaming GCM calls against the AES-128 cases of the GCM
+  * specification (McGrew & Viega, test cases 1 to 6, with case 6 using a
+  * different 60 byte IV), feeding header and text in uneven pieces.  Then
+  * checks the single-call functions, a rejected frame, and that a context
+  * with the software backend gives the same result.  All lengths are
+  * multiples of four bytes so the test also runs in __ALIGN32__ builds.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+#define UNIT        sizeof(io_t)
+#define MAX_BYTES   2048
+
+typedef struct {
+    const char* key;
+    const char* iv;
+    const char* hdr;
+    const char* pt;
+    const char* ct;
+    const char* tag;
+} gcm_vec_t;
+
+#define K0  "00000000000000000000000000000000"
+#define K1  "feffe9928665731c6d6a8f9467308308"
+#define P1  "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72" \
+            "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+#define A1  "feedfacedeadbeeffeedfacedeadbeefabaddad2"
+
+static const gcm_vec_t vec[6] = {
+    { K0, "000000000000000000000000", "", "", "",
+      "58e2fccefa7e3061367f1d57a4e7455a" },
+    { K0, "000000000000000000000000", "", "00000000000000000000000000000000",
+      "0388dace60b6a392f328c2b971b2fe78",
+      "ab6e47d42cec13bdf53a67b21257bddf" },
+    { K1, "cafebabefacedbaddecaf888", "", P1 "1aafd255",
+      "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+      "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091473f5985",
+      "4d5c2af327cd64a62cf35abd2ba6fab4" },
+    { K1, "cafebabefacedbaddecaf888", A1, P1,
+      "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e"
+      "21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+      "5bc94fbc3221a5db94fae95ae7121a47" },
+    { K1, "cafebabefacedbad", A1, P1,
+      "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c7423"
+      "73806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598",
+      "3612d2e79e3b0785561be14aaca2fccb" },
+    { K1, "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728"
+          "c3c0c95156809539fcf0e2452a6b525ab16aedf5aa0de657ba637b39", A1, P1,
+      "23ff821ca40c599179a3bde8617398f16296c3c04f87a87810c00f955fe496d7"
+      "aa4c5cdc19bb9a9e7c04bccdc9e90cc85577a2b723f61f35a5e26342",
+      "c868bed878587061479eab9c066ec94b" }
+};
+
+
+
+static size_t sub_hex(uint32_t* out, const char* hex) {
+    size_t n = strlen(hex) / 2;
+    size_t i;
+    for (i=0; i<n; i++) {
+        unsigned int b;
+        sscanf(&hex[2*i], "%2x", &b);
+        ((uint8_t*)out)[i] = (uint8_t)b;
+    }
+    return n;
+}
+
+
+
+/* Feed len bytes in pieces of 4, 8, 12 ... bytes */
+static void sub_stream(ret_type (*fn)(io_t*, unsigned long, gcm_ctx*), uint32_t* data, size_t len, gcm_ctx* ctx) {
+    size_t pos, step;
+    for (pos=0, step=4; pos<len; pos+=step, step+=4) {
+        if (step > (len-pos)) {
+            step = len-pos;
+        }
+        fn((io_t*)&((uint8_t*)data)[pos], step/UNIT, ctx);
+    }
+}
+
+
+
+int main(void) {
+    int v;
+    int errors = 0;
+
+    gcm_ctx     ctx[1];
+    uint32_t    key[4], iv[16], hdr[8], pt[16], ct[16], tag[4];
+    uint32_t    buf[16], out[4];
+    size_t      iv_len, hdr_len, pt_len, i;
+
+    static uint32_t big[(MAX_BYTES/4) + 4];
+    static uint32_t big2[(MAX_BYTES/4) + 4];
+
+    for (v=0; v<6; v++) {
+        sub_hex(key, vec[v].key);
+        iv_len  = sub_hex(iv, vec[v].iv);
+        hdr_len = sub_hex(hdr, vec[v].hdr);
+        pt_len  = sub_hex(pt, vec[v].pt);
+        sub_hex(ct, vec[v].ct);
+        sub_hex(tag, vec[v].tag);
+
+        gcm_init_and_key(key, ctx);
+
+        // Streaming encryption
+        memcpy(buf, pt, pt_len);
+        gcm_init_message((io_t*)iv, iv_len/UNIT, ctx);
+        if (hdr_len != 0) {
+            gcm_auth_header((io_t*)hdr, 4/UNIT, ctx);
+            gcm_auth_header((io_t*)&hdr[1], (hdr_len-4)/UNIT, ctx);
+        }
+        sub_stream(&gcm_encrypt, buf, pt_len, ctx);
+        gcm_compute_tag((io_t*)out, ctx);
+        if ((memcmp(buf, ct, pt_len) != 0) || (memcmp(out, tag, 16) != 0)) {
+            printf("Test case %d: streaming encryption mismatch\n", v+1);
+            errors++;
+        }
+
+        // Streaming decryption
+        gcm_init_message((io_t*)iv, iv_len/UNIT, ctx);
+        gcm_auth_header((io_t*)hdr, hdr_len/UNIT, ctx);
+        sub_stream(&gcm_decrypt, buf, pt_len, ctx);
+        gcm_compute_tag((io_t*)out, ctx);
+        if ((memcmp(buf, pt, pt_len) != 0) || (memcmp(out, tag, 16) != 0)) {
+            printf("Test case %d: streaming decryption mismatch\n", v+1);
+            errors++;
+        }
+
+        gcm_end(ctx);
+    }
+
+    // Single-call API, a longer message, and the software backend
+    for (i=0; i<MAX_BYTES; i++) {
+        ((uint8_t*)big)[i] = (uint8_t)(i * 29);
+    }
+    sub_hex(key, K1);
+    sub_hex(iv, "cafebabefacedbaddecaf888");
+    sub_hex(hdr, A1);
+    gcm_init_and_key(key, ctx);
+
+    memcpy(big2, big, MAX_BYTES);
+    gcm_encrypt_message(iv, hdr, 20, big2, MAX_BYTES, ctx);
+
+    gcm_init_message((io_t*)iv, 12/UNIT, ctx);
+    gcm_auth_header((io_t*)hdr, 20/UNIT, ctx);
+    sub_stream(&gcm_decrypt, big2, MAX_BYTES, ctx);
+    gcm_compute_tag((io_t*)out, ctx);
+    if ((memcmp(big2, big, MAX_BYTES) != 0) || (memcmp(out, &big2[MAX_BYTES/4], 16) != 0)) {
+        printf("Single-call encryption does not match streaming decryption\n");
+        errors++;
+    }
+
+    memcpy(big2, big, MAX_BYTES);
+    gcm_encrypt_message(iv, hdr, 20, big2, MAX_BYTES, ctx);
+    memcpy(big, big2, MAX_BYTES + 16);
+    gcm_set_backend(&eax_backend_sw, NULL, ctx);
+    memcpy(big2, big, MAX_BYTES + 16);
+    ((uint8_t*)big2)[MAX_BYTES/3] ^= 0x20;
+    if (gcm_decrypt_message(iv, hdr, 20, big2, MAX_BYTES, ctx) == 0) {
+        printf("Corrupted frame accepted\n");
+        errors++;
+    }
+    ((uint8_t*)big2)[MAX_BYTES/3] ^= 0x20;
+    if (memcmp(big2, big, MAX_BYTES + 16) != 0) {
+        printf("Rejected frame was modified\n");
+        errors++;
+    }
+    if (gcm_decrypt_message(iv, hdr, 20, big2, MAX_BYTES, ctx) != 0) {
+        printf("Valid frame rejected by the software backend\n");
+        errors++;
+    }
+    for (i=0; i<MAX_BYTES; i++) {
+        if (((uint8_t*)big2)[i] != (uint8_t)(i * 29)) {
+            printf("Software backend decryption mismatch at byte %zu\n", i);
+            errors++;
+            break;
+        }
+    }
+    gcm_end(ctx);
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
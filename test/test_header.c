@@ -0,0 +1,175 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_header.c
+  * @version    R100
+  * @brief      OTEAX Test program for EAX header authentication
+  *
+  * Checks tags for messages with a header against standard EAX (truncated to
+  * 4 bytes), computed three ways: with a cached header and the single-call
+  * functions, with eax_set_header(), and streaming with eax_auth_header() in
+  * two pieces.  Then checks that the header-less tag is unchanged and that
+  * a frame is rejected if the header does not match.  Lengths are multiples
+  * of four bytes so that the same test runs in __ALIGN32__ builds.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+#define UNIT        sizeof(io_t)
+#define MAX_HDR     36
+#define MAX_MSG     36
+
+static const uint8_t key[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+static const uint8_t nonce[8] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x00
+};
+
+/* Header bytes are 0xA0, 0xA1 ..., message bytes are 0, 7, 14 ... */
+static const struct {
+    unsigned int    hdr_len;
+    unsigned int    msg_len;
+    uint8_t         tag[4];
+} vec[5] = {
+    {  0,  0, { 0x9f, 0xba, 0xb9, 0xf6 } },
+    {  4, 20, { 0xe8, 0xe0, 0xdc, 0xe4 } },
+    { 16, 16, { 0x40, 0x56, 0xaa, 0xef } },
+    { 20, 36, { 0x3e, 0x10, 0x67, 0xf3 } },
+    { 36,  8, { 0x77, 0xfb, 0xde, 0xf3 } }
+};
+
+
+
+int main(void) {
+    int v;
+    int errors = 0;
+    size_t i;
+
+    eax_ctx     ctx[1];
+    eax_hdr_t   cache[1];
+    uint32_t    kbuf[4], nbuf[2];
+    uint32_t    hdr[MAX_HDR/4];
+    uint32_t    pt[MAX_MSG/4];
+    uint32_t    frame[(MAX_MSG/4) + 1];
+    uint32_t    plain[(MAX_MSG/4) + 1];
+    uint32_t    tag[1];
+
+    memcpy(kbuf, key, 16);
+    memcpy(nbuf, nonce, 8);
+    eax_init_and_key(kbuf, ctx);
+
+    for (i=0; i<MAX_HDR; i++) {
+        ((uint8_t*)hdr)[i] = (uint8_t)(0xA0 + i);
+    }
+    for (i=0; i<MAX_MSG; i++) {
+        ((uint8_t*)pt)[i] = (uint8_t)(i * 7);
+    }
+
+    for (v=0; v<5; v++) {
+        unsigned int hdr_len = vec[v].hdr_len;
+        unsigned int msg_len = vec[v].msg_len;
+
+        // Cached header, single-call functions
+        eax_cache_header(hdr, hdr_len, cache, ctx);
+        memcpy(frame, pt, msg_len);
+        eax_encrypt_message_hdr(nbuf, cache, frame, msg_len, ctx);
+        if (memcmp(&((uint8_t*)frame)[msg_len], vec[v].tag, 4) != 0) {
+            printf("Header %u, message %u: cached header tag mismatch\n", hdr_len, msg_len);
+            errors++;
+        }
+        memcpy(plain, frame, msg_len+4);
+        if (eax_decrypt_message_hdr(nbuf, cache, plain, msg_len, ctx) != 0) {
+            printf("Header %u, message %u: valid frame rejected\n", hdr_len, msg_len);
+            errors++;
+        }
+        else if (memcmp(plain, pt, msg_len) != 0) {
+            printf("Header %u, message %u: decryption mismatch\n", hdr_len, msg_len);
+            errors++;
+        }
+
+        // Cached header, streaming
+        memcpy(plain, pt, msg_len);
+        eax_init_message((io_t*)nbuf, ctx);
+        eax_set_header(cache, ctx);
+        eax_encrypt((io_t*)plain, msg_len/UNIT, ctx);
+        eax_compute_tag((io_t*)tag, ctx);
+        if ((memcmp(plain, frame, msg_len) != 0) || (memcmp(tag, vec[v].tag, 4) != 0)) {
+            printf("Header %u, message %u: eax_set_header() mismatch\n", hdr_len, msg_len);
+            errors++;
+        }
+
+        // Header streamed in two pieces, after the text
+        memcpy(plain, pt, msg_len);
+        eax_init_message((io_t*)nbuf, ctx);
+        eax_encrypt((io_t*)plain, msg_len/UNIT, ctx);
+        if (hdr_len != 0) {
+            eax_auth_header((io_t*)hdr, 4/UNIT, ctx);
+            eax_auth_header((io_t*)&hdr[1], (hdr_len-4)/UNIT, ctx);
+        }
+        else {
+            eax_set_header(cache, ctx);
+        }
+        eax_compute_tag((io_t*)tag, ctx);
+        if (memcmp(tag, vec[v].tag, 4) != 0) {
+            printf("Header %u, message %u: eax_auth_header() mismatch\n", hdr_len, msg_len);
+            errors++;
+        }
+
+        // Wrong header
+        if (hdr_len != 0) {
+            ((uint8_t*)hdr)[hdr_len-1] ^= 0x01;
+            eax_cache_header(hdr, hdr_len, cache, ctx);
+            ((uint8_t*)hdr)[hdr_len-1] ^= 0x01;
+            memcpy(plain, frame, msg_len+4);
+            if (eax_decrypt_message_hdr(nbuf, cache, plain, msg_len, ctx) == 0) {
+                printf("Header %u, message %u: wrong header accepted\n", hdr_len, msg_len);
+                errors++;
+            }
+        }
+    }
+
+    // Without a header the tag is the same as before
+    memcpy(frame, pt, 20);
+    memcpy(plain, pt, 20);
+    eax_encrypt_message(nbuf, frame, 20, ctx);
+    eax_init_message((io_t*)nbuf, ctx);
+    eax_encrypt((io_t*)plain, 20/UNIT, ctx);
+    eax_compute_tag((io_t*)tag, ctx);
+    if ((memcmp(plain, frame, 20) != 0) || (memcmp(tag, &((uint8_t*)frame)[20], 4) != 0)) {
+        printf("Header-less tag changed\n");
+        errors++;
+    }
+
+    eax_end(ctx);
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
@@ -0,0 +1,131 @@
+/* Copyright 2026 OTEAX contributors
+  *
+  * Licensed under the OpenTag License, Version 1.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  * http://www.indigresso.com/wiki/doku.php?id=opentag:license_1_0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  */
+/**
+  * @file       /oteax/test_smallframe.c
+  * @version    R100
+  * @brief      OTEAX Test program for the short-frame kernels
+  *
+  * eax_encrypt_message() and eax_decrypt_message() take the unrolled
+  * short-frame kernels up to 256 bytes, and the general loops beyond that.
+  * This checks both against the streaming calls, fed one io_t at a time,
+  * for every length from 0 to 288 bytes (every multiple of four bytes in
+  * __ALIGN32__ builds) and, for byte builds, at an odd buffer offset.
+  ******************************************************************************
+  */
+
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oteax.h>
+
+#define UNIT        sizeof(io_t)
+#define MAX_BYTES   288
+
+static const uint8_t key[16] = {
+    0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+
+static const uint8_t nonce[8] = {
+    0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0x00
+};
+
+
+
+static int sub_check(uint8_t* frame, size_t len, eax_ctx* ctx) {
+    int         errors = 0;
+    uint32_t    nbuf[2];
+    uint32_t    ref[(MAX_BYTES/4) + 1];
+    uint32_t    tag[1];
+    size_t      i;
+
+    memcpy(nbuf, nonce, 8);
+    for (i=0; i<len; i++) {
+        frame[i] = (uint8_t)(i * 13);
+    }
+    memcpy(ref, frame, len);
+
+    // Reference: streaming, one io_t at a time, so never the kernels
+    eax_init_message((io_t*)nbuf, ctx);
+    for (i=0; i<(len/UNIT); i++) {
+        eax_encrypt(&((io_t*)ref)[i], 1, ctx);
+    }
+    eax_compute_tag((io_t*)tag, ctx);
+    memcpy(&((uint8_t*)ref)[len], tag, 4);
+
+    eax_encrypt_message(nbuf, frame, len, ctx);
+    if (memcmp(frame, ref, len+4) != 0) {
+        printf("%zu bytes: encryption mismatch\n", len);
+        errors++;
+    }
+
+    if (eax_decrypt_message(nbuf, frame, len, ctx) != 0) {
+        printf("%zu bytes: valid frame rejected\n", len);
+        errors++;
+    }
+    for (i=0; i<len; i++) {
+        if (frame[i] != (uint8_t)(i * 13)) {
+            printf("%zu bytes: decryption mismatch at byte %zu\n", len, i);
+            errors++;
+            break;
+        }
+    }
+
+    memcpy(frame, ref, len+4);
+    frame[len/2] ^= 0x80;
+    if (eax_decrypt_message(nbuf, frame, len, ctx) == 0) {
+        printf("%zu bytes: corrupted frame accepted\n", len);
+        errors++;
+    }
+
+    return errors;
+}
+
+
+
+int main(void) {
+    int errors = 0;
+    size_t len;
+
+    eax_ctx     ctx[1];
+    uint32_t    kbuf[4];
+    uint32_t    buf[(MAX_BYTES/4) + 2];
+
+    memcpy(kbuf, key, 16);
+    eax_init_and_key(kbuf, ctx);
+
+    for (len=0; len<=MAX_BYTES; len+=UNIT) {
+        errors += sub_check((uint8_t*)buf, len, ctx);
+    }
+#   if !defined(__ALIGN32__)
+    for (len=0; len<=MAX_BYTES; len++) {
+        errors += sub_check(&((uint8_t*)buf)[1], len, ctx);
+    }
+#   endif
+
+    eax_end(ctx);
+
+    if (errors == 0) {
+        printf("Check done: no errors!\n");
+    }
+    putchar('\n');
+
+    return (errors != 0);
+}
@@ -126,7 +126,7 @@ int main(void) {
             printf("eax_init_and_key() failed, unknown error\n\n");
         }
         else {
-            for (i=0; i<44; i++) {
+            for (i=0; i<EKS_LENGTH; i++) {
                 printf("ks[%02d] = %u\n", i, context.aes[0].ks[i]);
             }
             printf("aes.inf.l = %u\n\n", context.aes[0].inf.l);